@@ -8,6 +8,11 @@ uniform mat4 u_NormalMatrix;
 in vec3 a_position;
 out vec3 v_Position;
 
+#ifdef HAS_QUANTIZED_POSITION
+uniform vec3 u_PositionScale;
+uniform vec3 u_PositionOffset;
+#endif
+
 #ifdef HAS_NORMAL_VEC3
 in vec3 a_normal;
 #endif
@@ -50,9 +55,24 @@ in mat4 a_instance_model_matrix;
 uniform mat3 u_vertNormalUVTransform;
 #endif
 
+#ifdef HAS_OCTAHEDRAL_NORMAL
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+#endif
+
 vec4 getPosition()
 {
+#ifdef HAS_QUANTIZED_POSITION
+    vec4 pos = vec4(a_position * u_PositionScale + u_PositionOffset, 1.0);
+#else
     vec4 pos = vec4(a_position, 1.0);
+#endif
 
 #ifdef USE_MORPHING
     pos += getTargetPosition(gl_VertexID);
@@ -69,7 +89,11 @@ vec4 getPosition()
 #ifdef HAS_NORMAL_VEC3
 vec3 getNormal()
 {
+#ifdef HAS_OCTAHEDRAL_NORMAL
+    vec3 normal = octDecode(a_normal.xy);
+#else
     vec3 normal = a_normal;
+#endif
 
 #ifdef USE_MORPHING
     normal += getTargetNormal(gl_VertexID);
@@ -4,6 +4,7 @@
 
 #include <jni.h>
 #include <string>
+#include <vector>
 #include <GLES2/gl2.h>
 #include <android/asset_manager_jni.h>
 #include "utils/LogUtils.h"
@@ -13,6 +14,7 @@
 #include "gltfdata/converter/ShaderManager.h"
 #include "gltfdata/ibl/HDRImageLoader.h"
 #include "gltfdata/ibl_sampler.h"
+#include "utils/AssetProvider.h"
 
 
 namespace digitalhumans {
@@ -41,7 +43,7 @@ std::shared_ptr<UserCamera> getCameraShared(jlong camera_ptr) {
   return (it != g_camera_map.end()) ? it->second : nullptr;
 }
 
-std::string readGLSLFile(JNIEnv *env, jobject context, const char *filename);
+AAssetManager *getAssetManager(JNIEnv *env, jobject context);
 
 
 void loadShaders(JNIEnv *env, jobject thiz);
@@ -51,67 +53,20 @@ Engine *getEngine(jlong enginePtr);
 Engine *getEngine(jlong enginePtr);
 
 void loadShaders(JNIEnv *env, jobject thiz) {
+  AndroidAssetProvider provider(getAssetManager(env, thiz));
+  if (!ShaderManager::getInstance().loadShaderFiles(provider)) {
+    LOGE("Failed to load some GLSL shader files");
+  }
+}
+
 
-  auto animation = readGLSLFile(env, thiz, "pbrshader/animation.glsl");
-  auto brdf = readGLSLFile(env, thiz, "pbrshader/brdf.glsl");
-  auto cubemap = readGLSLFile(env, thiz, "pbrshader/cubemap.frag");
-  auto cubemap_vert = readGLSLFile(env, thiz, "pbrshader/cubemap.vert");
-
-  auto functions = readGLSLFile(env, thiz, "pbrshader/functions.glsl");
-  auto ibl = readGLSLFile(env, thiz, "pbrshader/ibl.glsl");
-  auto iridescence = readGLSLFile(env, thiz, "pbrshader/iridescence.glsl");
-
-  auto material_info = readGLSLFile(env, thiz, "pbrshader/material_info.glsl");
-  auto pbr = readGLSLFile(env, thiz, "pbrshader/pbr.frag");
-  auto primitive = readGLSLFile(env, thiz, "pbrshader/primitive.vert");
-  auto punctual = readGLSLFile(env, thiz, "pbrshader/punctual.glsl");
-  auto specular_glossiness =
-      readGLSLFile(env, thiz, "pbrshader/specular_glossiness.frag");
-  auto textures = readGLSLFile(env, thiz, "pbrshader/textures.glsl");
-  auto tonemapping = readGLSLFile(env, thiz, "pbrshader/tonemapping.glsl");
-  auto fullscreen = readGLSLFile(env, thiz, "iblshader/fullscreen.vert");
-  auto panorama_to_cubemap =
-      readGLSLFile(env, thiz, "iblshader/panorama_to_cubemap.frag");
-  auto ibl_filtering = readGLSLFile(env, thiz, "iblshader/ibl_filtering.frag");
-  auto debug = readGLSLFile(env, thiz, "iblshader/debug.frag");
-  GLSLStringFiles glslStringShaders;
-  glslStringShaders.animation = animation;
-  glslStringShaders.brdf = brdf;
-  glslStringShaders.cubemap = cubemap;
-  glslStringShaders.cubemap_vert = cubemap_vert;
-  glslStringShaders.functions = functions;
-  glslStringShaders.ibl = ibl;
-  glslStringShaders.iridescence = iridescence;
-  glslStringShaders.material_info = material_info;
-  glslStringShaders.pbr = pbr;
-  glslStringShaders.primitive = primitive;
-  glslStringShaders.punctual = punctual;
-  glslStringShaders.specular_glossiness = specular_glossiness;
-  glslStringShaders.textures = textures;
-  glslStringShaders.tonemapping = tonemapping;
-  glslStringShaders.fullscreen = fullscreen;
-  glslStringShaders.panorama_to_cubemap = panorama_to_cubemap;
-  glslStringShaders.ibl_filtering = ibl_filtering;
-  glslStringShaders.debug = debug;
-  ShaderManager::getInstance().setShaderFiles(glslStringShaders);
-}
-
-
-std::string readGLSLFile(JNIEnv *env, jobject context, const char *filename) {
+AAssetManager *getAssetManager(JNIEnv *env, jobject context) {
   jclass contextClass = env->GetObjectClass(context);
   jmethodID getAssetsMethod = env->GetMethodID(contextClass,
                                                "getAssets",
                                                "()Landroid/content/res/AssetManager;");
   jobject assetManagerObj = env->CallObjectMethod(context, getAssetsMethod);
-  AAssetManager *assetManager = AAssetManager_fromJava(env, assetManagerObj);
-  AAsset
-      *asset = AAssetManager_open(assetManager, filename, AASSET_MODE_UNKNOWN);
-  if (!asset) return "";
-  size_t size = AAsset_getLength(asset);
-  std::string content(size, '\0');
-  AAsset_read(asset, &content[0], size);
-  AAsset_close(asset);
-  return content;
+  return AAssetManager_fromJava(env, assetManagerObj);
 }
 
 Engine *getEngine(jlong enginePtr) {
@@ -121,6 +76,16 @@ Engine *getEngine(jlong enginePtr) {
   return reinterpret_cast<Engine *>(enginePtr);
 }
 
+std::string toString(JNIEnv *env, jstring value) {
+  if (!value) {
+    return {};
+  }
+  const char *chars = env->GetStringUTFChars(value, nullptr);
+  std::string result = chars ? chars : "";
+  env->ReleaseStringUTFChars(value, chars);
+  return result;
+}
+
 
 UserCamera *getCamera(jlong userCameraPtr) {
   auto camera = getCameraShared(userCameraPtr);
@@ -157,6 +122,36 @@ Java_com_example_lightdigitalhuman_render_Engine_nativeDestroy(JNIEnv *env,
   }
 }
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_nativeSetCookedCacheDir(JNIEnv *env,
+                                                                         jobject thiz,
+                                                                         jstring dir) {
+  const char *dirStr = env->GetStringUTFChars(dir, nullptr);
+  if (dirStr) {
+    digitalhumans::loader.setCookedCacheDir(dirStr);
+    env->ReleaseStringUTFChars(dir, dirStr);
+  }
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_nativeSetIblCacheDir(JNIEnv *env,
+                                                                      jobject thiz,
+                                                                      jlong engine_ptr,
+                                                                      jstring dir) {
+  auto *mainEngine = digitalhumans::getEngine(engine_ptr);
+  if (!mainEngine) {
+    LOGE("Invalid engine pointer: %lld", static_cast<long long>(engine_ptr));
+    return;
+  }
+  const char *dirStr = env->GetStringUTFChars(dir, nullptr);
+  if (dirStr) {
+    mainEngine->setIblCacheDir(dirStr);
+    env->ReleaseStringUTFChars(dir, dirStr);
+  }
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_example_lightdigitalhuman_render_Engine_renderFrame(JNIEnv *env,
@@ -220,6 +215,60 @@ Java_com_example_lightdigitalhuman_render_Engine_loadModel(JNIEnv *env,
   env->ReleaseStringUTFChars(patch, filenameStr);
   return success ? JNI_TRUE : JNI_FALSE;
 }
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_loadModelAsync(JNIEnv *env,
+                                                                jobject thiz,
+                                                                jlong engine_ptr,
+                                                                jobject asset_manager,
+                                                                jstring patch) {
+  AAssetManager *assetManager = AAssetManager_fromJava(env, asset_manager);
+  if (!assetManager) {
+    LOGE("Failed to get native AssetManager from Java object");
+    return JNI_FALSE;
+  }
+
+  auto *engine = digitalhumans::getEngine(engine_ptr);
+  if (!engine) {
+    LOGE("Invalid engine pointer: %lld", static_cast<long long>(engine_ptr));
+    return JNI_FALSE;
+  }
+
+  const char *filenameStr = env->GetStringUTFChars(patch, nullptr);
+  if (!filenameStr) {
+    LOGE("Failed to get filename string");
+    return JNI_FALSE;
+  }
+
+  bool success = false;
+  try {
+    LOGI("Loading GLTF file asynchronously: %s", filenameStr);
+    auto provider =
+        std::make_shared<digitalhumans::AndroidAssetProvider>(assetManager);
+    success = digitalhumans::loader.loadGltfFromProviderAsync(provider,
+                                                              filenameStr,
+                                                              *engine)
+        != nullptr;
+  } catch (const std::exception &e) {
+    LOGE("Exception during model loading: %s", e.what());
+    success = false;
+  }
+  env->ReleaseStringUTFChars(patch, filenameStr);
+  return success ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT jfloat JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_nativeGetLoadProgress(JNIEnv *env,
+                                                                       jobject thiz,
+                                                                       jlong engine_ptr) {
+  auto *engine = digitalhumans::getEngine(engine_ptr);
+  if (!engine) {
+    return -1.0f;
+  }
+  return engine->getLoadProgress();
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_example_lightdigitalhuman_render_Engine_initializeOpenGLResources(
@@ -646,6 +695,131 @@ Java_com_example_lightdigitalhuman_render_Engine_nativeStopAnimation(
   mainEngine->stopAnimation(env->GetStringUTFChars(animation_name, nullptr));
 }
 
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_nativeAddAnimationLayer(
+    JNIEnv *env,
+    jobject thiz,
+    jlong engine_ptr,
+    jstring layer,
+    jboolean additive,
+    jfloat weight) {
+  auto *mainEngine = digitalhumans::getEngine(engine_ptr);
+  if (!mainEngine) {
+    LOGE("Invalid engine pointer: %lld", static_cast<long long>(engine_ptr));
+    return -1;
+  }
+  return mainEngine->addAnimationLayer(digitalhumans::toString(env, layer),
+                                       additive == JNI_TRUE, weight);
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_nativeCrossFadeAnimation(
+    JNIEnv *env,
+    jobject thiz,
+    jlong engine_ptr,
+    jstring layer,
+    jstring animation_name,
+    jfloat fade_seconds,
+    jint loop_count,
+    jfloat weight) {
+  auto *mainEngine = digitalhumans::getEngine(engine_ptr);
+  if (!mainEngine) {
+    LOGE("Invalid engine pointer: %lld", static_cast<long long>(engine_ptr));
+    return JNI_FALSE;
+  }
+  return mainEngine->crossFadeAnimation(digitalhumans::toString(env, layer),
+                                        digitalhumans::toString(env, animation_name),
+                                        fade_seconds, loop_count, weight)
+         ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_nativeStopAnimationLayer(
+    JNIEnv *env,
+    jobject thiz,
+    jlong engine_ptr,
+    jstring layer,
+    jfloat fade_seconds) {
+  auto *mainEngine = digitalhumans::getEngine(engine_ptr);
+  if (!mainEngine) {
+    LOGE("Invalid engine pointer: %lld", static_cast<long long>(engine_ptr));
+    return JNI_FALSE;
+  }
+  return mainEngine->stopAnimationLayer(digitalhumans::toString(env, layer),
+                                        fade_seconds) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_nativeSetAnimationLayerWeight(
+    JNIEnv *env,
+    jobject thiz,
+    jlong engine_ptr,
+    jstring layer,
+    jfloat weight,
+    jfloat fade_seconds) {
+  auto *mainEngine = digitalhumans::getEngine(engine_ptr);
+  if (!mainEngine) {
+    LOGE("Invalid engine pointer: %lld", static_cast<long long>(engine_ptr));
+    return JNI_FALSE;
+  }
+  return mainEngine->setAnimationLayerWeight(digitalhumans::toString(env, layer),
+                                             weight, fade_seconds)
+         ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_nativeSetAnimationLayerMask(
+    JNIEnv *env,
+    jobject thiz,
+    jlong engine_ptr,
+    jstring layer,
+    jobjectArray root_nodes) {
+  auto *mainEngine = digitalhumans::getEngine(engine_ptr);
+  if (!mainEngine) {
+    LOGE("Invalid engine pointer: %lld", static_cast<long long>(engine_ptr));
+    return JNI_FALSE;
+  }
+  std::vector<std::string> roots;
+  const jsize count = root_nodes ? env->GetArrayLength(root_nodes) : 0;
+  for (jsize i = 0; i < count; ++i) {
+    auto name = static_cast<jstring>(env->GetObjectArrayElement(root_nodes, i));
+    roots.push_back(digitalhumans::toString(env, name));
+    env->DeleteLocalRef(name);
+  }
+  return mainEngine->setAnimationLayerMask(digitalhumans::toString(env, layer),
+                                           roots) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_nativeSetAnimationLod(
+    JNIEnv *env,
+    jobject thiz,
+    jlong engine_ptr,
+    jboolean enabled,
+    jfloat half_rate_size,
+    jfloat quarter_rate_size,
+    jfloat joint_chain_size,
+    jfloat morph_weight_size) {
+  auto *mainEngine = digitalhumans::getEngine(engine_ptr);
+  if (!mainEngine) {
+    LOGE("Invalid engine pointer: %lld", static_cast<long long>(engine_ptr));
+    return;
+  }
+  digitalhumans::GltfAnimationLodSettings settings;
+  settings.enabled = enabled == JNI_TRUE;
+  settings.halfRateSize = half_rate_size;
+  settings.quarterRateSize = quarter_rate_size;
+  settings.jointChainSize = joint_chain_size;
+  settings.morphWeightSize = morph_weight_size;
+  mainEngine->setAnimationLod(settings);
+}
+
 extern "C"
 JNIEXPORT jboolean JNICALL
 Java_com_example_lightdigitalhuman_render_Engine_loadEnvironmentFromAssets(
@@ -667,11 +841,9 @@ Java_com_example_lightdigitalhuman_render_Engine_loadEnvironmentFromAssets(
   const char *envPathStr = env->GetStringUTFChars(env_path, nullptr);
   std::string envPath(envPathStr);
   env->ReleaseStringUTFChars(env_path, envPathStr);
-//  mainEngine->getState()->getEnvironment()->setAssetManager(
-//      AAssetManager_fromJava(env, asset_manager));
-  bool success = false;
-//      mainEngine->getState()->getEnvironment()->loadEnvironmentFromAssets(
-//          envPath);
+  digitalhumans::AndroidAssetProvider
+      provider(AAssetManager_fromJava(env, asset_manager));
+  bool success = mainEngine->loadEnvironmentFromAssets(provider, envPath);
   return success ? JNI_TRUE : JNI_FALSE;
 }
 extern "C"
@@ -748,4 +920,34 @@ Java_com_example_lightdigitalhuman_render_Engine_loadFromFile(JNIEnv *env,
   }
   env->ReleaseStringUTFChars(file_path, filenameStr);
   return success ? JNI_TRUE : JNI_FALSE;
-}
\ No newline at end of file
+}
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_example_lightdigitalhuman_render_Engine_loadFromFileAsync(JNIEnv *env,
+                                                                   jobject thiz,
+                                                                   jlong native_engine_ptr,
+                                                                   jstring file_path) {
+  auto *engine = digitalhumans::getEngine(native_engine_ptr);
+  if (!engine) {
+    LOGE("Invalid engine pointer: %lld",
+         static_cast<long long>(native_engine_ptr));
+    return JNI_FALSE;
+  }
+
+  const char *filenameStr = env->GetStringUTFChars(file_path, nullptr);
+  if (!filenameStr) {
+    LOGE("Failed to get filename string");
+    return JNI_FALSE;
+  }
+
+  bool success = false;
+  try {
+    success =
+        digitalhumans::loader.loadFromFileAsync(filenameStr, *engine) != nullptr;
+  } catch (const std::exception &e) {
+    LOGE("Exception during model loading: %s", e.what());
+    success = false;
+  }
+  env->ReleaseStringUTFChars(file_path, filenameStr);
+  return success ? JNI_TRUE : JNI_FALSE;
+}
@@ -0,0 +1,1123 @@
+//
+// Created by vincentsyan on 2025/9/22.
+//
+// 主机端核心路径基准测试（Google Benchmark）:
+//   Load        tinygltf 解析 + 并行图像解码 + GltfConverter 转换（mapped:1 为GLB内存映射加载）
+//   LoadCached  转换资源缓存命中时的重复加载
+//   LoadCooked  映射烘焙文件加载（跳过解析、解码与去交错）
+//   Dequantize  全部访问器的类型化视图反量化
+//   VertexLayout 全部图元的交错压缩顶点布局生成（报告打包前后的字节数）
+//   MeshOptimize 全部三角形图元的 Tipsify 与过度绘制重排（报告前后的 ACMR）
+//   IndexSplit  合成网格（超出 16 位范围）的 32 位索引切分为 16 位图元（报告块数）
+//   BufferArena 缓冲区域中两个模型的顶点与索引分配、卸载其一后整理碎片（报告缓冲数）
+//   Animation   动画通道采样并写回节点 TRS
+//   AnimationLayers 动画层栈（底层、半权重覆盖层与叠加层）混合后一次写回节点
+//   LongClip    合成的长动作捕捉片段上的顺序循环播放与随机跳转（scrub:1）,
+//               clip:0 为逐通道插值器, clip:1 为未压缩的片段, clip:2 为压缩后的片段;
+//               报告每帧二分查找次数与片段压缩前后的字节数
+//   Hierarchy   场景层级世界矩阵更新
+//   Joints      蒙皮关节矩阵计算与纹理上传
+//   Stream*     合成的量化顶点流（KHR_mesh_quantization 布局）上的去交错、反量化与
+//               稀疏替换, simd:0 为逐元素的原实现, simd:1 为 ComponentConvert
+// 逐帧路径（Animation / Joints）额外报告每次迭代的堆分配次数 allocs_per_iter。
+//
+// 转换与蒙皮会调用 GL 接口, 因此在 surfaceless EGL 上下文中运行。
+// 用法: core_benchmark [--asset-dir=<assets目录>] [benchmark 参数...]
+//
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <GLES3/gl3.h>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../engine/Engine.h"
+#include "../gltfdata/Gltf.h"
+#include "../gltfdata/GltfAccessor.h"
+#include "../gltfdata/GltfAnimation.h"
+#include "../gltfdata/GltfBuffer.h"
+#include "../gltfdata/GltfBufferArena.h"
+#include "../gltfdata/GltfInterpolator.h"
+#include "../gltfdata/GltfMesh.h"
+#include "../gltfdata/GltfNode.h"
+#include "../gltfdata/GltfPrimitive.h"
+#include "../gltfdata/GltfScene.h"
+#include "../gltfdata/GltfSkin.h"
+#include "../gltfdata/GltfState.h"
+#include "../gltfdata/converter/GltfIndexPacker.h"
+#include "../gltfdata/converter/GltfLoadTask.h"
+#include "../gltfdata/converter/GltfLoader.h"
+#include "../gltfdata/converter/GltfMeshOptimizer.h"
+#include "../host/HeadlessEglContext.h"
+#include "../utils/ComponentConvert.h"
+#include "../utils/LogUtils.h"
+
+using namespace digitalhumans;
+
+namespace {
+std::atomic<size_t> gAllocationCount{0};
+
+/**
+ * @brief 计数并分配, 失败时返回 nullptr; 对齐分配与普通分配都可用 free 释放
+ */
+void *countedAlloc(size_t size, size_t alignment) noexcept {
+  gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+  size = size ? size : 1;
+  if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    return std::malloc(size);
+  }
+  // aligned_alloc 要求大小是对齐的整数倍
+  return std::aligned_alloc(alignment,
+                            (size + alignment - 1) / alignment * alignment);
+}
+
+void *countedAllocOrThrow(size_t size, size_t alignment) {
+  if (void *ptr = countedAlloc(size, alignment)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+} // namespace
+
+// 统计堆分配次数: 替换全部 new/delete 形式, 分配与释放始终成对
+void *operator new(size_t size) {
+  return countedAllocOrThrow(size, 0);
+}
+
+void *operator new[](size_t size) {
+  return countedAllocOrThrow(size, 0);
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+  return countedAllocOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+  return countedAllocOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return countedAlloc(size, 0);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return countedAlloc(size, 0);
+}
+
+void *operator new(size_t size, std::align_val_t alignment,
+                   const std::nothrow_t &) noexcept {
+  return countedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment,
+                     const std::nothrow_t &) noexcept {
+  return countedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+
+std::string gAssetDir = LIGHTDIGITALHUMAN_ASSET_DIR;
+bool gCheckFailed = false;  ///< 校验失败时冒烟测试以非零状态退出
+
+/**
+ * @brief 校验失败: 跳过该基准并记录, 与加载失败等环境问题区分
+ */
+void failCheck(benchmark::State &state, const char *message) {
+  gCheckFailed = true;
+  state.SkipWithError(message);
+}
+
+// 基准模型: 静态 PBR / 蒙皮动画 / 变形目标 / 变形目标（EXT_meshopt_compression）
+const std::vector<std::string> kModels = {
+    "testmodel/DamagedHelmet/DamagedHelmet.glb",
+    "testmodel/BrainStem/BrainStem.gltf",
+    "testmodel/glb/MorphPrimitivesTest.glb",
+    "testmodel/glb/MorphPrimitivesTest_meshopt.glb",
+};
+
+constexpr float kAnimationStep = 1.0f / 60.0f;
+
+// 合成的长动作捕捉片段: 30 fps 五分钟, 每个关节一条旋转与一条平移通道
+constexpr size_t kLongClipKeys = 9000;
+constexpr size_t kLongClipJoints = 64;
+constexpr float kLongClipFps = 30.0f;
+
+/**
+ * @brief 量化顶点流中的属性, 交错布局:
+ *   position SHORT x3（补齐到 8 字节）| normal BYTE x3 标准化（补齐到 4 字节）|
+ *   uv UNSIGNED_SHORT x2 标准化
+ */
+struct StreamAttribute {
+  size_t offset;
+  int componentType;
+  size_t componentCount;
+  size_t componentSize;
+  bool normalized;
+
+  size_t elementSize() const { return componentCount * componentSize; }
+};
+
+const std::map<std::string, StreamAttribute> kStreamAttributes = {
+    {"position", {0, GL_SHORT, 3, 2, false}},
+    {"normal", {8, GL_BYTE, 3, 1, true}},
+    {"uv", {12, GL_UNSIGNED_SHORT, 2, 2, true}},
+};
+constexpr size_t kStreamVertexCount = 1 << 20;
+constexpr size_t kStreamStride = 16;
+constexpr size_t kStreamSparseInterval = 16;  ///< 每 16 个顶点替换一个
+
+/**
+ * @brief 伪随机填充的交错顶点流
+ */
+const std::vector<uint8_t> &quantizedStream() {
+  static const std::vector<uint8_t> stream = [] {
+    std::vector<uint8_t> data(kStreamVertexCount * kStreamStride);
+    uint32_t state = 0x12345678u;
+    for (auto &byte: data) {
+      state = state * 1664525u + 1013904223u;
+      byte = static_cast<uint8_t>(state >> 24);
+    }
+    return data;
+  }();
+  return stream;
+}
+
+std::string modelPath(const std::string &model) {
+  return gAssetDir + "/" + model;
+}
+
+/**
+ * @brief 已加载模型缓存, 避免每个基准重复转换
+ */
+std::shared_ptr<Engine> loadedEngine(const std::string &model) {
+  static std::map<std::string, std::shared_ptr<Engine>> engines;
+  auto it = engines.find(model);
+  if (it != engines.end()) {
+    return it->second;
+  }
+  auto engine = std::make_shared<Engine>();
+  GltfLoader loader;
+  if (!loader.loadFromFile(modelPath(model), *engine) ||
+      !engine->state->getGltf()) {
+    engine = nullptr;
+  }
+  engines[model] = engine;
+  return engine;
+}
+
+void BM_Load(benchmark::State &state, const std::string &model) {
+  const bool mapped = state.range(0) != 0;
+  size_t heapBufferBytes = 0;
+  for (auto _: state) {
+    Engine engine;
+    GltfLoader loader;
+    loader.setUseMappedGlb(mapped);
+    if (!loader.loadFromFile(modelPath(model), engine)) {
+      state.SkipWithError("load failed");
+      break;
+    }
+    auto gltf = engine.state->getGltf();
+    benchmark::DoNotOptimize(gltf);
+    heapBufferBytes = 0;
+    for (const auto &buffer: gltf->getBuffers()) {
+      if (!buffer->isExternal()) {
+        heapBufferBytes += buffer->getActualSize();
+      }
+    }
+  }
+  // 转换后仍驻留在堆上的 buffer 数据量, 映射加载时 BIN 块不计入
+  state.counters["heap_buffer_bytes"] =
+      static_cast<double>(heapBufferBytes);
+}
+
+void BM_Residency(benchmark::State &state, const std::string &model) {
+  GltfResidencyStats stats;
+  size_t heapBufferBytes = 0;
+  for (auto _: state) {
+    Engine engine;
+    GltfLoader loader;
+    // 资源缓存会共享 buffer, 关闭后才能观察到 buffer 的释放
+    loader.setCacheBudget(0);
+    auto task = loader.loadFromFileAsync(modelPath(model), engine);
+    while (task && !task->isFinished()) {
+      task->update(engine.context, 1000.0);
+    }
+    auto gltf = task ? task->getGltf() : nullptr;
+    if (!gltf) {
+      state.SkipWithError("load failed");
+      break;
+    }
+    stats = gltf->getResidencyStats();
+    heapBufferBytes = 0;
+    for (const auto &buffer: gltf->getBuffers()) {
+      if (buffer && !buffer->isExternal()) {
+        heapBufferBytes += buffer->getActualSize();
+      }
+    }
+  }
+  glFinish();
+  state.counters["runtime_kept_bytes"] =
+      static_cast<double>(stats.runtimeKeptBytes);
+  state.counters["runtime_freed_bytes"] =
+      static_cast<double>(stats.runtimeFreedBytes);
+  state.counters["upload_freed_bytes"] =
+      static_cast<double>(stats.uploadOnlyFreedBytes);
+  state.counters["buffer_freed_bytes"] =
+      static_cast<double>(stats.bufferFreedBytes);
+  // 上传完成后仍驻留在堆上的 buffer 数据量
+  state.counters["heap_buffer_bytes"] = static_cast<double>(heapBufferBytes);
+  state.counters["pending_primitives"] =
+      static_cast<double>(stats.pendingPrimitives);
+}
+
+void BM_LoadCached(benchmark::State &state, const std::string &model) {
+  GltfLoader loader;
+  Engine warmup;
+  if (!loader.loadFromFile(modelPath(model), warmup)) {
+    state.SkipWithError("load failed");
+    return;
+  }
+  for (auto _: state) {
+    Engine engine;
+    if (!loader.loadFromFile(modelPath(model), engine)) {
+      state.SkipWithError("load failed");
+      break;
+    }
+    benchmark::DoNotOptimize(engine.state->getGltf());
+  }
+  state.counters["cache_bytes"] =
+      static_cast<double>(loader.getAssetCache().getUsedBytes());
+}
+
+/**
+ * @brief 同一路径交替替换为两个模型, 缓存不能返回替换前的转换结果
+ */
+void BM_LoadReplaced(benchmark::State &state) {
+  const std::string sources[] = {modelPath(kModels[0]), modelPath(kModels[2])};
+  size_t expectedAccessors[2] = {};
+  for (size_t i = 0; i < 2; ++i) {
+    GltfLoader loader;
+    Engine engine;
+    if (!loader.loadFromFile(sources[i], engine)) {
+      state.SkipWithError("load failed");
+      return;
+    }
+    expectedAccessors[i] = engine.state->getGltf()->accessors.size();
+  }
+  const auto path = std::filesystem::temp_directory_path() /
+      "lightdigitalhuman_replaced.glb";
+  GltfLoader loader;
+  size_t loads = 0;
+  for (auto _: state) {
+    const size_t current = loads++ % 2;
+    state.PauseTiming();
+    std::error_code error;
+    std::filesystem::copy_file(
+        sources[current], path,
+        std::filesystem::copy_options::overwrite_existing, error);
+    state.ResumeTiming();
+    Engine engine;
+    if (error || !loader.loadFromFile(path.string(), engine)) {
+      state.SkipWithError("load failed");
+      break;
+    }
+    if (engine.state->getGltf()->accessors.size() != expectedAccessors[current]) {
+      failCheck(state, "cache returned the replaced model");
+      break;
+    }
+  }
+  std::error_code error;
+  std::filesystem::remove(path, error);
+}
+
+void BM_LoadCooked(benchmark::State &state, const std::string &model) {
+  const auto cookedDir = std::filesystem::temp_directory_path() /
+      "lightdigitalhuman_cooked_bench";
+  {
+    // 首次加载生成烘焙文件
+    GltfLoader loader;
+    loader.setCookedCacheDir(cookedDir.string());
+    Engine warmup;
+    if (!loader.loadFromFile(modelPath(model), warmup)) {
+      state.SkipWithError("load failed");
+      return;
+    }
+  }
+  for (auto _: state) {
+    Engine engine;
+    GltfLoader loader;
+    loader.setCookedCacheDir(cookedDir.string());
+    loader.setCacheBudget(0);
+    if (!loader.loadFromFile(modelPath(model), engine)) {
+      state.SkipWithError("load failed");
+      break;
+    }
+    benchmark::DoNotOptimize(engine.state->getGltf());
+  }
+}
+
+void BM_Dequantize(benchmark::State &state, const std::string &model) {
+  auto engine = loadedEngine(model);
+  if (!engine) {
+    state.SkipWithError("load failed");
+    return;
+  }
+  auto gltf = engine->state->getGltf();
+  size_t bytes = 0;
+  for (auto _: state) {
+    bytes = 0;
+    for (const auto &accessor: gltf->getAccessors()) {
+      auto [data, size] = accessor->getTypedView(*gltf);
+      std::vector<float> values = GltfAccessor::dequantize(
+          data, size, accessor->getComponentType().value_or(0));
+      benchmark::DoNotOptimize(values.data());
+      bytes += size;
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+void BM_VertexLayout(benchmark::State &state, const std::string &model) {
+  auto engine = loadedEngine(model);
+  if (!engine) {
+    state.SkipWithError("load failed");
+    return;
+  }
+  auto gltf = engine->state->getGltf();
+  size_t sourceBytes = 0;
+  size_t packedBytes = 0;
+  for (auto _: state) {
+    sourceBytes = 0;
+    packedBytes = 0;
+    for (const auto &mesh: gltf->getMeshes()) {
+      for (const auto &primitive: mesh->getPrimitives()) {
+        if (primitive->shouldSkip()) {
+          continue;
+        }
+        auto layout = GltfVertexLayout::build(*gltf, primitive->getAttributes());
+        if (layout) {
+          sourceBytes += layout->getSourceBytes();
+          packedBytes += layout->getPackedBytes();
+        }
+        benchmark::DoNotOptimize(layout);
+      }
+    }
+  }
+  state.counters["source_bytes"] = static_cast<double>(sourceBytes);
+  state.counters["packed_bytes"] = static_cast<double>(packedBytes);
+}
+
+void BM_MeshOptimize(benchmark::State &state, const std::string &model) {
+  auto engine = loadedEngine(model);
+  if (!engine) {
+    state.SkipWithError("load failed");
+    return;
+  }
+  auto gltf = engine->state->getGltf();
+  const auto &accessors = gltf->getAccessors();
+
+  // 每个索引三角形图元的原始索引与位置
+  struct Input {
+    std::vector<uint32_t> indices;
+    std::vector<float> positions;
+  };
+  std::vector<Input> inputs;
+  for (const auto &mesh: gltf->getMeshes()) {
+    for (const auto &primitive: mesh->getPrimitives()) {
+      const auto &attributes = primitive->getAttributes();
+      auto position = attributes.find("POSITION");
+      if (primitive->shouldSkip() || primitive->getMode() != GL_TRIANGLES ||
+          !primitive->getIndices().has_value() ||
+          position == attributes.end()) {
+        continue;
+      }
+      Input input;
+      input.indices = primitive->getIndicesAsUint32(
+          accessors[primitive->getIndices().value()], *gltf);
+      auto positions =
+          accessors[position->second]->getNormalizedDeinterlacedSpan(*gltf);
+      input.positions.assign(positions.begin(), positions.end());
+      inputs.push_back(std::move(input));
+    }
+  }
+
+  GltfMeshOptimizerStats stats;
+  for (auto _: state) {
+    stats = GltfMeshOptimizerStats();
+    for (const auto &input: inputs) {
+      const size_t vertexCount = input.positions.size() / 3;
+      std::vector<uint32_t> clusters;
+      auto indices = GltfMeshOptimizer::optimizeVertexCache(
+          input.indices.data(), input.indices.size(), vertexCount, &clusters);
+      GltfMeshOptimizer::optimizeOverdraw(indices, input.positions.data(),
+                                          vertexCount, clusters);
+      benchmark::DoNotOptimize(indices.data());
+      stats.triangles += input.indices.size() / 3;
+      stats.missesBefore += GltfMeshOptimizer::simulateCache(
+          input.indices.data(), input.indices.size(), vertexCount);
+      stats.missesAfter += GltfMeshOptimizer::simulateCache(
+          indices.data(), indices.size(), vertexCount);
+    }
+  }
+  state.counters["acmr_before"] = stats.acmrBefore();
+  state.counters["acmr_after"] = stats.acmrAfter();
+}
+
+void BM_IndexSplit(benchmark::State &state) {
+  // 行优先的规则网格, 顶点数超出 16 位索引范围
+  const auto side = static_cast<uint32_t>(state.range(0));
+  const size_t vertexCount = static_cast<size_t>(side + 1) * (side + 1);
+  std::vector<uint32_t> indices;
+  indices.reserve(static_cast<size_t>(side) * side * 6);
+  for (uint32_t y = 0; y < side; ++y) {
+    for (uint32_t x = 0; x < side; ++x) {
+      const uint32_t v = y * (side + 1) + x;
+      indices.insert(indices.end(),
+                     {v, v + side + 1, v + 1, v + 1, v + side + 1, v + side + 2});
+    }
+  }
+  size_t chunkCount = 0;
+  for (auto _: state) {
+    auto chunks = GltfIndexPacker::split(indices, vertexCount);
+    chunkCount = chunks.size();
+    benchmark::DoNotOptimize(chunks.data());
+  }
+  state.counters["vertices"] = static_cast<double>(vertexCount);
+  state.counters["chunks"] = static_cast<double>(chunkCount);
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * indices.size() / 3));
+}
+
+void BM_BufferArena(benchmark::State &state) {
+  // 两个交替加载的模型, 各含大小不一的访问器, 卸载第一个后整理碎片
+  const auto count = static_cast<size_t>(state.range(0));
+  std::vector<uint8_t> data(256 << 10, 0x5a);
+  std::vector<size_t> sizes(count);
+  for (size_t i = 0; i < count; ++i) {
+    sizes[i] = 64 + (i * 7919) % data.size();
+  }
+  GltfBufferArenaStats loaded;
+  GltfBufferArenaStats compacted;
+  for (auto _: state) {
+    GltfBufferArena arena;
+    std::vector<std::unique_ptr<GltfBufferAllocation>> first;
+    std::vector<std::unique_ptr<GltfBufferAllocation>> second;
+    for (size_t i = 0; i < count; ++i) {
+      const GLenum target = i % 4 == 0 ? GL_ELEMENT_ARRAY_BUFFER
+                                       : GL_ARRAY_BUFFER;
+      first.push_back(arena.allocate(target, data.data(), sizes[i]));
+      second.push_back(arena.allocate(target, data.data(), sizes[i]));
+    }
+    loaded = arena.getStats();
+    first.clear();
+    arena.compact();
+    compacted = arena.getStats();
+    second.clear();
+    arena.compact();
+  }
+  glFinish();
+  state.counters["allocations"] = static_cast<double>(loaded.allocations);
+  state.counters["buffers_loaded"] = static_cast<double>(loaded.blocks);
+  state.counters["buffers_compacted"] = static_cast<double>(compacted.blocks);
+}
+
+/**
+ * @brief compact 中途无法创建新缓冲时, 已移走的区间应归还给旧缓冲
+ * @return 存活分配与缓冲的已用字节数一致时返回 true
+ */
+bool compactWithinLimit() {
+  constexpr size_t kMiB = 1 << 20;
+  std::vector<uint8_t> data(5 * kMiB, 0x5a);
+  GltfBufferArena arena;
+  // 缓冲 A: 2 + 2 MiB, 缓冲 B: 2 + 1.5 MiB, 缓冲 C: 5 MiB（新缓冲也按 5 MiB 创建）
+  auto a1 = arena.allocate(GL_ARRAY_BUFFER, data.data(), 2 * kMiB);
+  auto a2 = arena.allocate(GL_ARRAY_BUFFER, data.data(), 2 * kMiB);
+  auto b1 = arena.allocate(GL_ARRAY_BUFFER, data.data(), 2 * kMiB);
+  auto b2 = arena.allocate(GL_ARRAY_BUFFER, data.data(), 3 * kMiB / 2);
+  auto c1 = arena.allocate(GL_ARRAY_BUFFER, data.data(), 5 * kMiB);
+  if (!a1 || !a2 || !b1 || !b2 || !c1) {
+    return false;
+  }
+  a2.reset();
+  // 只够创建一个新缓冲: A 移入后删除, B 移走 b1 后创建第二个新缓冲失败
+  arena.setMaxBytes(18 * kMiB);
+  arena.compact(0.1f);
+  const auto stats = arena.getStats();
+  const size_t liveBytes = 2 * kMiB + 2 * kMiB + 3 * kMiB / 2 + 5 * kMiB;
+  if (stats.allocations != 4 || stats.usedBytes != liveBytes) {
+    LOGE("Arena after failed compaction: %zu allocations, %zu used bytes",
+         stats.allocations, stats.usedBytes);
+    return false;
+  }
+  // 归还的区间可以再次分配
+  auto b3 = arena.allocate(GL_ARRAY_BUFFER, data.data(), 2 * kMiB);
+  return b3 != nullptr && arena.getStats().blocks == 3;
+}
+
+void BM_BufferArenaCompactLimit(benchmark::State &state) {
+  for (auto _: state) {
+    if (!compactWithinLimit()) {
+      failCheck(state, "compaction failure leaked arena ranges");
+      return;
+    }
+  }
+  glFinish();
+}
+
+void BM_Animation(benchmark::State &state, const std::string &model) {
+  auto engine = loadedEngine(model);
+  if (!engine || engine->state->getGltf()->getAnimations().empty()) {
+    state.SkipWithError("no animations");
+    return;
+  }
+  const auto &animations = engine->state->getGltf()->getAnimations();
+  size_t tracks = 0;
+  for (const auto &animation: animations) {
+    if (animation->getClip()) {
+      tracks += animation->getClip()->getTracks().size();
+    }
+  }
+  float time = 0.0f;
+  size_t allocations = 0;
+  for (auto _: state) {
+    const size_t before = gAllocationCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < animations.size(); ++i) {
+      animations[i]->advance(engine->state, time, -1, static_cast<int>(i));
+    }
+    allocations += gAllocationCount.load(std::memory_order_relaxed) - before;
+    time += kAnimationStep;
+  }
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * animations.size()));
+  state.counters["allocs_per_iter"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+  state.counters["tracks"] = static_cast<double>(tracks);
+}
+
+void BM_AnimationLayers(benchmark::State &state, const std::string &model) {
+  auto engine = loadedEngine(model);
+  if (!engine || engine->state->getGltf()->getAnimations().empty()) {
+    state.SkipWithError("no animations");
+    return;
+  }
+  // 底层 + 半权重覆盖层 + 叠加层, 三个片段实例在一次求值中混合
+  auto gltf = engine->state->getGltf();
+  const int last = static_cast<int>(gltf->getAnimations().size() - 1);
+  auto &mixer = engine->state->getAnimationMixer();
+  const int base = mixer.addLayer("base");
+  const int overlay = mixer.addLayer("overlay", AnimationBlendMode::OVERRIDE, 0.5f);
+  const int additive = mixer.addLayer("additive", AnimationBlendMode::ADDITIVE);
+  if (!mixer.play(*gltf, base, 0) || !mixer.play(*gltf, overlay, last) ||
+      !mixer.play(*gltf, additive, 0)) {
+    state.SkipWithError("animation not compiled");
+    return;
+  }
+  auto &pose = engine->state->getAnimationPose();
+  float time = 0.0f;
+  size_t allocations = 0;
+  for (auto _: state) {
+    const size_t before = gAllocationCount.load(std::memory_order_relaxed);
+    mixer.evaluate(*gltf, pose, time);
+    allocations += gAllocationCount.load(std::memory_order_relaxed) - before;
+    time += kAnimationStep;
+  }
+  const auto &stats = mixer.getStats();
+  state.counters["allocs_per_iter"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+  state.counters["instances"] = static_cast<double>(stats.instances);
+  state.counters["tracks"] = static_cast<double>(stats.sampledTracks);
+  state.counters["nodes"] = static_cast<double>(stats.writtenNodes);
+}
+
+/**
+ * @brief 按 Engine::animate 的顺序推进全部动画, 模型尺寸（视口高度的百分比）由参数给出
+ */
+void BM_AnimationLod(benchmark::State &state, const std::string &model) {
+  auto engine = loadedEngine(model);
+  if (!engine || engine->state->getGltf()->getAnimations().empty()) {
+    state.SkipWithError("no animations");
+    return;
+  }
+  auto gltf = engine->state->getGltf();
+  const auto &scenes = gltf->getScenes();
+  const int sceneIndex = engine->state->getSceneIndex();
+  if (sceneIndex < 0 || sceneIndex >= static_cast<int>(scenes.size()) ||
+      !scenes[sceneIndex]) {
+    state.SkipWithError("no scene");
+    return;
+  }
+  scenes[sceneIndex]->applyTransformHierarchy(gltf);
+  auto &lod = engine->state->getAnimationLod();
+  lod.bind(*gltf);
+  lod.measure(gltf, sceneIndex);
+  auto &pose = engine->state->getAnimationPose();
+  const auto &animations = gltf->getAnimations();
+  // 每帧应计入的通道数: 片段轨道与未编译通道, 没有片段的动画按通道计
+  size_t frameChannels = 0;
+  for (const auto &animation: animations) {
+    const auto &clip = animation->getClip();
+    frameChannels += clip
+        ? clip->getTracks().size() + clip->getUncompiledChannels().size()
+        : animation->getChannelCount();
+  }
+  const float screenSize = static_cast<float>(state.range(0)) / 100.0f;
+  float time = 0.0f;
+  size_t allocations = 0;
+  for (auto _: state) {
+    const size_t before = gAllocationCount.load(std::memory_order_relaxed);
+    if (lod.beginFrame(*gltf, pose, screenSize, time)) {
+      for (size_t i = 0; i < animations.size(); ++i) {
+        animations[i]->advance(engine->state, time, -1, static_cast<int>(i));
+      }
+      lod.endFrame(*gltf, pose, time);
+    }
+    allocations += gAllocationCount.load(std::memory_order_relaxed) - before;
+    time += kAnimationStep;
+  }
+  const auto &stats = lod.getStats();
+  const size_t channels = stats.evaluatedChannels + stats.skippedChannels;
+  // 采样帧与插值帧都要计入全部通道, 否则 evaluated_ratio 没有意义
+  const size_t frames = stats.evaluatedFrames + stats.interpolatedFrames;
+  if (channels != frames * frameChannels) {
+    failCheck(state, "channel counts do not match the clip tracks");
+    return;
+  }
+  state.counters["allocs_per_iter"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+  state.counters["interval"] = static_cast<double>(stats.updateInterval);
+  state.counters["evaluated_ratio"] = channels > 0
+      ? static_cast<double>(stats.evaluatedChannels) / static_cast<double>(channels)
+      : 1.0;
+  state.counters["skipped_nodes"] = static_cast<double>(stats.skippedNodes);
+}
+
+std::shared_ptr<GltfAccessor> floatAccessor(const std::vector<float> &values,
+                                            int componentCount,
+                                            const std::string &type) {
+  auto accessor = std::make_shared<GltfAccessor>();
+  accessor->setComponentType(GL_FLOAT);
+  accessor->setType(type);
+  accessor->setCount(static_cast<int>(values.size() / componentCount));
+  std::vector<uint8_t> bytes(values.size() * sizeof(float));
+  std::memcpy(bytes.data(), values.data(), bytes.size());
+  accessor->setDecodedData(std::move(bytes));
+  return accessor;
+}
+
+/**
+ * @brief 全部通道共用一个时间访问器的长片段
+ */
+std::shared_ptr<Gltf> longClipModel(const GltfAnimationCompression &compression) {
+  auto gltf = std::make_shared<Gltf>();
+  std::vector<float> times(kLongClipKeys);
+  for (size_t k = 0; k < kLongClipKeys; ++k) {
+    times[k] = static_cast<float>(k) / kLongClipFps;
+  }
+  gltf->accessors.push_back(floatAccessor(times, 1, "SCALAR"));
+
+  auto animation = std::make_shared<GltfAnimation>();
+  for (size_t j = 0; j < kLongClipJoints; ++j) {
+    gltf->addNode(std::make_shared<GltfNode>());
+    std::vector<float> rotations(kLongClipKeys * 4);
+    std::vector<float> translations(kLongClipKeys * 3);
+    for (size_t k = 0; k < kLongClipKeys; ++k) {
+      const float angle = std::sin(static_cast<float>(k) * 0.05f + j);
+      rotations[k * 4] = std::sin(angle * 0.5f);
+      rotations[k * 4 + 3] = std::cos(angle * 0.5f);
+      translations[k * 3 + 1] = angle;
+    }
+    const std::pair<InterpolationPath, std::shared_ptr<GltfAccessor>> outputs[] = {
+        {InterpolationPath::ROTATION, floatAccessor(rotations, 4, "VEC4")},
+        {InterpolationPath::TRANSLATION, floatAccessor(translations, 3, "VEC3")},
+    };
+    for (const auto &[path, output]: outputs) {
+      gltf->accessors.push_back(output);
+      auto sampler = std::make_shared<GltfAnimationSampler>();
+      sampler->setInput(0);
+      sampler->setOutput(static_cast<int>(gltf->accessors.size() - 1));
+      sampler->setInterpolation(InterpolationMode::LINEAR);
+      animation->addSampler(sampler);
+      auto target = std::make_shared<GltfAnimationTarget>();
+      target->setNode(static_cast<int>(j));
+      target->setPath(path);
+      auto channel = std::make_shared<GltfAnimationChannel>();
+      channel->setSampler(static_cast<int>(animation->getSamplerCount() - 1));
+      channel->setTarget(target);
+      animation->addChannel(channel);
+    }
+  }
+  animation->initGl(gltf, nullptr, compression);
+  gltf->animations.push_back(animation);
+  return gltf;
+}
+
+void BM_LongClip(benchmark::State &state) {
+  // scrub:0 为 60 Hz 顺序循环播放, scrub:1 为每帧随机跳转;
+  // clip:0 为逐通道的 GltfInterpolator, clip:1 为未压缩的片段, clip:2 为压缩后的片段
+  const bool scrub = state.range(0) != 0;
+  const bool compiled = state.range(1) != 0;
+  GltfAnimationCompression compression;
+  compression.enabled = state.range(1) == 2;
+  auto gltf = longClipModel(compression);
+  const auto &animation = gltf->getAnimations()[0];
+  const auto clip = animation->getClip();
+  const float duration = animation->getMaxTime();
+  if (!clip || duration <= 0.0f) {
+    state.SkipWithError("clip not compiled");
+    return;
+  }
+
+  GltfAnimationPose pose;
+  pose.reset(*gltf);
+  std::vector<GltfKeyframeCursor> cursors(clip->getCursorCount());
+  // 与 GltfAnimation 相同, 共用时间访问器的通道共用游标
+  const auto sharedCursor = std::make_shared<GltfKeyframeCursor>();
+  std::vector<GltfInterpolator> interpolators(animation->getChannelCount());
+  for (auto &interpolator: interpolators) {
+    interpolator.setCursor(sharedCursor);
+  }
+
+  uint32_t seed = 1;
+  float time = 0.0f;
+  for (auto _: state) {
+    if (scrub) {
+      seed = seed * 1664525u + 1013904223u;
+      time = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * duration;
+    } else {
+      time = std::fmod(time + kAnimationStep, duration);
+    }
+    if (compiled) {
+      clip->sample(time, pose, cursors.data());
+      pose.apply(*gltf);
+    } else {
+      for (size_t i = 0; i < interpolators.size(); ++i) {
+        const auto &channel = animation->getChannel(i);
+        const auto stride =
+            channel->getTargetPath() == InterpolationPath::ROTATION ? 4 : 3;
+        auto result = interpolators[i].interpolate(
+            gltf, channel, animation->getSampler(channel->getSampler().value()),
+            time, stride, duration);
+        benchmark::DoNotOptimize(result.data());
+      }
+    }
+  }
+  size_t searches = compiled ? 0 : sharedCursor->getSearchCount();
+  for (const auto &cursor: cursors) {
+    searches += cursor.getSearchCount();
+  }
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * animation->getChannelCount()));
+  state.counters["keys"] = static_cast<double>(kLongClipKeys);
+  state.counters["kept_ratio"] = static_cast<double>(clip->getStats().keptKeys) /
+      static_cast<double>(clip->getStats().sourceKeys);
+  state.counters["source_bytes"] = static_cast<double>(clip->getStats().sourceBytes);
+  state.counters["bytes"] = static_cast<double>(clip->getByteSize());
+  state.counters["searches_per_iter"] = benchmark::Counter(
+      static_cast<double>(searches), benchmark::Counter::kAvgIterations);
+}
+
+void BM_Hierarchy(benchmark::State &state, const std::string &model) {
+  auto engine = loadedEngine(model);
+  if (!engine || engine->state->getGltf()->getScenes().empty()) {
+    state.SkipWithError("no scene");
+    return;
+  }
+  auto gltf = engine->state->getGltf();
+  auto scene = gltf->getScenes()[engine->state->getSceneIndex()];
+  for (auto _: state) {
+    scene->applyTransformHierarchy(gltf);
+  }
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * gltf->getNodes().size()));
+}
+
+void BM_Joints(benchmark::State &state, const std::string &model) {
+  auto engine = loadedEngine(model);
+  if (!engine || engine->state->getGltf()->getSkins().empty()) {
+    state.SkipWithError("no skins");
+    return;
+  }
+  auto gltf = engine->state->getGltf();
+  gltf->getScenes()[engine->state->getSceneIndex()]
+      ->applyTransformHierarchy(gltf);
+  size_t allocations = 0;
+  for (auto _: state) {
+    const size_t before = gAllocationCount.load(std::memory_order_relaxed);
+    for (const auto &skin: gltf->getSkins()) {
+      skin->computeJoints(gltf, engine->context);
+    }
+    allocations += gAllocationCount.load(std::memory_order_relaxed) - before;
+  }
+  state.counters["allocs_per_iter"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+void BM_StreamGather(benchmark::State &state, const std::string &name) {
+  const StreamAttribute &attribute = kStreamAttributes.at(name);
+  const uint8_t *src = quantizedStream().data() + attribute.offset;
+  const size_t elementSize = attribute.elementSize();
+  std::vector<uint8_t> dst(kStreamVertexCount * elementSize);
+  const bool simd = state.range(0) != 0;
+  for (auto _: state) {
+    if (simd) {
+      component::gatherElements(src, kStreamStride, elementSize, dst.data(),
+                                kStreamVertexCount);
+    } else {
+      for (size_t i = 0; i < kStreamVertexCount; ++i) {
+        std::memcpy(dst.data() + i * elementSize, src + i * kStreamStride,
+                    elementSize);
+      }
+    }
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(
+      state.iterations() * kStreamVertexCount * elementSize));
+}
+
+template<typename T>
+void dequantizeBaseline(const T *src, size_t count, const StreamAttribute &attribute,
+                        std::vector<float> &dst) {
+  // 原实现: 逐元素 push_back, 标准化时除以最大值
+  constexpr float kMax = static_cast<float>(std::numeric_limits<T>::max());
+  dst.clear();
+  dst.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    float value = static_cast<float>(src[i]);
+    if (attribute.normalized) {
+      value = std::max(value / kMax, -1.0f);
+    }
+    dst.push_back(value);
+  }
+}
+
+void BM_StreamDequantize(benchmark::State &state, const std::string &name) {
+  const StreamAttribute &attribute = kStreamAttributes.at(name);
+  const size_t count = kStreamVertexCount * attribute.componentCount;
+  std::vector<uint8_t> packed(kStreamVertexCount * attribute.elementSize());
+  component::gatherElements(quantizedStream().data() + attribute.offset,
+                            kStreamStride, attribute.elementSize(),
+                            packed.data(), kStreamVertexCount);
+  std::vector<float> dst(count);
+  const bool simd = state.range(0) != 0;
+  for (auto _: state) {
+    if (simd) {
+      component::toFloat(packed.data(), attribute.componentType,
+                         attribute.normalized, dst.data(), count);
+    } else if (attribute.componentType == GL_SHORT) {
+      dequantizeBaseline(reinterpret_cast<const int16_t *>(packed.data()),
+                         count, attribute, dst);
+    } else if (attribute.componentType == GL_BYTE) {
+      dequantizeBaseline(reinterpret_cast<const int8_t *>(packed.data()),
+                         count, attribute, dst);
+    } else {
+      dequantizeBaseline(reinterpret_cast<const uint16_t *>(packed.data()),
+                         count, attribute, dst);
+    }
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+void BM_StreamSparse(benchmark::State &state, const std::string &name) {
+  const StreamAttribute &attribute = kStreamAttributes.at(name);
+  const size_t elementSize = attribute.elementSize();
+  const size_t sparseCount = kStreamVertexCount / kStreamSparseInterval;
+  // 32 位索引与紧密排列的替换值
+  std::vector<uint32_t> sourceIndices(sparseCount);
+  for (size_t i = 0; i < sparseCount; ++i) {
+    sourceIndices[i] = static_cast<uint32_t>(i * kStreamSparseInterval);
+  }
+  const uint8_t *values = quantizedStream().data();
+  std::vector<uint8_t> view(kStreamVertexCount * elementSize);
+  std::vector<uint32_t> indices;
+  const bool simd = state.range(0) != 0;
+  for (auto _: state) {
+    if (simd) {
+      indices.resize(sparseCount);
+      component::widenIndices(sourceIndices.data(), GL_UNSIGNED_INT,
+                              indices.data(), sparseCount);
+      component::scatterElements(values, elementSize, indices.data(),
+                                 sparseCount, view.data(), elementSize,
+                                 kStreamVertexCount);
+    } else {
+      indices.clear();
+      indices.reserve(sparseCount);
+      for (size_t i = 0; i < sparseCount; ++i) {
+        indices.push_back(sourceIndices[i]);
+      }
+      for (size_t i = 0; i < sparseCount; ++i) {
+        std::memcpy(view.data() + indices[i] * elementSize,
+                    values + i * elementSize, elementSize);
+      }
+    }
+    benchmark::DoNotOptimize(view.data());
+  }
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * sparseCount));
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; ++i) {
+    const char *prefix = "--asset-dir=";
+    if (std::strncmp(argv[i], prefix, std::strlen(prefix)) == 0) {
+      gAssetDir = argv[i] + std::strlen(prefix);
+    }
+  }
+
+  HeadlessEglContext eglContext;
+  if (!eglContext.create(64, 64)) {
+    LOGE("Failed to create headless EGL context");
+    return 1;
+  }
+
+  for (const auto &model: kModels) {
+    benchmark::RegisterBenchmark(("Load/" + model).c_str(), BM_Load, model)
+        ->ArgName("mapped")
+        ->Arg(0)
+        ->Arg(1)
+        ->UseRealTime()  // 图像在线程池中解码, 主线程 CPU 时间不能反映加载耗时
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("Residency/" + model).c_str(),
+                                 BM_Residency, model)
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("LoadCached/" + model).c_str(),
+                                 BM_LoadCached, model)
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("LoadCooked/" + model).c_str(),
+                                 BM_LoadCooked, model)
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("Dequantize/" + model).c_str(),
+                                 BM_Dequantize, model)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("VertexLayout/" + model).c_str(),
+                                 BM_VertexLayout, model)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("MeshOptimize/" + model).c_str(),
+                                 BM_MeshOptimize, model)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("Animation/" + model).c_str(),
+                                 BM_Animation, model)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("AnimationLayers/" + model).c_str(),
+                                 BM_AnimationLayers, model)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("AnimationLod/" + model).c_str(),
+                                 BM_AnimationLod, model)
+        ->ArgName("size")
+        ->Arg(100)
+        ->Arg(30)
+        ->Arg(10)
+        ->Arg(3)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("Hierarchy/" + model).c_str(),
+                                 BM_Hierarchy, model)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("Joints/" + model).c_str(), BM_Joints, model)
+        ->Unit(benchmark::kMicrosecond);
+  }
+
+  benchmark::RegisterBenchmark("LoadReplaced", BM_LoadReplaced)
+      ->Iterations(4)
+      ->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark("LongClip", BM_LongClip)
+      ->ArgNames({"scrub", "clip"})
+      ->ArgsProduct({{0, 1}, {0, 1, 2}})
+      ->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("BufferArena", BM_BufferArena)
+      ->ArgName("accessors")
+      ->Arg(256)
+      ->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark("BufferArenaCompactLimit",
+                               BM_BufferArenaCompactLimit)
+      ->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark("IndexSplit", BM_IndexSplit)
+      ->ArgName("side")
+      ->Arg(512)
+      ->Unit(benchmark::kMicrosecond);
+
+  for (const auto &[name, attribute]: kStreamAttributes) {
+    benchmark::RegisterBenchmark(("StreamGather/" + name).c_str(),
+                                 BM_StreamGather, name)
+        ->ArgName("simd")
+        ->Arg(0)
+        ->Arg(1)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("StreamDequantize/" + name).c_str(),
+                                 BM_StreamDequantize, name)
+        ->ArgName("simd")
+        ->Arg(0)
+        ->Arg(1)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("StreamSparse/" + name).c_str(),
+                                 BM_StreamSparse, name)
+        ->ArgName("simd")
+        ->Arg(0)
+        ->Arg(1)
+        ->Unit(benchmark::kMicrosecond);
+  }
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return gCheckFailed ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+# Draco 解码库配置, 由顶层 CMakeLists.txt 引入。
+#
+# 按以下顺序查找, 找到时创建接口目标 lightdigitalhuman_draco（链接 Draco 并定义
+# LIGHTDIGITALHUMAN_HAS_DRACO）, 启用 KHR_draco_mesh_compression 解码:
+#   1. third_party/draco 下的 Draco 源码, 随项目一起编译
+#   2. LIGHTDIGITALHUMAN_FETCH_DRACO 为 ON 时从 GitHub 下载固定版本的源码编译
+#      （Android 构建默认开启; 主机构建默认关闭, 离线环境也能配置）
+#   3. 已安装的 draco 包, 可通过 draco_DIR 指定安装位置
+# 都没有时压缩的图元使用未压缩的回退数据或被跳过, extensionsRequired 中列出该扩展的模型
+# 拒绝加载。LIGHTDIGITALHUMAN_REQUIRE_DRACO 为 ON（下载时默认开启）时找不到 Draco 直接报错,
+# CI 应以 -DLIGHTDIGITALHUMAN_FETCH_DRACO=ON 配置, 使 render_test 的 draco_sphere 用例实际解码。
+
+option(LIGHTDIGITALHUMAN_WITH_DRACO "Decode KHR_draco_mesh_compression" ON)
+option(LIGHTDIGITALHUMAN_FETCH_DRACO "Download and build Draco" ${ANDROID})
+option(LIGHTDIGITALHUMAN_REQUIRE_DRACO "Fail the configure step without Draco"
+        ${LIGHTDIGITALHUMAN_FETCH_DRACO})
+set(LIGHTDIGITALHUMAN_DRACO_TAG "1.5.7" CACHE STRING "Draco release to download")
+
+set(LIGHTDIGITALHUMAN_DRACO_SOURCE_DIR ${CMAKE_CURRENT_SOURCE_DIR}/third_party/draco)
+
+# 只编译解码所需的静态库, 不编译 Draco 自带的命令行工具与测试
+function(lightdigitalhuman_add_draco source_dir binary_dir)
+    set(DRACO_JS_GLUE OFF CACHE BOOL "" FORCE)
+    set(DRACO_TESTS OFF CACHE BOOL "" FORCE)
+    set(DRACO_ANIMATION_ENCODING OFF CACHE BOOL "" FORCE)
+    set(DRACO_TRANSCODER_SUPPORTED OFF CACHE BOOL "" FORCE)
+    set(BUILD_SHARED_LIBS OFF)
+    # 静态库链接进 Android 共享库, 需要位置无关代码
+    set(CMAKE_POSITION_INDEPENDENT_CODE ON)
+    add_subdirectory(${source_dir} ${binary_dir} EXCLUDE_FROM_ALL)
+
+    # MSVC 下库目标名为 draco, 其余平台为 draco_static
+    if (TARGET draco_static)
+        set(draco_target draco_static)
+    elseif (TARGET draco)
+        set(draco_target draco)
+    else ()
+        message(FATAL_ERROR "Draco library target not found in ${source_dir}")
+    endif ()
+    add_library(lightdigitalhuman_draco INTERFACE)
+    target_link_libraries(lightdigitalhuman_draco INTERFACE ${draco_target})
+    # 源码头文件与生成的 draco/draco_features.h
+    target_include_directories(lightdigitalhuman_draco INTERFACE
+            ${source_dir}/src
+            ${binary_dir})
+endfunction()
+
+if (NOT LIGHTDIGITALHUMAN_WITH_DRACO)
+    message(STATUS "Draco: disabled")
+elseif (EXISTS ${LIGHTDIGITALHUMAN_DRACO_SOURCE_DIR}/CMakeLists.txt)
+    lightdigitalhuman_add_draco(${LIGHTDIGITALHUMAN_DRACO_SOURCE_DIR}
+            ${CMAKE_BINARY_DIR}/third_party/draco)
+    message(STATUS "Draco: ${LIGHTDIGITALHUMAN_DRACO_SOURCE_DIR}")
+elseif (LIGHTDIGITALHUMAN_FETCH_DRACO)
+    include(FetchContent)
+    FetchContent_Declare(draco
+            GIT_REPOSITORY https://github.com/google/draco.git
+            GIT_TAG ${LIGHTDIGITALHUMAN_DRACO_TAG}
+            GIT_SHALLOW TRUE)
+    # 只下载, 由 lightdigitalhuman_add_draco 按需编译
+    FetchContent_GetProperties(draco)
+    if (NOT draco_POPULATED)
+        FetchContent_Populate(draco)
+    endif ()
+    lightdigitalhuman_add_draco(${draco_SOURCE_DIR} ${draco_BINARY_DIR})
+    message(STATUS "Draco: ${LIGHTDIGITALHUMAN_DRACO_TAG} (downloaded)")
+else ()
+    find_package(draco CONFIG QUIET)
+    if (draco_FOUND)
+        add_library(lightdigitalhuman_draco INTERFACE)
+        target_link_libraries(lightdigitalhuman_draco INTERFACE draco::draco)
+        message(STATUS "Draco: ${draco_DIR}")
+    else ()
+        message(STATUS "Draco: not found, compressed primitives need fallback data")
+    endif ()
+endif ()
+
+if (TARGET lightdigitalhuman_draco)
+    target_compile_definitions(lightdigitalhuman_draco INTERFACE
+            LIGHTDIGITALHUMAN_HAS_DRACO)
+elseif (LIGHTDIGITALHUMAN_REQUIRE_DRACO)
+    message(FATAL_ERROR "Draco is required but was not found: add its source to "
+            "third_party/draco, enable LIGHTDIGITALHUMAN_FETCH_DRACO or set draco_DIR")
+endif ()
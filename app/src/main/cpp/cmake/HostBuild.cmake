@@ -0,0 +1,54 @@
+# 主机（Linux）构建配置, 由顶层 CMakeLists.txt 在非 Android 平台下引入。
+#
+# 产物:
+#   lightdigitalhuman_core  与平台无关的核心静态库（不含 JNI 与 KTX）
+#   core_benchmark          加载/反量化/动画采样/层级更新/骨骼矩阵的基准测试
+#   render_test             离屏渲染 golden 图像比较 + 各渲染通道耗时
+#
+# 转换与蒙皮路径会调用 GL 接口, 因此链接系统 Mesa 的 EGL/GLESv2,
+# 基准测试在 surfaceless EGL 上下文（llvmpipe）中运行。
+
+set(CMAKE_CXX_STANDARD 17)
+set(CMAKE_CXX_STANDARD_REQUIRED ON)
+
+if (NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES)
+    set(CMAKE_BUILD_TYPE Release CACHE STRING "Build type" FORCE)
+endif ()
+
+set(TINYGLTF_BUILD_LOADER_EXAMPLE OFF CACHE BOOL "" FORCE)
+set(TINYGLTF_INSTALL OFF CACHE BOOL "" FORCE)
+add_subdirectory(third_party/tinygltf)
+
+# 只在这里定义STB实现
+target_compile_definitions(tinygltf PRIVATE
+        TINYGLTF_IMPLEMENTATION
+        STB_IMAGE_IMPLEMENTATION
+        STB_IMAGE_WRITE_IMPLEMENTATION
+        STB_IMAGE_RESIZE_IMPLEMENTATION
+)
+set_target_properties(tinygltf PROPERTIES POSITION_INDEPENDENT_CODE ON)
+
+find_library(host-egl-lib EGL REQUIRED)
+find_library(host-glesv2-lib GLESv2 REQUIRED)
+find_package(Threads REQUIRED)
+
+add_library(lightdigitalhuman_core STATIC ${LIGHTDIGITALHUMAN_CORE_SOURCES})
+# 仅使用 KTX 头文件, 主机构建不链接 libktx
+target_include_directories(lightdigitalhuman_core PUBLIC
+        ${CMAKE_CURRENT_SOURCE_DIR}/third_party/ktx/include)
+target_link_libraries(lightdigitalhuman_core PUBLIC
+        tinygltf
+        ${host-glesv2-lib}
+        ${host-egl-lib}
+        Threads::Threads)
+if (TARGET lightdigitalhuman_draco)
+    target_link_libraries(lightdigitalhuman_core PRIVATE lightdigitalhuman_draco)
+endif ()
+
+enable_testing()
+
+# 测试资源目录（app/src/main/assets）
+set(LIGHTDIGITALHUMAN_ASSET_DIR ${CMAKE_CURRENT_SOURCE_DIR}/../assets)
+
+add_subdirectory(benchmark)
+add_subdirectory(rendertest)
@@ -11,9 +11,13 @@
 #include "../gltfdata/Gltf.h"
 #include "../gltfdata/GltfState.h"
 #include "../gltfdata/GltfAnimation.h"
+#include "../gltfdata/GltfNode.h"
+#include "../gltfdata/GltfBufferArena.h"
 #include "../gltfdata/GltfOpenGLContext.h"
 #include "../utils/LogUtils.h"
 #include "../gltfdata/ibl_sampler.h"
+#include "../gltfdata/ibl/IBLAssetLoader.h"
+#include "../gltfdata/converter/GltfLoadTask.h"
 
 namespace digitalhumans {
 
@@ -26,6 +30,7 @@ Engine::Engine() {
 
 void Engine::renderFrame(int width, int height) {
   renderer->init(state);
+  processPendingLoad();
   animate(state);
   renderer->resize(width, height);
   renderer->clearFrame(state->getRenderingParameters().clearColor);
@@ -41,7 +46,14 @@ void Engine::renderFrame(int width, int height) {
     return;
   }
   scene->applyTransformHierarchy(state->getGltf());
+  // 动画 LOD 按首次计算出的世界变换测量模型与关节链的尺寸
+  auto &lod = state->getAnimationLod();
+  if (!lod.isMeasured()) {
+    lod.measure(state->getGltf(), state->getSceneIndex());
+  }
   renderer->drawScene(state, scene);
+  // 同步加载的模型在首帧绘制时按需上传, 之后释放只用于上传的 CPU 数据
+  GltfResidency::releaseUploaded(*state->getGltf());
   if (!init) {
     state->getUserCamera()->fitViewToScene(state->getGltf(),
                                            state->getSceneIndex());
@@ -49,15 +61,70 @@ void Engine::renderFrame(int width, int height) {
   }
 }
 
+void Engine::setPendingLoad(std::shared_ptr<GltfLoadTask> task) {
+  std::lock_guard<std::mutex> lock(loadMutex);
+  loadTask = std::move(task);
+  loadApplied = false;
+}
+
+GltfResidencyStats Engine::getResidencyStats() const {
+  auto gltf = state ? state->getGltf() : nullptr;
+  return gltf ? gltf->getResidencyStats() : GltfResidencyStats();
+}
+
+float Engine::getLoadProgress() const {
+  std::lock_guard<std::mutex> lock(loadMutex);
+  return loadTask ? loadTask->getProgress() : 1.0f;
+}
+
+void Engine::processPendingLoad() {
+  std::shared_ptr<GltfLoadTask> task;
+  {
+    std::lock_guard<std::mutex> lock(loadMutex);
+    if (!loadTask || loadApplied) {
+      return;
+    }
+    task = loadTask;
+  }
+
+  // 使用渲染器的上下文上传, 其扩展能力（各向异性过滤等）已在 init 中检测
+  if (!task->update(renderer->getWebGL(), uploadBudgetMs)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(loadMutex);
+  // 上传期间可能已提交了新任务
+  if (task != loadTask) {
+    return;
+  }
+  state->setGltf(task->getGltf());
+  // 旧模型的顶点与索引已归还缓冲区域（仍被资源缓存持有时除外）, 整理碎片
+  GltfBufferArena::shared().compact();
+  // 环境纹理挂在模型上, 需要为新模型重新绑定
+  if (environmentTextures) {
+    bindEnvironmentMap(*environmentTextures);
+  }
+  // 动画索引属于旧模型
+  state->clearAnimationIndices();
+  loadApplied = true;
+  LOGI("Swapped in model: %s", task->getName().c_str());
+}
+
 void Engine::animate(std::shared_ptr<GltfState> state) {
   if (state->getGltf() == nullptr) {
     return;
   }
 
-  const auto &animations = state->getGltf()->getAnimations();
+  Gltf &gltf = *state->getGltf();
+  const auto &animations = gltf.getAnimations();
   const auto &animationIndices = state->getAnimationIndices();
+  auto &mixer = state->getAnimationMixer();
+  auto &lod = state->getAnimationLod();
+  auto &pose = state->getAnimationPose();
 
-  if (animations.empty() || animationIndices.empty()) {
+  if (animations.empty() || (animationIndices.empty() && !mixer.isActive())) {
+    // 降频时最近一次采样的姿态还未完全显示
+    lod.flush(gltf, pose);
     return;
   }
 
@@ -68,11 +135,25 @@ void Engine::animate(std::shared_ptr<GltfState> state) {
   }
 
   float currentTime = state->getAnimationTimer().elapsedSec();
+  // 按上一帧的相机估计模型的投影尺寸, 不采样的帧已在两次采样结果间插值
+  const float screenSize = lod.projectSize(renderer->getViewMatrix(),
+                                           renderer->getProjectionMatrix());
+  if (!lod.beginFrame(gltf, pose, screenSize, currentTime)) {
+    return;
+  }
   for (const auto &[index, animTime]: animationIndices) {
     if (index >= 0 && index < static_cast<int>(animations.size())) {
       animations[index]->advance(state, currentTime, animTime, index);
     }
   }
+
+  // 动画层在一次求值中混合全部片段, 每个节点只写回一次
+  if (mixer.isActive()) {
+    mixer.evaluate(gltf, pose, currentTime, lod.getSkipMask());
+    const auto &mixerStats = mixer.getStats();
+    lod.recordChannels(mixerStats.sampledTracks, mixerStats.skippedTracks);
+  }
+  lod.endFrame(gltf, pose, currentTime);
 }
 
 void Engine::setUserCamera(std::shared_ptr<UserCamera> userCamera) const {
@@ -141,6 +222,101 @@ void Engine::stopAnimation(const std::string& name) const {
   }
 }
 
+int Engine::addAnimationLayer(const std::string &layer, bool additive,
+                              float weight) const {
+  if (!state) {
+    LOGE("Engine状态为空");
+    return -1;
+  }
+  return state->getAnimationMixer().addLayer(
+      layer,
+      additive ? AnimationBlendMode::ADDITIVE : AnimationBlendMode::OVERRIDE,
+      weight);
+}
+
+bool Engine::crossFadeAnimation(const std::string &layer, const std::string &name,
+                                float fadeSeconds, int loopCount,
+                                float weight) const {
+  if (!state || !state->getGltf()) {
+    LOGE("GLTF对象为空");
+    return false;
+  }
+  const auto &gltf = state->getGltf();
+  const auto &animations = gltf->getAnimations();
+  for (size_t i = 0; i < animations.size(); ++i) {
+    if (animations[i] && animations[i]->getName() == name) {
+      auto &mixer = state->getAnimationMixer();
+      int index = mixer.findLayer(layer);
+      if (index < 0) {
+        index = mixer.addLayer(layer);
+      }
+      return mixer.play(*gltf, index, static_cast<int>(i), fadeSeconds,
+                        loopCount, weight);
+    }
+  }
+  LOGE("动画不存在: %s", name.c_str());
+  return false;
+}
+
+bool Engine::stopAnimationLayer(const std::string &layer,
+                                float fadeSeconds) const {
+  if (!state) {
+    LOGE("Engine状态为空");
+    return false;
+  }
+  auto &mixer = state->getAnimationMixer();
+  return mixer.stop(mixer.findLayer(layer), fadeSeconds);
+}
+
+void Engine::setAnimationLod(const GltfAnimationLodSettings &settings) const {
+  if (!state) {
+    LOGE("Engine状态为空");
+    return;
+  }
+  state->getAnimationLod().setSettings(settings);
+}
+
+GltfAnimationLodStats Engine::getAnimationLodStats() const {
+  return state ? state->getAnimationLod().getStats() : GltfAnimationLodStats();
+}
+
+bool Engine::setAnimationLayerWeight(const std::string &layer, float weight,
+                                     float fadeSeconds) const {
+  if (!state) {
+    LOGE("Engine状态为空");
+    return false;
+  }
+  auto &mixer = state->getAnimationMixer();
+  return mixer.setLayerWeight(mixer.findLayer(layer), weight, fadeSeconds);
+}
+
+bool Engine::setAnimationLayerMask(const std::string &layer,
+                                   const std::vector<std::string> &rootNodes) const {
+  if (!state || !state->getGltf()) {
+    LOGE("GLTF对象为空");
+    return false;
+  }
+  const auto &gltf = state->getGltf();
+  const auto &nodes = gltf->getNodes();
+  std::vector<int> roots;
+  for (const auto &name: rootNodes) {
+    const auto found = std::find_if(nodes.begin(), nodes.end(),
+                                    [&](const std::shared_ptr<GltfNode> &node) {
+                                      return node && node->getName() == name;
+                                    });
+    if (found == nodes.end()) {
+      LOGW("节点不存在: %s", name.c_str());
+      continue;
+    }
+    roots.push_back(static_cast<int>(found - nodes.begin()));
+  }
+  if (!rootNodes.empty() && roots.empty()) {
+    return false;
+  }
+  auto &mixer = state->getAnimationMixer();
+  return mixer.setLayerMask(*gltf, mixer.findLayer(layer), roots);
+}
+
 const std::shared_ptr<GltfState> &Engine::getState() const {
   return state;
 }
@@ -153,54 +329,152 @@ void Engine::setIbL(bool use) const {
   state->getRenderingParameters().useIBL = use;
 }
 
-bool Engine::processEnvironmentMap(const HDRImage &hdrImage) const {
-
-  auto startTime = std::chrono::high_resolution_clock::now();
-
+bool Engine::processEnvironmentMap(const HDRImage &hdrImage) {
+  if (hdrImage.dataFloat.empty()) {
+    LOGE("Failed to load HDR image");
+    return false;
+  }
   try {
-    if (hdrImage.dataFloat.empty()) {
-      LOGE("Failed to load HDR image");
-      return false;
+    IBLSampler sampler(context);
+    const IBLBakeKey key = IBLBakeKey::make(hdrImage, sampler);
+    // 模型切换后重新设置同一环境时直接复用
+    if (ownsEnvironmentTextures && environmentTextures &&
+        environmentKey == key) {
+      LOGI("Environment unchanged, reusing IBL textures");
+      return applyEnvironmentMap(*environmentTextures);
     }
-
-    auto iblSampler = std::make_shared<IBLSampler>(context);
-    if (!iblSampler->init(hdrImage)) {
-      LOGE("Failed to initialize IBL sampler");
+    EnvironmentMapTextures textures;
+    if (!bakeEnvironmentMap(hdrImage, sampler, key, textures) ||
+        !applyOwnedEnvironmentMap(textures)) {
       return false;
     }
-    iblSampler->filterAll();
-    GLuint diffuseTexture = iblSampler->getLambertianTextureID();
-    GLuint specularTexture = iblSampler->getGGXTextureID();
-    GLuint sheenTexture = iblSampler->getSheenTextureID();
-    GLuint ggxLutTexture = iblSampler->getGGXLutTextureID();
-    GLuint charlieLutTexture = iblSampler->getCharlieLutTextureID();
-
-    if (diffuseTexture == 0 || specularTexture == 0 || ggxLutTexture == 0) {
-      LOGE("Failed to generate IBL textures");
-      return false;
-    }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        endTime - startTime).count();
-
-    auto env = getState()->getEnvironment();
-    env->diffuseEnvMap =
-        env->createImageInfo(diffuseTexture, GL_TEXTURE_CUBE_MAP, 1);
-    env->specularEnvMap =
-        env->createImageInfo(specularTexture, GL_TEXTURE_CUBE_MAP, 0);
-    env->sheenEnvMap =
-        env->createImageInfo(sheenTexture, GL_TEXTURE_CUBE_MAP, 0);
-    env->lut = env->createImageInfo(ggxLutTexture, GL_TEXTURE_2D, 1);
-    env->sheenLUT = env->createImageInfo(charlieLutTexture, GL_TEXTURE_2D, 1);
-    env->mipCount_ = iblSampler->getMipmapLevels();
-    env->diffuseEnvMap_ = diffuseTexture;
+    environmentKey = key;
     return true;
+  } catch (const std::exception &e) {
+    LOGE("Exception during IBL processing: %s", e.what());
+    return false;
+  }
+}
 
+bool Engine::loadEnvironmentFromAssets(const AssetProvider &provider,
+                                       const std::string &envDir) {
+  EnvironmentMapTextures textures;
+  if (!IBLAssetLoader::load(provider, envDir, textures)) {
+    return false;
+  }
+  return applyOwnedEnvironmentMap(textures);
+}
+
+bool Engine::applyOwnedEnvironmentMap(EnvironmentMapTextures &textures) {
+  if (!applyEnvironmentMap(textures)) {
+    textures.release();
+    return false;
+  }
+  ownsEnvironmentTextures = true;
+  return true;
+}
+
+bool Engine::bakeEnvironmentMap(const HDRImage &hdrImage,
+                                EnvironmentMapTextures &textures) const {
+  if (hdrImage.dataFloat.empty()) {
+    LOGE("Failed to load HDR image");
+    return false;
+  }
+  try {
+    IBLSampler sampler(context);
+    return bakeEnvironmentMap(hdrImage, sampler,
+                              IBLBakeKey::make(hdrImage, sampler), textures);
   } catch (const std::exception &e) {
     LOGE("Exception during IBL processing: %s", e.what());
     return false;
   }
-  return false;
+}
+
+bool Engine::bakeEnvironmentMap(const HDRImage &hdrImage, IBLSampler &sampler,
+                                const IBLBakeKey &key,
+                                EnvironmentMapTextures &textures) const {
+  if (!iblCacheDir.empty() && IBLBakeCache::load(iblCacheDir, key, textures)) {
+    return true;
+  }
+
+  auto startTime = std::chrono::high_resolution_clock::now();
+  if (!sampler.init(hdrImage)) {
+    LOGE("Failed to initialize IBL sampler");
+    return false;
+  }
+  sampler.filterAll();
+  textures.diffuse = sampler.getLambertianTextureID();
+  textures.specular = sampler.getGGXTextureID();
+  textures.sheen = sampler.getSheenTextureID();
+  textures.ggxLut = sampler.getGGXLutTextureID();
+  textures.charlieLut = sampler.getCharlieLutTextureID();
+  textures.mipCount = sampler.getMipmapLevels();
+
+  if (!textures.isValid()) {
+    LOGE("Failed to generate IBL textures");
+    return false;
+  }
+
+  auto endTime = std::chrono::high_resolution_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      endTime - startTime).count();
+  LOGI("IBL baked in %lld ms", static_cast<long long>(duration));
+
+  if (!iblCacheDir.empty() &&
+      !IBLBakeCache::store(iblCacheDir, key, textures, sampler)) {
+    LOGW("Failed to write IBL cache to %s", iblCacheDir.c_str());
+  }
+  return true;
+}
+
+bool Engine::applyEnvironmentMap(const EnvironmentMapTextures &textures) {
+  if (!textures.isValid()) {
+    LOGE("Invalid IBL textures");
+    return false;
+  }
+  if (!getState()->getEnvironment()) {
+    LOGE("Environment is not initialized");
+    return false;
+  }
+  // 重新应用当前纹理时保持不变, 否则由引擎创建的旧纹理不再被引用
+  if (!environmentTextures || environmentTextures->specular != textures.specular) {
+    if (ownsEnvironmentTextures && environmentTextures) {
+      environmentTextures->release();
+    }
+    ownsEnvironmentTextures = false;
+    environmentKey = IBLBakeKey();
+    environmentTextures = std::make_shared<EnvironmentMapTextures>(textures);
+  }
+  if (!getState()->getGltf()) {
+    LOGI("No model loaded yet, environment will be bound once it is ready");
+    return true;
+  }
+  bindEnvironmentMap(textures);
+  return true;
+}
+
+void Engine::bindEnvironmentMap(const EnvironmentMapTextures &textures) {
+  auto env = getState()->getEnvironment();
+
+  GLuint diffuseTexture = textures.diffuse;
+  GLuint specularTexture = textures.specular;
+  GLuint sheenTexture = textures.sheen;
+  GLuint ggxLutTexture = textures.ggxLut;
+  GLuint charlieLutTexture = textures.charlieLut;
+  env->diffuseEnvMap =
+      env->createImageInfo(diffuseTexture, GL_TEXTURE_CUBE_MAP, 1);
+  env->specularEnvMap =
+      env->createImageInfo(specularTexture, GL_TEXTURE_CUBE_MAP, 0);
+  env->sheenEnvMap =
+      env->createImageInfo(sheenTexture, GL_TEXTURE_CUBE_MAP, 0);
+  env->lut = env->createImageInfo(ggxLutTexture, GL_TEXTURE_2D, 1);
+  env->sheenLUT = env->createImageInfo(charlieLutTexture, GL_TEXTURE_2D, 1);
+  env->mipCount_ = textures.mipCount;
+  env->diffuseEnvMap_ = diffuseTexture;
+  // 天空盒按 specularEnvMap_ 判断是否有环境贴图
+  env->specularEnvMap_ = specularTexture;
+  env->sheenEnvMap_ = sheenTexture;
+  env->brdfLUT_ = ggxLutTexture;
+  env->sheenLUT_ = charlieLutTexture;
 }
 } // namespace digitalhumans
\ No newline at end of file
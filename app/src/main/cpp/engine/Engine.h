@@ -6,7 +6,12 @@
 #define LIGHTDIGITALHUMAN_ENGINE_H
 
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
+#include "../gltfdata/GltfAnimationLod.h"
+#include "../gltfdata/GltfResidency.h"
+#include "../gltfdata/ibl/IBLBakeCache.h"
 
 namespace digitalhumans {
 class GltfRenderer;
@@ -19,6 +24,14 @@ class UserCamera;
 
 class HDRImage;
 
+struct EnvironmentMapTextures;
+
+class IBLSampler;
+
+class GltfLoadTask;
+
+class AssetProvider;
+
 class Engine {
  public:
 
@@ -34,7 +47,47 @@ class Engine {
   std::shared_ptr<GltfOpenGLContext> context;
   std::vector<std::string> getAnimationAllName() const;
 
-  bool processEnvironmentMap(const HDRImage &hdrImage) const;
+  /**
+   * @brief 预处理 HDR 全景图并绑定到当前场景
+   *
+   * 与当前环境相同（内容与预处理参数一致）时直接复用已有纹理;
+   * 设置了 IBL 缓存目录时优先从缓存加载, 未命中则烘焙后写入缓存。
+   * @param hdrImage HDR 全景图
+   * @return 是否成功
+   */
+  bool processEnvironmentMap(const HDRImage &hdrImage);
+
+  /**
+   * @brief 预处理 HDR 全景图, 生成 IBL 纹理（不修改当前场景）
+   *
+   * 设置了 IBL 缓存目录时先查缓存, 未命中时烘焙并写入缓存。
+   * @param hdrImage HDR 全景图
+   * @param textures 输出的 IBL 纹理
+   * @return 是否成功
+   */
+  bool bakeEnvironmentMap(const HDRImage &hdrImage,
+                          EnvironmentMapTextures &textures) const;
+
+  /**
+   * @brief 将已生成的 IBL 纹理绑定到当前场景的环境
+   *
+   * 纹理会被记录下来, 异步加载的模型替换进来时重新绑定;
+   * 尚未加载模型时延迟到模型就绪后绑定。
+   * @param textures IBL 纹理
+   * @return 是否成功
+   */
+  bool applyEnvironmentMap(const EnvironmentMapTextures &textures);
+
+  /**
+   * @brief 从预滤波的 KTX 环境资源加载 IBL 并绑定到当前场景, 需在 GL 线程调用
+   *
+   * 不经过 IBLSampler 预处理, 切换环境只需读取与上传纹理。
+   * @param provider 资源读取
+   * @param envDir 环境目录, 如 "envs" 或 "envs/studio"
+   * @return 是否成功
+   */
+  bool loadEnvironmentFromAssets(const AssetProvider &provider,
+                                 const std::string &envDir);
 
   const std::shared_ptr<GltfState> &getState() const;
 
@@ -45,9 +98,108 @@ class Engine {
 
   void stopAnimation(const std::string &name) const;
 
+  /**
+   * @brief 添加动画层, 同名层已存在时更新其混合方式与权重
+   *
+   * 层按添加顺序自下而上混合, 全部层在一次求值中合成后写回节点。
+   * 同一节点不要同时由 playAnimation 与动画层驱动, 后者的结果会覆盖前者。
+   * @param additive 为 true 时叠加片段相对其首帧的变化量
+   * @return 层下标
+   */
+  int addAnimationLayer(const std::string &layer, bool additive,
+                        float weight) const;
+
+  /**
+   * @brief 在层上交叉淡化到指定动画, 层不存在时以覆盖方式创建
+   * @param fadeSeconds 淡化时长, 为 0 时立即切换
+   * @param loopCount 循环次数, -1 为无限循环
+   * @param weight 片段在层内的权重
+   */
+  bool crossFadeAnimation(const std::string &layer, const std::string &name,
+                          float fadeSeconds, int loopCount, float weight) const;
+
+  /**
+   * @brief 淡出层上的全部动画
+   */
+  bool stopAnimationLayer(const std::string &layer, float fadeSeconds) const;
+
+  /**
+   * @brief 在 fadeSeconds 秒内把层权重渐变到 weight
+   */
+  bool setAnimationLayerWeight(const std::string &layer, float weight,
+                               float fadeSeconds) const;
+
+  /**
+   * @brief 限制层只作用于指定名称的节点及其子节点, 为空时作用于全部节点
+   */
+  bool setAnimationLayerMask(const std::string &layer,
+                             const std::vector<std::string> &rootNodes) const;
+
+  /**
+   * @brief 设置动画 LOD 阈值
+   *
+   * 模型投影尺寸低于阈值时降低采样频率并在两次采样间插值, 跳过过小的末端关节链
+   * 与 morph 权重通道。enabled 为 false 时每帧采样全部通道。
+   */
+  void setAnimationLod(const GltfAnimationLodSettings &settings) const;
+
+  /**
+   * @brief 动画 LOD 的统计, 没有状态时全部为 0
+   */
+  GltfAnimationLodStats getAnimationLodStats() const;
+
   void setIbL(bool use) const;
 
+  /**
+   * @brief 提交异步加载任务（可在任意线程调用）
+   * renderFrame 中按预算推进 GPU 上传, 就绪后替换当前模型。
+   * 新任务会取代尚未完成的旧任务。
+   */
+  void setPendingLoad(std::shared_ptr<GltfLoadTask> task);
+
+  /**
+   * @brief 最近一次异步加载的进度 [0, 1], 失败返回 -1, 没有任务返回 1
+   */
+  float getLoadProgress() const;
+
+  /**
+   * @brief 当前模型各驻留策略释放的 CPU 内存, 没有模型时全部为 0
+   */
+  GltfResidencyStats getResidencyStats() const;
+
+  /**
+   * @brief 设置每帧用于 GPU 上传的时间预算（毫秒）
+   */
+  void setUploadBudgetMs(double budgetMs) { uploadBudgetMs = budgetMs; }
+
+  /**
+   * @brief 设置 IBL 烘焙缓存目录, 为空时关闭缓存
+   */
+  void setIblCacheDir(const std::string &dir) { iblCacheDir = dir; }
+
  private:
+  /**
+   * @brief 推进异步加载任务, 就绪后替换模型
+   */
+  void processPendingLoad();
+
+  /**
+   * @brief 将 IBL 纹理绑定到当前模型的环境
+   */
+  void bindEnvironmentMap(const EnvironmentMapTextures &textures);
+
+  /**
+   * @brief 应用由引擎创建的 IBL 纹理, 被替换或应用失败时删除
+   */
+  bool applyOwnedEnvironmentMap(EnvironmentMapTextures &textures);
+
+  /**
+   * @brief 使用给定的 IBLSampler 生成 IBL 纹理, 缓存命中时跳过烘焙
+   */
+  bool bakeEnvironmentMap(const HDRImage &hdrImage, IBLSampler &sampler,
+                          const IBLBakeKey &key,
+                          EnvironmentMapTextures &textures) const;
+
   /**
    * @brief 动画更新
    * 内部方法，用于更新动画状态
@@ -56,6 +208,15 @@ class Engine {
   void animate(std::shared_ptr<GltfState> state);
   bool init = false;
 
+  mutable std::mutex loadMutex;
+  std::shared_ptr<GltfLoadTask> loadTask;  ///< 最近一次异步加载任务
+  bool loadApplied = false;                ///< loadTask 的模型是否已替换
+  double uploadBudgetMs = 4.0;
+  std::shared_ptr<EnvironmentMapTextures> environmentTextures;  ///< 最近应用的 IBL
+  bool ownsEnvironmentTextures = false;  ///< environmentTextures 是否由引擎创建
+  IBLBakeKey environmentKey;             ///< 引擎烘焙的 environmentTextures 对应的键
+  std::string iblCacheDir;               ///< IBL 烘焙缓存目录, 为空时不缓存
+
 };
 
 } // namespace digitalhumans
@@ -4,7 +4,6 @@
 
 #include "EnvironmentRenderer.h"
 
-#include <android/log.h>
 #include <algorithm>
 
 #include "../utils/LogUtils.h"
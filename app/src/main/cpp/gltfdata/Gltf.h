@@ -10,6 +10,7 @@
 #include <string>
 #include <memory>
 #include "GltfObject.h"
+#include "GltfResidency.h"
 
 namespace digitalhumans {
 
@@ -143,6 +144,8 @@ class Gltf: public GltfObject {
   const std::vector<std::shared_ptr<GltfVariant>> &
   getVariants() const { return variants; }
 
+  const GltfResidencyStats &getResidencyStats() const { return residencyStats; }
+
   void setAsset(std::shared_ptr<GltfAsset> asset) { this->asset = asset; }
 
   void setScene(int scene) { this->scene = scene; }
@@ -376,6 +379,9 @@ class Gltf: public GltfObject {
   std::vector<std::shared_ptr<GltfAnimation>> animations;     ///< 动画数组
   std::vector<std::shared_ptr<GltfSkin>> skins;               ///< 蒙皮数组
   std::vector<std::shared_ptr<GltfVariant>> variants;         ///< 材质变体数组
+
+  // === 运行时数据 ===
+  GltfResidencyStats residencyStats;                          ///< 驻留策略释放的内存
 };
 
 } // namespace digitalhumans
@@ -8,8 +8,10 @@
 #include <algorithm>
 #include <cstring>
 #include <GLES3/gl3.h>
+#include "../utils/ComponentConvert.h"
 #include "../utils/LogUtils.h"
 #include "Gltf.h"
+#include "GltfBufferArena.h"
 #include "GltfBufferView.h"
 
 #include "GltfBuffer.h"
@@ -39,17 +41,6 @@ const std::unordered_map<AccessorType, std::string>
     {AccessorType::MAT4, "MAT4"}
 };
 
-const std::unordered_map<AccessorType, int>
-    AccessorTypeUtils::componentCounts = {
-    {AccessorType::SCALAR, 1},
-    {AccessorType::VEC2, 2},
-    {AccessorType::VEC3, 3},
-    {AccessorType::VEC4, 4},
-    {AccessorType::MAT2, 4},
-    {AccessorType::MAT3, 9},
-    {AccessorType::MAT4, 16}
-};
-
 AccessorType AccessorTypeUtils::fromString(const std::string &typeStr) {
   auto it = stringToEnum.find(typeStr);
   if (it != stringToEnum.end()) {
@@ -67,9 +58,20 @@ std::string AccessorTypeUtils::toString(AccessorType type) {
 }
 
 int AccessorTypeUtils::getComponentCount(AccessorType type) {
-  auto it = componentCounts.find(type);
-  if (it != componentCounts.end()) {
-    return it->second;
+  switch (type) {
+    case AccessorType::SCALAR:
+      return 1;
+    case AccessorType::VEC2:
+      return 2;
+    case AccessorType::VEC3:
+      return 3;
+    case AccessorType::VEC4:
+    case AccessorType::MAT2:
+      return 4;
+    case AccessorType::MAT3:
+      return 9;
+    case AccessorType::MAT4:
+      return 16;
   }
   return 0;
 }
@@ -92,7 +94,7 @@ GltfAccessor::GltfAccessor()
     : GltfObject(), bufferView(std::nullopt), byteOffset(0),
       componentType(std::nullopt), normalized(false),
       count(std::nullopt), type(std::nullopt), sparse(std::nullopt),
-      name(std::nullopt), glBuffer(0) {
+      name(std::nullopt) {
 }
 
 GltfAccessor::GltfAccessor(int bufferViewIndex,
@@ -101,8 +103,7 @@ GltfAccessor::GltfAccessor(int bufferViewIndex,
                            const std::string &type)
     : GltfObject(), bufferView(bufferViewIndex), byteOffset(0),
       componentType(componentType), normalized(false),
-      count(count), type(type), sparse(std::nullopt), name(std::nullopt),
-      glBuffer(0) {
+      count(count), type(type), sparse(std::nullopt), name(std::nullopt) {
   if (!AccessorTypeUtils::isValidType(type)) {
     throw std::invalid_argument("Invalid accessor type: " + type);
   }
@@ -110,6 +111,7 @@ GltfAccessor::GltfAccessor(int bufferViewIndex,
     throw std::invalid_argument(
         "Invalid component type: " + std::to_string(componentType));
   }
+  resolveLayout();
 }
 
 GltfAccessor::~GltfAccessor() {
@@ -124,7 +126,10 @@ GltfAccessor::GltfAccessor(GltfAccessor &&other) noexcept
       type(std::move(other.type)), max(std::move(other.max)),
       min(std::move(other.min)),
       sparse(std::move(other.sparse)), name(std::move(other.name)),
-      glBuffer(other.glBuffer),
+      glAllocation(std::move(other.glAllocation)),
+      glByteStride(other.glByteStride), residency(other.residency),
+      cpuDataReleased(other.cpuDataReleased),
+      decodedData(std::move(other.decodedData)),
       typedView(std::move(other.typedView)),
       filteredView(std::move(other.filteredView)),
       normalizedTypedView(std::move(other.normalizedTypedView)),
@@ -133,7 +138,7 @@ GltfAccessor::GltfAccessor(GltfAccessor &&other) noexcept
       filteredViewValid(other.filteredViewValid),
       normalizedTypedViewValid(other.normalizedTypedViewValid),
       normalizedFilteredViewValid(other.normalizedFilteredViewValid) {
-  other.glBuffer = 0;
+  resolveLayout();
   other.clearCachedViews();
 }
 
@@ -151,7 +156,11 @@ GltfAccessor &GltfAccessor::operator=(GltfAccessor &&other) noexcept {
     min = std::move(other.min);
     sparse = std::move(other.sparse);
     name = std::move(other.name);
-    glBuffer = other.glBuffer;
+    glAllocation = std::move(other.glAllocation);
+    glByteStride = other.glByteStride;
+    residency = other.residency;
+    cpuDataReleased = other.cpuDataReleased;
+    decodedData = std::move(other.decodedData);
     typedView = std::move(other.typedView);
     filteredView = std::move(other.filteredView);
     normalizedTypedView = std::move(other.normalizedTypedView);
@@ -160,7 +169,7 @@ GltfAccessor &GltfAccessor::operator=(GltfAccessor &&other) noexcept {
     filteredViewValid = other.filteredViewValid;
     normalizedTypedViewValid = other.normalizedTypedViewValid;
     normalizedFilteredViewValid = other.normalizedFilteredViewValid;
-    other.glBuffer = 0;
+    resolveLayout();
     other.clearCachedViews();
   }
   return *this;
@@ -178,6 +187,7 @@ bool GltfAccessor::validate() const {
 void GltfAccessor::setAccessorType(const std::string &accessorType) {
   if (AccessorTypeUtils::isValidType(accessorType)) {
     type = accessorType;
+    resolveLayout();
     clearCachedViews();
   } else {
     throw std::invalid_argument("Invalid accessor type: " + accessorType);
@@ -188,10 +198,21 @@ void GltfAccessor::setAccessorType(AccessorType accessorType) {
   setAccessorType(AccessorTypeUtils::toString(accessorType));
 }
 
+void GltfAccessor::setDecodedData(std::vector<uint8_t> &&data) {
+  decodedData = std::move(data);
+  clearCachedViews();
+}
+
 std::pair<const void *, size_t> GltfAccessor::getTypedView(const Gltf &gltf) {
+  if (checkReleased()) {
+    return {nullptr, 0};
+  }
   if (typedViewValid) {
     return {typedView.data(), typedView.size()};
   }
+  if (!decodedData.empty()) {
+    return {decodedData.data(), decodedData.size()};
+  }
 
   if (bufferView.has_value()) {
     const auto &bufferViews = gltf.getBufferViews();
@@ -220,10 +241,11 @@ std::pair<const void *, size_t> GltfAccessor::getTypedView(const Gltf &gltf) {
       return {nullptr, 0};
     }
 
-    const auto &bufferData = buffer->buffer;
+    const uint8_t *bufferData = buffer->getData();
+    size_t bufferSize = buffer->getActualSize();
     int totalByteOffset = byteOffset + bv->getByteOffset();
 
-    if (totalByteOffset >= static_cast<int>(bufferData.size())) {
+    if (totalByteOffset >= static_cast<int>(bufferSize)) {
       LOGE("Byte offset exceeds buffer size");
       return {nullptr, 0};
     }
@@ -244,7 +266,7 @@ std::pair<const void *, size_t> GltfAccessor::getTypedView(const Gltf &gltf) {
     } else if (count.has_value()) {
       arrayLength = count.value() * componentCount;
     }
-    size_t maxLength = (bufferData.size() - totalByteOffset) / componentSize;
+    size_t maxLength = (bufferSize - totalByteOffset) / componentSize;
     if (arrayLength > maxLength) {
       arrayLength = maxLength;
       LOGW("Count in accessor '%s' is too large",
@@ -252,18 +274,24 @@ std::pair<const void *, size_t> GltfAccessor::getTypedView(const Gltf &gltf) {
     }
 
     size_t totalBytes = arrayLength * componentSize;
+    // 没有稀疏数据时类型化视图与缓冲区内容相同, 直接引用
+    if (!sparse.has_value() || !sparse->isValid()) {
+      return {bufferData + totalByteOffset, totalBytes};
+    }
     typedView.resize(totalBytes);
     std::memcpy(typedView.data(),
-                bufferData.data() + totalByteOffset,
+                bufferData + totalByteOffset,
                 totalBytes);
 
   } else {
     typedView = createEmptyView();
   }
 
-  // 应用稀疏数据
+  // 应用稀疏数据, 类型化视图保留缓冲区视图的步长
   if (sparse.has_value() && sparse->isValid()) {
-    applySparse(gltf, typedView.data(), getComponentSize());
+    const int byteStride = bufferView.has_value() ? getByteStride(gltf) : 0;
+    applySparse(gltf, typedView.data(), typedView.size(),
+                byteStride > 0 ? byteStride : getElementSize());
   }
 
   typedViewValid = true;
@@ -271,74 +299,29 @@ std::pair<const void *, size_t> GltfAccessor::getTypedView(const Gltf &gltf) {
 }
 
 std::vector<float> GltfAccessor::getNormalizedTypedView(const Gltf &gltf) {
-  if (normalizedTypedViewValid) {
-    return normalizedTypedView;
-  }
+  ArrayView<float> view = getNormalizedTypedSpan(gltf);
+  return {view.begin(), view.end()};
+}
 
+ArrayView<float> GltfAccessor::getNormalizedTypedSpan(const Gltf &gltf) {
   auto [data, size] = getTypedView(gltf);
-  if (data && componentType.has_value()) {
-    if (normalized) {
-      normalizedTypedView = dequantize(data, size, componentType.value());
-    } else {
-      int componentCount = getComponentCount();
-      int elementCount = count.value_or(0);
-      normalizedTypedView.resize(elementCount * componentCount);
-
-      switch (componentType.value()) {
-        case GL_FLOAT:
-          std::memcpy(normalizedTypedView.data(), data, size);
-          break;
-        case GL_BYTE: {
-          const int8_t *src = static_cast<const int8_t *>(data);
-          for (size_t i = 0; i < normalizedTypedView.size(); ++i) {
-            normalizedTypedView[i] = static_cast<float>(src[i]);
-          }
-        }
-          break;
-        case GL_UNSIGNED_BYTE: {
-          const uint8_t *src = static_cast<const uint8_t *>(data);
-          for (size_t i = 0; i < normalizedTypedView.size(); ++i) {
-            normalizedTypedView[i] = static_cast<float>(src[i]);
-          }
-        }
-          break;
-        case GL_SHORT: {
-          const int16_t *src = static_cast<const int16_t *>(data);
-          for (size_t i = 0; i < normalizedTypedView.size(); ++i) {
-            normalizedTypedView[i] = static_cast<float>(src[i]);
-          }
-        }
-          break;
-        case GL_UNSIGNED_SHORT: {
-          const uint16_t *src = static_cast<const uint16_t *>(data);
-          for (size_t i = 0; i < normalizedTypedView.size(); ++i) {
-            normalizedTypedView[i] = static_cast<float>(src[i]);
-          }
-        }
-          break;
-        case GL_UNSIGNED_INT: {
-          const uint32_t *src = static_cast<const uint32_t *>(data);
-          for (size_t i = 0; i < normalizedTypedView.size(); ++i) {
-            normalizedTypedView[i] = static_cast<float>(src[i]);
-          }
-        }
-          break;
-      }
-    }
-  }
-
-  normalizedTypedViewValid = true;
-  return normalizedTypedView;
+  return normalizeView(data, size, normalizedTypedView,
+                       normalizedTypedViewValid);
 }
 
 std::pair<const void *, size_t>
 GltfAccessor::getDeinterlacedView(const Gltf &gltf) {
+  if (checkReleased()) {
+    return {nullptr, 0};
+  }
   if (filteredViewValid) {
     return {filteredView.data(), filteredView.size()};
   }
+  if (!decodedData.empty()) {
+    return {decodedData.data(), decodedData.size()};
+  }
 
-  if (!bufferView.has_value() || !componentType.has_value() ||
-      !count.has_value() || !type.has_value()) {
+  if (!componentType.has_value() || !count.has_value() || !type.has_value()) {
     filteredView = createEmptyView();
     filteredViewValid = true;
     return {filteredView.data(), filteredView.size()};
@@ -363,7 +346,8 @@ GltfAccessor::getDeinterlacedView(const Gltf &gltf) {
     filteredView.resize(arrayLength * componentSize, 0); // 初始化为 0
 
     // 应用稀疏数据
-    applySparse(gltf, filteredView.data(), componentSize);
+    applySparse(gltf, filteredView.data(), filteredView.size(),
+                componentSize * componentCount);
 
     filteredViewValid = true;
     return {filteredView.data(), filteredView.size()};
@@ -399,7 +383,8 @@ GltfAccessor::getDeinterlacedView(const Gltf &gltf) {
     return {filteredView.data(), filteredView.size()};
   }
 
-  const auto &bufferData = buffer->buffer;
+  const uint8_t *bufferData = buffer->getData();
+  size_t bufferSize = buffer->getActualSize();
   int componentSize = getComponentSize();
   int componentCount = getComponentCount();
   size_t arrayLength = count.value() * componentCount;
@@ -409,28 +394,32 @@ GltfAccessor::getDeinterlacedView(const Gltf &gltf) {
     stride = componentCount * componentSize;
   }
 
-  // 分配过滤视图
-  filteredView.resize(arrayLength * componentSize);
+  const size_t elementSize = static_cast<size_t>(componentCount) * componentSize;
+  const size_t viewOffset = static_cast<size_t>(bv->getByteOffset()) + byteOffset;
+  const size_t available = bufferSize > viewOffset ? bufferSize - viewOffset : 0;
+  size_t readable = 0;
+  if (available >= elementSize) {
+    readable = std::min(static_cast<size_t>(count.value()),
+                        (available - elementSize) / stride + 1);
+  }
 
-  // 从buffer中提取数据
-  const uint8_t *srcData = bufferData.data() + bv->getByteOffset();
-  uint8_t *dstData = filteredView.data();
-
-  for (int i = 0; i < count.value(); ++i) {
-    int srcOffset = i * stride + byteOffset;
-    int dstOffset = i * componentCount * componentSize;
-
-    if (srcOffset + componentCount * componentSize <=
-        static_cast<int>(bufferData.size()) - bv->getByteOffset()) {
-      std::memcpy(dstData + dstOffset,
-                  srcData + srcOffset,
-                  componentCount * componentSize);
-    }
+  // 紧密排列且完整位于缓冲区内的数据无需去交错, 直接引用
+  const bool hasSparse = sparse.has_value() && sparse->isValid();
+  if (!hasSparse && static_cast<size_t>(stride) == elementSize &&
+      readable == static_cast<size_t>(count.value()) && elementSize > 0) {
+    return {bufferData + viewOffset, arrayLength * componentSize};
   }
 
+  // 分配过滤视图, 超出缓冲区的元素保持为 0
+  filteredView.assign(arrayLength * componentSize, 0);
+
+  // 从buffer中提取数据
+  component::gatherElements(bufferData + viewOffset, stride, elementSize,
+                            filteredView.data(), readable);
+
   // 应用稀疏数据
-  if (sparse.has_value() && sparse->isValid()) {
-    applySparse(gltf, filteredView.data(), componentSize);
+  if (hasSparse) {
+    applySparse(gltf, filteredView.data(), filteredView.size(), elementSize);
   }
 
   filteredViewValid = true;
@@ -439,69 +428,70 @@ GltfAccessor::getDeinterlacedView(const Gltf &gltf) {
 
 std::vector<float>
 GltfAccessor::getNormalizedDeinterlacedView(const Gltf &gltf) {
-  if (normalizedFilteredViewValid) {
-    return normalizedFilteredView;
-  }
+  ArrayView<float> view = getNormalizedDeinterlacedSpan(gltf);
+  return {view.begin(), view.end()};
+}
 
+ArrayView<float>
+GltfAccessor::getNormalizedDeinterlacedSpan(const Gltf &gltf) {
   auto [data, size] = getDeinterlacedView(gltf);
-  if (data && componentType.has_value()) {
-    if (normalized) {
-      normalizedFilteredView = dequantize(data, size, componentType.value());
-    } else {
-      // 直接转换逻辑同 getNormalizedTypedView
-      int componentCount = getComponentCount();
-      int elementCount = count.value_or(0);
-      normalizedFilteredView.resize(elementCount * componentCount);
-
-      switch (componentType.value()) {
-        case GL_FLOAT:
-          std::memcpy(normalizedFilteredView.data(), data, size);
-          break;
-        case GL_BYTE: {
-          const int8_t *src = static_cast<const int8_t *>(data);
-          for (size_t i = 0; i < normalizedFilteredView.size(); ++i) {
-            normalizedFilteredView[i] = static_cast<float>(src[i]);
-          }
-        }
-          break;
-        case GL_UNSIGNED_BYTE: {
-          const uint8_t *src = static_cast<const uint8_t *>(data);
-          for (size_t i = 0; i < normalizedFilteredView.size(); ++i) {
-            normalizedFilteredView[i] = static_cast<float>(src[i]);
-          }
-        }
-          break;
-        case GL_SHORT: {
-          const int16_t *src = static_cast<const int16_t *>(data);
-          for (size_t i = 0; i < normalizedFilteredView.size(); ++i) {
-            normalizedFilteredView[i] = static_cast<float>(src[i]);
-          }
-        }
-          break;
-        case GL_UNSIGNED_SHORT: {
-          const uint16_t *src = static_cast<const uint16_t *>(data);
-          for (size_t i = 0; i < normalizedFilteredView.size(); ++i) {
-            normalizedFilteredView[i] = static_cast<float>(src[i]);
-          }
-        }
-          break;
-        case GL_UNSIGNED_INT: {
-          const uint32_t *src = static_cast<const uint32_t *>(data);
-          for (size_t i = 0; i < normalizedFilteredView.size(); ++i) {
-            normalizedFilteredView[i] = static_cast<float>(src[i]);
-          }
-        }
-          break;
-      }
+  return normalizeView(data, size, normalizedFilteredView,
+                       normalizedFilteredViewValid);
+}
+
+GltfAccessorView GltfAccessor::getView(const Gltf &gltf) {
+  GltfAccessorView view;
+  view.componentType = componentType.value_or(0);
+  view.componentCount = getComponentCount();
+  view.componentSize = getComponentSize();
+  view.normalized = normalized;
+  const size_t elementSize = view.elementSize();
+  if (elementSize == 0 || count.value_or(0) <= 0 || checkReleased()) {
+    return view;
+  }
+  const auto elementCount = static_cast<size_t>(count.value());
 
+  // 没有稀疏数据与解码数据时直接引用缓冲区, 避免去交错拷贝
+  if (!sparse.has_value() && decodedData.empty() && bufferView.has_value()) {
+    const auto &bufferViews = gltf.getBufferViews();
+    const auto &buffers = gltf.getBuffers();
+    const int viewIndex = bufferView.value();
+    const auto *bv = viewIndex >= 0 &&
+        viewIndex < static_cast<int>(bufferViews.size())
+                     ? bufferViews[viewIndex].get() : nullptr;
+    if (bv && bv->getBuffer().has_value()) {
+      const int bufferIndex = bv->getBuffer().value();
+      const auto *buffer = bufferIndex >= 0 &&
+          bufferIndex < static_cast<int>(buffers.size())
+                           ? buffers[bufferIndex].get() : nullptr;
+      const size_t stride = bv->getByteStride() > 0
+                            ? static_cast<size_t>(bv->getByteStride())
+                            : elementSize;
+      const size_t offset =
+          static_cast<size_t>(bv->getByteOffset()) + byteOffset;
+      if (buffer && buffer->getData() &&
+          offset + stride * (elementCount - 1) + elementSize <=
+              buffer->getActualSize()) {
+        view.data = buffer->getData() + offset;
+        view.count = elementCount;
+        view.byteStride = stride;
+        return view;
+      }
     }
   }
 
-  normalizedFilteredViewValid = true;
-  return normalizedFilteredView;
+  auto [data, size] = getDeinterlacedView(gltf);
+  view.data = static_cast<const uint8_t *>(data);
+  view.count = data ? std::min(elementCount, size / elementSize) : 0;
+  view.byteStride = elementSize;
+  return view;
 }
 
 int GltfAccessor::getByteStride(const Gltf &gltf) const {
+  // 解码数据紧密排列
+  if (!decodedData.empty()) {
+    return 0;
+  }
   if (bufferView.has_value()) {
     const auto &bufferViews = gltf.getBufferViews();
     if (bufferView.value() < static_cast<int>(bufferViews.size())) {
@@ -526,19 +516,19 @@ int GltfAccessor::getByteStride(const Gltf &gltf) const {
   return 0;
 }
 
-int GltfAccessor::getComponentCount() const {
-  if (type.has_value()) {
-    return AccessorTypeUtils::getComponentCount(type.value());
+void GltfAccessor::resolveLayout() {
+  if (type.has_value() && AccessorTypeUtils::isValidType(type.value())) {
+    resolvedType = AccessorTypeUtils::fromString(type.value());
+    componentCount = AccessorTypeUtils::getComponentCount(resolvedType);
+  } else {
+    resolvedType = AccessorType::SCALAR;
+    componentCount = 0;
   }
-  return 0;
+  componentSize = getComponentSize(componentType.value_or(0));
 }
 
-int GltfAccessor::getComponentSize() const {
-  if (!componentType.has_value()) {
-    return 0;
-  }
-
-  switch (componentType.value()) {
+int GltfAccessor::getComponentSize(int componentType) {
+  switch (componentType) {
     case GL_BYTE:
     case GL_UNSIGNED_BYTE:
       return 1;
@@ -553,10 +543,6 @@ int GltfAccessor::getComponentSize() const {
   }
 }
 
-int GltfAccessor::getElementSize() const {
-  return getComponentSize() * getComponentCount();
-}
-
 size_t GltfAccessor::getDataSize() const {
   if (count.has_value()) {
     return static_cast<size_t>(count.value()) * getElementSize();
@@ -571,65 +557,26 @@ GltfAccessor::dequantize(const void *data, size_t dataSize, int componentType) {
     return result;
   }
 
+  size_t componentSize = 0;
   switch (componentType) {
-    case GL_BYTE: {
-      size_t elementCount = dataSize / sizeof(int8_t);
-      result.reserve(elementCount);
-      const int8_t *src = static_cast<const int8_t *>(data);
-      for (size_t i = 0; i < elementCount; ++i) {
-        result.push_back(std::max(static_cast<float>(src[i]) / 127.0f, -1.0f));
-      }
-    }
-      break;
-    case GL_UNSIGNED_BYTE: {
-      size_t elementCount = dataSize / sizeof(uint8_t);
-      result.reserve(elementCount);
-      const uint8_t *src = static_cast<const uint8_t *>(data);
-      for (size_t i = 0; i < elementCount; ++i) {
-        result.push_back(static_cast<float>(src[i]) / 255.0f);
-      }
-    }
-      break;
-    case GL_SHORT: {
-      size_t elementCount = dataSize / sizeof(int16_t);
-      result.reserve(elementCount);
-      const int16_t *src = static_cast<const int16_t *>(data);
-      for (size_t i = 0; i < elementCount; ++i) {
-        result.push_back(std::max(static_cast<float>(src[i]) / 32767.0f,
-                                  -1.0f));
-      }
-    }
-      break;
-    case GL_UNSIGNED_SHORT: {
-      size_t elementCount = dataSize / sizeof(uint16_t);
-      result.reserve(elementCount);
-      const uint16_t *src = static_cast<const uint16_t *>(data);
-      for (size_t i = 0; i < elementCount; ++i) {
-        result.push_back(static_cast<float>(src[i]) / 65535.0f);
-      }
-    }
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+      componentSize = 1;
       break;
-    case GL_FLOAT: {
-      size_t elementCount = dataSize / sizeof(float);
-      result.reserve(elementCount);
-      const float *src = static_cast<const float *>(data);
-      result.assign(src, src + elementCount);
-    }
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+      componentSize = 2;
       break;
-    case GL_UNSIGNED_INT: {
-      size_t elementCount = dataSize / sizeof(uint32_t);
-      result.reserve(elementCount);
-      const uint32_t *src = static_cast<const uint32_t *>(data);
-      for (size_t i = 0; i < elementCount; ++i) {
-        result.push_back(static_cast<float>(src[i]));
-      }
-    }
+    case GL_UNSIGNED_INT:
+    case GL_FLOAT:
+      componentSize = 4;
       break;
     default:
       LOGW("Unsupported component type for dequantization: %d", componentType);
-      break;
+      return result;
   }
-
+  result.resize(dataSize / componentSize);
+  component::toFloat(data, componentType, true, result.data(), result.size());
   return result;
 }
 
@@ -650,11 +597,87 @@ bool GltfAccessor::isValidComponentType(int componentType) {
       componentType == GL_FLOAT;
 }
 
-void GltfAccessor::destroy() {
-  if (glBuffer != 0) {
-    glDeleteBuffers(1, &glBuffer);
-    glBuffer = 0;
+void GltfAccessor::setGLAllocation(std::unique_ptr<GltfBufferAllocation> allocation) {
+  glAllocation = std::move(allocation);
+}
+
+size_t GltfAccessor::settleRuntimeData(const Gltf &gltf) {
+  const int sourceType = componentType.value_or(0);
+  const bool hasSparse = sparse.has_value() && sparse->isValid();
+  bool keepReference = false;
+  if (sourceType == GL_FLOAT && !hasSparse && decodedData.empty() &&
+      bufferView.has_value()) {
+    // 映射的 GLB 由文件页支撑, 紧密 float 数据继续直接引用
+    const auto &bufferViews = gltf.getBufferViews();
+    const auto &buffers = gltf.getBuffers();
+    const int viewIndex = bufferView.value();
+    const auto *bv = viewIndex >= 0 &&
+        viewIndex < static_cast<int>(bufferViews.size())
+                     ? bufferViews[viewIndex].get() : nullptr;
+    if (bv && bv->getBuffer().has_value() &&
+        (bv->getByteStride() == 0 || bv->getByteStride() == static_cast<size_t>(getElementSize()))) {
+      const int bufferIndex = bv->getBuffer().value();
+      keepReference = bufferIndex >= 0 &&
+          bufferIndex < static_cast<int>(buffers.size()) &&
+          buffers[bufferIndex] && buffers[bufferIndex]->isExternal();
+    }
+  }
+
+  if (!keepReference && (sourceType != GL_FLOAT || hasSparse ||
+      decodedData.empty())) {
+    ArrayView<float> values = getNormalizedDeinterlacedSpan(gltf);
+    if (values.empty()) {
+      return releaseCachedViews();
+    }
+    std::vector<uint8_t> data(values.size() * sizeof(float));
+    std::memcpy(data.data(), values.data(), data.size());
+    decodedData = std::move(data);
+    sparse = std::nullopt;
+    if (sourceType != GL_FLOAT) {
+      componentType = GL_FLOAT;
+      normalized = false;
+      resolveLayout();
+      // 边界值是量化前的整数, 不再适用
+      min.clear();
+      max.clear();
+    }
   }
+  return releaseCachedViews();
+}
+
+size_t GltfAccessor::releaseCpuData() {
+  size_t released = releaseCachedViews() + decodedData.capacity();
+  std::vector<uint8_t>().swap(decodedData);
+  cpuDataReleased = true;
+  return released;
+}
+
+std::shared_ptr<GltfAccessor> GltfAccessor::cloneConverted() const {
+  auto cloned = std::make_shared<GltfAccessor>();
+  cloned->bufferView = bufferView;
+  cloned->byteOffset = byteOffset;
+  cloned->componentType = componentType;
+  cloned->normalized = normalized;
+  cloned->count = count;
+  cloned->type = type;
+  cloned->max = max;
+  cloned->min = min;
+  cloned->sparse = sparse;
+  cloned->name = name;
+  cloned->decodedData = decodedData;
+  cloned->resolveLayout();
+  return cloned;
+}
+
+size_t GltfAccessor::getCpuBytes() const {
+  return decodedData.capacity() + typedView.capacity() +
+      filteredView.capacity() +
+      (normalizedTypedView.capacity() + normalizedFilteredView.capacity()) *
+          sizeof(float);
+}
+
+void GltfAccessor::destroy() {
+  glAllocation.reset();
   clearCachedViews();
 }
 
@@ -669,6 +692,11 @@ void GltfAccessor::reset() {
   min.clear();
   sparse = std::nullopt;
   name = std::nullopt;
+  decodedData.clear();
+  glByteStride = 0;
+  residency = AccessorResidency::DEFAULT;
+  cpuDataReleased = false;
+  resolveLayout();
 
   destroy(); // 清理OpenGL资源
   clearCachedViews();
@@ -697,9 +725,12 @@ std::vector<uint8_t> GltfAccessor::createEmptyView() const {
 }
 
 void GltfAccessor::applySparse(const Gltf &gltf,
-                               void *view,
-                               size_t elementSize) const {
-  if (!sparse.has_value() || !sparse->isValid() || !view) {
+                               uint8_t *view,
+                               size_t viewSize,
+                               size_t stride) const {
+  const size_t elementSize = getElementSize();
+  if (!sparse.has_value() || !sparse->isValid() || !view || elementSize == 0 ||
+      stride < elementSize || viewSize < elementSize) {
     return;
   }
 
@@ -756,66 +787,81 @@ void GltfAccessor::applySparse(const Gltf &gltf,
     return;
   }
 
-  // 创建索引类型化数组
-  const auto &indicesBufferData = indicesBuffer->buffer;
-  int indicesByteOffset =
-      sparse->indices.byteOffset + indicesBufferView->getByteOffset();
-
-  std::vector<uint32_t> indices;
-  indices.reserve(sparse->count);
-
+  // 索引扩展为 32 位
+  size_t indexSize = 0;
   switch (sparse->indices.componentType) {
-    case GL_UNSIGNED_BYTE: {
-      const uint8_t *src =
-          reinterpret_cast<const uint8_t *>(indicesBufferData.data()
-              + indicesByteOffset);
-      for (int i = 0; i < sparse->count; ++i) {
-        indices.push_back(static_cast<uint32_t>(src[i]));
-      }
-    }
+    case GL_UNSIGNED_BYTE:
+      indexSize = 1;
       break;
-    case GL_UNSIGNED_SHORT: {
-      const uint16_t *src =
-          reinterpret_cast<const uint16_t *>(indicesBufferData.data()
-              + indicesByteOffset);
-      for (int i = 0; i < sparse->count; ++i) {
-        indices.push_back(static_cast<uint32_t>(src[i]));
-      }
-    }
+    case GL_UNSIGNED_SHORT:
+      indexSize = 2;
       break;
-    case GL_UNSIGNED_INT: {
-      const uint32_t *src =
-          reinterpret_cast<const uint32_t *>(indicesBufferData.data()
-              + indicesByteOffset);
-      for (int i = 0; i < sparse->count; ++i) {
-        indices.push_back(src[i]);
-      }
-    }
+    case GL_UNSIGNED_INT:
+      indexSize = 4;
       break;
     default:
       LOGE("Unsupported sparse indices component type: %d",
            sparse->indices.componentType);
       return;
   }
+  const auto sparseCount = static_cast<size_t>(sparse->count);
+  const size_t indicesByteOffset = static_cast<size_t>(
+      sparse->indices.byteOffset + indicesBufferView->getByteOffset());
+  const size_t valuesByteOffset = static_cast<size_t>(
+      sparse->values.byteOffset + valuesBufferView->getByteOffset());
+  if (!indicesBuffer->getData() || !valuesBuffer->getData() ||
+      indicesByteOffset + sparseCount * indexSize >
+          indicesBuffer->getActualSize() ||
+      valuesByteOffset + sparseCount * elementSize >
+          valuesBuffer->getActualSize()) {
+    LOGE("Sparse data of accessor '%s' out of range",
+         name.value_or("").c_str());
+    return;
+  }
 
-  // 获取值数据
-  const auto &valuesBufferData = valuesBuffer->buffer;
-  int valuesByteOffset =
-      sparse->values.byteOffset + valuesBufferView->getByteOffset();
-  const uint8_t *valuesData = valuesBufferData.data() + valuesByteOffset;
+  std::vector<uint32_t> indices(sparseCount);
+  component::widenIndices(indicesBuffer->getData() + indicesByteOffset,
+                          sparse->indices.componentType, indices.data(),
+                          sparseCount);
 
   // 应用稀疏值
-  uint8_t *viewData = static_cast<uint8_t *>(view);
-  for (int i = 0; i < sparse->count; ++i) {
-    uint32_t index = indices[i];
-    size_t srcOffset = i * elementSize;
-    size_t dstOffset = index * elementSize;
-
-    std::memcpy(viewData + dstOffset, valuesData + srcOffset, elementSize);
+  const size_t viewCount = (viewSize - elementSize) / stride + 1;
+  const size_t skipped = component::scatterElements(
+      valuesBuffer->getData() + valuesByteOffset, elementSize, indices.data(),
+      sparseCount, view, stride, viewCount);
+  if (skipped > 0) {
+    LOGW("Skipped %zu out-of-range sparse indices in accessor '%s'", skipped,
+         name.value_or("").c_str());
   }
 }
 
 
+ArrayView<float> GltfAccessor::normalizeView(const void *data, size_t size,
+                                             std::vector<float> &cache,
+                                             bool &cacheValid) const {
+  if (!data || !componentType.has_value()) {
+    return {};
+  }
+  // 浮点数据无需转换, 直接引用
+  if (componentType.value() == GL_FLOAT) {
+    return {static_cast<const float *>(data), size / sizeof(float)};
+  }
+  if (cacheValid) {
+    return cache;
+  }
+
+  const int componentSize = getComponentSize();
+  cache.resize(componentSize > 0 ? size / componentSize : 0);
+  if (!component::toFloat(data, componentType.value(), normalized,
+                          cache.data(), cache.size())) {
+    LOGW("Unsupported component type for conversion: %d",
+         componentType.value());
+    cache.clear();
+  }
+  cacheValid = true;
+  return cache;
+}
+
 void GltfAccessor::clearCachedViews() const {
   typedView.clear();
   filteredView.clear();
@@ -827,6 +873,26 @@ void GltfAccessor::clearCachedViews() const {
   normalizedFilteredViewValid = false;
 }
 
+size_t GltfAccessor::releaseCachedViews() const {
+  const size_t released = typedView.capacity() + filteredView.capacity() +
+      (normalizedTypedView.capacity() + normalizedFilteredView.capacity()) *
+          sizeof(float);
+  std::vector<uint8_t>().swap(typedView);
+  std::vector<uint8_t>().swap(filteredView);
+  std::vector<float>().swap(normalizedTypedView);
+  std::vector<float>().swap(normalizedFilteredView);
+  clearCachedViews();
+  return released;
+}
+
+bool GltfAccessor::checkReleased() const {
+  if (cpuDataReleased) {
+    LOGW("CPU data of accessor '%s' was released after upload",
+         name.value_or("").c_str());
+  }
+  return cpuDataReleased;
+}
+
 bool GltfAccessor::validateAccessor() const {
   // count 和 componentType 是必需的
   if (!count.has_value() || !componentType.has_value()) {
@@ -899,6 +965,7 @@ bool GltfAccessor::validateBounds() const {
 
 void GltfAccessor::setType(const std::optional<std::string> &type) {
   GltfAccessor::type = type;
+  resolveLayout();
 }
 
 const std::optional<std::string> &GltfAccessor::getType() const {
@@ -6,6 +6,7 @@
 #define LIGHTDIGITALHUMAN_GLTFACCESSOR_H
 
 #include "GltfObject.h"
+#include "GltfAccessorView.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -15,6 +16,8 @@
 
 namespace digitalhumans {
 
+class GltfBufferAllocation;
+
 /**
  * @brief 访问器类型枚举
  */
@@ -46,7 +49,15 @@ class AccessorTypeUtils {
  private:
   static const std::unordered_map<std::string, AccessorType> stringToEnum;
   static const std::unordered_map<AccessorType, std::string> enumToString;
-  static const std::unordered_map<AccessorType, int> componentCounts;
+};
+
+/**
+ * @brief 访问器 CPU 数据的驻留策略, 由转换器按引用关系设置
+ */
+enum class AccessorResidency {
+  DEFAULT,      ///< 没有被图元、动画或蒙皮引用, 数据按需读取
+  UPLOAD_ONLY,  ///< 只被图元或已编译的动画片段引用: 上传到 GPU 后释放全部 CPU 数据
+  RUNTIME       ///< 运行时在 CPU 读取（未编译的动画采样器、逆绑定矩阵）: 只保留一份 float 数据
 };
 
 /**
@@ -152,7 +163,10 @@ class GltfAccessor: public GltfObject {
 
   std::optional<int> getComponentType() const { return componentType; }
 
-  void setComponentType(int type) { componentType = type; }
+  void setComponentType(int type) {
+    componentType = type;
+    resolveLayout();
+  }
 
   bool hasComponentType() const { return componentType.has_value(); }
 
@@ -174,6 +188,12 @@ class GltfAccessor: public GltfObject {
 
   bool hasAccessorType() const { return type.has_value(); }
 
+  /**
+   * @brief 设置类型时解析的枚举, 没有类型或类型无效时为 SCALAR
+   * （此时 getComponentCount 为 0）
+   */
+  AccessorType getResolvedType() const { return resolvedType; }
+
   const std::vector<double> &getMax() const { return max; }
 
   void setMax(const std::vector<double> &maxValues) { max = maxValues; }
@@ -206,6 +226,49 @@ class GltfAccessor: public GltfObject {
 
   bool hasName() const { return name.has_value(); }
 
+  /**
+   * @brief 设置解码得到的数据（如 KHR_draco_mesh_compression）
+   *
+   * 数据按访问器类型紧密排列, 共 count 个元素, 作为没有 bufferView 的访问器的数据源,
+   * 类型化视图与去交错视图直接引用它。
+   */
+  void setDecodedData(std::vector<uint8_t> &&data);
+
+  bool hasDecodedData() const { return !decodedData.empty(); }
+
+  /**
+   * @brief 复制转换得到的描述与解码数据, 不复制 GL 分配、驻留策略与缓存视图
+   *
+   * 用于从缓存的转换结果创建新实例的访问器。
+   */
+  std::shared_ptr<GltfAccessor> cloneConverted() const;
+
+  AccessorResidency getResidency() const { return residency; }
+
+  void setResidency(AccessorResidency policy) { residency = policy; }
+
+  /**
+   * @brief 把运行时访问器整理为唯一的紧密 float 数据
+   *
+   * 量化、交错或稀疏数据转换后写入解码数据, 量化数据的边界值不再适用, 一并清除;
+   * 引用外部内存（映射的 GLB）的紧密 float 数据保持直接引用。整理后释放全部缓存视图。
+   * @return 释放的缓存字节数
+   */
+  size_t settleRuntimeData(const Gltf &gltf);
+
+  /**
+   * @brief 释放全部 CPU 数据（缓存视图与解码数据）, 之后读取数据的接口返回空
+   * @return 释放的字节数
+   */
+  size_t releaseCpuData();
+
+  bool isCpuDataReleased() const { return cpuDataReleased; }
+
+  /**
+   * @brief 访问器持有的 CPU 数据字节数（缓存视图与解码数据的容量）
+   */
+  size_t getCpuBytes() const;
+
   /**
    * @brief 获取类型化视图（直接用于OpenGL）
    * @param gltf glTF根对象
@@ -216,10 +279,19 @@ class GltfAccessor: public GltfObject {
   /**
    * @brief 获取标准化类型化视图（用于动画等）
    * @param gltf glTF根对象
-   * @return 标准化后的float数组
+   * @return 标准化后的float数组（getNormalizedTypedSpan 的拷贝）
    */
   std::vector<float> getNormalizedTypedView(const Gltf &gltf);
 
+  /**
+   * @brief 获取标准化类型化视图, 不拷贝
+   *
+   * 浮点访问器直接引用类型化视图, 其他类型引用转换后的缓存。
+   * @param gltf glTF根对象
+   * @return 在缓存失效前有效的只读视图
+   */
+  ArrayView<float> getNormalizedTypedSpan(const Gltf &gltf);
+
   /**
    * @brief 获取去交错视图（去除填充和无关组件）
    * @param gltf glTF根对象
@@ -230,10 +302,27 @@ class GltfAccessor: public GltfObject {
   /**
    * @brief 获取标准化去交错视图
    * @param gltf glTF根对象
-   * @return 标准化去交错后的float数组
+   * @return 标准化去交错后的float数组（getNormalizedDeinterlacedSpan 的拷贝）
    */
   std::vector<float> getNormalizedDeinterlacedView(const Gltf &gltf);
 
+  /**
+   * @brief 获取标准化去交错视图, 不拷贝, 供逐帧的动画、蒙皮路径使用
+   * @param gltf glTF根对象
+   * @return 在缓存失效前有效的只读视图
+   */
+  ArrayView<float> getNormalizedDeinterlacedSpan(const Gltf &gltf);
+
+  /**
+   * @brief 获取按元素步长访问的只读视图
+   *
+   * 没有稀疏数据与解码数据时直接引用缓冲区（包括内存映射的 GLB）, 保留交错布局;
+   * 否则引用去交错视图缓存。
+   * @param gltf glTF根对象
+   * @return 访问器元素视图, 数据无效时为空
+   */
+  GltfAccessorView getView(const Gltf &gltf);
+
   /**
    * @brief 获取字节步长
    * @param gltf glTF根对象
@@ -242,22 +331,27 @@ class GltfAccessor: public GltfObject {
   int getByteStride(const Gltf &gltf) const;
 
   /**
-   * @brief 获取组件数量
+   * @brief 获取组件数量（设置类型时已解析）
    * @return 组件数量
    */
-  int getComponentCount() const;
+  int getComponentCount() const { return componentCount; }
 
   /**
-   * @brief 获取组件大小（字节）
+   * @brief 获取组件大小（字节, 设置组件类型时已解析）
    * @return 组件大小
    */
-  int getComponentSize() const;
+  int getComponentSize() const { return componentSize; }
 
   /**
    * @brief 获取元素大小（字节）
    * @return 元素大小
    */
-  int getElementSize() const;
+  int getElementSize() const { return componentSize * componentCount; }
+
+  /**
+   * @brief GL 组件类型的字节数, 无效类型返回 0
+   */
+  static int getComponentSize(int componentType);
 
   /**
    * @brief 获取总数据大小（字节）
@@ -294,16 +388,24 @@ class GltfAccessor: public GltfObject {
   static bool isValidComponentType(int componentType);
 
   /**
-   * @brief 获取OpenGL缓冲区对象
-   * @return 缓冲区ID
+   * @brief 获取上传后在缓冲区域中的分配
+   * @return 尚未上传时返回 nullptr
+   */
+  const GltfBufferAllocation *getGLAllocation() const {
+    return glAllocation.get();
+  }
+
+  /**
+   * @brief 设置缓冲区域中的分配, 原有分配归还区域
    */
-  unsigned int getGLBuffer() const { return glBuffer; }
+  void setGLAllocation(std::unique_ptr<GltfBufferAllocation> allocation);
 
   /**
-   * @brief 设置OpenGL缓冲区对象
-   * @param buffer 缓冲区ID
+   * @brief 上传时记录的字节步长, CPU 数据释放后仍用于设置顶点属性
    */
-  void setGLBuffer(unsigned int buffer) { glBuffer = buffer; }
+  int getGLByteStride() const { return glByteStride; }
+
+  void setGLByteStride(int stride) { glByteStride = stride; }
 
   /**
    * @brief 清理OpenGL资源
@@ -344,8 +446,17 @@ class GltfAccessor: public GltfObject {
   std::optional<GltfSparse> sparse;   ///< 稀疏数据
   std::optional<std::string> name;    ///< 访问器名称
 
+  // 类型与组件类型变化时解析, 查询时不再解析字符串
+  AccessorType resolvedType = AccessorType::SCALAR; ///< 解析后的访问器类型
+  int componentCount = 0;             ///< 每个元素的分量数
+  int componentSize = 0;              ///< 每个分量的字节数
+
   // 非glTF属性（运行时数据）
-  unsigned int glBuffer = 0;                      ///< OpenGL缓冲区对象
+  std::unique_ptr<GltfBufferAllocation> glAllocation; ///< 缓冲区域中的分配
+  int glByteStride = 0;                           ///< 上传数据的字节步长
+  AccessorResidency residency = AccessorResidency::DEFAULT; ///< 驻留策略
+  bool cpuDataReleased = false;                   ///< CPU 数据是否已释放
+  std::vector<uint8_t> decodedData;               ///< 解码得到的数据（不是缓存）
   mutable std::vector<uint8_t> typedView;         ///< 缓存的类型化视图
   mutable std::vector<uint8_t> filteredView;      ///< 缓存的过滤视图
   mutable std::vector<float> normalizedTypedView; ///< 缓存的标准化类型化视图
@@ -365,15 +476,43 @@ class GltfAccessor: public GltfObject {
    * @brief 应用稀疏数据
    * @param gltf glTF根对象
    * @param view 目标视图
+   * @param viewSize 目标视图的字节数
+   * @param stride 目标视图中相邻元素的字节间隔
    */
-  void applySparse(const Gltf &gltf, void *view, size_t elementSize) const;
+  void applySparse(const Gltf &gltf, uint8_t *view, size_t viewSize,
+                   size_t stride) const;
+
 
+  /**
+   * @brief 将类型化数据转换为标准化的 float 视图
+   * @param cache 非浮点数据的转换缓存
+   * @param cacheValid 缓存是否有效
+   */
+  ArrayView<float> normalizeView(const void *data, size_t size,
+                                 std::vector<float> &cache,
+                                 bool &cacheValid) const;
 
   /**
    * @brief 清理缓存的视图
    */
   void clearCachedViews() const;
 
+  /**
+   * @brief 清理缓存的视图并归还内存
+   * @return 释放的字节数
+   */
+  size_t releaseCachedViews() const;
+
+  /**
+   * @brief 数据已释放时记录警告
+   */
+  bool checkReleased() const;
+
+  /**
+   * @brief 由类型字符串与组件类型解析分量数与字节数
+   */
+  void resolveLayout();
+
   /**
    * @brief 验证访问器完整性
    * @return true如果数据完整
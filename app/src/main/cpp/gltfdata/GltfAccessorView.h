@@ -0,0 +1,101 @@
+//
+// Created by vincentsyan on 2025/10/11.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFACCESSORVIEW_H
+#define LIGHTDIGITALHUMAN_GLTFACCESSORVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace digitalhumans {
+
+/**
+ * @brief 只读的连续数组视图, 不持有数据（相当于 C++20 的 std::span<const T>）
+ */
+template<typename T>
+class ArrayView {
+ public:
+  ArrayView() = default;
+
+  ArrayView(const T *data, size_t size) : data_(data), size_(size) {}
+
+  ArrayView(const std::vector<T> &values)
+      : data_(values.data()), size_(values.size()) {}
+
+  const T *data() const { return data_; }
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  const T &operator[](size_t index) const { return data_[index]; }
+
+  const T *begin() const { return data_; }
+
+  const T *end() const { return data_ + size_; }
+
+  const T &front() const { return data_[0]; }
+
+  const T &back() const { return data_[size_ - 1]; }
+
+ private:
+  const T *data_ = nullptr;
+  size_t size_ = 0;
+};
+
+/**
+ * @brief 访问器元素的只读视图, 按 byteStride 跨越元素
+ *
+ * 指向访问器的缓存或缓冲区（包括内存映射的 GLB）, 在访问器缓存失效
+ * 或缓冲区释放前有效。
+ */
+struct GltfAccessorView {
+  const uint8_t *data = nullptr;  ///< 第一个元素的地址
+  size_t count = 0;               ///< 元素数量
+  size_t byteStride = 0;          ///< 相邻元素的字节间隔
+  int componentType = 0;          ///< 组件类型（GL 枚举）
+  int componentCount = 0;         ///< 每个元素的组件数量
+  int componentSize = 0;          ///< 组件字节数
+  bool normalized = false;
+
+  bool empty() const { return data == nullptr || count == 0; }
+
+  size_t elementSize() const {
+    return static_cast<size_t>(componentCount) * componentSize;
+  }
+
+  /**
+   * @brief 元素之间没有填充, 可以作为连续数组读取
+   */
+  bool isTightlyPacked() const { return byteStride == elementSize(); }
+
+  const uint8_t *element(size_t index) const {
+    return data + index * byteStride;
+  }
+
+  /**
+   * @brief 以组件类型读取第 index 个元素
+   */
+  template<typename T>
+  const T *elementAs(size_t index) const {
+    return reinterpret_cast<const T *>(element(index));
+  }
+
+  /**
+   * @brief 紧密排列时作为组件数组读取, 否则返回空视图
+   */
+  template<typename T>
+  ArrayView<T> components() const {
+    if (empty() || !isTightlyPacked() ||
+        sizeof(T) != static_cast<size_t>(componentSize)) {
+      return {};
+    }
+    return {reinterpret_cast<const T *>(data), count * componentCount};
+  }
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFACCESSORVIEW_H
@@ -5,7 +5,9 @@
 #include "GltfAnimation.h"
 
 #include "../utils/utils.h"
+#include <cmath>
 #include <sstream>
+#include <unordered_map>
 #include <algorithm>
 #include <regex>
 #include "../utils/LogUtils.h"
@@ -27,8 +29,20 @@ GltfAnimation::GltfAnimation()
 
 
 void GltfAnimation::initGl(std::shared_ptr<Gltf> gltf,
-                           std::shared_ptr<GltfOpenGLContext> openGlContext) {
+                           std::shared_ptr<GltfOpenGLContext> openGlContext,
+                           const GltfAnimationCompression &compression) {
   initializeInterpolators();
+  if (gltf) {
+    clip = GltfAnimationClip::compile(*gltf, *this, compression);
+    if (clip) {
+      maxTime = clip->getDuration();
+      // 未编译的通道仍由插值器播放, 时长取全部通道的最大值
+      if (!clip->getUncompiledChannels().empty()) {
+        maxTime = std::max(maxTime, calculateMaxTime(gltf));
+      }
+      keyframeCursors.assign(clip->getCursorCount(), GltfKeyframeCursor());
+    }
+  }
 }
 
 
@@ -52,6 +66,8 @@ std::shared_ptr<GltfAnimation> GltfAnimation::clone() const {
   cloned->name = name;
   cloned->maxTime = maxTime;
   cloned->errors = errors;
+  cloned->clip = clip;
+  cloned->keyframeCursors.assign(keyframeCursors.size(), GltfKeyframeCursor());
 
   // 重新初始化插值器
   cloned->initializeInterpolators();
@@ -151,14 +167,30 @@ void GltfAnimation::advance(std::shared_ptr<GltfState> state,
     return;
   }
 
-  // 计算最大时间（如果还未计算）
-  if (maxTime == 0.0f) {
+  // 计算最大时间（如果还未计算）, 片段的时长在编译时已确定
+  if (maxTime == 0.0f && !clip) {
     maxTime = calculateMaxTime(gltf);
   }
   loopCount = time;
   if (startTime == 0.0f) {
     startTime = getCurrentTime();
   }
+  if (clip) {
+    if (!advanceClip(*state, *gltf, totalTime.value())) {
+      state->removeAnimationIndex(index);
+      return;
+    }
+    // 片段未编译的通道（指针动画等）逐通道插值
+    const auto &uncompiled = clip->getUncompiledChannels();
+    for (const uint32_t channel: uncompiled) {
+      if (!processChannel(gltf, channel, totalTime.value())) {
+        state->removeAnimationIndex(index);
+        return;
+      }
+    }
+    state->getAnimationLod().recordChannels(uncompiled.size(), 0);
+    return;
+  }
   // 处理每个动画通道
   for (size_t i = 0; i < channels.size() && i < interpolators.size(); ++i) {
     bool stop = processChannel(gltf, i, totalTime.value());
@@ -167,6 +199,7 @@ void GltfAnimation::advance(std::shared_ptr<GltfState> state,
       return;
     }
   }
+  state->getAnimationLod().recordChannels(channels.size(), 0);
 }
 
 void GltfAnimation::reset(std::shared_ptr<Gltf> gltf) {
@@ -270,7 +303,7 @@ float GltfAnimation::calculateMaxTime(std::shared_ptr<Gltf> gltf) {
 }
 
 float GltfAnimation::getDuration(std::shared_ptr<Gltf> gltf) {
-  if (maxTime == 0.0f) {
+  if (maxTime == 0.0f && !clip) {
     maxTime = calculateMaxTime(gltf);
   }
   return maxTime;
@@ -408,8 +441,21 @@ void GltfAnimation::initializeInterpolators() {
   interpolators.clear();
   interpolators.reserve(channels.size());
 
-  for (size_t i = 0; i < channels.size(); ++i) {
-    interpolators.push_back(std::make_shared<GltfInterpolator>());
+  // 使用同一输入访问器的通道共用关键帧游标
+  std::unordered_map<int, std::shared_ptr<GltfKeyframeCursor>> cursors;
+  for (const auto &channel: channels) {
+    auto interpolator = std::make_shared<GltfInterpolator>();
+    const int samplerIndex =
+        channel && channel->hasSampler() ? channel->getSampler().value() : -1;
+    if (samplerIndex >= 0 && samplerIndex < static_cast<int>(samplers.size()) &&
+        samplers[samplerIndex] && samplers[samplerIndex]->hasInput()) {
+      auto &cursor = cursors[samplers[samplerIndex]->getInput().value()];
+      if (!cursor) {
+        cursor = interpolator->getCursor();
+      }
+      interpolator->setCursor(cursor);
+    }
+    interpolators.push_back(interpolator);
   }
 }
 
@@ -549,7 +595,7 @@ bool GltfAnimation::processChannel(std::shared_ptr<Gltf> gltf,
   float loopTime = fmod(totalTime, maxTime);
 
   // 执行插值
-  std::vector<float> interpolant = interpolator->interpolate(
+  ArrayView<float> interpolant = interpolator->interpolate(
       gltf, channel, sampler, loopTime, stride, maxTime);
 
   if (interpolant.empty()) {
@@ -560,6 +606,31 @@ bool GltfAnimation::processChannel(std::shared_ptr<Gltf> gltf,
   return true;
 }
 
+bool GltfAnimation::advanceClip(GltfState &state, Gltf &gltf, float totalTime) {
+  GltfAnimationPose &pose = state.getAnimationPose();
+  if (!pose.isBoundTo(gltf)) {
+    pose.reset(gltf);
+  }
+  if (shouldAnimationStop(getCurrentTime() - startTime)) {
+    startTime = 0.0f;
+    LOGI("🏁 动画完成: %s", getName().c_str());
+    // 有限循环停在最后一帧
+    if (loopCount != -1) {
+      clip->sample(maxTime, pose);
+      pose.apply(gltf);
+    }
+    return false;
+  }
+  // 动画 LOD 跳过的节点属性保持最后一次写入的值
+  GltfAnimationLod &lod = state.getAnimationLod();
+  const size_t sampled =
+      clip->sample(maxTime > 0.0f ? std::fmod(totalTime, maxTime) : 0.0f, pose,
+                   keyframeCursors.data(), lod.getSkipMask());
+  lod.recordChannels(sampled, clip->getTracks().size() - sampled);
+  pose.apply(gltf);
+  return true;
+}
+
 // 处理动画完成
 void GltfAnimation::handleAnimationComplete(std::shared_ptr<Gltf> gltf,
                                             const GltfAnimationTarget &target) {
@@ -575,7 +646,7 @@ void GltfAnimation::handleAnimationComplete(std::shared_ptr<Gltf> gltf,
 // 直接应用动画到目标对象
 void GltfAnimation::applyAnimationToTarget(std::shared_ptr<Gltf> gltf,
                                            const GltfAnimationTarget &target,
-                                           const std::vector<float> &interpolant) {
+                                           ArrayView<float> interpolant) {
 //        if (!target.getPath()) {
 //            return;
 //        }
@@ -613,10 +684,10 @@ void GltfAnimation::applyAnimationToTarget(std::shared_ptr<Gltf> gltf,
 
     case InterpolationPath::WEIGHTS: {
       // 设置morph target权重
-      std::vector<double> weights(interpolant.begin(), interpolant.end());
-      LOGW("Unsupported animation path=======: %f", weights[0]);
+      weightsBuffer.assign(interpolant.begin(), interpolant.end());
+      LOGW("Unsupported animation path=======: %f", weightsBuffer[0]);
 
-      targetNode->setWeights(weights);
+      targetNode->setWeights(weightsBuffer);
       break;
     }
 
@@ -734,7 +805,7 @@ void GltfAnimation::setToFinalFrame(std::shared_ptr<Gltf> gltf,
         auto interpolator = interpolators[i];
         int stride = getPropertyStride(target.getPath());
         // 使用maxTime获取最终状态
-        std::vector<float> finalInterpolant = interpolator->interpolate(
+        ArrayView<float> finalInterpolant = interpolator->interpolate(
             gltf, channel, sampler, maxTime, stride, maxTime);
 
         if (!finalInterpolant.empty()) {
@@ -10,9 +10,11 @@
 #include <memory>
 #include <optional>
 #include <unordered_set>
+#include <chrono>
 #include "GltfAnimationChannel.h"
 #include "GltfAnimationSampler.h"
 #include "GltfInterpolator.h"
+#include "GltfAnimationClip.h"
 
 namespace digitalhumans {
 class GltfState;
@@ -224,6 +226,19 @@ class GltfAnimation: public GltfObject {
    */
   float getMaxTime() const { return maxTime; }
 
+  /**
+   * @brief 获取编译后的动画片段
+   * @return 没有可编译的通道时返回nullptr, 此时逐通道插值
+   */
+  std::shared_ptr<const GltfAnimationClip> getClip() const { return clip; }
+
+  /**
+   * @brief 获取片段的关键帧游标
+   * @return 关键帧游标列表, 与片段的时间数组一一对应
+   */
+  const std::vector<GltfKeyframeCursor> &
+  getKeyframeCursors() const { return keyframeCursors; }
+
   /**
    * @brief 获取动画描述信息
    * @return 描述信息字符串
@@ -247,8 +262,13 @@ class GltfAnimation: public GltfObject {
                std::optional<float> totalTime,
                int time,
                int index);
+  /**
+   * @brief 初始化插值器并编译动画片段
+   * @param compression 片段的关键帧压缩参数
+   */
   void initGl(std::shared_ptr<Gltf> gltf,
-              std::shared_ptr<GltfOpenGLContext> openGlContext);
+              std::shared_ptr<GltfOpenGLContext> openGlContext,
+              const GltfAnimationCompression &compression = GltfAnimationCompression());
 
  private:
   /**
@@ -266,6 +286,15 @@ class GltfAnimation: public GltfObject {
                       size_t channelIndex,
                       float totalTime);
 
+  /**
+   * @brief 采样编译后的片段写入状态的姿态缓冲并写回节点
+   * @param state 动画状态
+   * @param gltf glTF根对象
+   * @param totalTime 动画时间
+   * @return 动画结束时返回false
+   */
+  bool advanceClip(GltfState &state, Gltf &gltf, float totalTime);
+
   GltfAnimationTarget getAnimationTarget(std::shared_ptr<Gltf> gltf,
                                          std::shared_ptr<GltfAnimationChannel> channel) const;
 
@@ -286,7 +315,7 @@ class GltfAnimation: public GltfObject {
 
   void applyAnimationToTarget(std::shared_ptr<Gltf> gltf,
                               const GltfAnimationTarget &target,
-                              const std::vector<float> &interpolant);
+                              ArrayView<float> interpolant);
 
 
   /**
@@ -307,6 +336,9 @@ class GltfAnimation: public GltfObject {
 
   // 非glTF标准属性
   std::vector<std::shared_ptr<GltfInterpolator>> interpolators;       ///< 插值器列表
+  std::shared_ptr<const GltfAnimationClip> clip;                      ///< 编译后的动画片段, 克隆间共享
+  std::vector<GltfKeyframeCursor> keyframeCursors;                    ///< 片段的关键帧游标, 每个播放实例一份
+  std::vector<double> weightsBuffer;                                  ///< 权重动画结果, 逐帧复用
   float maxTime;                                                      ///< 最大时间
   std::vector<std::shared_ptr<GltfAnimation>>
       disjointAnimations;     ///< 分离的动画列表
@@ -0,0 +1,801 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#include "GltfAnimationClip.h"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <unordered_map>
+#include "Gltf.h"
+#include "GltfAccessor.h"
+#include "GltfAnimation.h"
+#include "GltfMesh.h"
+#include "GltfNode.h"
+#include "GltfPrimitive.h"
+#include "../utils/LogUtils.h"
+
+#if defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define DH_ANIMATION_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define DH_ANIMATION_SSE2 1
+#endif
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr float kSlerpLinearThreshold = 0.9995f;
+
+/**
+ * @brief out = a * wa + b * wb
+ */
+void blend(const float *a, float wa, const float *b, float wb, float *out,
+           size_t count) {
+  size_t i = 0;
+#if defined(DH_ANIMATION_NEON)
+  const float32x4_t va = vdupq_n_f32(wa);
+  const float32x4_t vb = vdupq_n_f32(wb);
+  for (; i + 4 <= count; i += 4) {
+    vst1q_f32(out + i, vaddq_f32(vmulq_f32(vld1q_f32(a + i), va),
+                                 vmulq_f32(vld1q_f32(b + i), vb)));
+  }
+#elif defined(DH_ANIMATION_SSE2)
+  const __m128 va = _mm_set1_ps(wa);
+  const __m128 vb = _mm_set1_ps(wb);
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a + i), va),
+                                      _mm_mul_ps(_mm_loadu_ps(b + i), vb)));
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = a[i] * wa + b[i] * wb;
+  }
+}
+
+/**
+ * @brief 三次 Hermite 样条, 切线系数已乘以关键帧时间差
+ * @param v0 前一关键帧的值
+ * @param b 前一关键帧的出切线
+ * @param v1 后一关键帧的值
+ * @param a 后一关键帧的入切线
+ */
+void hermite(const float *v0, const float *b, const float *v1, const float *a,
+             float keyDelta, float t, float *out, size_t count) {
+  const float tSq = t * t;
+  const float tCub = tSq * t;
+  const float h00 = 2 * tCub - 3 * tSq + 1;
+  const float h10 = (tCub - 2 * tSq + t) * keyDelta;
+  const float h01 = -2 * tCub + 3 * tSq;
+  const float h11 = (tCub - tSq) * keyDelta;
+  size_t i = 0;
+#if defined(DH_ANIMATION_NEON)
+  const float32x4_t c00 = vdupq_n_f32(h00);
+  const float32x4_t c10 = vdupq_n_f32(h10);
+  const float32x4_t c01 = vdupq_n_f32(h01);
+  const float32x4_t c11 = vdupq_n_f32(h11);
+  for (; i + 4 <= count; i += 4) {
+    const float32x4_t lhs = vaddq_f32(vmulq_f32(vld1q_f32(v0 + i), c00),
+                                      vmulq_f32(vld1q_f32(b + i), c10));
+    const float32x4_t rhs = vaddq_f32(vmulq_f32(vld1q_f32(v1 + i), c01),
+                                      vmulq_f32(vld1q_f32(a + i), c11));
+    vst1q_f32(out + i, vaddq_f32(lhs, rhs));
+  }
+#elif defined(DH_ANIMATION_SSE2)
+  const __m128 c00 = _mm_set1_ps(h00);
+  const __m128 c10 = _mm_set1_ps(h10);
+  const __m128 c01 = _mm_set1_ps(h01);
+  const __m128 c11 = _mm_set1_ps(h11);
+  for (; i + 4 <= count; i += 4) {
+    const __m128 lhs = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(v0 + i), c00),
+                                  _mm_mul_ps(_mm_loadu_ps(b + i), c10));
+    const __m128 rhs = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(v1 + i), c01),
+                                  _mm_mul_ps(_mm_loadu_ps(a + i), c11));
+    _mm_storeu_ps(out + i, _mm_add_ps(lhs, rhs));
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = (v0[i] * h00 + b[i] * h10) + (v1[i] * h01 + a[i] * h11);
+  }
+}
+
+/**
+ * @brief 四元数归一化, 长度接近 0 时置为单位四元数
+ */
+void normalizeQuat(float *q) {
+  const float length =
+      std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+  if (length < 1e-6f) {
+    q[0] = q[1] = q[2] = 0.0f;
+    q[3] = 1.0f;
+    return;
+  }
+  const float inverse = 1.0f / length;
+#if defined(DH_ANIMATION_NEON)
+  vst1q_f32(q, vmulq_f32(vld1q_f32(q), vdupq_n_f32(inverse)));
+#elif defined(DH_ANIMATION_SSE2)
+  _mm_storeu_ps(q, _mm_mul_ps(_mm_loadu_ps(q), _mm_set1_ps(inverse)));
+#else
+  for (int i = 0; i < 4; ++i) {
+    q[i] *= inverse;
+  }
+#endif
+}
+
+/**
+ * @brief 已归一化四元数的球面线性插值, 走最短路径
+ */
+void slerp(const float *q0, const float *q1, float t, float *out) {
+  float dot = q0[0] * q1[0] + q0[1] * q1[1] + q0[2] * q1[2] + q0[3] * q1[3];
+  float sign = 1.0f;
+  if (dot < 0.0f) {
+    sign = -1.0f;
+    dot = -dot;
+  }
+  float s0 = 1.0f - t;
+  float s1 = t;
+  // 夹角很小时退化为线性插值, 避免除以接近 0 的 sin
+  if (dot <= kSlerpLinearThreshold) {
+    const float theta0 = std::acos(dot);
+    const float sinTheta0 = std::sin(theta0);
+    const float theta = theta0 * t;
+    const float sinTheta = std::sin(theta);
+    s0 = std::cos(theta) - dot * sinTheta / sinTheta0;
+    s1 = sinTheta / sinTheta0;
+  }
+  blend(q0, s0, q1, s1 * sign, out, 4);
+  normalizeQuat(out);
+}
+
+float *poseTarget(GltfAnimationPose &pose, const GltfAnimationTrack &track) {
+  switch (track.path) {
+    case InterpolationPath::TRANSLATION:
+      return pose.translation(track.node);
+    case InterpolationPath::ROTATION:
+      return pose.rotation(track.node);
+    case InterpolationPath::SCALE:
+      return pose.scale(track.node);
+    default:
+      return pose.weights(track.node);
+  }
+}
+
+PoseChannel poseChannel(InterpolationPath path) {
+  switch (path) {
+    case InterpolationPath::TRANSLATION:
+      return POSE_TRANSLATION;
+    case InterpolationPath::ROTATION:
+      return POSE_ROTATION;
+    case InterpolationPath::SCALE:
+      return POSE_SCALE;
+    default:
+      return POSE_WEIGHTS;
+  }
+}
+
+/**
+ * @brief 访问器的标准化 float 数据, 下标无效时返回空
+ */
+ArrayView<float> floatData(const Gltf &gltf, const std::optional<int> &index) {
+  const auto &accessors = gltf.getAccessors();
+  if (!index.has_value() || index.value() < 0 ||
+      index.value() >= static_cast<int>(accessors.size()) ||
+      !accessors[index.value()]) {
+    return {};
+  }
+  return accessors[index.value()]->getNormalizedDeinterlacedSpan(gltf);
+}
+
+
+constexpr size_t kDecodeChunk = 16;         ///< 量化轨道逐块解码的分量数
+constexpr size_t kMaxReductionSpan = 256;   ///< 删除关键帧时一段最多跨越的关键帧数
+constexpr float kQuatRange = 0.70710678f;   ///< 最小三分量的取值范围 [-1/√2, 1/√2]
+constexpr float kQuatSteps = 32767.0f;      ///< 15 位量化
+constexpr float kRangeSteps = 65535.0f;     ///< 16 位量化
+
+/**
+ * @brief 最小三分量编码: 省略绝对值最大的分量（取正后由单位长度恢复）
+ */
+void encodeQuat(const float *q, uint16_t *out) {
+  size_t largest = 0;
+  for (size_t i = 1; i < 4; ++i) {
+    if (std::abs(q[i]) > std::abs(q[largest])) {
+      largest = i;
+    }
+  }
+  const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+  size_t slot = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    if (i != largest) {
+      const float v = std::clamp(q[i] * sign / kQuatRange, -1.0f, 1.0f);
+      out[slot++] = static_cast<uint16_t>(std::lround((v * 0.5f + 0.5f) * kQuatSteps));
+    }
+  }
+  out[0] |= static_cast<uint16_t>((largest & 1) << 15);
+  out[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+}
+
+void decodeQuat(const uint16_t *in, float *q) {
+  const size_t largest = (in[0] >> 15) | ((in[1] >> 15) << 1);
+  float sum = 0.0f;
+  size_t slot = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    if (i != largest) {
+      const float v = static_cast<float>(in[slot++] & 0x7FFF) / kQuatSteps;
+      q[i] = (v * 2.0f - 1.0f) * kQuatRange;
+      sum += q[i] * q[i];
+    }
+  }
+  q[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+}
+
+/**
+ * @brief out = minimum + in * step
+ */
+void dequantize(const uint16_t *in, const float *minimum, const float *step,
+                float *out, size_t count) {
+  size_t i = 0;
+#if defined(DH_ANIMATION_NEON)
+  for (; i + 4 <= count; i += 4) {
+    const float32x4_t q = vcvtq_f32_u32(vmovl_u16(vld1_u16(in + i)));
+    vst1q_f32(out + i, vaddq_f32(vld1q_f32(minimum + i),
+                                 vmulq_f32(q, vld1q_f32(step + i))));
+  }
+#elif defined(DH_ANIMATION_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 4 <= count; i += 4) {
+    const __m128i q16 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + i));
+    const __m128 q = _mm_cvtepi32_ps(_mm_unpacklo_epi16(q16, zero));
+    _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(minimum + i),
+                                      _mm_mul_ps(q, _mm_loadu_ps(step + i))));
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = minimum[i] + static_cast<float>(in[i]) * step[i];
+  }
+}
+
+/**
+ * @brief 两个关键帧值的误差, 与 GltfAnimationCompression 的容差同单位
+ */
+float keyError(InterpolationPath path, const float *a, const float *b,
+               size_t count) {
+  if (path == InterpolationPath::ROTATION) {
+    // 单位四元数的差的长度约为夹角的一半
+    const float dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    const float sign = dot < 0.0f ? -1.0f : 1.0f;
+    float sum = 0.0f;
+    for (size_t i = 0; i < 4; ++i) {
+      const float d = a[i] - sign * b[i];
+      sum += d * d;
+    }
+    return 2.0f * std::sqrt(sum);
+  }
+  if (path == InterpolationPath::TRANSLATION) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+      sum += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+    return std::sqrt(sum);
+  }
+  float error = 0.0f;
+  for (size_t i = 0; i < count; ++i) {
+    error = std::max(error, std::abs(a[i] - b[i]));
+  }
+  return error;
+}
+
+} // namespace
+
+void GltfAnimationPose::reset(const Gltf &gltf) {
+  nodeCount = gltf.getNodes().size();
+  trs.assign(nodeCount * kNodeStride, 0.0f);
+  weightOffsets.assign(nodeCount, 0);
+  weightCounts.assign(nodeCount, 0);
+  size_t totalWeights = 0;
+  size_t maxWeights = 0;
+  for (size_t i = 0; i < nodeCount; ++i) {
+    const size_t capacity = weightCapacity(gltf, static_cast<int>(i));
+    weightOffsets[i] = static_cast<uint32_t>(totalWeights);
+    totalWeights += capacity;
+    maxWeights = std::max(maxWeights, capacity);
+  }
+  weightValues.assign(totalWeights, 0.0f);
+  written.assign(nodeCount, 0);
+  touched.clear();
+  touched.reserve(nodeCount);
+  weightScratch.clear();
+  weightScratch.reserve(maxWeights);
+  bound = &gltf;
+}
+
+void GltfAnimationPose::clear() {
+  nodeCount = 0;
+  std::vector<float>().swap(trs);
+  std::vector<float>().swap(weightValues);
+  std::vector<uint32_t>().swap(weightOffsets);
+  std::vector<uint32_t>().swap(weightCounts);
+  std::vector<uint8_t>().swap(written);
+  std::vector<uint32_t>().swap(touched);
+  std::vector<double>().swap(weightScratch);
+  bound = nullptr;
+}
+
+bool GltfAnimationPose::isBoundTo(const Gltf &gltf) const {
+  return bound == &gltf && nodeCount == gltf.getNodes().size();
+}
+
+size_t GltfAnimationPose::weightCapacity(const Gltf &gltf, int node) {
+  const auto &nodes = gltf.getNodes();
+  if (node < 0 || node >= static_cast<int>(nodes.size()) || !nodes[node]) {
+    return 0;
+  }
+  size_t capacity = nodes[node]->getWeights().size();
+  const auto &meshes = gltf.getMeshes();
+  const int meshIndex = nodes[node]->getMesh().value_or(-1);
+  if (meshIndex < 0 || meshIndex >= static_cast<int>(meshes.size()) ||
+      !meshes[meshIndex]) {
+    return capacity;
+  }
+  const auto &mesh = meshes[meshIndex];
+  capacity = std::max(capacity, mesh->getWeights().size());
+  for (const auto &primitive: mesh->getPrimitives()) {
+    if (primitive) {
+      capacity = std::max(capacity, primitive->getTargets().size());
+    }
+  }
+  return capacity;
+}
+
+void GltfAnimationPose::mark(uint32_t node, PoseChannel channel,
+                             uint32_t weightCount) {
+  if (written[node] == 0) {
+    touched.push_back(node);
+  }
+  written[node] |= channel;
+  if (channel == POSE_WEIGHTS) {
+    weightCounts[node] = weightCount;
+  }
+}
+
+void GltfAnimationPose::discard() {
+  for (const uint32_t node: touched) {
+    written[node] = 0;
+  }
+  touched.clear();
+}
+
+void GltfAnimationPose::apply(Gltf &gltf) {
+  const auto &nodes = gltf.getNodes();
+  for (const uint32_t node: touched) {
+    const uint8_t channels = written[node];
+    written[node] = 0;
+    const auto &target = nodes[node];
+    if (channels & POSE_TRANSLATION) {
+      const float *t = translation(node);
+      target->setTranslation(glm::vec3(t[0], t[1], t[2]));
+    }
+    if (channels & POSE_ROTATION) {
+      const float *r = rotation(node);
+      target->setRotation(glm::quat(r[3], r[0], r[1], r[2]));  // w, x, y, z
+    }
+    if (channels & POSE_SCALE) {
+      const float *s = scale(node);
+      target->setScale(glm::vec3(s[0], s[1], s[2]));
+    }
+    if (channels & POSE_WEIGHTS) {
+      const float *w = weights(node);
+      // 容量在绑定时预留, assign 不再分配
+      weightScratch.assign(w, w + weightCounts[node]);
+      target->setWeights(weightScratch);
+    }
+  }
+  touched.clear();
+}
+
+std::shared_ptr<const GltfAnimationClip>
+GltfAnimationClip::compile(const Gltf &gltf, const GltfAnimation &animation,
+                           const GltfAnimationCompression &compression) {
+  auto clip = std::make_shared<GltfAnimationClip>();
+  const auto &nodes = gltf.getNodes();
+  const auto &samplers = animation.getSamplers();
+  // 输入访问器 -> 时间数组起始下标与游标, 共用输入的轨道共用时间与游标
+  std::unordered_map<int, std::pair<uint32_t, uint32_t>> timeRanges;
+  std::vector<float> raw;
+
+  const auto &channels = animation.getChannels();
+  for (size_t c = 0; c < channels.size(); ++c) {
+    const auto &channel = channels[c];
+    if (!channel || !channel->hasSampler() || !channel->getTarget()) {
+      clip->uncompiledChannels.push_back(static_cast<uint32_t>(c));
+      continue;
+    }
+    const auto &target = channel->getTarget();
+    const InterpolationPath path = target->getPath();
+    if (path != InterpolationPath::TRANSLATION &&
+        path != InterpolationPath::ROTATION &&
+        path != InterpolationPath::SCALE &&
+        path != InterpolationPath::WEIGHTS) {
+      clip->uncompiledChannels.push_back(static_cast<uint32_t>(c));
+      continue;
+    }
+    const int node = target->getNode().value_or(-1);
+    const int samplerIndex = channel->getSampler().value();
+    if (node < 0 || node >= static_cast<int>(nodes.size()) || !nodes[node] ||
+        samplerIndex < 0 || samplerIndex >= static_cast<int>(samplers.size()) ||
+        !samplers[samplerIndex]) {
+      clip->uncompiledChannels.push_back(static_cast<uint32_t>(c));
+      continue;
+    }
+    const auto &sampler = samplers[samplerIndex];
+    const ArrayView<float> input = floatData(gltf, sampler->getInput());
+    const ArrayView<float> output = floatData(gltf, sampler->getOutput());
+    if (input.empty() || output.empty()) {
+      LOGW("Animation '%s' has a channel without keyframe data",
+           animation.getName().c_str());
+      clip->uncompiledChannels.push_back(static_cast<uint32_t>(c));
+      continue;
+    }
+
+    GltfAnimationTrack track;
+    track.node = static_cast<uint32_t>(node);
+    track.path = path;
+    track.interpolation = sampler->getInterpolation();
+    if (track.interpolation != InterpolationMode::STEP &&
+        track.interpolation != InterpolationMode::CUBICSPLINE) {
+      track.interpolation = InterpolationMode::LINEAR;
+    }
+    const bool cubic = track.interpolation == InterpolationMode::CUBICSPLINE;
+    const size_t elements = input.size() * (cubic ? 3 : 1);
+    if (output.size() % elements != 0) {
+      LOGW("Animation '%s' output count %zu does not match %zu keyframes",
+           animation.getName().c_str(), output.size(), input.size());
+      clip->uncompiledChannels.push_back(static_cast<uint32_t>(c));
+      continue;
+    }
+    const size_t components = output.size() / elements;
+    if (path == InterpolationPath::WEIGHTS) {
+      // 权重数超出网格的变形目标数时只写入前面的权重
+      track.components = static_cast<uint32_t>(
+          std::min(components, GltfAnimationPose::weightCapacity(gltf, node)));
+      track.valueStride = static_cast<uint32_t>(components);
+    } else {
+      const size_t expected = path == InterpolationPath::ROTATION ? 4 : 3;
+      if (components != expected) {
+        LOGW("Animation '%s' has %zu components for a %zu component path",
+             animation.getName().c_str(), components, expected);
+        clip->uncompiledChannels.push_back(static_cast<uint32_t>(c));
+        continue;
+      }
+      track.components = static_cast<uint32_t>(components);
+      track.valueStride = 4;
+    }
+    if (track.components == 0) {
+      clip->uncompiledChannels.push_back(static_cast<uint32_t>(c));
+      continue;
+    }
+    track.keyCount = static_cast<uint32_t>(input.size());
+
+    raw.assign(elements * track.valueStride, 0.0f);
+    for (size_t e = 0; e < elements; ++e) {
+      std::copy(output.begin() + e * components,
+                output.begin() + (e + 1) * components,
+                raw.data() + e * track.valueStride);
+      // 线性与阶跃旋转关键帧预先归一化, 采样时不再逐帧归一化输入
+      if (path == InterpolationPath::ROTATION && !cubic) {
+        normalizeQuat(raw.data() + e * track.valueStride);
+      }
+    }
+
+    const int inputIndex = sampler->getInput().value();
+    auto found = timeRanges.find(inputIndex);
+    if (found == timeRanges.end()) {
+      found = timeRanges.emplace(
+          inputIndex, std::make_pair(static_cast<uint32_t>(clip->times.size()),
+                                     static_cast<uint32_t>(clip->cursorCount++))).first;
+      clip->times.insert(clip->times.end(), input.begin(), input.end());
+    }
+
+    auto &stats = clip->stats;
+    ++stats.tracks;
+    stats.sourceKeys += input.size();
+    stats.sourceBytes += (input.size() + output.size()) * sizeof(float);
+    clip->duration = std::max(clip->duration, input[input.size() - 1]);
+    if (compression.enabled && !cubic) {
+      clip->addCompressedTrack(track, input, raw, compression.toleranceFor(path),
+                               found->second);
+      continue;
+    }
+    track.timeOffset = found->second.first;
+    track.cursor = found->second.second;
+    track.valueOffset = static_cast<uint32_t>(clip->values.size());
+    clip->values.insert(clip->values.end(), raw.begin(), raw.end());
+    stats.keptKeys += track.keyCount;
+    clip->tracks.push_back(track);
+  }
+
+  if (clip->tracks.empty()) {
+    return nullptr;
+  }
+  if (!clip->uncompiledChannels.empty()) {
+    LOGI("Animation '%s': %zu channels left to the interpolators",
+         animation.getName().c_str(), clip->uncompiledChannels.size());
+  }
+  clip->times.shrink_to_fit();
+  clip->values.shrink_to_fit();
+  clip->packed.shrink_to_fit();
+  auto &stats = clip->stats;
+  stats.bytes = clip->getByteSize();
+  LOGI("Compiled animation '%s': %zu tracks (%zu constant, %zu quantized), "
+       "%zu -> %zu keys, %zu -> %zu bytes",
+       animation.getName().c_str(), stats.tracks, stats.constantTracks,
+       stats.quantizedTracks, stats.sourceKeys, stats.keptKeys,
+       stats.sourceBytes, stats.bytes);
+  return clip;
+}
+
+void GltfAnimationClip::addCompressedTrack(GltfAnimationTrack track,
+                                           ArrayView<float> input,
+                                           const std::vector<float> &raw,
+                                           float tolerance,
+                                           std::pair<uint32_t, uint32_t> sharedTimes) {
+  const size_t keyCount = track.keyCount;
+  const size_t stride = track.valueStride;
+  const size_t components = track.components;
+  const InterpolationPath path = track.path;
+  auto rawKey = [&](size_t key) { return raw.data() + key * stride; };
+
+  // 常量轨道只保留第一个关键帧
+  bool constant = true;
+  for (size_t k = 1; k < keyCount && constant; ++k) {
+    constant = keyError(path, rawKey(0), rawKey(k), components) <= tolerance;
+  }
+  if (constant) {
+    track.keyCount = 1;
+    track.timeOffset = sharedTimes.first;
+    track.cursor = sharedTimes.second;
+    track.valueOffset = static_cast<uint32_t>(values.size());
+    values.insert(values.end(), rawKey(0), rawKey(0) + stride);
+    ++stats.constantTracks;
+    ++stats.keptKeys;
+    tracks.push_back(track);
+    return;
+  }
+
+  // 量化后的关键帧, 误差在容差内时采用
+  std::vector<float> decoded(raw.size(), 0.0f);
+  std::vector<uint16_t> quantized;
+  std::vector<float> range;  // RANGE16 的最小值与步长
+  float quantizationError = 0.0f;
+  TrackEncoding encoding;
+  size_t quantizedStride;
+  if (path == InterpolationPath::ROTATION) {
+    encoding = TrackEncoding::QUAT16;
+    quantizedStride = 3;
+    quantized.resize(keyCount * quantizedStride);
+    for (size_t k = 0; k < keyCount; ++k) {
+      encodeQuat(rawKey(k), quantized.data() + k * quantizedStride);
+      decodeQuat(quantized.data() + k * quantizedStride, decoded.data() + k * stride);
+      quantizationError = std::max(
+          quantizationError, keyError(path, rawKey(k), decoded.data() + k * stride, 4));
+    }
+  } else {
+    encoding = TrackEncoding::RANGE16;
+    quantizedStride = components;
+    range.resize(components * 2);
+    for (size_t c = 0; c < components; ++c) {
+      float minimum = rawKey(0)[c];
+      float maximum = minimum;
+      for (size_t k = 1; k < keyCount; ++k) {
+        minimum = std::min(minimum, rawKey(k)[c]);
+        maximum = std::max(maximum, rawKey(k)[c]);
+      }
+      range[c] = minimum;
+      range[components + c] = (maximum - minimum) / kRangeSteps;
+    }
+    quantized.resize(keyCount * quantizedStride);
+    for (size_t k = 0; k < keyCount; ++k) {
+      uint16_t *q = quantized.data() + k * quantizedStride;
+      for (size_t c = 0; c < components; ++c) {
+        const float step = range[components + c];
+        q[c] = step > 0.0f ? static_cast<uint16_t>(std::lround(
+            std::clamp((rawKey(k)[c] - range[c]) / step, 0.0f, kRangeSteps))) : 0;
+      }
+      dequantize(q, range.data(), range.data() + components,
+                 decoded.data() + k * stride, components);
+      quantizationError = std::max(
+          quantizationError,
+          keyError(path, rawKey(k), decoded.data() + k * stride, components));
+    }
+  }
+  if (quantizationError > tolerance) {
+    encoding = TrackEncoding::RAW;
+    decoded = raw;
+  }
+
+  // 贪心删除关键帧: 从上一个保留的关键帧尽量向后延伸, 段内每个关键帧由两端
+  // 插值重建的误差都不超过容差
+  float reconstructed[kDecodeChunk];
+  auto segmentFits = [&](size_t from, size_t to) {
+    const float *a = decoded.data() + from * stride;
+    const float *b = decoded.data() + to * stride;
+    const float delta = input[to] - input[from];
+    for (size_t k = from + 1; k < to; ++k) {
+      const float t = delta > 0.0f ? (input[k] - input[from]) / delta : 0.0f;
+      for (size_t first = 0; first < components; first += kDecodeChunk) {
+        const size_t count = std::min(kDecodeChunk, components - first);
+        if (track.interpolation == InterpolationMode::STEP) {
+          std::copy(a + first, a + first + count, reconstructed);
+        } else if (path == InterpolationPath::ROTATION) {
+          slerp(a, b, t, reconstructed);
+        } else {
+          blend(a + first, 1.0f - t, b + first, t, reconstructed, count);
+        }
+        if (path == InterpolationPath::ROTATION
+            ? keyError(path, reconstructed, rawKey(k), 4) > tolerance
+            : keyError(path, reconstructed, rawKey(k) + first, count) > tolerance) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+  std::vector<uint32_t> kept{0};
+  size_t end = 1;
+  while (end + 1 < keyCount) {
+    const size_t anchor = kept.back();
+    if (end + 1 - anchor <= kMaxReductionSpan && segmentFits(anchor, end + 1)) {
+      ++end;
+      continue;
+    }
+    kept.push_back(static_cast<uint32_t>(end));
+    end = end + 1;
+  }
+  kept.push_back(static_cast<uint32_t>(keyCount - 1));
+
+  // 删除关键帧后轨道需要自己的时间数组与游标, 省下的字节不足以抵消时保留全部关键帧
+  const size_t valueBytes = encoding == TrackEncoding::RAW
+      ? stride * sizeof(float) : quantizedStride * sizeof(uint16_t);
+  if (kept.size() * (valueBytes + sizeof(float)) >= keyCount * valueBytes) {
+    kept.resize(keyCount);
+    for (size_t k = 0; k < keyCount; ++k) {
+      kept[k] = static_cast<uint32_t>(k);
+    }
+  }
+
+  if (kept.size() == keyCount) {
+    track.timeOffset = sharedTimes.first;
+    track.cursor = sharedTimes.second;
+  } else {
+    track.timeOffset = static_cast<uint32_t>(times.size());
+    track.cursor = static_cast<uint32_t>(cursorCount++);
+    for (const uint32_t k: kept) {
+      times.push_back(input[k]);
+    }
+  }
+  track.keyCount = static_cast<uint32_t>(kept.size());
+  track.encoding = encoding;
+  if (encoding == TrackEncoding::RAW) {
+    track.valueOffset = static_cast<uint32_t>(values.size());
+    for (const uint32_t k: kept) {
+      values.insert(values.end(), rawKey(k), rawKey(k) + stride);
+    }
+  } else {
+    track.valueStride = static_cast<uint32_t>(quantizedStride);
+    if (encoding == TrackEncoding::RANGE16) {
+      track.rangeOffset = static_cast<uint32_t>(values.size());
+      values.insert(values.end(), range.begin(), range.end());
+    }
+    track.valueOffset = static_cast<uint32_t>(packed.size());
+    for (const uint32_t k: kept) {
+      const uint16_t *q = quantized.data() + k * quantizedStride;
+      packed.insert(packed.end(), q, q + quantizedStride);
+    }
+    ++stats.quantizedTracks;
+  }
+  stats.keptKeys += kept.size();
+  tracks.push_back(track);
+}
+
+void GltfAnimationClip::decodeKey(const GltfAnimationTrack &track, size_t key,
+                                  size_t first, size_t count, float *out) const {
+  const uint16_t *q = packed.data() + track.valueOffset + key * track.valueStride;
+  if (track.encoding == TrackEncoding::QUAT16) {
+    decodeQuat(q, out);
+    return;
+  }
+  const float *minimum = values.data() + track.rangeOffset;
+  dequantize(q + first, minimum + first, minimum + track.components + first,
+             out, count);
+}
+
+void GltfAnimationClip::sampleRaw(const GltfAnimationTrack &track, size_t prev,
+                                  size_t next, float t, float keyDelta,
+                                  float *dst) const {
+  const float *keyValues = values.data() + track.valueOffset;
+  const bool cubic = track.interpolation == InterpolationMode::CUBICSPLINE;
+  const size_t keyStride = track.valueStride * (cubic ? 3 : 1);
+  const size_t width =
+      track.path == InterpolationPath::WEIGHTS ? track.components : 4;
+  const float *from = keyValues + prev * keyStride;
+  const float *to = keyValues + next * keyStride;
+  if (prev == next || track.interpolation == InterpolationMode::STEP) {
+    // 三次样条关键帧依次为入切线、值、出切线
+    const float *key = cubic ? from + track.valueStride : from;
+    std::copy(key, key + width, dst);
+    return;
+  }
+  if (cubic) {
+    hermite(from + track.valueStride, from + 2 * track.valueStride,
+            to + track.valueStride, to, keyDelta, t, dst, width);
+    if (track.path == InterpolationPath::ROTATION) {
+      normalizeQuat(dst);
+    }
+  } else if (track.path == InterpolationPath::ROTATION) {
+    slerp(from, to, t, dst);
+  } else {
+    blend(from, 1.0f - t, to, t, dst, width);
+  }
+}
+
+size_t GltfAnimationClip::sample(float time, GltfAnimationPose &pose,
+                                 GltfKeyframeCursor *cursors,
+                                 const uint8_t *skipChannels) const {
+  float from[kDecodeChunk];
+  float to[kDecodeChunk];
+  size_t sampled = 0;
+  for (const auto &track: tracks) {
+    if (skipChannels && (skipChannels[track.node] & poseChannel(track.path))) {
+      continue;
+    }
+    const float *keyTimes = times.data() + track.timeOffset;
+    const size_t last = track.keyCount - 1;
+    size_t prev = 0;
+    size_t next = 0;
+    float t = 0.0f;
+    float keyDelta = 0.0f;
+    if (last == 0 || time <= keyTimes[0]) {
+      prev = next = 0;
+    } else if (time >= keyTimes[last]) {
+      prev = next = last;
+    } else {
+      if (cursors) {
+        prev = cursors[track.cursor].seek(keyTimes, track.keyCount, time);
+      } else {
+        prev = static_cast<size_t>(
+            std::upper_bound(keyTimes, keyTimes + last + 1, time) - keyTimes) - 1;
+      }
+      next = prev + 1;
+      keyDelta = keyTimes[next] - keyTimes[prev];
+      t = keyDelta > 0.0f ? (time - keyTimes[prev]) / keyDelta : 0.0f;
+    }
+
+    float *dst = poseTarget(pose, track);
+    if (track.encoding == TrackEncoding::RAW) {
+      sampleRaw(track, prev, next, t, keyDelta, dst);
+    } else {
+      const bool hold = prev == next ||
+          track.interpolation == InterpolationMode::STEP;
+      for (size_t first = 0; first < track.components; first += kDecodeChunk) {
+        const size_t count = std::min<size_t>(kDecodeChunk, track.components - first);
+        decodeKey(track, prev, first, count, hold ? dst + first : from);
+        if (hold) {
+          continue;
+        }
+        decodeKey(track, next, first, count, to);
+        if (track.path == InterpolationPath::ROTATION) {
+          slerp(from, to, t, dst);
+        } else {
+          blend(from, 1.0f - t, to, t, dst + first, count);
+        }
+      }
+    }
+    pose.mark(track.node, poseChannel(track.path), track.components);
+    ++sampled;
+  }
+  return sampled;
+}
+
+} // namespace digitalhumans
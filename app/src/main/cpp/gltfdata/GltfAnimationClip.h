@@ -0,0 +1,303 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFANIMATIONCLIP_H
+#define LIGHTDIGITALHUMAN_GLTFANIMATIONCLIP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "GltfAccessorView.h"
+#include "GltfAnimationChannel.h"
+#include "GltfAnimationSampler.h"
+#include "GltfKeyframeCursor.h"
+
+namespace digitalhumans {
+
+class Gltf;
+
+class GltfAnimation;
+
+/**
+ * @brief 姿态中节点已写入的属性
+ */
+enum PoseChannel : uint8_t {
+  POSE_TRANSLATION = 1 << 0,
+  POSE_ROTATION = 1 << 1,
+  POSE_SCALE = 1 << 2,
+  POSE_WEIGHTS = 1 << 3,
+};
+
+/**
+ * @brief 预分配的姿态缓冲
+ *
+ * 每个节点固定占用 12 个 float（平移、旋转、缩放各补齐为 4 个分量）, morph 权重
+ * 按节点网格的变形目标数预留。采样只写缓冲并记录被写入的节点, apply 再把每个
+ * 节点的属性一次性写回 GltfNode。缓冲只在绑定模型时分配, 逐帧采样不再分配内存。
+ */
+class GltfAnimationPose {
+ public:
+  static constexpr size_t kNodeStride = 12;
+
+  /**
+   * @brief 按模型的节点与变形目标数分配缓冲
+   */
+  void reset(const Gltf &gltf);
+
+  /**
+   * @brief 解除与模型的绑定并释放缓冲
+   */
+  void clear();
+
+  /**
+   * @brief 缓冲是否按该模型的节点布局分配
+   */
+  bool isBoundTo(const Gltf &gltf) const;
+
+  /**
+   * @brief 节点可写入的 morph 权重数, 即节点或网格权重数与变形目标数的最大值
+   */
+  static size_t weightCapacity(const Gltf &gltf, int node);
+
+  float *translation(uint32_t node) { return trs.data() + node * kNodeStride; }
+
+  float *rotation(uint32_t node) { return trs.data() + node * kNodeStride + 4; }
+
+  float *scale(uint32_t node) { return trs.data() + node * kNodeStride + 8; }
+
+  float *weights(uint32_t node) { return weightValues.data() + weightOffsets[node]; }
+
+  /**
+   * @brief 记录节点属性已写入, 权重通道同时记录写入的权重数
+   */
+  void mark(uint32_t node, PoseChannel channel, uint32_t weightCount = 0);
+
+  /**
+   * @brief 本次采样写入的节点数
+   */
+  size_t getTouchedCount() const { return touched.size(); }
+
+  /**
+   * @brief 本次采样写入的节点, 按首次写入顺序
+   */
+  const std::vector<uint32_t> &getTouched() const { return touched; }
+
+  /**
+   * @brief 节点本次已写入的 PoseChannel 位
+   */
+  uint8_t getWritten(uint32_t node) const { return written[node]; }
+
+  /**
+   * @brief 节点本次写入的 morph 权重数
+   */
+  uint32_t getWeightCount(uint32_t node) const { return weightCounts[node]; }
+
+  /**
+   * @brief 节点预留的 morph 权重数
+   */
+  uint32_t getWeightCapacity(uint32_t node) const {
+    const size_t end = node + 1 < nodeCount ? weightOffsets[node + 1]
+                                            : weightValues.size();
+    return static_cast<uint32_t>(end - weightOffsets[node]);
+  }
+
+  /**
+   * @brief 丢弃写入记录而不写回节点, 用于作为中间结果的姿态
+   */
+  void discard();
+
+  /**
+   * @brief 把写入的属性写回节点并清空写入记录, 每个节点只写一次
+   */
+  void apply(Gltf &gltf);
+
+ private:
+  const Gltf *bound = nullptr;           ///< 缓冲布局对应的模型
+  size_t nodeCount = 0;
+  std::vector<float> trs;                 ///< 每节点 12 个 float
+  std::vector<float> weightValues;        ///< 全部节点的 morph 权重
+  std::vector<uint32_t> weightOffsets;    ///< 节点权重在 weightValues 中的偏移
+  std::vector<uint32_t> weightCounts;     ///< 本次写入的权重数
+  std::vector<uint8_t> written;           ///< 节点已写入的 PoseChannel 位
+  std::vector<uint32_t> touched;          ///< 本次写入的节点
+  std::vector<double> weightScratch;      ///< 写回节点时的权重缓冲
+};
+
+/**
+ * @brief 动画片段的加载时压缩参数
+ *
+ * 每条轨道按其属性类型的容差压缩, 关键帧处的重建误差不超过容差: 旋转为角度
+ * （弧度）, 平移为距离（模型单位）, 缩放与 morph 权重为分量的绝对误差。
+ * 三次样条轨道保持原样。
+ */
+struct GltfAnimationCompression {
+  bool enabled = true;                 ///< 是否压缩, 关闭时保留原始 float 关键帧
+  float translationTolerance = 1e-4f;  ///< 平移容差
+  float rotationTolerance = 1e-3f;     ///< 旋转容差
+  float scaleTolerance = 1e-4f;        ///< 缩放容差
+  float weightTolerance = 1e-3f;       ///< morph 权重容差
+
+  float toleranceFor(InterpolationPath path) const {
+    switch (path) {
+      case InterpolationPath::TRANSLATION:
+        return translationTolerance;
+      case InterpolationPath::ROTATION:
+        return rotationTolerance;
+      case InterpolationPath::SCALE:
+        return scaleTolerance;
+      default:
+        return weightTolerance;
+    }
+  }
+
+  bool operator==(const GltfAnimationCompression &other) const {
+    return enabled == other.enabled &&
+        translationTolerance == other.translationTolerance &&
+        rotationTolerance == other.rotationTolerance &&
+        scaleTolerance == other.scaleTolerance &&
+        weightTolerance == other.weightTolerance;
+  }
+};
+
+/**
+ * @brief 轨道关键帧值的存储方式
+ */
+enum class TrackEncoding : uint8_t {
+  RAW,      ///< float, 存放在 values 中
+  QUAT16,   ///< 最小三分量四元数: 3 个 uint16（各 15 位, 最大分量下标占两个最高位）
+  RANGE16,  ///< 按分量范围量化的 uint16, 最小值与步长存放在 values 中
+};
+
+/**
+ * @brief 编译后的动画轨道, 对应一个有效的动画通道
+ */
+struct GltfAnimationTrack {
+  uint32_t node = 0;             ///< 目标节点下标
+  InterpolationPath path = InterpolationPath::UNKNOWN;
+  InterpolationMode interpolation = InterpolationMode::LINEAR;
+  TrackEncoding encoding = TrackEncoding::RAW;
+  uint32_t components = 0;       ///< 每个值写入姿态的分量数
+  uint32_t valueStride = 0;      ///< 每个值占用的元素数, 原始平移/旋转/缩放补齐为 4
+  uint32_t timeOffset = 0;       ///< 关键帧时间在 times 中的起始下标
+  uint32_t cursor = 0;           ///< 关键帧游标下标, 共用时间数组的轨道共用游标
+  uint32_t keyCount = 0;         ///< 关键帧数
+  uint32_t valueOffset = 0;      ///< 关键帧值在 values 或 packed 中的起始下标
+  uint32_t rangeOffset = 0;      ///< RANGE16 的最小值与步长在 values 中的起始下标
+};
+
+/**
+ * @brief 片段编译与压缩的统计
+ */
+struct GltfAnimationClipStats {
+  size_t tracks = 0;           ///< 轨道数
+  size_t constantTracks = 0;   ///< 合并为单个值的常量轨道数
+  size_t quantizedTracks = 0;  ///< 量化为 16 位的轨道数
+  size_t sourceKeys = 0;       ///< 原始关键帧数
+  size_t keptKeys = 0;         ///< 保留的关键帧数
+  size_t sourceBytes = 0;      ///< 原始 float 关键帧时间与值的字节数
+  size_t bytes = 0;            ///< 片段占用的字节数
+};
+
+/**
+ * @brief 结构数组形式的动画片段
+ *
+ * 加载时把动画的全部通道编译为轨道: 关键帧时间与值分别连续存放在 times 与
+ * values 中（共用输入访问器的轨道共用一段时间数组）, 通道目标解析为节点下标。
+ * 三次样条的每个关键帧依次存放入切线、值、出切线; 线性旋转关键帧预先归一化。
+ * sample 一次遍历全部轨道, 用关键帧游标定位关键帧并以 SIMD 计算插值, 结果写入
+ * 预分配的姿态缓冲。指针动画（KHR_animation_pointer）等无法编译的通道记录在
+ * getUncompiledChannels 中, 由动画的逐通道插值器处理。
+ *
+ * 压缩在容差内依次: 合并常量轨道; 旋转量化为最小三分量、其余按范围量化为 16 位;
+ * 删除能由相邻保留关键帧插值重建的关键帧（删除了关键帧的轨道使用自己的时间数组）。
+ * 采样直接读取量化数据, 只解码当前区间两端的关键帧。
+ */
+class GltfAnimationClip {
+ public:
+  /**
+   * @brief 编译动画
+   * @return 没有可编译的通道时返回 nullptr
+   */
+  static std::shared_ptr<const GltfAnimationClip>
+  compile(const Gltf &gltf, const GltfAnimation &animation,
+          const GltfAnimationCompression &compression = GltfAnimationCompression());
+
+  /**
+   * @brief 采样全部轨道写入姿态, 时间超出轨道范围时取首尾关键帧
+   * @param time 片段内时间（秒）
+   * @param cursors 播放实例的关键帧游标, getCursorCount 个; 为空时每条轨道二分查找
+   * @param skipChannels 每个节点不采样的 PoseChannel 位, 为空时采样全部轨道
+   * @return 采样的轨道数
+   */
+  size_t sample(float time, GltfAnimationPose &pose,
+                GltfKeyframeCursor *cursors = nullptr,
+                const uint8_t *skipChannels = nullptr) const;
+
+  /**
+   * @brief 播放实例需要的关键帧游标数, 即不同时间数组的个数
+   */
+  size_t getCursorCount() const { return cursorCount; }
+
+  /**
+   * @brief 片段时长, 即全部轨道最后一个关键帧时间的最大值
+   */
+  float getDuration() const { return duration; }
+
+  const std::vector<GltfAnimationTrack> &getTracks() const { return tracks; }
+
+  /**
+   * @brief 未编译为轨道的通道下标（指针动画、目标或数据无效的通道）, 按通道顺序
+   */
+  const std::vector<uint32_t> &getUncompiledChannels() const {
+    return uncompiledChannels;
+  }
+
+  /**
+   * @brief 关键帧数据占用的字节数
+   */
+  size_t getByteSize() const {
+    return (times.size() + values.size()) * sizeof(float) +
+        packed.size() * sizeof(uint16_t) +
+        tracks.size() * sizeof(GltfAnimationTrack);
+  }
+
+  const GltfAnimationClipStats &getStats() const { return stats; }
+
+ private:
+  /**
+   * @brief 压缩并追加一条线性或阶跃轨道
+   * @param raw 原始关键帧值, 每个值 track.valueStride 个 float
+   * @param sharedTimes 输入访问器共用的时间数组起始下标与游标
+   */
+  void addCompressedTrack(GltfAnimationTrack track, ArrayView<float> input,
+                          const std::vector<float> &raw, float tolerance,
+                          std::pair<uint32_t, uint32_t> sharedTimes);
+
+  /**
+   * @brief 原始 float 轨道的插值
+   */
+  void sampleRaw(const GltfAnimationTrack &track, size_t prev, size_t next,
+                 float t, float keyDelta, float *dst) const;
+
+  /**
+   * @brief 解码量化轨道第 key 个关键帧的分量 [first, first + count)
+   */
+  void decodeKey(const GltfAnimationTrack &track, size_t key, size_t first,
+                 size_t count, float *out) const;
+
+  std::vector<GltfAnimationTrack> tracks;
+  std::vector<float> times;
+  std::vector<float> values;
+  std::vector<uint16_t> packed;  ///< 量化轨道的关键帧值
+  std::vector<uint32_t> uncompiledChannels;  ///< 未编译的通道下标
+  size_t cursorCount = 0;
+  float duration = 0.0f;
+  GltfAnimationClipStats stats;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFANIMATIONCLIP_H
@@ -0,0 +1,390 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#include "GltfAnimationLod.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "Gltf.h"
+#include "GltfAnimation.h"
+#include "GltfNode.h"
+#include "GltfSkin.h"
+#include "GltfUtils.h"
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr uint8_t kTransformChannels = POSE_TRANSLATION | POSE_ROTATION | POSE_SCALE;
+
+void lerp(const float *from, const float *to, float t, float *dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = from[i] + (to[i] - from[i]) * t;
+  }
+}
+
+} // namespace
+
+void GltfAnimationLod::bind(const Gltf &gltf) {
+  const auto &nodes = gltf.getNodes();
+  animatedChannels.assign(nodes.size(), 0);
+  for (const auto &animation: gltf.getAnimations()) {
+    if (!animation) {
+      continue;
+    }
+    for (const auto &channel: animation->getChannels()) {
+      if (!channel || !channel->getTarget()) {
+        continue;
+      }
+      const int node = channel->getTarget()->getNode().value_or(-1);
+      if (node < 0 || node >= static_cast<int>(nodes.size()) || !nodes[node]) {
+        continue;
+      }
+      switch (channel->getTarget()->getPath()) {
+        case InterpolationPath::TRANSLATION:
+          animatedChannels[node] |= POSE_TRANSLATION;
+          break;
+        case InterpolationPath::ROTATION:
+          animatedChannels[node] |= POSE_ROTATION;
+          break;
+        case InterpolationPath::SCALE:
+          animatedChannels[node] |= POSE_SCALE;
+          break;
+        case InterpolationPath::WEIGHTS:
+          animatedChannels[node] |= POSE_WEIGHTS;
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  animatedNodes.clear();
+  for (size_t i = 0; i < animatedChannels.size(); ++i) {
+    if (animatedChannels[i] != 0) {
+      animatedNodes.push_back(static_cast<uint32_t>(i));
+    }
+  }
+
+  chainSizes.assign(nodes.size(), FLT_MAX);
+  skipMask.assign(nodes.size(), 0);
+  previous.reset(gltf);
+  latest.reset(gltf);
+  previousCounts.assign(nodes.size(), 0);
+  latestCounts.assign(nodes.size(), 0);
+  measured = false;
+  hasHistory = false;
+  framesSinceEvaluation = 0;
+  frameChannels = 0;
+  stats = GltfAnimationLodStats();
+  bound = &gltf;
+}
+
+void GltfAnimationLod::clear() {
+  bound = nullptr;
+  std::vector<uint32_t>().swap(animatedNodes);
+  std::vector<uint8_t>().swap(animatedChannels);
+  std::vector<float>().swap(chainSizes);
+  std::vector<uint8_t>().swap(skipMask);
+  previous.clear();
+  latest.clear();
+  std::vector<uint32_t>().swap(previousCounts);
+  std::vector<uint32_t>().swap(latestCounts);
+  measured = false;
+  hasHistory = false;
+  stats = GltfAnimationLodStats();
+}
+
+bool GltfAnimationLod::isBoundTo(const Gltf &gltf) const {
+  return bound == &gltf && animatedChannels.size() == gltf.getNodes().size();
+}
+
+void GltfAnimationLod::setSettings(const GltfAnimationLodSettings &lodSettings) {
+  settings = lodSettings;
+  // 采样间隔可能变化, 重新开始插值历史
+  hasHistory = false;
+}
+
+bool GltfAnimationLod::measure(const std::shared_ptr<Gltf> &gltf, int sceneIndex) {
+  if (!gltf) {
+    return false;
+  }
+  if (!isBoundTo(*gltf)) {
+    bind(*gltf);
+  }
+  if (animatedNodes.empty()) {
+    return false;
+  }
+  glm::vec3 min;
+  glm::vec3 max;
+  GltfUtils::getSceneExtents(gltf, sceneIndex, min, max);
+  if (!(min.x <= max.x && min.y <= max.y && min.z <= max.z)) {
+    return false;
+  }
+  const float diameter = glm::length(max - min);
+  if (!(diameter > 0.0f) || !std::isfinite(diameter)) {
+    return false;
+  }
+  center = (min + max) * 0.5f;
+  radius = diameter * 0.5f;
+
+  const auto &nodes = gltf->getNodes();
+  const size_t nodeCount = nodes.size();
+  std::vector<int> parents(nodeCount, -1);
+  for (size_t i = 0; i < nodeCount; ++i) {
+    if (!nodes[i]) {
+      continue;
+    }
+    for (const int child: nodes[i]->getChildren()) {
+      if (child >= 0 && child < static_cast<int>(nodeCount)) {
+        parents[child] = static_cast<int>(i);
+      }
+    }
+  }
+  std::vector<uint8_t> joints(nodeCount, 0);
+  for (const auto &skin: gltf->getSkins()) {
+    if (!skin) {
+      continue;
+    }
+    for (const int joint: skin->getJoints()) {
+      if (joint >= 0 && joint < static_cast<int>(nodeCount)) {
+        joints[joint] = 1;
+      }
+    }
+  }
+
+  // 关节到子树中最远关节的距离; 叶子关节取骨骼长度（到父关节的距离）
+  std::vector<float> extents(nodeCount, 0.0f);
+  for (size_t i = 0; i < nodeCount; ++i) {
+    if (!joints[i]) {
+      continue;
+    }
+    const glm::vec3 position(nodes[i]->getWorldTransform()[3]);
+    const int parent = parents[i];
+    if (parent >= 0 && nodes[parent]) {
+      const float length =
+          glm::length(position - glm::vec3(nodes[parent]->getWorldTransform()[3]));
+      extents[i] = std::max(extents[i], length);
+    }
+    for (int ancestor = parent; ancestor >= 0; ancestor = parents[ancestor]) {
+      if (joints[ancestor]) {
+        const float distance = glm::length(
+            position - glm::vec3(nodes[ancestor]->getWorldTransform()[3]));
+        extents[ancestor] = std::max(extents[ancestor], distance);
+      }
+    }
+  }
+
+  // 自根向下遍历, 子关节不大于父关节, 跳过的总是完整的末端关节链
+  std::fill(chainSizes.begin(), chainSizes.end(), FLT_MAX);
+  std::vector<int> stack;
+  for (size_t i = 0; i < nodeCount; ++i) {
+    if (nodes[i] && parents[i] < 0) {
+      stack.push_back(static_cast<int>(i));
+    }
+  }
+  std::vector<uint8_t> visited(nodeCount, 0);
+  while (!stack.empty()) {
+    const int node = stack.back();
+    stack.pop_back();
+    if (visited[node]) {
+      continue;
+    }
+    visited[node] = 1;
+    const int parent = parents[node];
+    const float inherited = parent >= 0 ? chainSizes[parent] : FLT_MAX;
+    chainSizes[node] = joints[node] ? std::min(extents[node] / diameter, inherited)
+                                    : inherited;
+    for (const int child: nodes[node]->getChildren()) {
+      if (child >= 0 && child < static_cast<int>(nodeCount) && nodes[child]) {
+        stack.push_back(child);
+      }
+    }
+  }
+  measured = true;
+  return true;
+}
+
+float GltfAnimationLod::projectSize(const glm::mat4 &view,
+                                    const glm::mat4 &projection) const {
+  if (!measured) {
+    return 1.0f;
+  }
+  const glm::vec4 clip = projection * (view * glm::vec4(center, 1.0f));
+  // 包围球跨过相机平面时按全尺寸处理
+  if (clip.w <= radius * std::abs(projection[2][3])) {
+    return 1.0f;
+  }
+  return radius * std::abs(projection[1][1]) / clip.w;
+}
+
+bool GltfAnimationLod::beginFrame(Gltf &gltf, GltfAnimationPose &pose,
+                                  float screenSize, float time) {
+  if (!isBoundTo(gltf)) {
+    bind(gltf);
+  }
+  uint32_t interval = 1;
+  if (settings.enabled && measured) {
+    if (screenSize < settings.quarterRateSize) {
+      interval = 4;
+    } else if (screenSize < settings.halfRateSize) {
+      interval = 2;
+    }
+  }
+  stats.screenSize = screenSize;
+  stats.updateInterval = interval;
+  if (interval == 1) {
+    hasHistory = false;
+  }
+  if (hasHistory && ++framesSinceEvaluation < interval) {
+    const float span = latestTime - previousTime;
+    const float alpha = span > 0.0f ? std::clamp((time - latestTime) / span, 0.0f, 1.0f)
+                                    : 1.0f;
+    interpolate(gltf, pose, alpha);
+    ++stats.interpolatedFrames;
+    stats.skippedChannels += frameChannels;
+    return false;
+  }
+  framesSinceEvaluation = 0;
+  frameChannels = 0;
+  updateSkipMask(screenSize);
+  ++stats.evaluatedFrames;
+  return true;
+}
+
+void GltfAnimationLod::recordChannels(size_t evaluated, size_t skipped) {
+  stats.evaluatedChannels += evaluated;
+  stats.skippedChannels += skipped;
+  frameChannels += evaluated + skipped;
+}
+
+void GltfAnimationLod::endFrame(Gltf &gltf, GltfAnimationPose &pose, float time) {
+  if (stats.updateInterval <= 1 || !isBoundTo(gltf)) {
+    return;
+  }
+  if (!hasHistory) {
+    // 没有上一次采样, 本次结果直接显示并作为两端
+    capture(gltf, latest, latestCounts);
+    capture(gltf, previous, previousCounts);
+    previousTime = latestTime = time;
+    hasHistory = true;
+    return;
+  }
+  std::swap(previous, latest);
+  std::swap(previousCounts, latestCounts);
+  previousTime = latestTime;
+  latestTime = time;
+  capture(gltf, latest, latestCounts);
+  interpolate(gltf, pose, 0.0f);
+}
+
+void GltfAnimationLod::flush(Gltf &gltf, GltfAnimationPose &pose) {
+  if (hasHistory && isBoundTo(gltf)) {
+    interpolate(gltf, pose, 1.0f);
+  }
+  hasHistory = false;
+}
+
+void GltfAnimationLod::capture(const Gltf &gltf, GltfAnimationPose &snapshot,
+                               std::vector<uint32_t> &counts) const {
+  const auto &nodes = gltf.getNodes();
+  for (const uint32_t node: animatedNodes) {
+    const auto &source = nodes[node];
+    const glm::vec3 &t = source->getTranslation();
+    const glm::quat &r = source->getRotation();
+    const glm::vec3 &s = source->getScale();
+    float *translation = snapshot.translation(node);
+    translation[0] = t.x;
+    translation[1] = t.y;
+    translation[2] = t.z;
+    float *rotation = snapshot.rotation(node);
+    rotation[0] = r.x;
+    rotation[1] = r.y;
+    rotation[2] = r.z;
+    rotation[3] = r.w;
+    float *scale = snapshot.scale(node);
+    scale[0] = s.x;
+    scale[1] = s.y;
+    scale[2] = s.z;
+    if (animatedChannels[node] & POSE_WEIGHTS) {
+      const auto &weights = source->getWeights();
+      const uint32_t count = std::min<uint32_t>(
+          static_cast<uint32_t>(weights.size()), snapshot.getWeightCapacity(node));
+      std::copy(weights.begin(), weights.begin() + count, snapshot.weights(node));
+      counts[node] = count;
+    }
+  }
+}
+
+void GltfAnimationLod::interpolate(Gltf &gltf, GltfAnimationPose &pose,
+                                   float alpha) {
+  if (!pose.isBoundTo(gltf)) {
+    pose.reset(gltf);
+  }
+  for (const uint32_t node: animatedNodes) {
+    const uint8_t channels = animatedChannels[node];
+    if (channels & POSE_TRANSLATION) {
+      lerp(previous.translation(node), latest.translation(node), alpha,
+           pose.translation(node), 3);
+      pose.mark(node, POSE_TRANSLATION);
+    }
+    if (channels & POSE_ROTATION) {
+      const float *from = previous.rotation(node);
+      const float *to = latest.rotation(node);
+      const float sign = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] +
+          from[3] * to[3] < 0.0f ? -1.0f : 1.0f;
+      float *dst = pose.rotation(node);
+      float length = 0.0f;
+      for (size_t i = 0; i < 4; ++i) {
+        dst[i] = from[i] + (to[i] * sign - from[i]) * alpha;
+        length += dst[i] * dst[i];
+      }
+      const float inverse = length > 0.0f ? 1.0f / std::sqrt(length) : 0.0f;
+      for (size_t i = 0; i < 4; ++i) {
+        dst[i] *= inverse;
+      }
+      pose.mark(node, POSE_ROTATION);
+    }
+    if (channels & POSE_SCALE) {
+      lerp(previous.scale(node), latest.scale(node), alpha, pose.scale(node), 3);
+      pose.mark(node, POSE_SCALE);
+    }
+    if ((channels & POSE_WEIGHTS) && latestCounts[node] > 0) {
+      const uint32_t count = latestCounts[node];
+      if (previousCounts[node] == count) {
+        lerp(previous.weights(node), latest.weights(node), alpha,
+             pose.weights(node), count);
+      } else {
+        std::copy(latest.weights(node), latest.weights(node) + count,
+                  pose.weights(node));
+      }
+      pose.mark(node, POSE_WEIGHTS, count);
+    }
+  }
+  pose.apply(gltf);
+}
+
+void GltfAnimationLod::updateSkipMask(float screenSize) {
+  stats.skippedNodes = 0;
+  if (!settings.enabled || !measured) {
+    return;
+  }
+  const bool skipWeights = screenSize < settings.morphWeightSize;
+  for (const uint32_t node: animatedNodes) {
+    uint8_t skip = 0;
+    if (chainSizes[node] != FLT_MAX &&
+        chainSizes[node] * screenSize < settings.jointChainSize) {
+      skip |= kTransformChannels;
+    }
+    if (skipWeights) {
+      skip |= POSE_WEIGHTS;
+    }
+    skip &= animatedChannels[node];
+    skipMask[node] = skip;
+    if (skip != 0) {
+      ++stats.skippedNodes;
+    }
+  }
+}
+
+} // namespace digitalhumans
@@ -0,0 +1,158 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFANIMATIONLOD_H
+#define LIGHTDIGITALHUMAN_GLTFANIMATIONLOD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "glm.hpp"
+#include "GltfAnimationClip.h"
+
+namespace digitalhumans {
+
+class Gltf;
+
+/**
+ * @brief 动画 LOD 的阈值
+ *
+ * 尺寸均为占视口高度的比例: 模型尺寸为模型包围球直径的投影高度, 关节链尺寸为
+ * 关节到其子树中最远关节（叶子关节取到父关节）距离的投影高度。
+ */
+struct GltfAnimationLodSettings {
+  bool enabled = true;            ///< 关闭时每帧采样全部通道
+  float halfRateSize = 0.4f;      ///< 模型尺寸低于该值时每 2 帧采样一次
+  float quarterRateSize = 0.15f;  ///< 模型尺寸低于该值时每 4 帧采样一次
+  float jointChainSize = 0.01f;   ///< 关节链尺寸低于该值时跳过该链的平移、旋转与缩放
+  float morphWeightSize = 0.15f;  ///< 模型尺寸低于该值时跳过 morph 权重通道
+};
+
+/**
+ * @brief 动画 LOD 的统计, 帧与通道数自绑定模型起累计
+ */
+struct GltfAnimationLodStats {
+  float screenSize = 1.0f;        ///< 最近一帧的模型尺寸
+  uint32_t updateInterval = 1;    ///< 最近一帧的采样间隔（帧）
+  size_t skippedNodes = 0;        ///< 最近一次采样跳过了部分属性的节点数
+  size_t evaluatedFrames = 0;     ///< 采样的帧数
+  size_t interpolatedFrames = 0;  ///< 在两次采样结果间插值的帧数
+  size_t evaluatedChannels = 0;   ///< 采样的通道数
+  size_t skippedChannels = 0;     ///< 跳过的通道数, 含插值帧上未采样的通道
+};
+
+/**
+ * @brief 按模型投影尺寸降低动画的采样频率与精度
+ *
+ * 模型尺寸低于阈值时每 2 或 4 帧才采样一次, 其余帧在最近两次采样的姿态之间
+ * 插值写回节点（显示结果滞后一个采样间隔, 换取不采样的帧只做一次线性插值）。
+ * 采样时按尺寸生成节点的跳过掩码: 投影过小的末端关节链（手指、面部关节等）与
+ * 看不清面部时的 morph 权重不再采样, 保持最后一次写入的值。
+ *
+ * 关节链尺寸在模型首次绘制后由 measure 按世界变换测量, 测量前按全尺寸处理。
+ */
+class GltfAnimationLod {
+ public:
+  /**
+   * @brief 记录各节点被动画驱动的属性并分配快照缓冲, 清除测量结果与插值历史
+   */
+  void bind(const Gltf &gltf);
+
+  /**
+   * @brief 解除与模型的绑定并释放缓冲
+   */
+  void clear();
+
+  bool isBoundTo(const Gltf &gltf) const;
+
+  void setSettings(const GltfAnimationLodSettings &settings);
+
+  const GltfAnimationLodSettings &getSettings() const { return settings; }
+
+  /**
+   * @brief 测量模型包围球与各关节链的尺寸, 需在计算世界变换之后调用
+   * @return 场景包围盒无效时返回 false
+   */
+  bool measure(const std::shared_ptr<Gltf> &gltf, int sceneIndex);
+
+  bool isMeasured() const { return measured; }
+
+  /**
+   * @brief 模型包围球直径投影到视口的高度比例, 未测量或包围球跨过相机平面时为 1
+   */
+  float projectSize(const glm::mat4 &view, const glm::mat4 &projection) const;
+
+  /**
+   * @brief 开始一帧
+   * @param screenSize 模型尺寸
+   * @param time 动画时间轴的当前时间（秒）
+   * @return 本帧是否需要采样; 返回 false 时已把插值后的姿态写回节点
+   */
+  bool beginFrame(Gltf &gltf, GltfAnimationPose &pose, float screenSize,
+                  float time);
+
+  /**
+   * @brief 每个节点本帧跳过的 PoseChannel 位, 没有跳过的通道时为 nullptr
+   */
+  const uint8_t *getSkipMask() const {
+    return stats.skippedNodes > 0 ? skipMask.data() : nullptr;
+  }
+
+  /**
+   * @brief 记录本帧采样与按掩码跳过的通道数
+   */
+  void recordChannels(size_t evaluated, size_t skipped);
+
+  /**
+   * @brief 结束采样帧: 降频时记录本次采样的姿态, 并写回上一次采样的姿态作为插值起点
+   */
+  void endFrame(Gltf &gltf, GltfAnimationPose &pose, float time);
+
+  /**
+   * @brief 动画全部停止时把最近一次采样的姿态写回节点并清除插值历史
+   */
+  void flush(Gltf &gltf, GltfAnimationPose &pose);
+
+  const GltfAnimationLodStats &getStats() const { return stats; }
+
+ private:
+  /**
+   * @brief 把动画驱动的节点属性读入快照
+   */
+  void capture(const Gltf &gltf, GltfAnimationPose &snapshot,
+               std::vector<uint32_t> &counts) const;
+
+  /**
+   * @brief 在 previous 与 latest 之间插值写回节点
+   */
+  void interpolate(Gltf &gltf, GltfAnimationPose &pose, float alpha);
+
+  void updateSkipMask(float screenSize);
+
+  const Gltf *bound = nullptr;
+  GltfAnimationLodSettings settings;
+  std::vector<uint32_t> animatedNodes;   ///< 被动画驱动的节点
+  std::vector<uint8_t> animatedChannels; ///< 每个节点被驱动的 PoseChannel 位
+  std::vector<float> chainSizes;         ///< 关节链尺寸与模型直径之比, 非关节节点为 FLT_MAX
+  std::vector<uint8_t> skipMask;         ///< 每个节点跳过的 PoseChannel 位
+  glm::vec3 center = glm::vec3(0.0f);    ///< 模型包围球
+  float radius = 0.0f;
+  bool measured = false;
+
+  GltfAnimationPose previous;            ///< 倒数第二次采样的姿态
+  GltfAnimationPose latest;              ///< 最近一次采样的姿态
+  std::vector<uint32_t> previousCounts;  ///< 快照中每个节点的 morph 权重数
+  std::vector<uint32_t> latestCounts;
+  float previousTime = 0.0f;
+  float latestTime = 0.0f;
+  bool hasHistory = false;               ///< 快照是否有效
+  uint32_t framesSinceEvaluation = 0;
+  size_t frameChannels = 0;              ///< 最近一次采样帧的通道总数
+  GltfAnimationLodStats stats;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFANIMATIONLOD_H
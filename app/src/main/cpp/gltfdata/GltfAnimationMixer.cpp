@@ -0,0 +1,540 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#include "GltfAnimationMixer.h"
+#include <algorithm>
+#include <cmath>
+#include "Gltf.h"
+#include "GltfAnimation.h"
+#include "GltfMesh.h"
+#include "GltfNode.h"
+#include "../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr PoseChannel kChannels[] = {POSE_TRANSLATION, POSE_ROTATION,
+                                     POSE_SCALE, POSE_WEIGHTS};
+constexpr size_t kChannelCount = 4;
+constexpr float kIdentity[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+
+float *channelData(GltfAnimationPose &pose, PoseChannel channel, uint32_t node) {
+  switch (channel) {
+    case POSE_TRANSLATION:
+      return pose.translation(node);
+    case POSE_ROTATION:
+      return pose.rotation(node);
+    case POSE_SCALE:
+      return pose.scale(node);
+    default:
+      return pose.weights(node);
+  }
+}
+
+/**
+ * @brief 属性的分量数, morph 权重为本次写入的权重数
+ */
+uint32_t channelWidth(const GltfAnimationPose &pose, PoseChannel channel,
+                      uint32_t node) {
+  switch (channel) {
+    case POSE_ROTATION:
+      return 4;
+    case POSE_WEIGHTS:
+      return pose.getWeightCount(node);
+    default:
+      return 3;
+  }
+}
+
+/**
+ * @brief out = a * b, 四元数按 x, y, z, w 存放, out 可以与 a 或 b 相同
+ */
+void quatMultiply(const float *a, const float *b, float *out) {
+  const float x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+  const float y = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+  const float z = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+  const float w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+  out[0] = x;
+  out[1] = y;
+  out[2] = z;
+  out[3] = w;
+}
+
+void normalizeQuat(float *q) {
+  const float lengthSquared = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+  if (lengthSquared < 1e-16f) {
+    std::copy(kIdentity, kIdentity + 4, q);
+    return;
+  }
+  const float inverse = 1.0f / std::sqrt(lengthSquared);
+  for (size_t i = 0; i < 4; ++i) {
+    q[i] *= inverse;
+  }
+}
+
+float quatDot(const float *a, const float *b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+}
+
+/**
+ * @brief a 沿较短路径向 b 归一化线性插值 t
+ */
+void nlerp(float *a, const float *b, float t) {
+  const float sign = quatDot(a, b) < 0.0f ? -1.0f : 1.0f;
+  for (size_t i = 0; i < 4; ++i) {
+    a[i] = a[i] * (1.0f - t) + sign * b[i] * t;
+  }
+  normalizeQuat(a);
+}
+
+} // namespace
+
+void GltfAnimationMixer::Fade::start(float to, float seconds) {
+  from = value;
+  target = to;
+  duration = std::max(0.0f, seconds);
+  elapsed = 0.0f;
+  if (duration <= 0.0f) {
+    value = to;
+  }
+}
+
+void GltfAnimationMixer::Fade::advance(float delta) {
+  if (value == target) {
+    return;
+  }
+  elapsed += delta;
+  value = elapsed < duration
+      ? from + (target - from) * (elapsed / duration) : target;
+}
+
+float GltfAnimationMixer::Instance::sampleTime() const {
+  const float duration = clip->getDuration();
+  if (duration <= 0.0f) {
+    return 0.0f;
+  }
+  // 有限循环播放完后停在最后一帧
+  if (loopCount >= 0 &&
+      elapsed >= duration * static_cast<float>(std::max(loopCount, 1))) {
+    return duration;
+  }
+  return std::fmod(elapsed, duration);
+}
+
+void GltfAnimationMixer::bind(const Gltf &gltf) {
+  rest.reset(gltf);
+  scratch.reset(gltf);
+  layerPose.reset(gltf);
+  const auto &nodes = gltf.getNodes();
+  const auto &meshes = gltf.getMeshes();
+  for (uint32_t i = 0; i < nodes.size(); ++i) {
+    const auto &node = nodes[i];
+    if (!node) {
+      std::copy(kIdentity, kIdentity + 4, rest.rotation(i));
+      std::fill(rest.scale(i), rest.scale(i) + 3, 1.0f);
+      continue;
+    }
+    const glm::vec3 &t = node->getTranslation();
+    const glm::quat &r = node->getRotation();
+    const glm::vec3 &s = node->getScale();
+    std::copy(&t[0], &t[0] + 3, rest.translation(i));
+    float *rotation = rest.rotation(i);
+    rotation[0] = r.x;
+    rotation[1] = r.y;
+    rotation[2] = r.z;
+    rotation[3] = r.w;
+    std::copy(&s[0], &s[0] + 3, rest.scale(i));
+
+    // 节点没有权重时取网格的默认权重
+    const std::vector<double> *weights = &node->getWeights();
+    const int meshIndex = node->getMesh().value_or(-1);
+    if (weights->empty() && meshIndex >= 0 &&
+        meshIndex < static_cast<int>(meshes.size()) && meshes[meshIndex]) {
+      weights = &meshes[meshIndex]->getWeights();
+    }
+    float *restWeights = rest.weights(i);
+    const uint32_t capacity = rest.getWeightCapacity(i);
+    for (uint32_t k = 0; k < capacity; ++k) {
+      restWeights[k] = k < weights->size() ? static_cast<float>((*weights)[k]) : 0.0f;
+    }
+  }
+  coverage.assign(nodes.size() * kChannelCount, 0.0f);
+  // 层保留, 片段与遮罩属于原模型
+  for (auto &layer: layers) {
+    layer.mask.clear();
+    layer.instances.clear();
+  }
+  lastTime = -1.0f;
+  bound = &gltf;
+}
+
+void GltfAnimationMixer::clear() {
+  layers.clear();
+  rest.clear();
+  scratch.clear();
+  layerPose.clear();
+  std::vector<float>().swap(coverage);
+  lastTime = -1.0f;
+  stats = GltfAnimationMixerStats();
+  bound = nullptr;
+}
+
+bool GltfAnimationMixer::isBoundTo(const Gltf &gltf) const {
+  return bound == &gltf && rest.isBoundTo(gltf);
+}
+
+int GltfAnimationMixer::addLayer(const std::string &name, AnimationBlendMode mode,
+                                 float weight) {
+  int index = findLayer(name);
+  if (index < 0) {
+    layers.emplace_back();
+    layers.back().name = name;
+    index = static_cast<int>(layers.size() - 1);
+  }
+  Layer &layer = layers[index];
+  layer.mode = mode;
+  layer.weight.start(weight, 0.0f);
+  return index;
+}
+
+int GltfAnimationMixer::findLayer(const std::string &name) const {
+  for (size_t i = 0; i < layers.size(); ++i) {
+    if (layers[i].name == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+bool GltfAnimationMixer::setLayerWeight(int layer, float weight,
+                                        float fadeSeconds) {
+  if (layer < 0 || layer >= static_cast<int>(layers.size())) {
+    LOGE("Invalid animation layer: %d", layer);
+    return false;
+  }
+  layers[layer].weight.start(weight, fadeSeconds);
+  return true;
+}
+
+bool GltfAnimationMixer::setLayerMask(const Gltf &gltf, int layer,
+                                      const std::vector<int> &roots) {
+  if (layer < 0 || layer >= static_cast<int>(layers.size())) {
+    LOGE("Invalid animation layer: %d", layer);
+    return false;
+  }
+  auto &mask = layers[layer].mask;
+  mask.clear();
+  if (roots.empty()) {
+    return true;
+  }
+  const auto &nodes = gltf.getNodes();
+  mask.assign(nodes.size(), 0.0f);
+  std::vector<int> stack(roots.begin(), roots.end());
+  while (!stack.empty()) {
+    const int node = stack.back();
+    stack.pop_back();
+    if (node < 0 || node >= static_cast<int>(nodes.size()) || !nodes[node] ||
+        mask[node] > 0.0f) {
+      continue;
+    }
+    mask[node] = 1.0f;
+    const auto &children = nodes[node]->getChildren();
+    stack.insert(stack.end(), children.begin(), children.end());
+  }
+  return true;
+}
+
+bool GltfAnimationMixer::play(const Gltf &gltf, int layer, int animation,
+                              float fadeSeconds, int loopCount, float weight) {
+  if (layer < 0 || layer >= static_cast<int>(layers.size())) {
+    LOGE("Invalid animation layer: %d", layer);
+    return false;
+  }
+  const auto &animations = gltf.getAnimations();
+  if (animation < 0 || animation >= static_cast<int>(animations.size()) ||
+      !animations[animation]) {
+    LOGE("Invalid animation index: %d", animation);
+    return false;
+  }
+  auto clip = animations[animation]->getClip();
+  if (!clip) {
+    LOGW("Animation '%s' has no compiled clip and cannot be layered",
+         animations[animation]->getName().c_str());
+    return false;
+  }
+  if (!clip->getUncompiledChannels().empty()) {
+    LOGW("Animation '%s': %zu uncompiled channels are not layered",
+         animations[animation]->getName().c_str(),
+         clip->getUncompiledChannels().size());
+  }
+  if (!isBoundTo(gltf)) {
+    bind(gltf);
+  }
+
+  Layer &target = layers[layer];
+  for (auto &instance: target.instances) {
+    if (instance.stopping || instance.animation != animation) {
+      continue;
+    }
+    if (instance.loopCount >= 0 &&
+        instance.sampleTime() >= clip->getDuration()) {
+      instance.elapsed = 0.0f;
+      for (auto &cursor: instance.cursors) {
+        cursor.reset();
+      }
+    }
+    instance.loopCount = loopCount;
+    instance.weight.start(weight, fadeSeconds);
+    return true;
+  }
+
+  for (auto &instance: target.instances) {
+    instance.stopping = true;
+    instance.weight.start(0.0f, fadeSeconds);
+  }
+  if (fadeSeconds <= 0.0f) {
+    target.instances.clear();
+  }
+  Instance instance;
+  instance.animation = animation;
+  instance.clip = std::move(clip);
+  instance.cursors.assign(instance.clip->getCursorCount(), GltfKeyframeCursor());
+  instance.loopCount = loopCount;
+  instance.weight.start(weight, fadeSeconds);
+  if (target.mode == AnimationBlendMode::ADDITIVE) {
+    prepareReference(gltf, instance);
+  }
+  target.instances.push_back(std::move(instance));
+  return true;
+}
+
+bool GltfAnimationMixer::stop(int layer, float fadeSeconds) {
+  if (layer < 0 || layer >= static_cast<int>(layers.size())) {
+    LOGE("Invalid animation layer: %d", layer);
+    return false;
+  }
+  auto &instances = layers[layer].instances;
+  for (auto &instance: instances) {
+    instance.stopping = true;
+    instance.weight.start(0.0f, fadeSeconds);
+  }
+  if (fadeSeconds <= 0.0f) {
+    instances.clear();
+  }
+  return true;
+}
+
+bool GltfAnimationMixer::isActive() const {
+  return std::any_of(layers.begin(), layers.end(), [](const Layer &layer) {
+    return !layer.instances.empty();
+  });
+}
+
+void GltfAnimationMixer::prepareReference(const Gltf &gltf,
+                                          Instance &instance) const {
+  instance.reference = std::make_unique<GltfAnimationPose>();
+  instance.reference->reset(gltf);
+  instance.clip->sample(0.0f, *instance.reference);
+  // 只保留数据, 写入记录不再需要
+  instance.reference->discard();
+}
+
+void GltfAnimationMixer::evaluate(Gltf &gltf, GltfAnimationPose &pose,
+                                  float time, const uint8_t *skipChannels) {
+  if (!isBoundTo(gltf)) {
+    bind(gltf);
+  }
+  if (!pose.isBoundTo(gltf)) {
+    pose.reset(gltf);
+  }
+  const float delta = lastTime < 0.0f ? 0.0f : std::max(0.0f, time - lastTime);
+  lastTime = time;
+  stats = GltfAnimationMixerStats();
+
+  for (auto &layer: layers) {
+    layer.weight.advance(delta);
+    for (auto &instance: layer.instances) {
+      instance.weight.advance(delta);
+      instance.elapsed += delta;
+    }
+    // 淡出结束的片段移除
+    auto &instances = layer.instances;
+    instances.erase(std::remove_if(instances.begin(), instances.end(),
+                                   [](const Instance &instance) {
+                                     return instance.stopping &&
+                                         instance.weight.value <= 0.0f;
+                                   }),
+                    instances.end());
+    if (instances.empty() || layer.weight.value <= 0.0f) {
+      continue;
+    }
+    if (layer.mode == AnimationBlendMode::ADDITIVE) {
+      for (auto &instance: instances) {
+        if (!instance.reference) {
+          prepareReference(gltf, instance);
+        }
+      }
+    }
+    accumulate(layer, skipChannels);
+    compose(layer, pose);
+    ++stats.layers;
+  }
+
+  stats.writtenNodes = pose.getTouchedCount();
+  pose.apply(gltf);
+}
+
+void GltfAnimationMixer::accumulate(Layer &layer, const uint8_t *skipChannels) {
+  const bool additive = layer.mode == AnimationBlendMode::ADDITIVE;
+  for (auto &instance: layer.instances) {
+    const float weight = instance.weight.value;
+    if (weight <= 0.0f) {
+      continue;
+    }
+    const size_t sampled = instance.clip->sample(
+        instance.sampleTime(), scratch, instance.cursors.data(), skipChannels);
+    ++stats.instances;
+    stats.sampledTracks += sampled;
+    stats.skippedTracks += instance.clip->getTracks().size() - sampled;
+
+    for (const uint32_t node: scratch.getTouched()) {
+      if (!layer.mask.empty() && layer.mask[node] <= 0.0f) {
+        continue;
+      }
+      const uint8_t written = scratch.getWritten(node);
+      for (size_t c = 0; c < kChannelCount; ++c) {
+        const PoseChannel channel = kChannels[c];
+        if (!(written & channel)) {
+          continue;
+        }
+        float *value = channelData(scratch, channel, node);
+        const uint32_t width = channelWidth(scratch, channel, node);
+        // 叠加层累加相对参考姿态的变化量
+        if (additive) {
+          const float *reference = channelData(*instance.reference, channel, node);
+          if (channel == POSE_ROTATION) {
+            const float inverse[4] = {-reference[0], -reference[1],
+                                      -reference[2], reference[3]};
+            quatMultiply(inverse, value, value);
+            if (value[3] < 0.0f) {
+              for (size_t i = 0; i < 4; ++i) {
+                value[i] = -value[i];
+              }
+            }
+          } else if (channel == POSE_SCALE) {
+            for (uint32_t i = 0; i < width; ++i) {
+              value[i] = reference[i] != 0.0f ? value[i] / reference[i] : 1.0f;
+            }
+          } else {
+            for (uint32_t i = 0; i < width; ++i) {
+              value[i] -= reference[i];
+            }
+          }
+        }
+
+        float &covered = coverage[node * kChannelCount + c];
+        float *sum = channelData(layerPose, channel, node);
+        if (covered <= 0.0f) {
+          if (channel == POSE_WEIGHTS) {
+            std::fill(sum, sum + layerPose.getWeightCapacity(node), 0.0f);
+          }
+          for (uint32_t i = 0; i < width; ++i) {
+            sum[i] = value[i] * weight;
+          }
+        } else {
+          // 四元数取与已累加值同一半球
+          const float sign = channel == POSE_ROTATION && quatDot(sum, value) < 0.0f
+              ? -1.0f : 1.0f;
+          for (uint32_t i = 0; i < width; ++i) {
+            sum[i] += sign * value[i] * weight;
+          }
+        }
+        covered += weight;
+        const uint32_t weightCount = channel == POSE_WEIGHTS
+            ? std::max(width, (layerPose.getWritten(node) & POSE_WEIGHTS)
+                              ? layerPose.getWeightCount(node) : 0u)
+            : 0u;
+        layerPose.mark(node, channel, weightCount);
+      }
+    }
+    scratch.discard();
+  }
+}
+
+void GltfAnimationMixer::compose(const Layer &layer, GltfAnimationPose &pose) {
+  const bool additive = layer.mode == AnimationBlendMode::ADDITIVE;
+  for (const uint32_t node: layerPose.getTouched()) {
+    const float mask = layer.mask.empty() ? 1.0f : layer.mask[node];
+    const float layerWeight = layer.weight.value * mask;
+    const uint8_t written = layerPose.getWritten(node);
+    for (size_t c = 0; c < kChannelCount; ++c) {
+      const PoseChannel channel = kChannels[c];
+      if (!(written & channel)) {
+        continue;
+      }
+      float &covered = coverage[node * kChannelCount + c];
+      const float total = covered;
+      covered = 0.0f;
+      float *sum = channelData(layerPose, channel, node);
+      const uint32_t width = channelWidth(layerPose, channel, node);
+
+      // 本帧首次写入的属性从静止姿态开始
+      float *out = channelData(pose, channel, node);
+      const uint8_t outWritten = pose.getWritten(node);
+      if (!(outWritten & channel)) {
+        const float *restValue = channelData(rest, channel, node);
+        const uint32_t restWidth = channel == POSE_WEIGHTS
+            ? rest.getWeightCapacity(node) : (channel == POSE_ROTATION ? 4 : 3);
+        std::copy(restValue, restValue + restWidth, out);
+      }
+      const uint32_t outWidth = channel == POSE_WEIGHTS
+          ? std::max(width, (outWritten & POSE_WEIGHTS) ? pose.getWeightCount(node)
+                                                        : rest.getWeightCapacity(node))
+          : 0u;
+
+      // 实例权重和超过 1 时取加权平均, 不足 1 时按权重和降低本层的作用
+      const float amount = layerWeight * std::min(total, 1.0f);
+      const float scale = total > 1.0f ? 1.0f / total : 1.0f;
+      if (amount > 0.0f) {
+        if (channel == POSE_ROTATION) {
+          normalizeQuat(sum);
+          if (additive) {
+            float delta[4];
+            std::copy(kIdentity, kIdentity + 4, delta);
+            nlerp(delta, sum, amount);
+            quatMultiply(out, delta, out);
+            normalizeQuat(out);
+          } else if (amount >= 1.0f) {
+            std::copy(sum, sum + 4, out);
+          } else {
+            nlerp(out, sum, amount);
+          }
+        } else if (additive && channel == POSE_SCALE) {
+          for (uint32_t i = 0; i < width; ++i) {
+            // 覆盖不足 1 的部分按比例 1 计
+            const float ratio = sum[i] * scale + (total < 1.0f ? 1.0f - total : 0.0f);
+            out[i] *= 1.0f + (ratio - 1.0f) * layerWeight;
+          }
+        } else if (additive) {
+          for (uint32_t i = 0; i < width; ++i) {
+            out[i] += sum[i] * scale * layerWeight;
+          }
+        } else if (amount >= 1.0f && total == 1.0f) {
+          // 单个满权重片段直接覆盖
+          std::copy(sum, sum + width, out);
+        } else {
+          const float average = 1.0f / total;
+          for (uint32_t i = 0; i < width; ++i) {
+            out[i] += (sum[i] * average - out[i]) * amount;
+          }
+        }
+      }
+      pose.mark(node, channel, outWidth);
+    }
+  }
+  layerPose.discard();
+}
+
+} // namespace digitalhumans
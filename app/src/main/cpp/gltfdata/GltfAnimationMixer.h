@@ -0,0 +1,183 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFANIMATIONMIXER_H
+#define LIGHTDIGITALHUMAN_GLTFANIMATIONMIXER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "GltfAnimationClip.h"
+
+namespace digitalhumans {
+
+class Gltf;
+
+/**
+ * @brief 动画层的混合方式
+ */
+enum class AnimationBlendMode : uint8_t {
+  OVERRIDE,  ///< 按层权重从下层结果插值到本层姿态
+  ADDITIVE,  ///< 叠加本层片段相对其首帧的变化量
+};
+
+/**
+ * @brief 最近一次 evaluate 的统计
+ */
+struct GltfAnimationMixerStats {
+  size_t layers = 0;         ///< 参与混合的层数
+  size_t instances = 0;      ///< 采样的片段实例数
+  size_t sampledTracks = 0;  ///< 采样的轨道数
+  size_t skippedTracks = 0;  ///< 按跳过掩码未采样的轨道数
+  size_t writtenNodes = 0;   ///< 写回的节点数
+};
+
+/**
+ * @brief 动画层栈: 在一次求值中混合全部活动片段
+ *
+ * 层按添加顺序自下而上叠加, 每层有混合方式、可渐变的权重与节点遮罩（若干子树）。
+ * 层内可以同时有多个片段实例: play 时新片段淡入, 原有片段在同一时长内淡出,
+ * 实现不中断的交叉淡化。
+ *
+ * evaluate 逐层把实例采样到临时姿态, 按实例权重累加为层姿态, 再按层权重与遮罩
+ * 合成到输出姿态; 输出姿态中本帧首次写入的属性从模型的静止姿态开始。全部层合成
+ * 后每个节点只写回一次, 不再由多个动画先后覆盖同一节点。
+ */
+class GltfAnimationMixer {
+ public:
+  /**
+   * @brief 按模型分配缓冲并记录节点的静止姿态, 需在动画修改节点之前调用
+   */
+  void bind(const Gltf &gltf);
+
+  /**
+   * @brief 移除全部层并释放缓冲
+   */
+  void clear();
+
+  bool isBoundTo(const Gltf &gltf) const;
+
+  /**
+   * @brief 添加层, 同名层已存在时更新其混合方式与权重
+   * @return 层下标
+   */
+  int addLayer(const std::string &name,
+               AnimationBlendMode mode = AnimationBlendMode::OVERRIDE,
+               float weight = 1.0f);
+
+  /**
+   * @brief 按名称查找层, 不存在时返回 -1
+   */
+  int findLayer(const std::string &name) const;
+
+  /**
+   * @brief 在 fadeSeconds 秒内把层权重渐变到 weight
+   */
+  bool setLayerWeight(int layer, float weight, float fadeSeconds = 0.0f);
+
+  /**
+   * @brief 限制层只作用于若干节点及其全部子节点, roots 为空时作用于全部节点
+   */
+  bool setLayerMask(const Gltf &gltf, int layer, const std::vector<int> &roots);
+
+  /**
+   * @brief 在层上播放动画, 层上原有的片段在同一时长内淡出
+   *
+   * 动画已在该层播放且未淡出时只调整其目标权重（已播放完的有限循环从头开始）。
+   * @param animation 动画下标, 动画需已编译为片段
+   * @param fadeSeconds 交叉淡化时长, 为 0 时立即切换
+   * @param loopCount 循环次数, -1 为无限循环; 播放完后停在最后一帧
+   * @param weight 片段在层内的权重
+   */
+  bool play(const Gltf &gltf, int layer, int animation, float fadeSeconds = 0.0f,
+            int loopCount = -1, float weight = 1.0f);
+
+  /**
+   * @brief 在 fadeSeconds 秒内淡出层上的全部片段
+   */
+  bool stop(int layer, float fadeSeconds = 0.0f);
+
+  /**
+   * @brief 是否有正在播放的片段
+   */
+  bool isActive() const;
+
+  /**
+   * @brief 推进全部片段与渐变并把混合结果写回节点
+   * @param time 动画时间轴的当前时间（秒）, 与上次调用的差值作为本帧时长
+   * @param pose 输出姿态, 未按该模型分配时重新分配
+   * @param skipChannels 每个节点不采样的 PoseChannel 位, 跳过的属性保持节点当前值
+   */
+  void evaluate(Gltf &gltf, GltfAnimationPose &pose, float time,
+                const uint8_t *skipChannels = nullptr);
+
+  const GltfAnimationMixerStats &getStats() const { return stats; }
+
+ private:
+  /**
+   * @brief 线性渐变的权重
+   */
+  struct Fade {
+    float value = 0.0f;
+    float from = 0.0f;
+    float target = 0.0f;
+    float duration = 0.0f;
+    float elapsed = 0.0f;
+
+    void start(float to, float seconds);
+
+    void advance(float delta);
+  };
+
+  /**
+   * @brief 层上播放的一个片段
+   */
+  struct Instance {
+    int animation = -1;
+    std::shared_ptr<const GltfAnimationClip> clip;
+    std::vector<GltfKeyframeCursor> cursors;   ///< 实例自己的关键帧游标
+    std::unique_ptr<GltfAnimationPose> reference; ///< 叠加层的参考姿态（片段首帧）
+    float elapsed = 0.0f;                      ///< 已播放的时间（秒）
+    int loopCount = -1;
+    bool stopping = false;                     ///< 正在淡出, 淡出结束后移除
+    Fade weight;
+
+    float sampleTime() const;
+  };
+
+  struct Layer {
+    std::string name;
+    AnimationBlendMode mode = AnimationBlendMode::OVERRIDE;
+    Fade weight;
+    std::vector<float> mask;  ///< 每个节点的遮罩权重, 为空时作用于全部节点
+    std::vector<Instance> instances;
+  };
+
+  void prepareReference(const Gltf &gltf, Instance &instance) const;
+
+  /**
+   * @brief 把层内实例按权重累加到 layerPose
+   */
+  void accumulate(Layer &layer, const uint8_t *skipChannels);
+
+  /**
+   * @brief 把 layerPose 按层权重与遮罩合成到输出姿态
+   */
+  void compose(const Layer &layer, GltfAnimationPose &pose);
+
+  const Gltf *bound = nullptr;
+  std::vector<Layer> layers;
+  GltfAnimationPose rest;       ///< 节点的静止姿态
+  GltfAnimationPose scratch;    ///< 单个实例的采样结果
+  GltfAnimationPose layerPose;  ///< 层内实例的加权和
+  std::vector<float> coverage;  ///< 每个节点每种属性的累加权重, 每节点 4 个
+  float lastTime = -1.0f;
+  GltfAnimationMixerStats stats;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFANIMATIONMIXER_H
@@ -4,7 +4,6 @@
 
 #include "GltfAsset.h"
 #include "../utils/utils.h"
-#include <android/log.h>
 #include <regex>
 #include <sstream>
 
@@ -17,6 +17,7 @@ void GltfBuffer::clear() {
   byteLength.reset();
   name.reset();
   buffer.clear();
+  external = GltfBinaryChunk();
 }
 
 bool GltfBuffer::validate() const {
@@ -25,10 +26,10 @@ bool GltfBuffer::validate() const {
     return true;
   }
 
-  if (!buffer.empty()) {
+  if (getActualSize() > 0) {
     // 如果有byteLength，检查是否匹配
     if (byteLength.has_value()) {
-      return buffer.size() == byteLength.value();
+      return getActualSize() == byteLength.value();
     }
     return true;
   }
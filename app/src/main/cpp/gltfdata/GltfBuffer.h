@@ -13,9 +13,20 @@
 #include <string>
 #include <optional>
 #include <cstdint>
+#include <memory>
 
 namespace digitalhumans {
 
+/**
+ * @brief 外部二进制数据块（如内存映射的 GLB BIN 块）
+ * owner 负责保持底层存储存活, data/size 描述实际数据范围
+ */
+struct GltfBinaryChunk {
+  std::shared_ptr<const void> owner;      ///< 底层存储的持有者
+  const uint8_t *data = nullptr;          ///< 数据起始地址
+  size_t size = 0;                        ///< 数据字节长度
+};
+
 /**
  * @brief glTF缓冲区类
  * 表示二进制数据的缓冲区
@@ -45,12 +56,36 @@ class GltfBuffer: public GltfObject {
   void setBuffer(const std::vector<unsigned char> &buffer) {
     this->buffer = buffer;
     this->byteLength = buffer.size();
+    this->external = GltfBinaryChunk();
   }
   void setBuffer(std::vector<unsigned char> &&buffer) {
     this->buffer = std::move(buffer);
     this->byteLength = this->buffer.size();
+    this->external = GltfBinaryChunk();
+  }
+
+  /**
+   * @brief 直接引用外部数据块（零拷贝）, 不复制数据
+   * @param chunk 外部数据块, 其 owner 会被持有直到缓冲区释放
+   */
+  void setExternalData(const GltfBinaryChunk &chunk) {
+    this->buffer.clear();
+    this->external = chunk;
+    this->byteLength = chunk.size;
   }
 
+  /**
+   * @brief 获取缓冲区数据（自有数据或外部引用的数据）
+   */
+  const uint8_t *getData() const {
+    return external.data ? external.data : buffer.data();
+  }
+
+  /**
+   * @brief 是否引用外部数据
+   */
+  bool isExternal() const { return external.data != nullptr; }
+
   // === 工具方法 ===
   /**
    * @brief 检查缓冲区是否有效
@@ -69,7 +104,9 @@ class GltfBuffer: public GltfObject {
   /**
    * @brief 获取实际数据大小
    */
-  size_t getActualSize() const { return buffer.size(); }
+  size_t getActualSize() const {
+    return external.data ? external.size : buffer.size();
+  }
 
 
  public:
@@ -80,6 +117,7 @@ class GltfBuffer: public GltfObject {
 
   // === 非glTF标准属性 ===
   std::vector<uint8_t> buffer;            ///< 原始二进制数据
+  GltfBinaryChunk external;               ///< 外部引用的数据（非空时优先于 buffer）
 
 
 };
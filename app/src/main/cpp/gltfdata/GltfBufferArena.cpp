@@ -0,0 +1,262 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#include "GltfBufferArena.h"
+#include <algorithm>
+#include "../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+namespace {
+
+size_t alignSize(size_t size) {
+  const size_t mask = GltfBufferArena::kAlignment - 1;
+  return (size + mask) & ~mask;
+}
+
+} // namespace
+
+GltfBufferAllocation::~GltfBufferAllocation() {
+  arena.release(*this);
+}
+
+GltfBufferArena &GltfBufferArena::shared() {
+  // 分配可能由静态缓存中的模型持有, 区域不能先于它们析构
+  static auto *arena = new GltfBufferArena();
+  return *arena;
+}
+
+std::unique_ptr<GltfBufferAllocation>
+GltfBufferArena::allocate(GLenum target, const void *data, size_t size) {
+  if (!data || size == 0) {
+    return nullptr;
+  }
+  const size_t alignedSize = alignSize(size);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  Pool &pool = poolFor(target);
+  Block *block = nullptr;
+  size_t offset = 0;
+  for (const auto &candidate: pool.blocks) {
+    if (takeRange(*candidate, alignedSize, offset)) {
+      block = candidate.get();
+      break;
+    }
+  }
+  if (!block) {
+    block = createBlock(pool, target, std::max(kBlockSize, alignedSize));
+    if (!block || !takeRange(*block, alignedSize, offset)) {
+      return nullptr;
+    }
+  }
+
+  glBindBuffer(target, block->buffer);
+  glBufferSubData(target, static_cast<GLintptr>(offset),
+                  static_cast<GLsizeiptr>(size), data);
+  std::unique_ptr<GltfBufferAllocation> allocation(
+      new GltfBufferAllocation(*this, target, block->buffer, offset, size));
+  block->live.insert(allocation.get());
+  return allocation;
+}
+
+void GltfBufferArena::release(GltfBufferAllocation &allocation) {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto &block: poolFor(allocation.target).blocks) {
+    if (block->buffer == allocation.buffer) {
+      block->live.erase(&allocation);
+      returnRange(*block, allocation.offset, alignSize(allocation.size));
+      return;
+    }
+  }
+}
+
+bool GltfBufferArena::takeRange(Block &block, size_t size, size_t &offset) {
+  // 首次适配: 空闲区间按偏移有序, 优先填充缓冲前部
+  for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it) {
+    if (it->second < size) {
+      continue;
+    }
+    offset = it->first;
+    const size_t remaining = it->second - size;
+    block.freeRanges.erase(it);
+    if (remaining > 0) {
+      block.freeRanges.emplace(offset + size, remaining);
+    }
+    return true;
+  }
+  return false;
+}
+
+void GltfBufferArena::returnRange(Block &block, size_t offset, size_t size) {
+  auto it = block.freeRanges.emplace(offset, size).first;
+  // 与后一个区间合并
+  auto next = std::next(it);
+  if (next != block.freeRanges.end() && it->first + it->second == next->first) {
+    it->second += next->second;
+    block.freeRanges.erase(next);
+  }
+  // 与前一个区间合并
+  if (it != block.freeRanges.begin()) {
+    auto prev = std::prev(it);
+    if (prev->first + prev->second == it->first) {
+      prev->second += it->second;
+      block.freeRanges.erase(it);
+    }
+  }
+}
+
+GltfBufferArena::Block *
+GltfBufferArena::createBlock(Pool &pool, GLenum target, size_t size) {
+  if (maxBytes > 0 && totalBytes + size > maxBytes) {
+    LOGW("Arena buffer of %zu bytes exceeds the %zu byte limit", size, maxBytes);
+    return nullptr;
+  }
+  auto block = std::make_unique<Block>();
+  glGenBuffers(1, &block->buffer);
+  glBindBuffer(target, block->buffer);
+  glBufferData(target, static_cast<GLsizeiptr>(size), nullptr, GL_STATIC_DRAW);
+  if (block->buffer == 0 || glGetError() == GL_OUT_OF_MEMORY) {
+    LOGE("Failed to create arena buffer of %zu bytes", size);
+    glDeleteBuffers(1, &block->buffer);
+    return nullptr;
+  }
+  block->size = size;
+  block->freeRanges.emplace(0, size);
+  totalBytes += size;
+  pool.blocks.push_back(std::move(block));
+  return pool.blocks.back().get();
+}
+
+void GltfBufferArena::deleteBlock(Block &block) {
+  glDeleteBuffers(1, &block.buffer);
+  totalBytes -= block.size;
+}
+
+size_t GltfBufferArena::compact(float minFreeRatio) {
+  std::lock_guard<std::mutex> lock(mutex);
+  return compactPool(vertexPool, GL_ARRAY_BUFFER, minFreeRatio) +
+      compactPool(indexPool, GL_ELEMENT_ARRAY_BUFFER, minFreeRatio);
+}
+
+size_t GltfBufferArena::compactPool(Pool &pool, GLenum target,
+                                    float minFreeRatio) {
+  // 没有存活分配的缓冲直接删除
+  size_t released = 0;
+  for (auto it = pool.blocks.begin(); it != pool.blocks.end();) {
+    if ((*it)->live.empty()) {
+      deleteBlock(**it);
+      it = pool.blocks.erase(it);
+      ++released;
+    } else {
+      ++it;
+    }
+  }
+
+  size_t totalBytes = 0;
+  size_t freeBytes = 0;
+  size_t largest = 0;
+  for (const auto &block: pool.blocks) {
+    totalBytes += block->size;
+    for (const auto &[_, length]: block->freeRanges) {
+      freeBytes += length;
+    }
+    for (const auto *allocation: block->live) {
+      largest = std::max(largest, alignSize(allocation->size));
+    }
+  }
+  if (pool.blocks.size() < 2 || totalBytes == 0 ||
+      static_cast<float>(freeBytes) < minFreeRatio * static_cast<float>(totalBytes)) {
+    return released;
+  }
+
+  // 按原缓冲与偏移顺序把存活数据紧密复制到新缓冲
+  std::vector<std::unique_ptr<Block>> old;
+  old.swap(pool.blocks);
+  const size_t blockSize = std::max(kBlockSize, largest);
+  Block *current = nullptr;
+  size_t cursor = 0;
+  for (auto &block: old) {
+    std::vector<GltfBufferAllocation *> live(block->live.begin(),
+                                             block->live.end());
+    std::sort(live.begin(), live.end(),
+              [](const GltfBufferAllocation *a, const GltfBufferAllocation *b) {
+                return a->offset < b->offset;
+              });
+    // 已移出当前旧缓冲的区间, 中途失败时归还给旧缓冲
+    std::vector<std::pair<size_t, size_t>> moved;
+    moved.reserve(live.size());
+    for (auto *allocation: live) {
+      const size_t alignedSize = alignSize(allocation->size);
+      if (!current || cursor + alignedSize > current->size) {
+        current = createBlock(pool, target, blockSize);
+        if (!current) {
+          // 创建失败时保留未移动的旧缓冲, 已移走的区间重新标记为空闲
+          for (const auto &[offset, size]: moved) {
+            returnRange(*block, offset, size);
+          }
+          for (auto &remaining: old) {
+            if (remaining && !remaining->live.empty()) {
+              pool.blocks.push_back(std::move(remaining));
+            }
+          }
+          glBindBuffer(GL_COPY_READ_BUFFER, 0);
+          glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+          return released;
+        }
+        current->freeRanges.clear();
+        cursor = 0;
+      }
+      glBindBuffer(GL_COPY_READ_BUFFER, block->buffer);
+      glBindBuffer(GL_COPY_WRITE_BUFFER, current->buffer);
+      glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                          static_cast<GLintptr>(allocation->offset),
+                          static_cast<GLintptr>(cursor),
+                          static_cast<GLsizeiptr>(allocation->size));
+      block->live.erase(allocation);
+      moved.emplace_back(allocation->offset, alignedSize);
+      allocation->buffer = current->buffer;
+      allocation->offset = cursor;
+      current->live.insert(allocation);
+      cursor += alignedSize;
+      current->freeRanges.clear();
+      if (cursor < current->size) {
+        current->freeRanges.emplace(cursor, current->size - cursor);
+      }
+    }
+    deleteBlock(*block);
+    block.reset();
+    ++released;
+  }
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  LOGI("Compacted %s arena: %zu -> %zu buffers, %zu bytes free before",
+       target == GL_ELEMENT_ARRAY_BUFFER ? "index" : "vertex", old.size(),
+       pool.blocks.size(), freeBytes);
+  return released;
+}
+
+void GltfBufferArena::setMaxBytes(size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex);
+  maxBytes = bytes;
+}
+
+GltfBufferArenaStats GltfBufferArena::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  GltfBufferArenaStats stats;
+  for (const Pool *pool: {&vertexPool, &indexPool}) {
+    for (const auto &block: pool->blocks) {
+      ++stats.blocks;
+      stats.allocations += block->live.size();
+      size_t freeBytes = 0;
+      for (const auto &[_, length]: block->freeRanges) {
+        freeBytes += length;
+      }
+      stats.freeBytes += freeBytes;
+      stats.usedBytes += block->size - freeBytes;
+    }
+  }
+  return stats;
+}
+
+} // namespace digitalhumans
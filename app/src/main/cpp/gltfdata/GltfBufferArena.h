@@ -0,0 +1,165 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFBUFFERARENA_H
+#define LIGHTDIGITALHUMAN_GLTFBUFFERARENA_H
+
+#include <GLES3/gl3.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace digitalhumans {
+
+class GltfBufferArena;
+
+/**
+ * @brief 缓冲区域中的一段分配, 析构时归还区域
+ *
+ * 整理碎片时数据可能被移动到其他缓冲, 因此每次绑定都要重新读取缓冲与偏移。
+ */
+class GltfBufferAllocation {
+ public:
+  ~GltfBufferAllocation();
+
+  GltfBufferAllocation(const GltfBufferAllocation &) = delete;
+  GltfBufferAllocation &operator=(const GltfBufferAllocation &) = delete;
+
+  GLuint getBuffer() const { return buffer; }
+
+  size_t getOffset() const { return offset; }
+
+  size_t getSize() const { return size; }
+
+  /**
+   * @brief 偏移转换为 glVertexAttribPointer / glDrawElements 的指针参数
+   */
+  const void *offsetPointer(size_t extra = 0) const {
+    return reinterpret_cast<const void *>(static_cast<uintptr_t>(offset + extra));
+  }
+
+ private:
+  friend class GltfBufferArena;
+
+  GltfBufferAllocation(GltfBufferArena &arena, GLenum target, GLuint buffer,
+                       size_t offset, size_t size)
+      : arena(arena), target(target), buffer(buffer), offset(offset),
+        size(size) {}
+
+  GltfBufferArena &arena;
+  GLenum target;
+  GLuint buffer;
+  size_t offset;
+  size_t size;
+};
+
+/**
+ * @brief 缓冲区域的使用统计
+ */
+struct GltfBufferArenaStats {
+  size_t blocks = 0;       ///< 缓冲对象数
+  size_t allocations = 0;  ///< 存活的分配数
+  size_t usedBytes = 0;    ///< 已分配字节数（含对齐）
+  size_t freeBytes = 0;    ///< 缓冲中的空闲字节数
+};
+
+/**
+ * @brief 顶点与索引数据的缓冲区域
+ *
+ * 每个访问器单独创建缓冲会产生大量小缓冲对象, 绘制时频繁切换。区域按绑定目标
+ * （GL_ARRAY_BUFFER / GL_ELEMENT_ARRAY_BUFFER）分别维护若干大缓冲, 缓冲只在创建时
+ * 用 glBufferData 定义一次存储, 之后以 glBufferSubData 填充子区间, 不再重新分配。
+ * 空闲区间按偏移有序存放, 释放时与相邻区间合并; compact 在模型卸载后把碎片化
+ * 缓冲中的数据用 glCopyBufferSubData 紧密复制到新缓冲并删除旧缓冲。
+ *
+ * allocate 与 compact 需在 GL 线程调用; 分配可在任意线程析构, 只修改空闲列表。
+ */
+class GltfBufferArena {
+ public:
+  static constexpr size_t kBlockSize = 4 << 20;  ///< 默认缓冲大小
+  static constexpr size_t kAlignment = 16;       ///< 分配的起始对齐
+
+  GltfBufferArena() = default;
+
+  /**
+   * @brief 缓冲对象与 GL 上下文一同销毁, 析构时不调用 GL
+   */
+  ~GltfBufferArena() = default;
+
+  GltfBufferArena(const GltfBufferArena &) = delete;
+  GltfBufferArena &operator=(const GltfBufferArena &) = delete;
+
+  /**
+   * @brief 进程内共享的缓冲区域, 首次使用时创建, 不随静态对象析构
+   */
+  static GltfBufferArena &shared();
+
+  /**
+   * @brief 分配并上传数据
+   * @param target GL_ARRAY_BUFFER 或 GL_ELEMENT_ARRAY_BUFFER
+   * @return 分配失败时返回 nullptr
+   */
+  std::unique_ptr<GltfBufferAllocation> allocate(GLenum target,
+                                                 const void *data,
+                                                 size_t size);
+
+  /**
+   * @brief 空闲字节超过 minFreeRatio 时把该目标的数据紧密复制到新缓冲
+   * @return 整理了的缓冲数
+   */
+  size_t compact(float minFreeRatio = 0.25f);
+
+  /**
+   * @brief 设置两个目标的缓冲总字节上限, 0 表示不限制
+   *
+   * 超出上限时不再创建缓冲: allocate 返回 nullptr, compact 保留尚未移动的数据。
+   */
+  void setMaxBytes(size_t bytes);
+
+  GltfBufferArenaStats getStats() const;
+
+ private:
+  friend class GltfBufferAllocation;
+
+  struct Block {
+    GLuint buffer = 0;
+    size_t size = 0;
+    std::map<size_t, size_t> freeRanges;      ///< 偏移 -> 长度
+    std::set<GltfBufferAllocation *> live;    ///< 存活的分配
+  };
+
+  struct Pool {
+    std::vector<std::unique_ptr<Block>> blocks;
+  };
+
+  void release(GltfBufferAllocation &allocation);
+
+  static bool takeRange(Block &block, size_t size, size_t &offset);
+
+  static void returnRange(Block &block, size_t offset, size_t size);
+
+  Block *createBlock(Pool &pool, GLenum target, size_t size);
+
+  void deleteBlock(Block &block);
+
+  size_t compactPool(Pool &pool, GLenum target, float minFreeRatio);
+
+  Pool &poolFor(GLenum target) {
+    return target == GL_ELEMENT_ARRAY_BUFFER ? indexPool : vertexPool;
+  }
+
+  mutable std::mutex mutex;
+  Pool vertexPool;
+  Pool indexPool;
+  size_t totalBytes = 0;  ///< 两个目标的缓冲总字节数
+  size_t maxBytes = 0;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFBUFFERARENA_H
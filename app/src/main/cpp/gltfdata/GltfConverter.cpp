@@ -3,6 +3,11 @@
 //
 
 #include "GltfConverter.h"
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <map>
+#include <set>
 #include "../utils/LogUtils.h"
 #include "converter/MaterialConverter.h"
 #include "Gltf.h"
@@ -23,30 +28,139 @@
 #include "GltfAnimation.h"
 #include "GltfObject.h"
 #include "GltfPrimitive.h"
+#include "GltfVertexLayout.h"
+#include "GltfResidency.h"
 #include "GltfMaterial.h"
 #include "../../engine/Engine.h"
 #include "UserCamera.h"
+#include "converter/GltfAssetCache.h"
+#include "converter/GltfDracoDecoder.h"
+#include "converter/GltfIndexPacker.h"
+#include "converter/GltfMeshOptimizer.h"
+#include "../utils/PixelConvert.h"
+#include "../utils/ThreadPool.h"
 
 
 namespace digitalhumans {
 
 std::shared_ptr<Gltf> GltfConverter::convert(const tinygltf::Model &model,
                                              Engine &gltfView,
-                                             const std::string &filePath) {
+                                             const std::string &filePath,
+                                             const GltfBinaryChunk *binChunk,
+                                             bool deferGlInit,
+                                             const std::vector<std::shared_ptr<ImageData>> *decodedImages,
+                                             bool optimizeMeshes,
+                                             const GltfAnimationCompression &compression,
+                                             std::shared_ptr<const GltfConvertedData> *converted) {
+  return convertModel(model, gltfView, filePath, binChunk, nullptr,
+                      deferGlInit, decodedImages, optimizeMeshes, compression,
+                      converted);
+}
+
+std::shared_ptr<Gltf> GltfConverter::convert(const GltfSharedAsset &asset,
+                                             Engine &gltfView,
+                                             bool deferGlInit,
+                                             bool optimizeMeshes,
+                                             const GltfAnimationCompression &compression,
+                                             std::shared_ptr<const GltfConvertedData> *converted) {
+  if (!asset.document) {
+    LOGE("共享资源缺少结构描述");
+    return nullptr;
+  }
+  return convertModel(*asset.document, gltfView, "", nullptr, &asset,
+                      deferGlInit, nullptr,
+                      optimizeMeshes && !asset.optimizedMeshes, compression,
+                      converted);
+}
+
+std::shared_ptr<GltfSharedAsset>
+GltfConverter::createSharedAsset(tinygltf::Model &&model, const Gltf &gltf,
+                                 std::shared_ptr<const GltfConvertedData> converted) {
+  auto asset = std::make_shared<GltfSharedAsset>();
+  if (converted) {
+    asset->byteSize += converted->byteSize;
+    asset->converted = std::move(converted);
+  }
+
+  // 转换过程中可能追加生成的 buffer, 只取与模型对应的部分
+  const auto &buffers = gltf.getBuffers();
+  size_t bufferCount = std::min(model.buffers.size(), buffers.size());
+  asset->buffers.assign(buffers.begin(), buffers.begin() + bufferCount);
+  for (const auto &buffer: asset->buffers) {
+    asset->byteSize += buffer ? buffer->getActualSize() : 0;
+  }
+
+  const auto &images = gltf.getImages();
+  asset->images.resize(model.images.size());
+  for (size_t i = 0; i < model.images.size() && i < images.size(); ++i) {
+    if (images[i] && images[i]->getImageData()) {
+      asset->images[i] = images[i]->getImageData();
+      asset->byteSize += asset->images[i]->getDataSize();
+    }
+  }
+
+  // 数据已由共享资源持有, 释放模型中的副本
+  for (auto &buffer: model.buffers) {
+    std::vector<unsigned char>().swap(buffer.data);
+  }
+  for (auto &image: model.images) {
+    std::vector<unsigned char>().swap(image.image);
+  }
+  asset->document = std::make_shared<const tinygltf::Model>(std::move(model));
+  return asset;
+}
+
+std::shared_ptr<Gltf>
+GltfConverter::convertModel(const tinygltf::Model &model,
+                            Engine &gltfView,
+                            const std::string &filePath,
+                            const GltfBinaryChunk *binChunk,
+                            const GltfSharedAsset *shared,
+                            bool deferGlInit,
+                            const std::vector<std::shared_ptr<ImageData>> *decodedImages,
+                            bool optimizeMeshes,
+                            const GltfAnimationCompression &compression,
+                            std::shared_ptr<const GltfConvertedData> *converted) {
+  // 没有回退数据的压缩图元无法显示, 构建不含 Draco 时不接受要求该扩展的模型
+  for (const auto &extension: model.extensionsRequired) {
+    if (extension == GltfDracoDecoder::kExtensionName &&
+        !GltfDracoDecoder::isAvailable()) {
+      LOGE("模型要求 %s, 当前构建不含 Draco 解码", extension.c_str());
+      return nullptr;
+    }
+  }
   auto gltf = std::make_shared<Gltf>(filePath);
   if (!gltf) {
     LOGE("创建Gltf对象失败");
     return nullptr;
   }
+  // 缓存的处理结果: 网格优化与请求相符时复用访问器与图元, 压缩参数相同时复用动画片段
+  const GltfConvertedData *reuse = shared ? shared->converted.get() : nullptr;
+  const bool reuseMeshes = reuse &&
+      (reuse->optimizedMeshes || !optimizeMeshes) &&
+      reuse->primitives.size() == model.meshes.size();
+  const bool reuseAnimations = reuse && reuse->compression == compression &&
+      reuse->animations.size() == model.animations.size();
+  std::shared_ptr<GltfConvertedData> record;
+  if (converted && !reuse) {
+    record = std::make_shared<GltfConvertedData>();
+    record->optimizedMeshes =
+        optimizeMeshes || (shared && shared->optimizedMeshes);
+    record->compression = compression;
+  }
   try {
     // 转换 Asset
     if (!model.asset.version.empty()) {
       gltf->setAsset(convertAsset(model.asset));
     }
 
-    // 转换 Buffers
-    for (const auto &buffer: model.buffers) {
-      gltf->buffers.push_back(convertBuffer(buffer));
+    // 转换 Buffers（共享资源直接复用）
+    if (shared) {
+      gltf->buffers = shared->buffers;
+    } else {
+      for (const auto &buffer: model.buffers) {
+        gltf->buffers.push_back(convertBuffer(buffer, binChunk));
+      }
     }
 
     // 转换 BufferViews
@@ -54,14 +168,26 @@ std::shared_ptr<Gltf> GltfConverter::convert(const tinygltf::Model &model,
       gltf->bufferViews.push_back(convertBufferView(bufferView));
     }
 
-    // 转换 Accessors
-    for (const auto &accessor: model.accessors) {
-      gltf->accessors.push_back(convertAccessor(accessor));
+    // 转换 Accessors（缓存的处理结果直接复制）
+    if (reuseMeshes) {
+      for (const auto &accessor: reuse->accessors) {
+        gltf->accessors.push_back(accessor->cloneConverted());
+      }
+    } else {
+      for (const auto &accessor: model.accessors) {
+        gltf->accessors.push_back(convertAccessor(accessor));
+      }
     }
 
     // 转换 Images
-    for (const auto &image: model.images) {
-      gltf->images.push_back(convertImage(image));
+    for (size_t i = 0; i < model.images.size(); ++i) {
+      std::shared_ptr<ImageData> decoded;
+      if (shared && i < shared->images.size()) {
+        decoded = shared->images[i];
+      } else if (decodedImages && i < decodedImages->size()) {
+        decoded = (*decodedImages)[i];
+      }
+      gltf->images.push_back(convertImage(model.images[i], decoded));
     }
 
     // 转换 Samplers
@@ -71,7 +197,7 @@ std::shared_ptr<Gltf> GltfConverter::convert(const tinygltf::Model &model,
 
     // 转换 Textures
     for (const auto &texture: model.textures) {
-      gltf->textures.push_back(convertTexture(texture));
+      gltf->textures.push_back(convertTexture(texture, gltf->images));
     }
 
     // 转换 Materials
@@ -81,9 +207,51 @@ std::shared_ptr<Gltf> GltfConverter::convert(const tinygltf::Model &model,
       gltf->materials.push_back(newMaterial);
     }
 
-    // 转换 Meshes
-    for (const auto &mesh: model.meshes) {
-      gltf->meshes.push_back(convertMesh(mesh, gltf, gltfView));
+    // 转换 Meshes（共享资源可能带有预组装的变形目标纹理）,
+    // Draco 图元解码完成后才能 initGl
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+      const auto *morphTargets =
+          shared && i < shared->morphTargets.size() ? &shared->morphTargets[i]
+                                                    : nullptr;
+      gltf->meshes.push_back(convertMesh(model.meshes[i], gltf, gltfView,
+                                         true, morphTargets));
+    }
+    if (reuseMeshes) {
+      for (size_t i = 0; i < gltf->meshes.size(); ++i) {
+        std::vector<std::shared_ptr<GltfPrimitive>> primitives;
+        for (const auto &primitive: reuse->primitives[i]) {
+          primitives.push_back(std::make_shared<GltfPrimitive>(*primitive));
+        }
+        gltf->meshes[i]->setPrimitives(primitives);
+      }
+    } else {
+      decodeDracoPrimitives(gltf);
+      if (optimizeMeshes) {
+        GltfConverter::optimizeMeshes(model, gltf);
+      }
+      packIndices(gltf);
+    }
+    // 在生成顶点布局与 initGl 之前记录, 复制出的图元不带任何实例状态
+    if (record) {
+      for (const auto &accessor: gltf->accessors) {
+        auto cloned = accessor->cloneConverted();
+        record->byteSize += cloned->getCpuBytes();
+        record->accessors.push_back(std::move(cloned));
+      }
+      for (const auto &mesh: gltf->meshes) {
+        auto &primitives = record->primitives.emplace_back();
+        for (const auto &primitive: mesh->getPrimitives()) {
+          primitives.push_back(std::make_shared<const GltfPrimitive>(*primitive));
+        }
+      }
+    }
+    buildVertexLayouts(gltf);
+    if (!deferGlInit) {
+      for (const auto &mesh: gltf->meshes) {
+        for (const auto &primitive: mesh->getPrimitives()) {
+          primitive->initGl(gltf, gltfView.context);
+        }
+      }
     }
 
     // 转换 Nodes
@@ -100,7 +268,9 @@ std::shared_ptr<Gltf> GltfConverter::convert(const tinygltf::Model &model,
     // 转换 Skins
     for (const auto &skin: model.skins) {
       auto gltfSkin = convertSkin(skin);
-      gltfSkin->initGl(gltf, gltfView.context);
+      if (!deferGlInit) {
+        gltfSkin->initGl(gltf, gltfView.context);
+      }
       gltf->addSkin(gltfSkin);
     }
 
@@ -109,19 +279,32 @@ std::shared_ptr<Gltf> GltfConverter::convert(const tinygltf::Model &model,
       gltf->addCamera(convertCamera(camera));
     }
 
-    // 转换 Animations
-    for (const auto &animation: model.animations) {
-      auto gltfAnimation = convertAnimation(animation);
-      gltfAnimation->initGl(gltf, gltfView.context);
+    // 转换 Animations（缓存的动画克隆后共享编译好的片段）
+    for (size_t i = 0; i < model.animations.size(); ++i) {
+      if (reuseAnimations) {
+        gltf->animations.push_back(reuse->animations[i]->clone());
+        continue;
+      }
+      auto gltfAnimation = convertAnimation(model.animations[i]);
+      gltfAnimation->initGl(gltf, gltfView.context, compression);
       gltf->animations.push_back(gltfAnimation);
+      if (record) {
+        record->animations.push_back(gltfAnimation->clone());
+      }
     }
 
+    // 动画与蒙皮转换完成后才能确定访问器的驻留策略
+    GltfResidency::classify(*gltf);
+
     auto lights = convertLights(model);
     for (auto &light: lights) {
       gltf->lights.push_back(light);
     }
     // 设置默认场景
     gltf->setScene(model.defaultScene);
+    if (record) {
+      *converted = std::move(record);
+    }
     return gltf;
 
   } catch (const std::exception &e) {
@@ -562,7 +745,8 @@ GltfConverter::convertScene(const tinygltf::Scene &scene) {
 
 
 std::shared_ptr<GltfTexture>
-GltfConverter::convertTexture(const tinygltf::Texture &texture) {
+GltfConverter::convertTexture(const tinygltf::Texture &texture,
+                              const std::vector<std::shared_ptr<GltfImage>> &images) {
   try {
 
     // 处理索引
@@ -572,6 +756,10 @@ GltfConverter::convertTexture(const tinygltf::Texture &texture) {
     std::optional<int> sourceIndex = (texture.source >= 0) ?
                                      std::make_optional(texture.source)
                                                            : std::nullopt;
+    // KTX2 转码成功时优先使用, 否则回退到 texture.source
+    if (auto basisSource = convertKHRTextureBasisU(texture, images)) {
+      sourceIndex = basisSource;
+    }
 
     // 验证必要参数
     if (!sourceIndex.has_value()) {
@@ -668,8 +856,7 @@ void GltfConverter::convertTextureExtensions(
       // 处理立方体贴图扩展
       gltfTexture->setType(GL_TEXTURE_CUBE_MAP);
     } else if (extName == "KHR_texture_basisu") {
-      // 处理 Basis Universal 纹理扩展
-      //   convertKHRTextureBasisU(extValue, gltfTexture);
+      // 图像来源已在 convertTexture 中选择
     } else {
       // 其他扩展
       LOGW("Unhandled texture extension: %s", extName.c_str());
@@ -705,6 +892,27 @@ bool GltfConverter::inferLinearSpace(const tinygltf::Texture &texture,
   return false;
 }
 
+std::optional<int> GltfConverter::convertKHRTextureBasisU(
+    const tinygltf::Texture &texture,
+    const std::vector<std::shared_ptr<GltfImage>> &images) {
+  auto it = texture.extensions.find("KHR_texture_basisu");
+  if (it == texture.extensions.end() || !it->second.Has("source")) {
+    return std::nullopt;
+  }
+  const auto &source = it->second.Get("source");
+  if (!source.IsInt()) {
+    return std::nullopt;
+  }
+  const int index = source.GetNumberAsInt();
+  if (index < 0 || index >= static_cast<int>(images.size()) ||
+      !images[index] || !images[index]->getImageData()) {
+    LOGW("KHR_texture_basisu image %d is not available, "
+         "falling back to texture.source %d", index, texture.source);
+    return std::nullopt;
+  }
+  return index;
+}
+
 void GltfConverter::convertKHRTextureTransform(
     const tinygltf::Value &extValue,
     GltfTexture *gltfTexture) {
@@ -747,7 +955,10 @@ std::shared_ptr<GltfAccessor>
 GltfConverter::convertAccessor(const tinygltf::Accessor &accessor) {
   auto gltfAccessor = std::make_shared<GltfAccessor>();
 
-  gltfAccessor->setBufferView(accessor.bufferView);
+  // 没有 bufferView 的访问器（稀疏、Draco）保持为空
+  if (accessor.bufferView >= 0) {
+    gltfAccessor->setBufferView(accessor.bufferView);
+  }
   gltfAccessor->setByteOffset(accessor.byteOffset);
   gltfAccessor->setComponentType(accessor.componentType);
   gltfAccessor->setCount(accessor.count);
@@ -806,11 +1017,17 @@ GltfConverter::convertAccessor(const tinygltf::Accessor &accessor) {
 }
 
 std::shared_ptr<GltfBuffer>
-GltfConverter::convertBuffer(const tinygltf::Buffer &buffer) {
+GltfConverter::convertBuffer(const tinygltf::Buffer &buffer,
+                             const GltfBinaryChunk *binChunk) {
   auto gltfBuffer = std::make_shared<GltfBuffer>();
 
-  gltfBuffer->setBuffer(buffer.data);
-  gltfBuffer->setByteLength(buffer.data.size());
+  // GLB 的 BIN 块没有 uri, 映射加载时直接引用映射内存
+  if (binChunk && buffer.uri.empty() && buffer.data.empty()) {
+    gltfBuffer->setExternalData(*binChunk);
+  } else {
+    gltfBuffer->setBuffer(buffer.data);
+    gltfBuffer->setByteLength(buffer.data.size());
+  }
   gltfBuffer->setUri(buffer.uri);
   gltfBuffer->setName(buffer.name);
   return gltfBuffer;
@@ -830,7 +1047,8 @@ GltfConverter::convertBufferView(const tinygltf::BufferView &bufferView) {
 }
 
 std::shared_ptr<GltfImage>
-GltfConverter::convertImage(const tinygltf::Image &image) {
+GltfConverter::convertImage(const tinygltf::Image &image,
+                            std::shared_ptr<ImageData> decoded) {
   auto gltfImage = std::make_shared<GltfImage>();
 
   gltfImage->setUri(image.uri);
@@ -840,8 +1058,11 @@ GltfConverter::convertImage(const tinygltf::Image &image) {
   gltfImage->setBufferView(image.bufferView);
   gltfImage->setName(image.name);
   gltfImage->setType(GL_TEXTURE_2D);
-  // 如果 tinygltf 已经解码了图像数据
-  if (!image.image.empty() && image.width > 0 && image.height > 0) {
+  // 缓存或并行解码器已提供解码后的像素
+  if (decoded) {
+    gltfImage->setImageData(decoded);
+  } else if (!image.image.empty() && image.width > 0 && image.height > 0) {
+    // 如果 tinygltf 已经解码了图像数据
     auto imageData = createImageDataFromPixels(image);
     if (imageData) {
       gltfImage->setImageData(imageData);
@@ -863,40 +1084,41 @@ GltfConverter::createImageDataFromPixels(const tinygltf::Image &image) {
     return nullptr;
   }
 
-  // 创建像素数据副本
-  std::vector<uint8_t> pixelData;
+  int channels = image.component;
+  if (channels < 1 || channels > 4) {
+    LOGE("Unsupported channel count: %d", channels);
+    return nullptr;
+  }
 
   // tinygltf 的图像数据格式转换
-  int expectedSize = image.width * image.height * image.component;
-  if (static_cast<int>(image.image.size()) < expectedSize) {
-    LOGE("Image data size mismatch: expected %d, got %zu",
-         expectedSize, image.image.size());
+  const size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+  const size_t expectedSize = pixelCount * channels;
+  const size_t bytesPerComponent = image.bits > 8 ? image.bits / 8 : 1;
+  if (image.image.size() < expectedSize * bytesPerComponent) {
+    LOGE("Image data size mismatch: expected %zu, got %zu",
+         expectedSize * bytesPerComponent, image.image.size());
     return nullptr;
   }
 
-  // 根据像素类型处理数据
+  // 根据像素类型处理数据, 统一为 8 位
+  std::vector<uint8_t> pixelData;
   if (image.bits == 8) {
-    // 8位数据，直接复制
     pixelData.assign(image.image.begin(),
                      image.image.begin() + expectedSize);
   } else if (image.bits == 16) {
     // 16位数据，需要转换为8位
-    pixelData.reserve(expectedSize);
-    const uint16_t
-        *src16 = reinterpret_cast<const uint16_t *>(image.image.data());
-    for (int i = 0; i < expectedSize; ++i) {
-      // 简单的16位到8位转换（丢失精度）
-      pixelData.push_back(static_cast<uint8_t>(src16[i] >> 8));
-    }
+    pixelData.resize(expectedSize);
+    pixel::narrow16To8(reinterpret_cast<const uint16_t *>(image.image.data()),
+                       pixelData.data(), expectedSize);
     LOGW("Converting 16-bit image to 8-bit, precision loss may occur");
   } else if (image.bits == 32) {
     // 32位浮点数据，转换为8位
-    pixelData.reserve(expectedSize);
+    pixelData.resize(expectedSize);
     const float *srcFloat = reinterpret_cast<const float *>(image.image.data());
-    for (int i = 0; i < expectedSize; ++i) {
+    for (size_t i = 0; i < expectedSize; ++i) {
       // 浮点到8位转换，假设浮点值在[0,1]范围
       float value = std::clamp(srcFloat[i], 0.0f, 1.0f);
-      pixelData.push_back(static_cast<uint8_t>(value * 255.0f));
+      pixelData[i] = static_cast<uint8_t>(value * 255.0f);
     }
     LOGW("Converting 32-bit float image to 8-bit");
   } else {
@@ -904,42 +1126,16 @@ GltfConverter::createImageDataFromPixels(const tinygltf::Image &image) {
     return nullptr;
   }
 
-  // 处理通道数转换（如果需要）
-  int channels = image.component;
-  if (channels < 1 || channels > 4) {
-    LOGE("Unsupported channel count: %d", channels);
-    return nullptr;
-  }
-
-  // 如果是单通道或双通道，可能需要转换为RGB/RGBA
+  // 单通道转换为RGB, 灰度+Alpha 转换为RGBA
   if (channels == 1) {
-    // 灰度转换为RGB
-    std::vector<uint8_t> rgbData;
-    rgbData.reserve(image.width * image.height * 3);
-
-    for (size_t i = 0; i < pixelData.size(); ++i) {
-      uint8_t gray = pixelData[i];
-      rgbData.push_back(gray);  // R
-      rgbData.push_back(gray);  // G
-      rgbData.push_back(gray);  // B
-    }
-
+    std::vector<uint8_t> rgbData(pixelCount * 3);
+    pixel::expandGreyToRgb(pixelData.data(), rgbData.data(), pixelCount);
     pixelData = std::move(rgbData);
     channels = 3;
   } else if (channels == 2) {
-    // 灰度+Alpha 转换为RGBA
-    std::vector<uint8_t> rgbaData;
-    rgbaData.reserve(image.width * image.height * 4);
-
-    for (size_t i = 0; i < pixelData.size(); i += 2) {
-      uint8_t gray = pixelData[i];
-      uint8_t alpha = pixelData[i + 1];
-      rgbaData.push_back(gray);   // R
-      rgbaData.push_back(gray);   // G
-      rgbaData.push_back(gray);   // B
-      rgbaData.push_back(alpha);  // A
-    }
-
+    std::vector<uint8_t> rgbaData(pixelCount * 4);
+    pixel::expandGreyAlphaToRgba(pixelData.data(), rgbaData.data(),
+                                 pixelCount);
     pixelData = std::move(rgbaData);
     channels = 4;
   }
@@ -1044,11 +1240,14 @@ GltfConverter::convertSampler(const tinygltf::Sampler &sampler) {
 
 std::shared_ptr<GltfMesh> GltfConverter::convertMesh(const tinygltf::Mesh &mesh,
                                                      std::shared_ptr<Gltf> gltf,
-                                                     Engine &gltfView) {
+                                                     Engine &gltfView,
+                                                     bool deferGlInit,
+                                                     const std::vector<std::shared_ptr<const GltfMorphTargetTexture>> *morphTargets) {
   auto gltfMesh = std::make_shared<GltfMesh>();
 
   gltfMesh->setName(mesh.name);
-  for (const auto &primitive: mesh.primitives) {
+  for (size_t i = 0; i < mesh.primitives.size(); ++i) {
+    const auto &primitive = mesh.primitives[i];
     auto gltfPrimitive = std::make_shared<GltfPrimitive>();
 
     gltfPrimitive->setAttributes(primitive.attributes);
@@ -1058,9 +1257,15 @@ std::shared_ptr<GltfMesh> GltfConverter::convertMesh(const tinygltf::Mesh &mesh,
     gltfPrimitive->setMode(primitive.mode);
     // gltfPrimitive->setMaterial(mesh.)
     gltfPrimitive->setTargets(primitive.targets);
+    if (morphTargets && i < morphTargets->size()) {
+      gltfPrimitive->setMorphTargetTexture((*morphTargets)[i]);
+    }
+    convertKHRDracoMeshCompression(primitive, *gltfPrimitive);
     //            convertExtensions(primitive.extensions, &gltfPrimitive);
 //            convertExtras(primitive.extras, &gltfPrimitive);
-    gltfPrimitive->initGl(gltf, gltfView.context);
+    if (!deferGlInit) {
+      gltfPrimitive->initGl(gltf, gltfView.context);
+    }
 
     gltfMesh->addPrimitive(gltfPrimitive);
   }
@@ -1074,6 +1279,421 @@ std::shared_ptr<GltfMesh> GltfConverter::convertMesh(const tinygltf::Mesh &mesh,
   return gltfMesh;
 }
 
+void GltfConverter::convertKHRDracoMeshCompression(
+    const tinygltf::Primitive &primitive, GltfPrimitive &gltfPrimitive) {
+  auto it = primitive.extensions.find(GltfDracoDecoder::kExtensionName);
+  if (it == primitive.extensions.end()) {
+    return;
+  }
+  const auto &bufferView = it->second.Get("bufferView");
+  const auto &attributes = it->second.Get("attributes");
+  if (!bufferView.IsInt() || !attributes.IsObject()) {
+    LOGW("Invalid KHR_draco_mesh_compression extension, ignored");
+    return;
+  }
+
+  GltfDracoExtension extension;
+  extension.bufferView = bufferView.GetNumberAsInt();
+  for (const auto &name: attributes.Keys()) {
+    const auto &uniqueId = attributes.Get(name);
+    if (uniqueId.IsInt()) {
+      extension.attributes[name] = uniqueId.GetNumberAsInt();
+    }
+  }
+  gltfPrimitive.setDracoExtension(extension);
+}
+
+void GltfConverter::decodeDracoPrimitives(const std::shared_ptr<Gltf> &gltf) {
+  std::vector<std::shared_ptr<GltfPrimitive>> primitives;
+  for (const auto &mesh: gltf->meshes) {
+    for (const auto &primitive: mesh->getPrimitives()) {
+      if (primitive->getDracoExtension().has_value()) {
+        primitives.push_back(primitive);
+      }
+    }
+  }
+  if (primitives.empty()) {
+    return;
+  }
+
+  // 每个图元写入各自的访问器, 互不重叠
+  auto startTime = std::chrono::high_resolution_clock::now();
+  std::vector<std::future<bool>> jobs;
+  jobs.reserve(primitives.size());
+  for (const auto &primitive: primitives) {
+    jobs.push_back(ThreadPool::shared().submit([primitive, gltf]() {
+      return primitive->handleDracoCompression(gltf);
+    }));
+  }
+  size_t decoded = 0;
+  for (auto &job: jobs) {
+    decoded += job.get() ? 1 : 0;
+  }
+
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::high_resolution_clock::now() - startTime).count();
+  LOGI("Decoded %zu/%zu Draco primitives in %lld ms", decoded,
+       primitives.size(), static_cast<long long>(duration));
+}
+
+void GltfConverter::optimizeMeshes(const tinygltf::Model &model,
+                                   const std::shared_ptr<Gltf> &gltf) {
+  std::map<std::map<std::string, int>,
+           std::vector<std::shared_ptr<GltfPrimitive>>> groups;
+  for (const auto &mesh: gltf->meshes) {
+    for (const auto &primitive: mesh->getPrimitives()) {
+      if (!primitive->shouldSkip() && !primitive->getAttributes().empty()) {
+        groups[primitive->getAttributes()].push_back(primitive);
+      }
+    }
+  }
+  if (groups.empty()) {
+    return;
+  }
+
+  // 重排会改写访问器数据, 只处理访问器由单个组独占的组
+  std::map<int, const std::map<std::string, int> *> owners;
+  std::set<const std::map<std::string, int> *> shared;
+  auto claim = [&owners, &shared](int index,
+                                  const std::map<std::string, int> *group) {
+    auto [it, inserted] = owners.emplace(index, group);
+    if (!inserted && it->second != group) {
+      shared.insert(it->second);
+      shared.insert(group);
+    }
+  };
+  for (const auto &[attributes, primitives]: groups) {
+    for (const auto &primitive: primitives) {
+      claim(primitive->getIndices().value_or(-1), &attributes);
+      for (const auto &[_, index]: primitive->getAttributes()) {
+        claim(index, &attributes);
+      }
+      for (const auto &target: primitive->getTargets()) {
+        for (const auto &[_, index]: target) {
+          claim(index, &attributes);
+        }
+      }
+    }
+  }
+  // 其他网格的图元（如被跳过的 Draco 图元）、动画与蒙皮引用的访问器
+  auto release = [&owners, &shared](int index) {
+    auto it = owners.find(index);
+    if (it != owners.end()) {
+      shared.insert(it->second);
+    }
+  };
+  for (const auto &mesh: model.meshes) {
+    for (const auto &primitive: mesh.primitives) {
+      auto it = groups.find(primitive.attributes);
+      if (it == groups.end()) {
+        release(primitive.indices);
+        for (const auto &[_, index]: primitive.attributes) {
+          release(index);
+        }
+      }
+    }
+  }
+  for (const auto &animation: model.animations) {
+    for (const auto &sampler: animation.samplers) {
+      release(sampler.input);
+      release(sampler.output);
+    }
+  }
+  for (const auto &skin: model.skins) {
+    release(skin.inverseBindMatrices);
+  }
+
+  auto startTime = std::chrono::high_resolution_clock::now();
+  std::vector<std::future<GltfMeshOptimizerStats>> jobs;
+  jobs.reserve(groups.size());
+  for (const auto &[attributes, primitives]: groups) {
+    if (shared.count(&attributes) != 0) {
+      continue;
+    }
+    const auto *group = &primitives;
+    jobs.push_back(ThreadPool::shared().submit([gltf, group]() {
+      GltfMeshOptimizerStats stats;
+      GltfMeshOptimizer::optimize(*gltf, *group, stats);
+      return stats;
+    }));
+  }
+  GltfMeshOptimizerStats stats;
+  for (auto &job: jobs) {
+    stats.merge(job.get());
+  }
+
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::high_resolution_clock::now() - startTime).count();
+  LOGI("Optimized %zu/%zu vertex groups, %zu triangles ACMR %.3f -> %.3f in %lld ms",
+       jobs.size(), groups.size(), stats.triangles, stats.acmrBefore(),
+       stats.acmrAfter(), static_cast<long long>(duration));
+}
+
+namespace {
+
+/**
+ * @brief 按顶点序号抽取访问器元素, 生成新的访问器
+ * @return 新访问器的索引, 数据无效时返回 -1
+ */
+int gatherAccessor(Gltf &gltf, int sourceIndex,
+                   const std::vector<uint32_t> &vertices) {
+  const auto &accessors = gltf.getAccessors();
+  if (sourceIndex < 0 || sourceIndex >= static_cast<int>(accessors.size()) ||
+      !accessors[sourceIndex]) {
+    return -1;
+  }
+  auto &source = *accessors[sourceIndex];
+  const GltfAccessorView view = source.getView(gltf);
+  const size_t elementSize = view.elementSize();
+  if (view.empty()) {
+    return -1;
+  }
+  std::vector<uint8_t> data(vertices.size() * elementSize);
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    if (vertices[i] >= view.count) {
+      return -1;
+    }
+    std::memcpy(data.data() + i * elementSize,
+                view.data + vertices[i] * view.byteStride, elementSize);
+  }
+  auto accessor = std::make_shared<GltfAccessor>();
+  accessor->setComponentType(view.componentType);
+  accessor->setNormalized(view.normalized);
+  accessor->setCount(static_cast<int>(vertices.size()));
+  accessor->setType(source.getType());
+  accessor->setMin(source.getMin());
+  accessor->setMax(source.getMax());
+  accessor->setDecodedData(std::move(data));
+  return gltf.addAccessor(accessor);
+}
+
+int addIndexAccessor(Gltf &gltf, std::vector<uint8_t> &&data, size_t count,
+                     int componentType) {
+  auto accessor = std::make_shared<GltfAccessor>();
+  accessor->setComponentType(componentType);
+  accessor->setCount(static_cast<int>(count));
+  accessor->setAccessorType(AccessorType::SCALAR);
+  accessor->setDecodedData(std::move(data));
+  return gltf.addAccessor(accessor);
+}
+
+/**
+ * @brief 按块重新映射一组属性
+ * @return 任一属性无效时返回 false
+ */
+bool gatherStream(Gltf &gltf, const std::map<std::string, int> &stream,
+                  const std::vector<uint32_t> &vertices,
+                  std::map<int, int> &gathered,
+                  std::map<std::string, int> &result) {
+  for (const auto &[name, index]: stream) {
+    auto it = gathered.find(index);
+    if (it == gathered.end()) {
+      it = gathered.emplace(index, gatherAccessor(gltf, index, vertices)).first;
+    }
+    if (it->second < 0) {
+      return false;
+    }
+    result[name] = it->second;
+  }
+  return true;
+}
+
+} // namespace
+
+void GltfConverter::packIndices(const std::shared_ptr<Gltf> &gltf) {
+  auto startTime = std::chrono::high_resolution_clock::now();
+  GltfIndexPackerStats stats;
+
+  // 无索引图元: 在共享线程池中并行查找重复顶点
+  std::vector<std::shared_ptr<GltfPrimitive>> unindexed;
+  for (const auto &mesh: gltf->meshes) {
+    for (const auto &primitive: mesh->getPrimitives()) {
+      if (!primitive->shouldSkip() && primitive->getIndices().value_or(-1) < 0 &&
+          primitive->getMode() != GL_POINTS &&
+          !primitive->getAttributes().empty()) {
+        unindexed.push_back(primitive);
+      }
+    }
+  }
+  std::vector<std::future<std::vector<uint32_t>>> jobs;
+  jobs.reserve(unindexed.size());
+  for (const auto &primitive: unindexed) {
+    jobs.push_back(ThreadPool::shared().submit([gltf, primitive]() {
+      return GltfIndexPacker::generate(*gltf, *primitive);
+    }));
+  }
+  std::set<int> packed;
+  for (size_t i = 0; i < unindexed.size(); ++i) {
+    auto indices = jobs[i].get();
+    if (indices.empty()) {
+      continue;
+    }
+    std::vector<uint8_t> data;
+    int componentType = GL_UNSIGNED_INT;
+    if (indices.size() <= GltfIndexPacker::kMaxShortVertices) {
+      componentType = GL_UNSIGNED_SHORT;
+      data.resize(indices.size() * sizeof(uint16_t));
+      auto *dst = reinterpret_cast<uint16_t *>(data.data());
+      std::copy(indices.begin(), indices.end(), dst);
+    } else {
+      data.resize(indices.size() * sizeof(uint32_t));
+      std::memcpy(data.data(), indices.data(), data.size());
+    }
+    stats.bytesAfter += data.size();
+    const int index = addIndexAccessor(*gltf, std::move(data), indices.size(),
+                                       componentType);
+    unindexed[i]->setIndices(index);
+    packed.insert(index);
+    ++stats.generated;
+  }
+
+  // 索引访问器改写为 16 位, 多个图元共用的访问器只处理一次
+  const auto &accessors = gltf->accessors;
+  std::vector<std::pair<std::shared_ptr<GltfMesh>,
+                        std::shared_ptr<GltfPrimitive>>> oversized;
+  for (const auto &mesh: gltf->meshes) {
+    for (const auto &primitive: mesh->getPrimitives()) {
+      const int index = primitive->getIndices().value_or(-1);
+      if (primitive->shouldSkip() || index < 0 ||
+          index >= static_cast<int>(accessors.size()) || !accessors[index]) {
+        continue;
+      }
+      auto &accessor = *accessors[index];
+      if (packed.insert(index).second) {
+        const size_t count = accessor.getCount().value_or(0);
+        stats.bytesBefore += count * accessor.getComponentSize();
+        stats.narrowed += GltfIndexPacker::narrow(*gltf, accessor) ? 1 : 0;
+        stats.bytesAfter += count * accessor.getComponentSize();
+      }
+      if (accessor.getComponentType().value_or(0) == GL_UNSIGNED_INT &&
+          primitive->getMode() == GL_TRIANGLES) {
+        oversized.emplace_back(mesh, primitive);
+      }
+    }
+  }
+
+  // 超出 16 位范围的三角形列表: 按三角形顺序切分, 每块抽取各自的顶点,
+  // 第一块替换原图元, 其余追加到网格末尾
+  for (const auto &[mesh, primitive]: oversized) {
+    auto indexAccessor = accessors[primitive->getIndices().value()];
+    const auto indices = primitive->getIndicesAsUint32(indexAccessor, *gltf);
+    auto position = primitive->getAttributes().find("POSITION");
+    if (indices.empty() || position == primitive->getAttributes().end() ||
+        !accessors[position->second]) {
+      continue;
+    }
+    const size_t vertexCount =
+        accessors[position->second]->getCount().value_or(0);
+    const auto chunks = GltfIndexPacker::split(indices, vertexCount);
+    if (chunks.empty()) {
+      continue;
+    }
+
+    const GltfPrimitive original = *primitive;
+    std::vector<std::shared_ptr<GltfPrimitive>> parts;
+    for (const auto &chunk: chunks) {
+      std::map<int, int> gathered;
+      std::map<std::string, int> attributes;
+      std::vector<std::map<std::string, int>> targets(
+          original.getTargets().size());
+      bool valid = gatherStream(*gltf, original.getAttributes(),
+                                chunk.vertices, gathered, attributes);
+      for (size_t t = 0; valid && t < targets.size(); ++t) {
+        valid = gatherStream(*gltf, original.getTargets()[t], chunk.vertices,
+                             gathered, targets[t]);
+      }
+      if (!valid) {
+        parts.clear();
+        break;
+      }
+      std::vector<uint8_t> data(chunk.indices.size() * sizeof(uint16_t));
+      std::memcpy(data.data(), chunk.indices.data(), data.size());
+      auto part = parts.empty() ? primitive
+                                : std::make_shared<GltfPrimitive>(original);
+      part->setAttributes(attributes);
+      part->setTargets(targets);
+      part->setIndices(addIndexAccessor(*gltf, std::move(data),
+                                        chunk.indices.size(),
+                                        GL_UNSIGNED_SHORT));
+      part->setMorphTargetTexture(nullptr);
+      part->setVertexLayout(nullptr);
+      parts.push_back(part);
+    }
+    if (parts.empty()) {
+      *primitive = original;
+      continue;
+    }
+    for (size_t i = 1; i < parts.size(); ++i) {
+      mesh->addPrimitive(parts[i]);
+    }
+    stats.bytesBefore += indices.size() * sizeof(uint32_t);
+    stats.bytesAfter += indices.size() * sizeof(uint16_t);
+    ++stats.split;
+  }
+
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::high_resolution_clock::now() - startTime).count();
+  LOGI("Packed indices: %zu narrowed, %zu generated, %zu split (%zu -> %zu bytes) in %lld ms",
+       stats.narrowed, stats.generated, stats.split, stats.bytesBefore,
+       stats.bytesAfter, static_cast<long long>(duration));
+}
+
+void GltfConverter::buildVertexLayouts(const std::shared_ptr<Gltf> &gltf) {
+  std::map<std::map<std::string, int>,
+           std::vector<std::shared_ptr<GltfPrimitive>>> groups;
+  for (const auto &mesh: gltf->meshes) {
+    for (const auto &primitive: mesh->getPrimitives()) {
+      if (!primitive->shouldSkip() && !primitive->getAttributes().empty()) {
+        groups[primitive->getAttributes()].push_back(primitive);
+      }
+    }
+  }
+  if (groups.empty()) {
+    return;
+  }
+
+  // 稀疏访问器首次读取时写入缓存, 先在当前线程读取, 并行任务中只读
+  for (const auto &[attributes, _]: groups) {
+    for (const auto &[name, index]: attributes) {
+      if (index >= 0 && index < static_cast<int>(gltf->accessors.size()) &&
+          gltf->accessors[index] && gltf->accessors[index]->hasSparse()) {
+        gltf->accessors[index]->getDeinterlacedView(*gltf);
+      }
+    }
+  }
+
+  auto startTime = std::chrono::high_resolution_clock::now();
+  std::vector<std::future<std::shared_ptr<GltfVertexLayout>>> jobs;
+  jobs.reserve(groups.size());
+  for (const auto &[attributes, _]: groups) {
+    const auto *key = &attributes;
+    jobs.push_back(ThreadPool::shared().submit([gltf, key]() {
+      return GltfVertexLayout::build(*gltf, *key);
+    }));
+  }
+
+  size_t sourceBytes = 0;
+  size_t packedBytes = 0;
+  auto job = jobs.begin();
+  for (const auto &[_, primitives]: groups) {
+    auto layout = (job++)->get();
+    if (!layout) {
+      continue;
+    }
+    sourceBytes += layout->getSourceBytes();
+    packedBytes += layout->getPackedBytes();
+    for (const auto &primitive: primitives) {
+      primitive->setVertexLayout(layout);
+    }
+  }
+
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::high_resolution_clock::now() - startTime).count();
+  LOGI("Packed %zu vertex layouts (%zu -> %zu bytes) in %lld ms",
+       groups.size(), sourceBytes, packedBytes,
+       static_cast<long long>(duration));
+}
+
 std::shared_ptr<GltfNode>
 GltfConverter::convertNode(const tinygltf::Node &node) {
   auto gltfNode = std::make_shared<GltfNode>();
@@ -7,6 +7,9 @@
 
 #include "tiny_gltf.h"
 #include <memory>
+#include <optional>
+#include <vector>
+#include "GltfAnimationClip.h"
 
 namespace digitalhumans {
 class Gltf;
@@ -19,6 +22,10 @@ enum class InterpolationMode;
 
 enum class InterpolationPath;
 class GltfBuffer;
+struct GltfBinaryChunk;
+struct GltfSharedAsset;
+struct GltfConvertedData;
+struct GltfMorphTargetTexture;
 class GltfAsset;
 class GltfBufferView;
 class GltfAccessor;
@@ -27,6 +34,7 @@ class GltfSampler;
 class GltfTexture;
 class GltfMaterial;
 class GltfMesh;
+class GltfPrimitive;
 class GltfNode;
 class GltfScene;
 class GltfSkin;
@@ -39,12 +47,62 @@ class GltfConverter {
  public:
   /**
    * @brief 从 tiny_gltf::Model 转换到自定义 Gltf 对象
+   * @param binChunk 外部 GLB 二进制块（内存映射加载时使用）,
+   *                 非空时没有 uri 的 buffer 直接引用该数据块而不复制
+   * @param deferGlInit 为 true 时不调用任何 GL 接口（可在工作线程执行）,
+   *                    图元与蒙皮的 initGl 由 GltfUploadQueue 在渲染线程完成
+   * @param decodedImages 按图像索引预先解码的像素（GltfImageDecoder）,
+   *                      非空项直接移交给 GltfImage, 不再复制
+   * @param optimizeMeshes 是否重排三角形与顶点（GltfMeshOptimizer）
+   * @param compression 动画片段的关键帧压缩参数
+   * @param converted 非空时输出处理后的访问器、图元与动画, 供 createSharedAsset 缓存
    */
 // 将有默认值的参数放到最后
   static std::shared_ptr<Gltf> convert(const tinygltf::Model &model,
                                        Engine &gltfView,
-                                       const std::string &filePath = "");
+                                       const std::string &filePath = "",
+                                       const GltfBinaryChunk *binChunk = nullptr,
+                                       bool deferGlInit = false,
+                                       const std::vector<std::shared_ptr<ImageData>> *decodedImages = nullptr,
+                                       bool optimizeMeshes = false,
+                                       const GltfAnimationCompression &compression = GltfAnimationCompression(),
+                                       std::shared_ptr<const GltfConvertedData> *converted = nullptr);
+
+  /**
+   * @brief 从缓存的共享资源创建新的 Gltf 实例
+   * buffer 与解码后的图像直接复用, 不再复制。
+   * 共享资源的网格已经优化过（烘焙文件）时不再重复优化;
+   * 带有 converted 且优化与压缩参数相符时直接复制处理后的访问器、图元与动画片段
+   * @param converted 非空时输出本次的处理结果（共享资源没有 converted 时）
+   */
+  static std::shared_ptr<Gltf> convert(const GltfSharedAsset &asset,
+                                       Engine &gltfView,
+                                       bool deferGlInit = false,
+                                       bool optimizeMeshes = false,
+                                       const GltfAnimationCompression &compression = GltfAnimationCompression(),
+                                       std::shared_ptr<const GltfConvertedData> *converted = nullptr);
+
+  /**
+   * @brief 从首次转换的结果提取可共享资源
+   * @param model 已转换的模型, buffer 数据与图像像素会被释放, 只保留结构描述
+   * @param gltf 由 model 转换得到的 Gltf
+   * @param converted 转换时输出的处理结果, 可为空
+   */
+  static std::shared_ptr<GltfSharedAsset>
+  createSharedAsset(tinygltf::Model &&model, const Gltf &gltf,
+                    std::shared_ptr<const GltfConvertedData> converted = nullptr);
  private:
+  static std::shared_ptr<Gltf> convertModel(const tinygltf::Model &model,
+                                            Engine &gltfView,
+                                            const std::string &filePath,
+                                            const GltfBinaryChunk *binChunk,
+                                            const GltfSharedAsset *shared,
+                                            bool deferGlInit,
+                                            const std::vector<std::shared_ptr<ImageData>> *decodedImages,
+                                            bool optimizeMeshes,
+                                            const GltfAnimationCompression &compression,
+                                            std::shared_ptr<const GltfConvertedData> *converted);
+
   // 转换各种组件
   static std::shared_ptr<GltfAsset> convertAsset(const tinygltf::Asset &asset);
 
@@ -52,25 +110,61 @@ class GltfConverter {
   convertAccessor(const tinygltf::Accessor &accessor);
 
   static std::shared_ptr<GltfBuffer>
-  convertBuffer(const tinygltf::Buffer &buffer);
+  convertBuffer(const tinygltf::Buffer &buffer,
+                const GltfBinaryChunk *binChunk = nullptr);
 
   static std::shared_ptr<GltfBufferView>
   convertBufferView(const tinygltf::BufferView &bufferView);
 
-  static std::shared_ptr<GltfImage> convertImage(const tinygltf::Image &image);
+  static std::shared_ptr<GltfImage>
+  convertImage(const tinygltf::Image &image,
+               std::shared_ptr<ImageData> decoded = nullptr);
 
   static std::shared_ptr<GltfSampler>
   convertSampler(const tinygltf::Sampler &sampler);
 
   static std::shared_ptr<GltfTexture>
-  convertTexture(const tinygltf::Texture &texture);
+  convertTexture(const tinygltf::Texture &texture,
+                 const std::vector<std::shared_ptr<GltfImage>> &images = {});
 
   static std::shared_ptr<GltfMaterial>
   convertMaterial(const tinygltf::Material &material);
 
   static std::shared_ptr<GltfMesh>
   convertMesh(const tinygltf::Mesh &mesh, std::shared_ptr<Gltf> gltf,
-              Engine &gltfView);
+              Engine &gltfView, bool deferGlInit = false,
+              const std::vector<std::shared_ptr<const GltfMorphTargetTexture>> *morphTargets = nullptr);
+
+  /**
+   * @brief 读取 KHR_draco_mesh_compression 扩展, 记录到图元上
+   */
+  static void convertKHRDracoMeshCompression(const tinygltf::Primitive &primitive,
+                                             GltfPrimitive &gltfPrimitive);
+
+  /**
+   * @brief 在共享线程池中并行解码所有 Draco 压缩的图元（不调用 GL）
+   */
+  static void decodeDracoPrimitives(const std::shared_ptr<Gltf> &gltf);
+
+  /**
+   * @brief 在共享线程池中并行重排图元的三角形与顶点（不调用 GL）
+   *
+   * 属性完全相同的图元作为一组处理; 访问器被多组、动画或蒙皮共用的组跳过
+   */
+  static void optimizeMeshes(const tinygltf::Model &model,
+                             const std::shared_ptr<Gltf> &gltf);
+
+  /**
+   * @brief 索引尽量改写为 16 位（GltfIndexPacker）: 无索引图元按顶点内容生成索引,
+   * 8/32 位索引在值域允许时改写, 超出 16 位范围的三角形列表切分为多个图元
+   */
+  static void packIndices(const std::shared_ptr<Gltf> &gltf);
+
+  /**
+   * @brief 在共享线程池中并行生成图元的交错压缩顶点布局（不调用 GL）,
+   * 属性完全相同的图元共用一个布局
+   */
+  static void buildVertexLayouts(const std::shared_ptr<Gltf> &gltf);
 
   static std::shared_ptr<GltfNode> convertNode(const tinygltf::Node &node);
 
@@ -92,6 +186,13 @@ class GltfConverter {
   static bool inferLinearSpace(const tinygltf::Texture &texture,
                                std::optional<int> sourceIndex);
 
+  /**
+   * @brief KHR_texture_basisu 指向的 KTX2 图像已成功转码时返回其索引
+   */
+  static std::optional<int>
+  convertKHRTextureBasisU(const tinygltf::Texture &texture,
+                          const std::vector<std::shared_ptr<GltfImage>> &images);
+
   static void convertKHRTextureTransform(const tinygltf::Value &extValue,
                                          GltfTexture *gltfTexture);
 
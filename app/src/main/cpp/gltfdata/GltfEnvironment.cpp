@@ -3,7 +3,6 @@
 #include "ktx.h"
 #include <iostream>
 #include <stdexcept>
-#include <android/log.h>
 #include <vector>          // ✅ 必需：std::vector
 #include <GLES3/gl3.h>
 #include "glm.hpp"
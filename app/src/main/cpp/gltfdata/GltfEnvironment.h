@@ -5,7 +5,6 @@
 #include <string>
 #include <memory>
 #include <GLES3/gl3.h>
-#include <android/asset_manager.h>
 
 namespace digitalhumans {
 class Gltf;
@@ -5,7 +5,6 @@
 #include "GltfImage.h"
 
 #include "../utils/utils.h"
-#include <android/log.h>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -16,6 +15,7 @@
 #include "GltfBufferView.h"
 #include "GltfBuffer.h"
 #include "ImageMimeTypes.h"
+#include "converter/KtxTextureDecoder.h"
 
 
 // 第三方图像解码库（需要添加到项目中）
@@ -43,22 +43,48 @@ BasicImageData::BasicImageData(int width,
                                int height,
                                int channels,
                                std::vector<uint8_t> data)
-    : width(width), height(height), channels(channels), data(std::move(data)) {
+    : width(width), height(height), channels(channels), size(data.size()) {
+  // 以别名 shared_ptr 引用 vector 的存储, 两种构造方式共用同一访问路径
+  auto holder = std::make_shared<std::vector<uint8_t>>(std::move(data));
+  pixels = std::shared_ptr<const uint8_t>(holder, holder->data());
+}
+
+BasicImageData::BasicImageData(int width,
+                               int height,
+                               int channels,
+                               std::shared_ptr<const uint8_t> pixels,
+                               size_t size)
+    : width(width), height(height), channels(channels),
+      pixels(std::move(pixels)), size(size) {
 }
 
 // ===== KtxImageData实现 =====
 
 KtxImageData::KtxImageData(int width,
                            int height,
-                           int levelCount,
                            GLenum internalFormat,
                            GLenum format,
                            GLenum type,
                            std::vector<uint8_t> data,
+                           std::vector<Level> levels,
                            bool compressed)
-    : width(width), height(height), levelCount(levelCount),
-      internalFormat(internalFormat), format(format),
-      type(type), data(std::move(data)), compressed(compressed) {
+    : width(width), height(height), internalFormat(internalFormat),
+      format(format), type(type), data(std::move(data)),
+      levels(std::move(levels)), compressed(compressed) {
+}
+
+const uint8_t *KtxImageData::getLevelData(int level) const {
+  if (level < 0 || level >= static_cast<int>(levels.size())) {
+    return nullptr;
+  }
+  return data.data() + levels[level].offset;
+}
+
+size_t KtxImageData::getLevelDataSize(int level) const {
+  if (level < 0 || level >= static_cast<int>(levels.size())) {
+    return 0;
+  }
+  return levels[level].size;
 }
 
 // ===== GltfImage实现 =====
@@ -150,17 +176,13 @@ bool GltfImage::setImageFromBytes(std::shared_ptr<Gltf> gltf,
 
   try {
     if (mimeType == ImageMimeType::KTX2) {
-      // 处理KTX2格式
-      //TODO 不支持KTX2
-//                auto ktxDecoder = gltf->getKtxDecoder();
-//                if (ktxDecoder) {
-//                    imageData = ktxDecoder->decodeFromBuffer(data);
-//                    return imageData != nullptr;
-//                } else {
-//                    LOGW("Loading of KTX images failed: KtxDecoder not initialized");
-//                    return false;
-//                }
-      return false;
+      // 转码为设备支持的压缩格式
+      std::string error;
+      imageData = KtxTextureDecoder::decode(data.data(), data.size(), error);
+      if (!imageData) {
+        LOGW("Loading of KTX images failed: %s", error.c_str());
+      }
+      return imageData != nullptr;
     } else if (mimeType == ImageMimeType::JPEG) {
       imageData = decodeJpeg(data);
       return imageData != nullptr;
@@ -229,25 +251,13 @@ std::future<bool> GltfImage::setImageFromUriAsync(std::shared_ptr<Gltf> gltf) {
     }
 
     try {
-      if (mimeType == ImageMimeType::KTX2) {
-//                    auto ktxDecoder = gltf->getKtxDecoder();
-//                    if (ktxDecoder) {
-//                        imageData = ktxDecoder->loadFromUri(uri);
-//                        return imageData != nullptr;
-//                    } else {
-//                        LOGW("Loading of KTX images failed: KtxDecoder not initialized");
-//                        return false;
-//                    }
+      // 读取文件, KTX2 在 setImageFromBytes 中转码
+      auto fileData = readFileAsync(uri).get();
+      if (fileData.empty()) {
+        LOGE("Could not read file: %s", uri.c_str());
         return false;
-      } else {
-        // 读取文件
-        auto fileData = readFileAsync(uri).get();
-        if (fileData.empty()) {
-          LOGE("Could not read file: %s", uri.c_str());
-          return false;
-        }
-        return setImageFromBytes(gltf, fileData);
       }
+      return setImageFromBytes(gltf, fileData);
     } catch (const std::exception &e) {
       LOGE("Error loading image from URI %s: %s", uri.c_str(), e.what());
       return false;
@@ -285,13 +295,13 @@ GltfImage::setImageFromBufferViewAsync(std::shared_ptr<Gltf> gltf) {
     }
 
     auto buffer = buffers[bufferIndex];
-    if (!buffer || buffer->buffer.empty()) {
+    if (!buffer || buffer->getActualSize() == 0) {
       LOGE("Buffer is null or has no data");
       return false;
     }
 
     const uint8_t
-        *bufferData = static_cast<const uint8_t *>(buffer->buffer.data());
+        *bufferData = buffer->getData();
     size_t byteOffset = view->getByteOffset();
     size_t byteLength = view->getByteLength().value();
 
@@ -331,19 +341,7 @@ std::future<bool> GltfImage::setImageFromFilesAsync(std::shared_ptr<Gltf> gltf,
     }
 
     try {
-      if (mimeType == ImageMimeType::KTX2) {
-//                    auto ktxDecoder = gltf->getKtxDecoder();
-//                    if (ktxDecoder) {
-//                        imageData = ktxDecoder->decodeFromBuffer(foundFile->second);
-//                        return imageData != nullptr;
-//                    } else {
-//                        LOGW("Loading of KTX images failed: KtxDecoder not initialized");
-//                        return false;
-//                    }
-        return false;
-      } else {
-        return setImageFromBytes(gltf, foundFile->second);
-      }
+      return setImageFromBytes(gltf, foundFile->second);
     } catch (const std::exception &e) {
       LOGE("Error reading image from file %s: %s", uri.c_str(), e.what());
       return false;
@@ -40,6 +40,17 @@ class ImageData {
 
   virtual int getLevelCount() const { return 1; }
 
+  /**
+   * @brief 指定 mip 层级的数据, 层级 0 即 getData()
+   */
+  virtual const uint8_t *getLevelData(int level) const {
+    return level == 0 ? getData() : nullptr;
+  }
+
+  virtual size_t getLevelDataSize(int level) const {
+    return level == 0 ? getDataSize() : 0;
+  }
+
   virtual GLenum getInternalFormat() const { return GL_RGBA8; }
 
   virtual GLenum getFormat() const { return GL_RGBA; }
@@ -59,6 +70,17 @@ class BasicImageData: public ImageData {
                  int channels,
                  std::vector<uint8_t> data);
 
+  /**
+   * @brief 直接接管外部分配的像素（如 stb 解码结果）, 不复制
+   * @param pixels 像素数据, 释放方式由其删除器决定
+   * @param size 像素数据字节数
+   */
+  BasicImageData(int width,
+                 int height,
+                 int channels,
+                 std::shared_ptr<const uint8_t> pixels,
+                 size_t size);
+
   ~BasicImageData() override = default;
 
   int getWidth() const override { return width; }
@@ -67,29 +89,42 @@ class BasicImageData: public ImageData {
 
   int getChannels() const override { return channels; }
 
-  const uint8_t *getData() const override { return data.data(); }
+  const uint8_t *getData() const override { return pixels.get(); }
 
-  size_t getDataSize() const override { return data.size(); }
+  size_t getDataSize() const override { return size; }
 
  private:
   int width;
   int height;
   int channels;
-  std::vector<uint8_t> data;
+  std::shared_ptr<const uint8_t> pixels;
+  size_t size;
 };
 
 /**
- * @brief KTX2图像数据
+ * @brief KTX2图像数据（转码后的 GPU 格式, 含完整 mip 链）
  */
 class KtxImageData: public ImageData {
  public:
+  /**
+   * @brief mip 层级在 data 中的位置
+   */
+  struct Level {
+    size_t offset = 0;
+    size_t size = 0;
+  };
+
+  /**
+   * @param internalFormat 线性空间的内部格式, sRGB 变体在上传时选择
+   * @param levels 各 mip 层级, 层级 0 为原始尺寸
+   */
   KtxImageData(int width,
                int height,
-               int levelCount,
                GLenum internalFormat,
                GLenum format,
                GLenum type,
                std::vector<uint8_t> data,
+               std::vector<Level> levels,
                bool compressed);
 
   ~KtxImageData() override = default;
@@ -103,7 +138,13 @@ class KtxImageData: public ImageData {
 
   size_t getDataSize() const override { return data.size(); }
 
-  int getLevelCount() const override { return levelCount; }
+  int getLevelCount() const override {
+    return static_cast<int>(levels.size());
+  }
+
+  const uint8_t *getLevelData(int level) const override;
+
+  size_t getLevelDataSize(int level) const override;
 
   GLenum getInternalFormat() const override { return internalFormat; }
 
@@ -116,11 +157,11 @@ class KtxImageData: public ImageData {
  private:
   int width;
   int height;
-  int levelCount;
   GLenum internalFormat;
   GLenum format;
   GLenum type;
   std::vector<uint8_t> data;
+  std::vector<Level> levels;
   bool compressed;
 };
 
@@ -4,7 +4,6 @@
 
 #include "GltfInterpolator.h"
 
-#include <android/log.h>
 #include <cmath>
 #include <algorithm>
 
@@ -16,7 +15,7 @@
 namespace digitalhumans {
 
 GltfInterpolator::GltfInterpolator()
-    : prevKey(0), prevT(0.0f) {
+    : cursor(std::make_shared<GltfKeyframeCursor>()) {
 }
 
 std::array<float, 4> GltfInterpolator::slerpQuat(const std::array<float, 4> &q1,
@@ -68,40 +67,26 @@ std::array<float, 4> GltfInterpolator::slerpQuat(const std::array<float, 4> &q1,
   return normalizeQuat(result);
 }
 
-std::vector<float> GltfInterpolator::step(int prevKey,
-                                          const std::vector<float> &output,
-                                          int stride) {
-  std::vector<float> result(stride);
-
+void GltfInterpolator::step(int prevKey, ArrayView<float> output, int stride,
+                            float *result) {
   for (int i = 0; i < stride; ++i) {
     result[i] = output[prevKey * stride + i];
   }
-
-  return result;
 }
 
-std::vector<float> GltfInterpolator::linear(int prevKey,
-                                            int nextKey,
-                                            const std::vector<float> &output,
-                                            float t,
-                                            int stride) {
-  std::vector<float> result(stride);
-
+void GltfInterpolator::linear(int prevKey, int nextKey,
+                              ArrayView<float> output, float t, int stride,
+                              float *result) {
   for (int i = 0; i < stride; ++i) {
     float prevValue = output[prevKey * stride + i];
     float nextValue = output[nextKey * stride + i];
     result[i] = prevValue * (1.0f - t) + nextValue * t;
   }
-
-  return result;
 }
 
-std::vector<float> GltfInterpolator::cubicSpline(int prevKey,
-                                                 int nextKey,
-                                                 const std::vector<float> &output,
-                                                 float keyDelta,
-                                                 float t,
-                                                 int stride) {
+void GltfInterpolator::cubicSpline(int prevKey, int nextKey,
+                                   ArrayView<float> output, float keyDelta,
+                                   float t, int stride, float *result) {
   // stride: 组件数量（例如四元数为4）
   // 乘以3，因为每个输出条目包含两个切线和一个数据点
   const int prevIndex = prevKey * stride * 3;
@@ -110,7 +95,6 @@ std::vector<float> GltfInterpolator::cubicSpline(int prevKey,
   const int V = 1 * stride;       // 值偏移
   const int B = 2 * stride;       // 出切线偏移
 
-  std::vector<float> result(stride);
   const float tSq = t * t;
   const float tCub = t * t * t;
 
@@ -127,51 +111,54 @@ std::vector<float> GltfInterpolator::cubicSpline(int prevKey,
         ((-2 * tCub + 3 * tSq) * v1) +
         ((tCub - tSq) * a);
   }
-
-  return result;
 }
 
 void GltfInterpolator::resetKey() {
-  prevKey = 0;
+  cursor->reset();
 }
 
-std::vector<float> GltfInterpolator::interpolate(std::shared_ptr<Gltf> gltf,
-                                                 std::shared_ptr<
-                                                     GltfAnimationChannel> channel,
-                                                 std::shared_ptr<
-                                                     GltfAnimationSampler> sampler,
-                                                 float t,
-                                                 int stride,
-                                                 float maxTime) {
+ArrayView<float> GltfInterpolator::interpolate(
+    const std::shared_ptr<Gltf> &gltf,
+    const std::shared_ptr<GltfAnimationChannel> &channel,
+    const std::shared_ptr<GltfAnimationSampler> &sampler,
+    float t,
+    int stride,
+    float maxTime) {
   if (!gltf || !channel || !sampler || maxTime <= 0.0f) {
-    return std::vector<float>();
+    return {};
   }
 
   // 获取输入和输出访问器
-  auto inputAccessor = gltf->getAccessors()[sampler->getInput().value()];
-  auto outputAccessor = gltf->getAccessors()[sampler->getOutput().value()];
+  const auto &inputAccessor = gltf->getAccessors()[sampler->getInput().value()];
+  const auto &outputAccessor =
+      gltf->getAccessors()[sampler->getOutput().value()];
 
   if (!inputAccessor || !outputAccessor) {
     LOGE("Invalid accessor for animation sampler");
-    return std::vector<float>();
+    return {};
   }
 
-  // 获取归一化的数据视图
-  std::vector<float>
-      input = inputAccessor->getNormalizedDeinterlacedView(*gltf);
-  std::vector<float>
-      output = outputAccessor->getNormalizedDeinterlacedView(*gltf);
+  // 获取归一化的数据视图（引用访问器缓存, 不拷贝）
+  const ArrayView<float>
+      input = inputAccessor->getNormalizedDeinterlacedSpan(*gltf);
+  const ArrayView<float>
+      output = outputAccessor->getNormalizedDeinterlacedSpan(*gltf);
 
   if (input.empty() || output.empty()) {
     LOGE("Empty input or output data");
-    return std::vector<float>();
+    return {};
   }
 
+  const bool rotation =
+      channel->getTarget()->getPath() == InterpolationPath::ROTATION;
+  // 容量足够后 resize 不再分配
+  result.resize(rotation ? 4 : stride);
+  float *values = result.data();
+
   // 单关键帧动画不需要插值
-  if (static_cast<int>(output.size()) == stride) {
-    std::vector<float> result(stride);
+  if (static_cast<int>(output.size()) == stride || input.size() < 2) {
     std::copy(output.begin(), output.begin() + stride, result.begin());
-    return result;
+    return {values, static_cast<size_t>(stride)};
   }
 
 
@@ -180,26 +167,11 @@ std::vector<float> GltfInterpolator::interpolate(std::shared_ptr<Gltf> gltf,
   t = std::fmod(t, maxTime);
   t = clamp(t, input[0], input[input.size() - 1]);
 
-  if (prevT > t) {
-    prevKey = 0;
-  }
-  prevT = t;
-
-  // 找到下一个关键帧: min{ t of input | t > prevKey }
-  int nextKey = -1;
-  for (int i = prevKey; i < static_cast<int>(input.size()); ++i) {
-    if (t <= input[i]) {
-      nextKey = clamp(i, 1, static_cast<int>(input.size()) - 1);
-      break;
-    }
-  }
-
-  if (nextKey == -1) {
-    // 如果没找到下一个关键帧，使用最后一个
-    nextKey = static_cast<int>(input.size()) - 1;
-  }
-
-  prevKey = clamp(nextKey - 1, 0, nextKey);
+  // 游标给出 input[prevKey] <= t < input[nextKey], 顺序播放时直接命中,
+  // 循环回绕或跳转时二分查找
+  const int prevKey =
+      static_cast<int>(cursor->seek(input.data(), input.size(), t));
+  const int nextKey = prevKey + 1;
 
   const float keyDelta = input[nextKey] - input[prevKey];
 
@@ -210,55 +182,51 @@ std::vector<float> GltfInterpolator::interpolate(std::shared_ptr<Gltf> gltf,
   }
 
   // 处理旋转插值（四元数）
-  if (channel->getTarget()->getPath() == InterpolationPath::ROTATION) {
+  if (rotation) {
 
     if (sampler->getInterpolation() == InterpolationMode::CUBICSPLINE) {
       // glTF要求四元数使用三次样条插值
       // https://github.com/KhronosGroup/glTF/issues/1386
-      std::vector<float>
-          result = cubicSpline(prevKey, nextKey, output, keyDelta, tn, 4);
+      cubicSpline(prevKey, nextKey, output, keyDelta, tn, 4, values);
 
       // 归一化四元数
-      if (result.size() >= 4) {
-        std::array<float, 4>
-            quat = {result[0], result[1], result[2], result[3]};
-        quat = normalizeQuat(quat);
-        result[0] = quat[0];
-        result[1] = quat[1];
-        result[2] = quat[2];
-        result[3] = quat[3];
-      }
-      return result;
+      std::array<float, 4>
+          quat = normalizeQuat({values[0], values[1], values[2], values[3]});
+      std::copy(quat.begin(), quat.end(), values);
+      return {values, 4};
     } else if (sampler->getInterpolation() == InterpolationMode::LINEAR) {
       std::array<float, 4> q0 = getQuat(output, prevKey);
       std::array<float, 4> q1 = getQuat(output, nextKey);
       std::array<float, 4> resultQuat = slerpQuat(q0, q1, tn);
-
-      return std::vector<float>{resultQuat[0], resultQuat[1], resultQuat[2],
-                                resultQuat[3]};
+      std::copy(resultQuat.begin(), resultQuat.end(), values);
+      return {values, 4};
     } else if (sampler->getInterpolation() == InterpolationMode::STEP) {
       std::array<float, 4> q0 = getQuat(output, prevKey);
-      return std::vector<float>{q0[0], q0[1], q0[2], q0[3]};
+      std::copy(q0.begin(), q0.end(), values);
+      return {values, 4};
     }
   }
 
   // 处理其他类型的插值
   switch (sampler->getInterpolation()) {
     case InterpolationMode::STEP:
-      return step(prevKey, output, stride);
+      step(prevKey, output, stride, values);
+      break;
 
     case InterpolationMode::CUBICSPLINE:
-      return cubicSpline(prevKey, nextKey, output, keyDelta, tn, stride);
+      cubicSpline(prevKey, nextKey, output, keyDelta, tn, stride, values);
+      break;
 
     case InterpolationMode::LINEAR:
     default:
-      return linear(prevKey, nextKey, output, tn, stride);
+      linear(prevKey, nextKey, output, tn, stride, values);
+      break;
   }
-  return std::vector<float>();
+  return {values, static_cast<size_t>(stride)};
 }
 
 std::array<float, 4>
-GltfInterpolator::getQuat(const std::vector<float> &output, int index) {
+GltfInterpolator::getQuat(ArrayView<float> output, int index) {
   if (static_cast<size_t>(4 * index + 3) >= output.size()) {
     LOGE("Index out of bounds when getting quaternion");
     return {0.0f, 0.0f, 0.0f, 1.0f}; // 返回单位四元数
@@ -9,8 +9,10 @@
 #include <memory>
 #include <array>
 #include <cstddef>
+#include "GltfAccessorView.h"
 #include "GltfAnimationSampler.h"
 #include "GltfAnimationChannel.h"
+#include "GltfKeyframeCursor.h"
 
 namespace digitalhumans {
 
@@ -46,10 +48,9 @@ class GltfInterpolator {
    * @param prevKey 前一个关键帧索引
    * @param output 输出数据数组
    * @param stride 每个关键帧的组件数量
-   * @return 插值结果
+   * @param result 插值结果, 至少 stride 个元素
    */
-  std::vector<float>
-  step(int prevKey, const std::vector<float> &output, int stride);
+  void step(int prevKey, ArrayView<float> output, int stride, float *result);
 
   /**
    * @brief 线性插值
@@ -58,11 +59,10 @@ class GltfInterpolator {
    * @param output 输出数据数组
    * @param t 插值参数 [0, 1]
    * @param stride 每个关键帧的组件数量
-   * @return 插值结果
+   * @param result 插值结果, 至少 stride 个元素
    */
-  std::vector<float>
-  linear(int prevKey, int nextKey, const std::vector<float> &output,
-         float t, int stride);
+  void linear(int prevKey, int nextKey, ArrayView<float> output, float t,
+              int stride, float *result);
 
   /**
    * @brief 三次样条插值
@@ -72,17 +72,26 @@ class GltfInterpolator {
    * @param keyDelta 关键帧时间差
    * @param t 插值参数 [0, 1]
    * @param stride 每个关键帧的组件数量
-   * @return 插值结果
+   * @param result 插值结果, 至少 stride 个元素
    */
-  std::vector<float>
-  cubicSpline(int prevKey, int nextKey, const std::vector<float> &output,
-              float keyDelta, float t, int stride);
+  void cubicSpline(int prevKey, int nextKey, ArrayView<float> output,
+                   float keyDelta, float t, int stride, float *result);
 
   /**
-   * @brief 重置关键帧索引
+   * @brief 重置关键帧游标
    */
   void resetKey();
 
+  /**
+   * @brief 设置关键帧游标, 使用同一输入访问器的通道可共用
+   * @param keyframeCursor 关键帧游标
+   */
+  void setCursor(std::shared_ptr<GltfKeyframeCursor> keyframeCursor) {
+    cursor = std::move(keyframeCursor);
+  }
+
+  const std::shared_ptr<GltfKeyframeCursor> &getCursor() const { return cursor; }
+
   /**
    * @brief 执行插值计算
    * @param gltf glTF根对象
@@ -91,12 +100,13 @@ class GltfInterpolator {
    * @param t 当前时间
    * @param stride 每个关键帧的组件数量
    * @param maxTime 动画最大时间
-   * @return 插值结果，如果无效则返回空vector
+   * @return 插值结果，如果无效则返回空视图;
+   *         指向插值器内部的缓冲区, 下次调用前有效
    */
-  std::vector<float> interpolate(std::shared_ptr<Gltf> gltf,
-                                 std::shared_ptr<GltfAnimationChannel> channel,
-                                 std::shared_ptr<GltfAnimationSampler> sampler,
-                                 float t, int stride, float maxTime);
+  ArrayView<float> interpolate(const std::shared_ptr<Gltf> &gltf,
+                               const std::shared_ptr<GltfAnimationChannel> &channel,
+                               const std::shared_ptr<GltfAnimationSampler> &sampler,
+                               float t, int stride, float maxTime);
 
   /**
    * @brief 从输出数组中获取四元数
@@ -104,7 +114,7 @@ class GltfInterpolator {
    * @param index 关键帧索引
    * @return 四元数
    */
-  std::array<float, 4> getQuat(const std::vector<float> &output, int index);
+  std::array<float, 4> getQuat(ArrayView<float> output, int index);
 
  private:
   /**
@@ -141,8 +151,8 @@ class GltfInterpolator {
   int clamp(int value, int min, int max);
 
  private:
-  int prevKey;    ///< 前一个关键帧索引
-  float prevT;    ///< 前一个时间值
+  std::shared_ptr<GltfKeyframeCursor> cursor;  ///< 关键帧游标
+  std::vector<float> result;  ///< 插值结果缓冲, 逐帧复用
 };
 
 } // namespace digitalhumans
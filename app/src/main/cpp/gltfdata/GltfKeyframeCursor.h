@@ -0,0 +1,69 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFKEYFRAMECURSOR_H
+#define LIGHTDIGITALHUMAN_GLTFKEYFRAMECURSOR_H
+
+#include <algorithm>
+#include <cstddef>
+
+namespace digitalhumans {
+
+/**
+ * @brief 关键帧游标, 记录上次采样所在的关键帧区间
+ *
+ * 顺序播放时时间只前进一小步, 采样点仍在当前区间或下一个区间, 直接命中;
+ * 循环回绕、跳转与往返播放等不连续的时间改用二分查找, 不再从第 0 帧线性扫描。
+ * 使用同一输入访问器（时间数组）的通道可以共用一个游标, 同一帧内第一个通道
+ * 定位后其余通道直接命中。
+ */
+class GltfKeyframeCursor {
+ public:
+  /**
+   * @brief 查找满足 times[key] <= time < times[key + 1] 的前一关键帧
+   * @param times 递增的关键帧时间
+   * @param count 关键帧数
+   * @return 前一关键帧下标, 范围 [0, count - 2]; 时间早于首帧时为 0,
+   *         不早于末帧时为 count - 2; 少于两个关键帧时为 0
+   */
+  size_t seek(const float *times, size_t count, float time) {
+    if (count < 2) {
+      return 0;
+    }
+    const size_t last = count - 2;
+    if (key > last) {
+      key = last;
+    }
+    if (times[key] <= time || key == 0) {
+      if (time < times[key + 1] || key == last) {
+        return key;
+      }
+      if (key + 1 == last || time < times[key + 2]) {
+        return ++key;
+      }
+    }
+    ++searches;
+    const auto next = std::upper_bound(times, times + count, time) - times;
+    key = std::min(static_cast<size_t>(next > 0 ? next - 1 : 0), last);
+    return key;
+  }
+
+  /**
+   * @brief 回到第一个关键帧区间
+   */
+  void reset() { key = 0; }
+
+  /**
+   * @brief 因时间不连续而二分查找的次数
+   */
+  size_t getSearchCount() const { return searches; }
+
+ private:
+  size_t key = 0;       ///< 上次命中的前一关键帧
+  size_t searches = 0;  ///< 二分查找次数
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFKEYFRAMECURSOR_H
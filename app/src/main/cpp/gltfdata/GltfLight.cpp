@@ -4,7 +4,6 @@
 
 #include "GltfLight.h"
 #include "math_utils.h"
-#include <android/log.h>
 #include <cmath>
 #include <algorithm>
 #include "glm.hpp"
@@ -5,7 +5,6 @@
 #include "GltfMaterial.h"
 #include "../utils/utils.h"
 #include "GltfState.h"
-#include <android/log.h>
 #include <cmath>
 #include <algorithm>
 
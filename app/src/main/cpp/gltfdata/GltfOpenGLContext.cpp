@@ -4,7 +4,8 @@
 
 #include "GltfOpenGLContext.h"
 
-#include <android/log.h>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <regex>
@@ -16,10 +17,26 @@
 #include "Gltf.h"
 #include "GltfImage.h"
 #include "GltfAccessor.h"
+#include "GltfBufferArena.h"
+#include "GltfVertexLayout.h"
+#include "converter/KtxTextureDecoder.h"
 
 
 namespace digitalhumans {
 
+namespace {
+
+/**
+ * @brief 是否以 sRGB 内部格式上传颜色纹理（否则由着色器转换）
+ */
+bool hasSrgbExtension() {
+  const char
+      *extensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+  return extensions && strstr(extensions, "GL_EXT_sRGB");
+}
+
+} // namespace
+
 GltfOpenGLContext::GltfOpenGLContext()
     : supportsEXTTextureFilterAnisotropic(false), anisotropyParameter(0),
       maxAnisotropy(1.0f),
@@ -50,104 +67,163 @@ void GltfOpenGLContext::loadOpenGLExtensions() {
     supportsEXTTextureFilterAnisotropic = false;
     maxAnisotropy = 1.0f;
   }
+  // 记录 KTX2 转码目标, 供工作线程解码时使用
+  KtxTextureDecoder::detectDeviceFormats();
 }
 
 bool GltfOpenGLContext::setTexture(GLint uniformLocation,
                                    std::shared_ptr<Gltf> gltf,
                                    std::shared_ptr<GltfTextureInfo> textureInfo,
                                    GLint texSlot) {
-  if (uniformLocation == -1 || !gltf || !textureInfo) {
+  if (uniformLocation == -1) {
+    return false;
+  }
+
+  std::shared_ptr<GltfImage> image;
+  auto gltfTexture = resolveTexture(gltf, textureInfo, image);
+  if (!gltfTexture) {
     return false;
   }
+  ensureTextureObject(gltfTexture, image);
+
+  // 激活纹理槽并绑定纹理
+  glActiveTexture(GL_TEXTURE0 + texSlot);
+  glBindTexture(gltfTexture->getType(), gltfTexture->getGLTexture());
+
+  // 设置uniform
+  glUniform1i(uniformLocation, texSlot);
+
+  // 初始化纹理（如果尚未初始化）
+  if (!gltfTexture->isInitialized()) {
+    initializeTexture(gltf, textureInfo, gltfTexture, image);
+  }
+
+  return gltfTexture->isInitialized();
+}
+
+bool GltfOpenGLContext::prepareTexture(std::shared_ptr<Gltf> gltf,
+                                       std::shared_ptr<GltfTextureInfo> textureInfo) {
+  std::shared_ptr<GltfImage> image;
+  auto gltfTexture = resolveTexture(gltf, textureInfo, image);
+  if (!gltfTexture) {
+    return false;
+  }
+  if (gltfTexture->isInitialized()) {
+    return true;
+  }
+  ensureTextureObject(gltfTexture, image);
+  glBindTexture(gltfTexture->getType(), gltfTexture->getGLTexture());
+  return initializeTexture(gltf, textureInfo, gltfTexture, image);
+}
+
+std::shared_ptr<GltfTexture>
+GltfOpenGLContext::resolveTexture(const std::shared_ptr<Gltf> &gltf,
+                                  const std::shared_ptr<GltfTextureInfo> &textureInfo,
+                                  std::shared_ptr<GltfImage> &image) {
+  if (!gltf || !textureInfo) {
+    return nullptr;
+  }
 
   const int textureIndex = textureInfo->getIndex().value();
   if (textureIndex < 0
       || textureIndex >= static_cast<int>(gltf->getTextures().size())) {
-    return false;
+    return nullptr;
   }
 
   auto gltfTexture = gltf->getTextures()[textureIndex];
   if (!gltfTexture) {
-    return false;
+    return nullptr;
   }
 
   const int imageIndex = gltfTexture->getSource().value();
   if (imageIndex < 0
       || imageIndex >= static_cast<int>(gltf->getImages().size())) {
-    return false;
+    return nullptr;
   }
 
-  auto image = gltf->getImages()[imageIndex];
+  image = gltf->getImages()[imageIndex];
   if (!image) {
-    return false;
+    return nullptr;
   }
+  return gltfTexture;
+}
 
+void
+GltfOpenGLContext::ensureTextureObject(const std::shared_ptr<GltfTexture> &gltfTexture,
+                                       const std::shared_ptr<GltfImage> &image) {
   // 创建纹理对象（如果尚未创建）
   if (gltfTexture->getGLTexture() == 0) {
     const ImageMimeType mimeType = image->getMimeType();
-    if (mimeType == ImageMimeType::KTX2
-        || mimeType == ImageMimeType::GLTEXTURE) {
+    if (mimeType == ImageMimeType::GLTEXTURE) {
       // 这些图像资源直接由资源加载器加载到GPU资源
       gltfTexture->setGLTexture(image->getTexture());
+      // GLTEXTURE 图像引用的纹理（IBL 等）可被多个模型共享
+      gltfTexture->setExternal(mimeType == ImageMimeType::GLTEXTURE);
     } else {
       // 其他图像将在稍后步骤中上传
       gltfTexture->setGLTexture(createTexture());
     }
   }
+}
 
-  // 激活纹理槽并绑定纹理
-  glActiveTexture(GL_TEXTURE0 + texSlot);
-  glBindTexture(gltfTexture->getType(), gltfTexture->getGLTexture());
-
-  // 设置uniform
-  glUniform1i(uniformLocation, texSlot);
-
-  // 初始化纹理（如果尚未初始化）
-  if (!gltfTexture->isInitialized()) {
-    const int samplerIndex = gltfTexture->getSampler().value();
-    if (samplerIndex < 0
-        || samplerIndex >= static_cast<int>(gltf->getSamplers().size())) {
-      LOGW("Sampler is undefined for texture: %d", textureIndex);
-      return false;
-    }
-
-    auto gltfSampler = gltf->getSamplers()[samplerIndex];
-    if (!gltfSampler) {
-      return false;
-    }
+bool GltfOpenGLContext::initializeTexture(const std::shared_ptr<Gltf> &gltf,
+                                          const std::shared_ptr<GltfTextureInfo> &textureInfo,
+                                          const std::shared_ptr<GltfTexture> &gltfTexture,
+                                          const std::shared_ptr<GltfImage> &image) {
+  const int samplerIndex = gltfTexture->getSampler().value();
+  if (samplerIndex < 0
+      || samplerIndex >= static_cast<int>(gltf->getSamplers().size())) {
+    LOGW("Sampler is undefined for texture: %d",
+         textureInfo->getIndex().value());
+    return false;
+  }
 
-    // 上传图像数据
-    const ImageMimeType mimeType = image->getMimeType();
-    if (mimeType == ImageMimeType::PNG ||
-        mimeType == ImageMimeType::JPEG ||
-        mimeType == ImageMimeType::WEBP ||
-        mimeType == ImageMimeType::HDR) {
+  auto gltfSampler = gltf->getSamplers()[samplerIndex];
+  if (!gltfSampler) {
+    return false;
+  }
 
-      uploadImageToTexture(gltfTexture, image);
-    }
+  // 上传图像数据
+  const ImageMimeType mimeType = image->getMimeType();
+  const auto imageData = image->getImageData();
+  // KTX2 转码结果自带 mip 链, 压缩格式也无法 glGenerateMipmap
+  const bool hasOwnLevels = imageData &&
+      (imageData->isCompressed() || imageData->getLevelCount() > 1);
+  if (hasOwnLevels) {
+    uploadImageLevels(gltfTexture, image);
+  } else if (mimeType == ImageMimeType::PNG ||
+      mimeType == ImageMimeType::JPEG ||
+      mimeType == ImageMimeType::WEBP ||
+      mimeType == ImageMimeType::HDR ||
+      mimeType == ImageMimeType::KTX2) {
+
+    uploadImageToTexture(gltfTexture, image);
+  }
 
-    setSampler(gltfSampler,
-               gltfTexture->getType(),
-               textureInfo->shouldGenerateMips());
-
-    if (textureInfo->shouldGenerateMips()) {
-      GLenum minFilter = gltfSampler->getMinFilter();
-      switch (minFilter) {
-        case GL_NEAREST_MIPMAP_NEAREST:
-        case GL_NEAREST_MIPMAP_LINEAR:
-        case GL_LINEAR_MIPMAP_NEAREST:
-        case GL_LINEAR_MIPMAP_LINEAR:
-          glGenerateMipmap(gltfTexture->getType());
-          break;
-        default:
-          break;
-      }
+  setSampler(gltfSampler,
+             gltfTexture->getType(),
+             textureInfo->shouldGenerateMips());
+
+  if (hasOwnLevels) {
+    // 只有部分层级时限制采样范围, 保证纹理完整
+    glTexParameteri(gltfTexture->getType(), GL_TEXTURE_MAX_LEVEL,
+                    imageData->getLevelCount() - 1);
+  } else if (textureInfo->shouldGenerateMips()) {
+    GLenum minFilter = gltfSampler->getMinFilter();
+    switch (minFilter) {
+      case GL_NEAREST_MIPMAP_NEAREST:
+      case GL_NEAREST_MIPMAP_LINEAR:
+      case GL_LINEAR_MIPMAP_NEAREST:
+      case GL_LINEAR_MIPMAP_LINEAR:
+        glGenerateMipmap(gltfTexture->getType());
+        break;
+      default:
+        break;
     }
-
-    gltfTexture->setInitialized(true);
   }
 
-  return gltfTexture->isInitialized();
+  gltfTexture->setInitialized(true);
+  return true;
 }
 
 bool
@@ -162,24 +238,7 @@ GltfOpenGLContext::setIndices(std::shared_ptr<Gltf> gltf, int accessorIndex) {
     return false;
   }
 
-  if (gltfAccessor->getGLBuffer() == 0) {
-    gltfAccessor->setGLBuffer(createBuffer());
-
-    auto data = gltfAccessor->getTypedView(*gltf);
-    if (data.second <= 0) {
-      return false;
-    }
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gltfAccessor->getGLBuffer());
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 data.second,
-                 data.first,
-                 GL_STATIC_DRAW);
-  } else {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gltfAccessor->getGLBuffer());
-  }
-
-  return true;
+  return uploadAccessor(gltf, gltfAccessor, GL_ELEMENT_ARRAY_BUFFER);
 }
 
 bool GltfOpenGLContext::enableAttribute(std::shared_ptr<Gltf> gltf,
@@ -190,29 +249,82 @@ bool GltfOpenGLContext::enableAttribute(std::shared_ptr<Gltf> gltf,
     return false;
   }
 
-  if (accessor->getGLBuffer() == 0) {
-    accessor->setGLBuffer(createBuffer());
+  if (!uploadAccessor(gltf, accessor, GL_ARRAY_BUFFER)) {
+    return false;
+  }
+
+  glVertexAttribPointer(
+      attributeLocation,
+      accessor->getComponentCount(),
+      accessor->getComponentType().value(),
+      accessor->isNormalized() ? GL_TRUE : GL_FALSE,
+      accessor->getGLByteStride(),
+      accessor->getGLAllocation()->offsetPointer()
+  );
+  glEnableVertexAttribArray(attributeLocation);
+
+  return true;
+}
+
+bool GltfOpenGLContext::uploadAccessor(std::shared_ptr<Gltf> gltf,
+                                       std::shared_ptr<GltfAccessor> accessor,
+                                       GLenum target) {
+  if (!gltf || !accessor) {
+    return false;
+  }
+
+  if (!accessor->getGLAllocation()) {
     auto data = accessor->getTypedView(*gltf);
     if (data.second <= 0) {
       return false;
     }
+    auto allocation =
+        GltfBufferArena::shared().allocate(target, data.first, data.second);
+    if (!allocation) {
+      return false;
+    }
+    accessor->setGLAllocation(std::move(allocation));
+    // CPU 数据可能在上传后释放, 步长在此记录
+    accessor->setGLByteStride(accessor->getByteStride(*gltf));
+  }
+  glBindBuffer(target, accessor->getGLAllocation()->getBuffer());
+  return true;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, accessor->getGLBuffer());
-    glBufferData(GL_ARRAY_BUFFER, data.second, data.first, GL_STATIC_DRAW);
-  } else {
-    glBindBuffer(GL_ARRAY_BUFFER, accessor->getGLBuffer());
+bool GltfOpenGLContext::enablePackedAttribute(GLint attributeLocation,
+                                              GltfVertexLayout &layout,
+                                              const GltfPackedAttribute &attribute) {
+  if (attributeLocation == -1 || !uploadVertexLayout(layout)) {
+    return false;
   }
 
   glVertexAttribPointer(
       attributeLocation,
-      accessor->getComponentCount(),
-      accessor->getComponentType().value(),
-      accessor->isNormalized() ? GL_TRUE : GL_FALSE,
-      accessor->getByteStride(*gltf),
-      nullptr
+      attribute.componentCount,
+      attribute.componentType,
+      attribute.normalized ? GL_TRUE : GL_FALSE,
+      static_cast<GLsizei>(layout.getStride()),
+      layout.getGLAllocation()->offsetPointer(attribute.offset)
   );
   glEnableVertexAttribArray(attributeLocation);
+  return true;
+}
 
+bool GltfOpenGLContext::uploadVertexLayout(GltfVertexLayout &layout) {
+  if (!layout.getGLAllocation()) {
+    const auto &vertices = layout.getVertices();
+    if (vertices.empty()) {
+      return false;
+    }
+    auto allocation = GltfBufferArena::shared().allocate(
+        GL_ARRAY_BUFFER, vertices.data(), vertices.size());
+    if (!allocation) {
+      return false;
+    }
+    layout.setGLAllocation(std::move(allocation));
+    layout.releaseVertices();
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, layout.getGLAllocation()->getBuffer());
   return true;
 }
 
@@ -396,12 +508,7 @@ GltfOpenGLContext::uploadImageToTexture(std::shared_ptr<GltfTexture> gltfTexture
   }
 
   // Android平台上，检查是否支持SRGB格式
-  bool supportsSRGB = false;
-  const char
-      *extensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
-  if (extensions && strstr(extensions, "GL_EXT_sRGB")) {
-    supportsSRGB = true;
-  }
+  const bool supportsSRGB = hasSrgbExtension();
 
   // 确定内部格式
   GLenum internalFormat = GL_RGBA;
@@ -429,6 +536,37 @@ GltfOpenGLContext::uploadImageToTexture(std::shared_ptr<GltfTexture> gltfTexture
   }
 }
 
+void GltfOpenGLContext::uploadImageLevels(const std::shared_ptr<GltfTexture> &gltfTexture,
+                                          const std::shared_ptr<GltfImage> &image) {
+  const auto imageData = image->getImageData();
+  GLenum internalFormat = imageData->getInternalFormat();
+  if (!gltfTexture->isLinear() && hasSrgbExtension()) {
+    internalFormat = KtxTextureDecoder::toSrgbFormat(internalFormat);
+  }
+
+  const GLenum target = image->getType();
+  for (int level = 0; level < imageData->getLevelCount(); ++level) {
+    const GLsizei width = std::max(1, imageData->getWidth() >> level);
+    const GLsizei height = std::max(1, imageData->getHeight() >> level);
+    const uint8_t *data = imageData->getLevelData(level);
+    const size_t size = imageData->getLevelDataSize(level);
+    if (imageData->isCompressed()) {
+      glCompressedTexImage2D(target, level, internalFormat, width, height, 0,
+                             static_cast<GLsizei>(size), data);
+    } else {
+      glTexImage2D(target, level, static_cast<GLint>(internalFormat), width,
+                   height, 0, imageData->getFormat(), imageData->getType(),
+                   data);
+    }
+  }
+
+  GLenum error = glGetError();
+  if (error != GL_NO_ERROR) {
+    LOGE("OpenGL error uploading texture levels (format 0x%x): 0x%x",
+         internalFormat, error);
+  }
+}
+
 void GltfOpenGLContext::bindTexture(GLenum target, GLuint texture) {
   glBindTexture(target, texture);
   checkGLError("bindTexture");
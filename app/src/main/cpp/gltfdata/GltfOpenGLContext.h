@@ -26,6 +26,10 @@ class GltfAccessor;
 
 class GltfImage;
 
+class GltfVertexLayout;
+
+struct GltfPackedAttribute;
+
 /**
 * @brief Android OpenGL ES上下文封装类
 * 提供glTF渲染所需的OpenGL ES功能封装
@@ -66,6 +70,16 @@ class GltfOpenGLContext {
                   std::shared_ptr<GltfTextureInfo> textureInfo,
                   GLint texSlot);
 
+  /**
+   * @brief 预先创建并上传纹理（不绑定到着色器）
+   * 用于分帧上传, 之后的 setTexture 只需绑定
+   * @param gltf glTF对象
+   * @param textureInfo 纹理信息
+   * @return 纹理是否已初始化
+   */
+  bool prepareTexture(std::shared_ptr<Gltf> gltf,
+                      std::shared_ptr<GltfTextureInfo> textureInfo);
+
   /**
    * @brief 设置索引缓冲区
    * @param gltf glTF对象
@@ -85,6 +99,36 @@ class GltfOpenGLContext {
                        GLint attributeLocation,
                        std::shared_ptr<GltfAccessor> accessor);
 
+  /**
+   * @brief 在共享缓冲区域（GltfBufferArena）中分配并上传访问器数据,
+   * 已上传时只绑定所在缓冲; 属性与索引按分配的偏移绑定
+   * @param gltf glTF对象
+   * @param accessor 访问器对象
+   * @param target GL_ARRAY_BUFFER 或 GL_ELEMENT_ARRAY_BUFFER
+   * @return 是否成功
+   */
+  bool uploadAccessor(std::shared_ptr<Gltf> gltf,
+                      std::shared_ptr<GltfAccessor> accessor,
+                      GLenum target);
+
+  /**
+   * @brief 启用交错缓冲中的顶点属性
+   * @param attributeLocation 属性位置
+   * @param layout 图元的交错顶点布局
+   * @param attribute 布局中的属性
+   * @return 是否启用成功
+   */
+  bool enablePackedAttribute(GLint attributeLocation,
+                             GltfVertexLayout &layout,
+                             const GltfPackedAttribute &attribute);
+
+  /**
+   * @brief 在共享缓冲区域中分配交错顶点数据并上传, 上传后释放 CPU 端数据
+   * （已上传时只绑定）
+   * @return 是否成功
+   */
+  bool uploadVertexLayout(GltfVertexLayout &layout);
+
   /**
    * @brief 编译着色器
    * @param shaderIdentifier 着色器标识符
@@ -163,6 +207,25 @@ class GltfOpenGLContext {
   void uploadImageToTexture(std::shared_ptr<GltfTexture> gltfTexture,
                             std::shared_ptr<GltfImage> image);
 
+  /**
+   * @brief 逐级上传图像自带的 mip 链（KTX2 转码结果, 压缩格式用 glCompressedTexImage2D）
+   */
+  void uploadImageLevels(const std::shared_ptr<GltfTexture> &gltfTexture,
+                         const std::shared_ptr<GltfImage> &image);
+
+  std::shared_ptr<GltfTexture>
+  resolveTexture(const std::shared_ptr<Gltf> &gltf,
+                 const std::shared_ptr<GltfTextureInfo> &textureInfo,
+                 std::shared_ptr<GltfImage> &image);
+
+  void ensureTextureObject(const std::shared_ptr<GltfTexture> &gltfTexture,
+                           const std::shared_ptr<GltfImage> &image);
+
+  bool initializeTexture(const std::shared_ptr<Gltf> &gltf,
+                         const std::shared_ptr<GltfTextureInfo> &textureInfo,
+                         const std::shared_ptr<GltfTexture> &gltfTexture,
+                         const std::shared_ptr<GltfImage> &image);
+
  private:
   bool supportsEXTTextureFilterAnisotropic;
   GLenum anisotropyParameter;
@@ -3,7 +3,6 @@
 //
 
 #include "GltfPrimitive.h"
-#include <android/log.h>
 #include <cmath>
 #include <algorithm>
 #include <stdexcept>
@@ -17,6 +16,7 @@
 #include "GltfBuffer.h"
 #include "ImageMimeTypes.h"
 #include "GltfImage.h"
+#include "converter/GltfDracoDecoder.h"
 
 
 #define TINYGLTF_COMPONENT_TYPE_BYTE (5120)
@@ -55,8 +55,10 @@ void GltfPrimitive::initGl(std::shared_ptr<Gltf> gltf,
   GLint maxAttributes = 0;
   glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttributes);
 
-  // 处理扩展（如Draco压缩）
-  handleDracoCompression(gltf);
+  // Draco 解码失败且没有回退数据的图元不参与渲染
+  if (skip) {
+    return;
+  }
 
   // 生成切线（如果需要）
 //        if (attributes.find("TANGENT") == attributes.end() &&
@@ -80,38 +82,44 @@ void GltfPrimitive::initGl(std::shared_ptr<Gltf> gltf,
       break;
     }
 
-    bool knownAttribute = true;
-
     // 检查属性类型并设置标志
-    if (attributeName == "POSITION") {
-      skip = false;
-    } else if (attributeName == "NORMAL") {
-      m_hasNormals = true;
-    } else if (attributeName == "TANGENT") {
-      m_hasTangents = true;
-    } else if (attributeName == "TEXCOORD_0" || attributeName == "TEXCOORD_1") {
-      m_hasTexcoord = true;
-    } else if (attributeName == "COLOR_0") {
-      m_hasColor = true;
-    } else if (attributeName == "JOINTS_0" || attributeName == "JOINTS_1") {
-      m_hasJoints = true;
-    } else if (attributeName == "WEIGHTS_0" || attributeName == "WEIGHTS_1") {
-      m_hasWeights = true;
-    } else {
-      knownAttribute = false;
-      LOGI("Unknown attribute: %s", attributeName.c_str());
+    const VertexSemantic semantic = vertex_semantic::fromName(attributeName);
+    switch (semantic) {
+      case VertexSemantic::POSITION:
+        skip = false;
+        break;
+      case VertexSemantic::NORMAL:
+        m_hasNormals = true;
+        break;
+      case VertexSemantic::TANGENT:
+        m_hasTangents = true;
+        break;
+      case VertexSemantic::TEXCOORD_0:
+      case VertexSemantic::TEXCOORD_1:
+        m_hasTexcoord = true;
+        break;
+      case VertexSemantic::COLOR_0:
+        m_hasColor = true;
+        break;
+      case VertexSemantic::JOINTS_0:
+      case VertexSemantic::JOINTS_1:
+        m_hasJoints = true;
+        break;
+      case VertexSemantic::WEIGHTS_0:
+      case VertexSemantic::WEIGHTS_1:
+        m_hasWeights = true;
+        break;
+      case VertexSemantic::COUNT:
+        LOGI("Unknown attribute: %s", attributeName.c_str());
+        break;
     }
 
-    if (knownAttribute) {
-      // 创建OpenGL属性名称
-      std::string glAttributeName = "a_" + attributeName;
-      std::transform(glAttributeName.begin(), glAttributeName.end(),
-                     glAttributeName.begin(), ::tolower);
-
+    if (semantic != VertexSemantic::COUNT) {
       GLAttribute glAttr;
       glAttr.attribute = attributeName;
-      glAttr.name = glAttributeName;
+      glAttr.name = vertex_semantic::shaderName(semantic);
       glAttr.accessor = accessorIndex;
+      glAttr.semantic = semantic;
       glAttributes.push_back(glAttr);
 
       // 添加宏定义
@@ -127,6 +135,16 @@ void GltfPrimitive::initGl(std::shared_ptr<Gltf> gltf,
     }
   }
 
+  // 压缩格式需要在顶点着色器中还原
+  if (vertexLayout) {
+    if (vertexLayout->hasQuantizedPosition()) {
+      defines.push_back("HAS_QUANTIZED_POSITION 1");
+    }
+    if (vertexLayout->hasOctahedralNormal()) {
+      defines.push_back("HAS_OCTAHEDRAL_NORMAL 1");
+    }
+  }
+
   // 处理变形目标
   processMorphTargets(gltf, openGlContext);
 
@@ -134,24 +152,79 @@ void GltfPrimitive::initGl(std::shared_ptr<Gltf> gltf,
   computeCentroid(gltf);
 }
 
-void GltfPrimitive::handleDracoCompression(std::shared_ptr<Gltf> gltf) {
-  // TODO: 实现Draco压缩处理
-  // 这需要集成Draco解码库，在Android平台上可能需要特殊处理
-  LOGW("Draco compression handling not implemented yet");
-}
+bool GltfPrimitive::handleDracoCompression(std::shared_ptr<Gltf> gltf) {
+  if (!dracoExtension.has_value() || !gltf) {
+    return true;
+  }
+  const auto &accessors = gltf->getAccessors();
+  auto findAccessor = [&](int index) -> GltfAccessor * {
+    return index >= 0 && index < static_cast<int>(accessors.size())
+           ? accessors[index].get() : nullptr;
+  };
+
+  // 扩展中列出的属性与索引, 全部带有 bufferView 时可以回退到未压缩数据
+  GltfAccessor *indicesAccessor =
+      indices.has_value() ? findAccessor(indices.value()) : nullptr;
+  bool hasFallback = !indicesAccessor || indicesAccessor->hasBufferView();
+  std::vector<std::pair<int, GltfAccessor *>> targetAccessors;
+  for (const auto &[attributeName, uniqueId]: dracoExtension->attributes) {
+    auto it = attributes.find(attributeName);
+    GltfAccessor *accessor =
+        it != attributes.end() ? findAccessor(it->second) : nullptr;
+    if (!accessor) {
+      LOGW("Draco attribute %s has no accessor", attributeName.c_str());
+      continue;
+    }
+    hasFallback = hasFallback && accessor->hasBufferView();
+    targetAccessors.emplace_back(uniqueId, accessor);
+  }
+
+  std::string error;
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+  const auto &bufferViews = gltf->getBufferViews();
+  const auto &buffers = gltf->getBuffers();
+  const int viewIndex = dracoExtension->bufferView;
+  const auto *bufferView = viewIndex >= 0 &&
+      viewIndex < static_cast<int>(bufferViews.size())
+                           ? bufferViews[viewIndex].get() : nullptr;
+  if (bufferView && bufferView->getBuffer().has_value()) {
+    const int bufferIndex = bufferView->getBuffer().value();
+    const auto *buffer = bufferIndex >= 0 &&
+        bufferIndex < static_cast<int>(buffers.size())
+                         ? buffers[bufferIndex].get() : nullptr;
+    const size_t offset = bufferView->getByteOffset();
+    const size_t length = bufferView->getByteLength().value_or(0);
+    if (buffer && buffer->getData() &&
+        offset + length <= buffer->getActualSize()) {
+      data = buffer->getData() + offset;
+      size = length;
+    }
+  }
 
-void GltfPrimitive::processMorphTargets(std::shared_ptr<Gltf> gltf,
-                                        std::shared_ptr<GltfOpenGLContext> webGlContext) {
-  if (targets.empty()) {
-    return;
+  if (!data) {
+    error = "invalid bufferView " + std::to_string(viewIndex);
+  } else if (GltfDracoDecoder::decode(data, size, indicesAccessor,
+                                      targetAccessors, error)) {
+    return true;
   }
 
-  GLint maxTextureSize = 0;
-  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
-  const int max2DTextureSize = maxTextureSize * maxTextureSize;
+  if (hasFallback) {
+    LOGW("Draco decoding failed (%s), using uncompressed fallback data",
+         error.c_str());
+    return true;
+  }
+  LOGE("Draco decoding failed (%s), skipping primitive", error.c_str());
+  skip = true;
+  return false;
+}
 
-  GLint maxArrayTextureLayers = 0;
-  glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxArrayTextureLayers);
+std::shared_ptr<const GltfMorphTargetTexture>
+GltfPrimitive::assembleMorphTargets(const Gltf &gltf,
+                                    int maxArrayLayers) const {
+  if (targets.empty()) {
+    return nullptr;
+  }
 
   std::set<std::string> attributeSet;
   for (const auto &target: targets) {
@@ -164,114 +237,148 @@ void GltfPrimitive::processMorphTargets(std::shared_ptr<Gltf> gltf,
       morphAttributes(attributeSet.begin(), attributeSet.end());
 
   if (morphAttributes.empty()) {
-    return;
+    return nullptr;
   }
 
+  const auto &accessors = gltf.getAccessors();
+
   // 获取顶点数量
   int vertexCount = 0;
-  if (!morphAttributes.empty()) {
-    auto firstAttrIt = attributes.find(morphAttributes[0]);
-    if (firstAttrIt != attributes.end()) {
-      const int accessorIndex = firstAttrIt->second;
-      if (accessorIndex >= 0
-          && accessorIndex < static_cast<int>(gltf->getAccessors().size())) {
-        auto accessor = gltf->getAccessors()[accessorIndex];
-        if (accessor) {
-          vertexCount = accessor->getCount().value();
-        }
+  auto firstAttrIt = attributes.find(morphAttributes[0]);
+  if (firstAttrIt != attributes.end()) {
+    const int accessorIndex = firstAttrIt->second;
+    if (accessorIndex >= 0
+        && accessorIndex < static_cast<int>(accessors.size())) {
+      auto accessor = accessors[accessorIndex];
+      if (accessor) {
+        vertexCount = accessor->getCount().value();
       }
     }
   }
 
   if (vertexCount == 0) {
-    return;
+    return nullptr;
   }
 
-  defines.push_back("NUM_VERTICES " + std::to_string(vertexCount));
-
   // 检查纹理大小限制
   int targetCount = static_cast<int>(targets.size());
   if (targetCount * static_cast<int>(morphAttributes.size())
-      > maxArrayTextureLayers) {
-    targetCount =
-        maxArrayTextureLayers / static_cast<int>(morphAttributes.size());
+      > maxArrayLayers) {
+    targetCount = maxArrayLayers / static_cast<int>(morphAttributes.size());
     LOGW("Morph targets exceed texture size limit. Only %d of %zu are used.",
          targetCount, targets.size());
   }
 
+  auto texture = std::make_shared<GltfMorphTargetTexture>();
+  texture->width = static_cast<int>(std::ceil(std::sqrt(vertexCount)));
+  texture->vertexCount = vertexCount;
+  texture->targetCount = targetCount;
+  texture->attributes = std::move(morphAttributes);
+
+  const size_t singleTextureSize =
+      static_cast<size_t>(texture->width) * texture->width * 4;
+  auto texels = std::make_shared<std::vector<float>>(
+      singleTextureSize * texture->getLayerCount(), 0.0f);
+
+  // 组装纹理数据, 属性 a 的第 i 个目标位于第 a * targetCount + i 层
+  for (int i = 0; i < targetCount; ++i) {
+    const auto &target = targets[i];
+
+    for (size_t a = 0; a < texture->attributes.size(); ++a) {
+      auto targetAttrIt = target.find(texture->attributes[a]);
+      if (targetAttrIt == target.end()) {
+        continue;
+      }
+      const int accessorIndex = targetAttrIt->second;
+      if (accessorIndex < 0
+          || accessorIndex >= static_cast<int>(accessors.size())) {
+        continue;
+      }
+      auto accessor = accessors[accessorIndex];
+      if (!accessor || accessor->getComponentType() != GL_FLOAT) {
+        continue;
+      }
+      ArrayView<float> data = accessor->getNormalizedDeinterlacedSpan(gltf);
+      if (data.empty()) {
+        continue;
+      }
+      const size_t offset =
+          (a * targetCount + i) * singleTextureSize;
+      const int componentCount = accessor->getComponentCount();
+      const int copyCount = std::min(componentCount, 4);
+      const int count = std::min(accessor->getCount().value_or(0),
+                                 texture->width * texture->width);
+
+      // 将数据复制到纹理数组中，添加必要的填充
+      float *dst = texels->data() + offset;
+      const float *src = data.data();
+      for (int j = 0; j < count; ++j) {
+        std::copy(src, src + copyCount, dst);
+        dst += 4;
+        src += componentCount;
+      }
+    }
+  }
+
+  texture->texels.data = reinterpret_cast<const uint8_t *>(texels->data());
+  texture->texels.size = texels->size() * sizeof(float);
+  texture->texels.owner = std::move(texels);
+  return texture;
+}
+
+void GltfPrimitive::processMorphTargets(std::shared_ptr<Gltf> gltf,
+                                        std::shared_ptr<GltfOpenGLContext> webGlContext) {
+  if (targets.empty()) {
+    return;
+  }
+
+  GLint maxTextureSize = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+  const int max2DTextureSize = maxTextureSize * maxTextureSize;
+
+  GLint maxArrayTextureLayers = 0;
+  glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxArrayTextureLayers);
+
+  // 预先组装的数据超出本设备的层数限制时重新组装
+  auto texture = morphTargetTexture;
+  if (!texture || texture->getLayerCount() > maxArrayTextureLayers) {
+    texture = assembleMorphTargets(*gltf, maxArrayTextureLayers);
+  }
+  // 上传后不再需要
+  morphTargetTexture = nullptr;
+  if (!texture) {
+    return;
+  }
+
+  defines.push_back("NUM_VERTICES " + std::to_string(texture->vertexCount));
+
   // 设置属性偏移
-  std::unordered_map<std::string, int> attributeOffsets;
   int attributeOffset = 0;
-  for (const std::string &attribute: morphAttributes) {
+  for (const std::string &attribute: texture->attributes) {
     defines.push_back("HAS_MORPH_TARGET_" + attribute + " 1");
     defines.push_back("MORPH_TARGET_" + attribute + "_OFFSET "
                           + std::to_string(attributeOffset));
-    attributeOffsets[attribute] = attributeOffset;
-    attributeOffset += targetCount;
+    attributeOffset += texture->targetCount;
   }
   defines.push_back("HAS_MORPH_TARGETS 1");
 
-  if (vertexCount <= max2DTextureSize) {
-    // 创建变形目标纹理
-    const int width = static_cast<int>(std::ceil(std::sqrt(vertexCount)));
-    const int singleTextureSize = width * width * 4;
-    const int totalTextureSize = singleTextureSize * targetCount
-        * static_cast<int>(morphAttributes.size());
-
-    std::vector<float> morphTargetTextureArray(totalTextureSize, 0.0f);
-
-    // 组装纹理数据
-    for (int i = 0; i < targetCount; ++i) {
-      const auto &target = targets[i];
-
-      for (const auto &[attributeName, offsetRef]: attributeOffsets) {
-        auto targetAttrIt = target.find(attributeName);
-        if (targetAttrIt != target.end()) {
-          const int accessorIndex = targetAttrIt->second;
-          if (accessorIndex >= 0 && accessorIndex
-              < static_cast<int>(gltf->getAccessors().size())) {
-            auto accessor = gltf->getAccessors()[accessorIndex];
-            if (accessor && accessor->getComponentType() == GL_FLOAT) {
-              auto data = accessor->getNormalizedDeinterlacedView(*gltf);
-              if (data.size() > 0) {
-                const int offset = offsetRef * singleTextureSize;
-                const int componentCount = accessor->getComponentCount();
-
-                // 将数据复制到纹理数组中，添加必要的填充
-                int paddingOffset = 0;
-                int accessorOffset = 0;
-                for (int j = 0; j < accessor->getCount(); ++j) {
-                  const int copyCount = std::min(componentCount, 4);
-                  std::copy(data.begin() + accessorOffset,
-                            data.begin() + accessorOffset + copyCount,
-                            morphTargetTextureArray.begin() + offset
-                                + paddingOffset);
-                  paddingOffset += 4;
-                  accessorOffset += componentCount;
-                }
-              }
-            }
-          }
-        }
-      }
-    }
-
+  if (texture->vertexCount <= max2DTextureSize) {
     // 创建WebGL纹理
-    GLenum texture = webGlContext->createTexture();
-    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    GLenum glTexture = webGlContext->createTexture();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, glTexture);
 
     // 上传纹理数据
     glTexImage3D(
         GL_TEXTURE_2D_ARRAY,
         0,                                              // level
         GL_RGBA32F,                                     // internal format
-        width,                                          // width
-        width,                                          // height
-        targetCount * static_cast<int>(morphAttributes.size()),  // depth
+        texture->width,                                 // width
+        texture->width,                                 // height
+        texture->getLayerCount(),                       // depth
         0,                                              // border
         GL_RGBA,                                        // format
         GL_FLOAT,                                       // type
-        morphTargetTextureArray.data()                  // data
+        texture->texels.data                            // data
     );
 
     // 设置纹理参数
@@ -288,7 +395,7 @@ void GltfPrimitive::processMorphTargets(std::shared_ptr<Gltf> gltf,
         std::nullopt,                   // buffer view
         "",                   // name
         ImageMimeType::GLTEXTURE,     // mime type
-        texture                         // webgl texture
+        glTexture                       // webgl texture
     );
     //TODO
     gltf->addImage(morphTargetImage);
@@ -298,13 +405,13 @@ void GltfPrimitive::processMorphTargets(std::shared_ptr<Gltf> gltf,
     );
     gltf->addSampler(sampler);
 
-    auto morphTargetTexture = std::make_shared<GltfTexture>(
+    auto gltfTexture = std::make_shared<GltfTexture>(
         static_cast<int>(gltf->getSamplers().size() - 1),
         static_cast<int>(gltf->getImages().size() - 1),
         GL_TEXTURE_2D_ARRAY
     );
-    morphTargetTexture->setInitialized(true);
-    gltf->addTexture(morphTargetTexture);
+    gltfTexture->setInitialized(true);
+    gltf->addTexture(gltfTexture);
 
     morphTargetTextureInfo = std::make_shared<GltfTextureInfo>(
         static_cast<int>(gltf->getTextures().size() - 1), 0, true
@@ -316,6 +423,34 @@ void GltfPrimitive::processMorphTargets(std::shared_ptr<Gltf> gltf,
   }
 }
 
+bool GltfPrimitive::isUploaded(const Gltf &gltf) const {
+  if (skip) {
+    return true;
+  }
+  if (glAttributes.empty()) {
+    return false;
+  }
+  const auto &accessors = gltf.getAccessors();
+  auto uploaded = [&](int index) {
+    return index >= 0 && index < static_cast<int>(accessors.size()) &&
+        accessors[index] && accessors[index]->getGLAllocation();
+  };
+  if (indices.has_value() && !uploaded(indices.value())) {
+    return false;
+  }
+  const bool layoutUploaded = vertexLayout && vertexLayout->getGLAllocation();
+  for (const auto &attribute: glAttributes) {
+    if (vertexLayout && vertexLayout->find(attribute.semantic)) {
+      if (!layoutUploaded) {
+        return false;
+      }
+    } else if (!uploaded(attribute.accessor)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void GltfPrimitive::computeCentroid(std::shared_ptr<Gltf> gltf) {
   // 基础空指针检查
   if (!gltf) {
@@ -344,7 +479,8 @@ void GltfPrimitive::computeCentroid(std::shared_ptr<Gltf> gltf) {
   }
 
   // 获取位置数据
-  auto positions = positionsAccessor->getNormalizedTypedView(*gltf);
+  ArrayView<float> positions =
+      positionsAccessor->getNormalizedTypedSpan(*gltf);
   if (positions.empty()) {
     LOGW("位置数据为空");
     return;
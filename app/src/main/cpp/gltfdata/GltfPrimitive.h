@@ -8,6 +8,9 @@
 #include "GltfObject.h"
 #include "GltfTexture.h"
 #include "GltfAccessor.h"
+#include "GltfBuffer.h"
+#include "GltfVertexLayout.h"
+#include "VertexSemantic.h"
 #include "vec3.hpp"
 #include <GLES3/gl3.h>
 #include <memory>
@@ -29,6 +32,7 @@ struct GLAttribute {
   std::string attribute;      ///< 属性名称 (如 "POSITION")
   std::string name;          ///< OpenGL属性名称 (如 "a_position")
   int accessor;              ///< 访问器索引
+  VertexSemantic semantic = VertexSemantic::COUNT; ///< 加载时解析的语义
 };
 
 /**
@@ -39,6 +43,37 @@ struct MaterialMapping {
   std::vector<int> variants;              ///< 变体索引数组
 };
 
+/**
+ * @brief KHR_draco_mesh_compression 扩展信息
+ */
+struct GltfDracoExtension {
+  int bufferView = -1;                   ///< 压缩数据所在的缓冲区视图
+  std::map<std::string, int> attributes; ///< 属性名称 -> Draco 属性唯一 ID
+};
+
+/**
+ * @brief 组装好的变形目标纹理数据（GL_TEXTURE_2D_ARRAY, RGBA32F）
+ *
+ * 每个属性占 targetCount 层, 属性按名称排序, 每层 width * width 个顶点,
+ * 每个顶点 4 个 float（不足 4 分量补 0）。可由烘焙文件直接提供（texels 引用映射内存）。
+ */
+struct GltfMorphTargetTexture {
+  int width = 0;                          ///< 纹理边长
+  int vertexCount = 0;                    ///< 顶点数量
+  int targetCount = 0;                    ///< 实际使用的变形目标数
+  std::vector<std::string> attributes;    ///< 参与变形的属性名称（已排序）
+  GltfBinaryChunk texels;                 ///< 纹理数据
+
+  int getLayerCount() const {
+    return targetCount * static_cast<int>(attributes.size());
+  }
+
+  size_t getTexelBytes() const {
+    return static_cast<size_t>(width) * width * 4 * sizeof(float) *
+        getLayerCount();
+  }
+};
+
 /**
  * @brief glTF图元类
  * 表示渲染的基本几何单元
@@ -64,6 +99,13 @@ class GltfPrimitive: public GltfObject {
    */
   void computeCentroid(std::shared_ptr<Gltf> gltf);
 
+  /**
+   * @brief initGl 已执行, 且索引与顶点属性都已上传到缓冲区域
+   *
+   * 成立后图元不再读取访问器的 CPU 数据; 被跳过的图元始终成立。
+   */
+  bool isUploaded(const Gltf &gltf) const;
+
   // === Getter/Setter方法 ===
   const std::map<std::string, int> &getAttributes() const { return attributes; }
   void setAttributes(const std::map<std::string, int> &attributes) {
@@ -108,9 +150,53 @@ class GltfPrimitive: public GltfObject {
 
   // === 材质变体支持 ===
   const std::vector<MaterialMapping> &getMappings() const { return mappings; }
+
+  /**
+   * @brief 组装变形目标纹理数据（不调用 GL, 可在工作线程执行）
+   * @param gltf glTF根对象
+   * @param maxArrayLayers 纹理数组层数上限, 超出时只使用前面的变形目标
+   * @return 没有变形目标时返回 nullptr
+   */
+  std::shared_ptr<const GltfMorphTargetTexture>
+  assembleMorphTargets(const Gltf &gltf, int maxArrayLayers) const;
+
+  /**
+   * @brief 设置预先组装的变形目标纹理数据（如烘焙文件）, initGl 时直接上传
+   */
+  void setMorphTargetTexture(std::shared_ptr<const GltfMorphTargetTexture> texture) {
+    morphTargetTexture = std::move(texture);
+  }
+
   std::vector<uint32_t>
   getIndicesAsUint32(std::shared_ptr<GltfAccessor> accessor, const Gltf &gltf);
 
+  /**
+   * @brief 静态属性的交错压缩布局, 为空时各属性按访问器单独上传
+   */
+  const std::shared_ptr<GltfVertexLayout> &getVertexLayout() const {
+    return vertexLayout;
+  }
+  void setVertexLayout(std::shared_ptr<GltfVertexLayout> layout) {
+    vertexLayout = std::move(layout);
+  }
+
+  const std::optional<GltfDracoExtension> &getDracoExtension() const {
+    return dracoExtension;
+  }
+  void setDracoExtension(const GltfDracoExtension &extension) {
+    dracoExtension = extension;
+  }
+
+  /**
+   * @brief 解码 Draco 压缩的网格, 结果直接写入索引与属性访问器
+   *
+   * 不调用 GL, 可在工作线程执行, 须在 initGl 之前完成。
+   * 无法解码时若访问器带有未压缩的回退数据则使用回退数据, 否则跳过该图元。
+   * @param gltf glTF根对象
+   * @return 图元数据可用时返回 true
+   */
+  bool handleDracoCompression(std::shared_ptr<Gltf> gltf);
+
   /**
 * @brief 获取可动画属性名称列表
 * @return 属性名称列表
@@ -120,12 +206,6 @@ class GltfPrimitive: public GltfObject {
  private:
 
 
-  /**
-   * @brief 处理Draco压缩网格解压缩
-   * @param gltf glTF根对象
-   */
-  void handleDracoCompression(std::shared_ptr<Gltf> gltf);
-
   /**
    * @brief 处理变形目标
    * @param gltf glTF根对象
@@ -186,12 +266,18 @@ class GltfPrimitive: public GltfObject {
   std::optional<int>
       material = -1;                                        ///< 材质索引
   int mode;                                                        ///< 图元模式
+  std::optional<GltfDracoExtension>
+      dracoExtension;                                       ///< Draco 压缩扩展
 
   // === 非glTF标准属性（运行时数据） ===
   std::vector<GLAttribute>
        glAttributes;                              ///< OpenGL属性信息
   std::shared_ptr<GltfTextureInfo>
       morphTargetTextureInfo;            ///< 变形目标纹理信息
+  std::shared_ptr<const GltfMorphTargetTexture>
+      morphTargetTexture;                ///< 预先组装的变形目标纹理数据
+  std::shared_ptr<GltfVertexLayout>
+      vertexLayout;                      ///< 交错压缩的顶点布局
   std::vector<std::string>
       defines;                                   ///< 着色器宏定义
 
@@ -3,7 +3,6 @@
 //
 #include "GltfRenderer.h"
 #include "../utils/utils.h"
-#include <android/log.h>
 #include <algorithm>
 #include <sstream>
 #include <cmath>
@@ -18,6 +17,7 @@
 #include "GltfShader.h"
 
 #include "GltfOpenGLContext.h"
+#include "GltfBufferArena.h"
 #include "Gltf.h"
 #include "GltfMesh.h"
 #include "GltfSkin.h"
@@ -582,6 +582,8 @@ void GltfRenderer::drawScene(std::shared_ptr<GltfState> state,
 
     // 渲染透射背景（如果有透射对象）
     if (!transmissionDrawables.empty()) {
+      RenderPassProfiler::Scope
+          passScope(passProfiler.get(), RenderPass::TRANSMISSION);
       renderTransmissionBackground(state, instanceTransforms);
     }
 
@@ -1088,6 +1090,8 @@ void GltfRenderer::renderToCanvas(std::shared_ptr<GltfState> state,
   std::vector<std::string> fragDefines;
   pushFragParameterDefines(fragDefines, state);
   if (environmentRenderer) {
+    RenderPassProfiler::Scope
+        passScope(passProfiler.get(), RenderPass::ENVIRONMENT);
     environmentRenderer->drawEnvironmentMap(openGlContext,
                                             viewProjectionMatrix,
                                             state,
@@ -1100,6 +1104,9 @@ void GltfRenderer::renderToCanvas(std::shared_ptr<GltfState> state,
 
 
   // 渲染不透明对象
+  if (passProfiler) {
+    passProfiler->beginPass(RenderPass::OPAQUE);
+  }
   int drawableCounter = 0;
   for (const auto &[groupId, instanceData]: opaqueDrawables) {
     if (!instanceData.drawables.empty()) {
@@ -1119,7 +1126,14 @@ void GltfRenderer::renderToCanvas(std::shared_ptr<GltfState> state,
     drawableCounter++;
   }
 
+  if (passProfiler) {
+    passProfiler->endPass(RenderPass::OPAQUE);
+  }
+
 //        // 渲染透射对象
+  if (passProfiler) {
+    passProfiler->beginPass(RenderPass::TRANSMISSION);
+  }
   auto camera = getCurrentCamera(state);
   std::vector<Drawable>
       sortedTransmission = sortDrawablesByDepth(transmissionDrawables, state);
@@ -1131,7 +1145,13 @@ void GltfRenderer::renderToCanvas(std::shared_ptr<GltfState> state,
                     viewProjectionMatrix, opaqueRenderTexture);
     }
   }
+  if (passProfiler) {
+    passProfiler->endPass(RenderPass::TRANSMISSION);
+  }
+
   // 渲染透明对象
+  RenderPassProfiler::Scope
+      passScope(passProfiler.get(), RenderPass::TRANSPARENT);
   std::vector<Drawable>
       sortedTransparent = sortDrawablesByDepth(transparentDrawables, state);
   for (const auto &drawable: sortedTransparent) {
@@ -1433,6 +1453,13 @@ int GltfRenderer::bindVertexAttributes(std::shared_ptr<GltfState> state,
 
   int vertexCount = 0;
 
+  // 交错布局中的属性共用一个缓冲, 压缩的位置需要还原参数
+  const auto &layout = primitive->getVertexLayout();
+  if (layout && layout->hasQuantizedPosition()) {
+    shader->updateUniform("u_PositionScale", layout->getPositionScale());
+    shader->updateUniform("u_PositionOffset", layout->getPositionOffset());
+  }
+
   // 绑定顶点属性
   for (const auto &attribute: primitive->getGLAttributes()) {
     if (attribute.accessor >= gltf->accessors.size()) {
@@ -1443,9 +1470,18 @@ int GltfRenderer::bindVertexAttributes(std::shared_ptr<GltfState> state,
     auto accessor = gltf->accessors[attribute.accessor];
     vertexCount = accessor->getCount().value();
 
-    GLint location = shader->getAttributeLocation(attribute.name);
+    GLint location = shader->getAttributeLocation(attribute.semantic);
     if (location == -1) {
-      logVerbose("Attribute " + attribute.name + " not found in shader");
+      continue;
+    }
+
+    const GltfPackedAttribute *packed =
+        layout ? layout->find(attribute.semantic) : nullptr;
+    if (packed) {
+      if (!openGlContext->enablePackedAttribute(location, *layout, *packed)) {
+        LOGW("Failed to enable attribute %s", attribute.name.c_str());
+        return 0;
+      }
       continue;
     }
 
@@ -1535,7 +1571,7 @@ GltfRenderer::unbindVertexAttributes(std::shared_ptr<GltfPrimitive> primitive,
 
   // 禁用顶点属性
   for (const auto &attribute: primitive->getGLAttributes()) {
-    GLint location = shader->getAttributeLocation(attribute.name);
+    GLint location = shader->getAttributeLocation(attribute.semantic);
     if (location != -1) {
       glDisableVertexAttribArray(location);
     }
@@ -1883,11 +1919,17 @@ void GltfRenderer::executeDrawCall(std::shared_ptr<GltfPrimitive> primitive,
         return;
       }
 
+      // 索引位于共享缓冲区域中, 按分配的偏移绘制
+      const auto *allocation = indexAccessor->getGLAllocation();
+      if (!allocation) {
+        LOGW("Index accessor is not uploaded");
+        return;
+      }
       if (isInstanced) {
         glDrawElementsInstanced(primitive->getMode(),
                                 indexAccessor->getCount().value(),
                                 indexAccessor->getComponentType().value(),
-                                0,
+                                allocation->offsetPointer(),
                                 static_cast<GLsizei>(instanceOffset->size()));
         logVerbose("Drew " + std::to_string(instanceOffset->size())
                        + " indexed instances");
@@ -1896,7 +1938,7 @@ void GltfRenderer::executeDrawCall(std::shared_ptr<GltfPrimitive> primitive,
         glDrawElements(primitive->getMode(),
                        indexAccessor->getCount().value(),
                        indexAccessor->getComponentType().value(),
-                       0);
+                       allocation->offsetPointer());
       }
     } else {
       // 数组绘制
@@ -19,6 +19,7 @@
 #include "GltfScene.h"
 #include "GltfCamera.h"
 #include "GltfMaterial.h"
+#include "RenderPassProfiler.h"
 
 namespace digitalhumans {
 
@@ -264,6 +265,21 @@ class GltfRenderer {
    */
   void resetStatistics();
 
+  /**
+   * @brief 设置渲染通道耗时统计器, 传入 nullptr 关闭统计
+   * @param profiler 通道耗时统计器
+   */
+  void setPassProfiler(std::shared_ptr<RenderPassProfiler> profiler) {
+    passProfiler = std::move(profiler);
+  }
+
+  /**
+   * @brief 获取渲染通道耗时统计器
+   * @return 统计器, 未设置时为 nullptr
+   */
+  std::shared_ptr<RenderPassProfiler>
+  getPassProfiler() const { return passProfiler; }
+
   /**
    * @brief 设置多重采样级别
    * @param samples 采样级别
@@ -802,6 +818,7 @@ class GltfRenderer {
   mutable size_t renderedPrimitives;                     ///< 渲染图元数量
   mutable size_t shaderSwitches;                         ///< 着色器切换次数
   mutable size_t textureBinds;                           ///< 纹理绑定次数
+  std::shared_ptr<RenderPassProfiler> passProfiler;      ///< 通道耗时统计（可选）
 
  public:
 
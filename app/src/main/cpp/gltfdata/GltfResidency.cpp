@@ -0,0 +1,233 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#include "GltfResidency.h"
+#include <optional>
+#include <vector>
+#include "Gltf.h"
+#include "GltfAccessor.h"
+#include "GltfAnimation.h"
+#include "GltfAnimationClip.h"
+#include "GltfAnimationSampler.h"
+#include "GltfBuffer.h"
+#include "GltfBufferView.h"
+#include "GltfImage.h"
+#include "GltfMesh.h"
+#include "GltfPrimitive.h"
+#include "GltfSkin.h"
+#include "../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+namespace {
+
+/**
+ * @brief 图元引用的全部访问器（索引、属性、变形目标）
+ */
+template<typename Visit>
+void forEachPrimitiveAccessor(const GltfPrimitive &primitive, Visit visit) {
+  if (primitive.getIndices().has_value()) {
+    visit(primitive.getIndices().value());
+  }
+  for (const auto &[_, index]: primitive.getAttributes()) {
+    visit(index);
+  }
+  for (const auto &target: primitive.getTargets()) {
+    for (const auto &[_, index]: target) {
+      visit(index);
+    }
+  }
+}
+
+template<typename Visit>
+void forEachPrimitive(Gltf &gltf, Visit visit) {
+  for (const auto &mesh: gltf.getMeshes()) {
+    if (!mesh) {
+      continue;
+    }
+    for (const auto &primitive: mesh->getPrimitives()) {
+      if (primitive) {
+        visit(*primitive);
+      }
+    }
+  }
+}
+
+/**
+ * @brief 缓冲区视图所在的 buffer, 无效时返回 -1
+ */
+int bufferOf(const Gltf &gltf, const std::optional<int> &viewIndex) {
+  const auto &bufferViews = gltf.getBufferViews();
+  if (!viewIndex.has_value() || viewIndex.value() < 0 ||
+      viewIndex.value() >= static_cast<int>(bufferViews.size()) ||
+      !bufferViews[viewIndex.value()]) {
+    return -1;
+  }
+  return bufferViews[viewIndex.value()]->getBuffer().value_or(-1);
+}
+
+} // namespace
+
+void GltfResidency::classify(Gltf &gltf) {
+  auto &accessors = gltf.accessors;
+  std::vector<AccessorResidency> policies(accessors.size(),
+                                          AccessorResidency::DEFAULT);
+  auto mark = [&](int index, AccessorResidency policy) {
+    if (index >= 0 && index < static_cast<int>(policies.size()) &&
+        policies[index] != AccessorResidency::RUNTIME) {
+      policies[index] = policy;
+    }
+  };
+  for (const auto &animation: gltf.getAnimations()) {
+    if (!animation) {
+      continue;
+    }
+    // 编译为片段的通道只读取片段中的关键帧, 其采样器数据在首帧后释放;
+    // 片段未编译的通道（指针动画等）仍由插值器逐帧读取采样器
+    const auto &channels = animation->getChannels();
+    const auto &samplers = animation->getSamplers();
+    const auto clip = animation->getClip();
+    std::vector<bool> interpolated(channels.size(), !clip);
+    if (clip) {
+      for (const uint32_t channel: clip->getUncompiledChannels()) {
+        interpolated[channel] = true;
+      }
+    }
+    for (size_t c = 0; c < channels.size(); ++c) {
+      if (!channels[c] || !channels[c]->hasSampler()) {
+        continue;
+      }
+      const int samplerIndex = channels[c]->getSampler().value();
+      if (samplerIndex < 0 || samplerIndex >= static_cast<int>(samplers.size()) ||
+          !samplers[samplerIndex]) {
+        continue;
+      }
+      const auto &sampler = samplers[samplerIndex];
+      const AccessorResidency policy = interpolated[c]
+          ? AccessorResidency::RUNTIME : AccessorResidency::UPLOAD_ONLY;
+      mark(sampler->getInput().value_or(-1), policy);
+      mark(sampler->getOutput().value_or(-1), policy);
+    }
+  }
+  for (const auto &skin: gltf.getSkins()) {
+    if (skin) {
+      mark(skin->getInverseBindMatrices().value_or(-1),
+           AccessorResidency::RUNTIME);
+    }
+  }
+  forEachPrimitive(gltf, [&](const GltfPrimitive &primitive) {
+    forEachPrimitiveAccessor(primitive, [&](int index) {
+      mark(index, AccessorResidency::UPLOAD_ONLY);
+    });
+  });
+
+  auto &stats = gltf.residencyStats;
+  size_t uploadOnly = 0;
+  for (size_t i = 0; i < accessors.size(); ++i) {
+    if (!accessors[i]) {
+      continue;
+    }
+    accessors[i]->setResidency(policies[i]);
+    if (policies[i] == AccessorResidency::RUNTIME) {
+      stats.runtimeFreedBytes += accessors[i]->settleRuntimeData(gltf);
+      stats.runtimeKeptBytes += accessors[i]->getCpuBytes();
+      ++stats.runtimeAccessors;
+    } else if (policies[i] == AccessorResidency::UPLOAD_ONLY) {
+      ++uploadOnly;
+    }
+  }
+  LOGI("Accessor residency: %zu runtime (%zu bytes kept), %zu upload-only",
+       stats.runtimeAccessors, stats.runtimeKeptBytes, uploadOnly);
+}
+
+void GltfResidency::releaseUploaded(Gltf &gltf) {
+  auto &stats = gltf.residencyStats;
+  if (stats.uploadedDataReleased) {
+    return;
+  }
+  size_t pendingPrimitives = 0;
+  forEachPrimitive(gltf, [&](const GltfPrimitive &primitive) {
+    pendingPrimitives += primitive.isUploaded(gltf) ? 0 : 1;
+  });
+  // 图元只会从未上传变为已上传, 数量不变说明上次释放后没有新的图元上传
+  if (stats.releasePasses > 0 && pendingPrimitives == stats.pendingPrimitives) {
+    return;
+  }
+  ++stats.releasePasses;
+  stats.pendingPrimitives = pendingPrimitives;
+  stats.uploadedDataReleased = pendingPrimitives == 0;
+
+  // 尚未上传的图元仍可能读取其访问器
+  const auto &accessors = gltf.getAccessors();
+  std::vector<bool> pending(accessors.size(), false);
+  if (pendingPrimitives > 0) {
+    forEachPrimitive(gltf, [&](const GltfPrimitive &primitive) {
+      if (primitive.isUploaded(gltf)) {
+        return;
+      }
+      forEachPrimitiveAccessor(primitive, [&](int index) {
+        if (index >= 0 && index < static_cast<int>(pending.size())) {
+          pending[index] = true;
+        }
+      });
+    });
+  }
+
+  // buffer 在仍持有 CPU 数据来源的访问器或图像引用它时保留
+  std::vector<bool> needed(gltf.buffers.size(), false);
+  auto need = [&](int bufferIndex) {
+    if (bufferIndex >= 0 && bufferIndex < static_cast<int>(needed.size())) {
+      needed[bufferIndex] = true;
+    }
+  };
+  for (size_t i = 0; i < accessors.size(); ++i) {
+    auto &accessor = accessors[i];
+    if (!accessor || accessor->isCpuDataReleased()) {
+      continue;
+    }
+    const AccessorResidency policy = accessor->getResidency();
+    if (policy == AccessorResidency::UPLOAD_ONLY && !pending[i]) {
+      stats.uploadOnlyFreedBytes += accessor->releaseCpuData();
+      ++stats.uploadOnlyAccessors;
+      continue;
+    }
+    // 未被引用的访问器不会被读取, 不阻止释放
+    if (policy == AccessorResidency::DEFAULT || accessor->hasDecodedData()) {
+      continue;
+    }
+    need(bufferOf(gltf, accessor->getBufferView()));
+    const auto &sparse = accessor->getSparse();
+    if (sparse.has_value()) {
+      need(bufferOf(gltf, sparse->indices.bufferView));
+      need(bufferOf(gltf, sparse->values.bufferView));
+    }
+  }
+  for (const auto &image: gltf.getImages()) {
+    if (image) {
+      need(bufferOf(gltf, image->getBufferView()));
+    }
+  }
+
+  for (size_t i = 0; i < gltf.buffers.size(); ++i) {
+    auto &buffer = gltf.buffers[i];
+    if (!buffer || needed[i]) {
+      continue;
+    }
+    // 资源缓存或其他模型仍共享时只释放本模型的引用
+    if (buffer.use_count() == 1 && !buffer->isExternal()) {
+      stats.bufferFreedBytes += buffer->getActualSize();
+    }
+    buffer.reset();
+    ++stats.releasedBuffers;
+  }
+
+  LOGI("Released CPU data after upload: %zu accessors (%zu bytes), "
+       "%zu buffers (%zu bytes); runtime accessors freed %zu bytes; "
+       "%zu primitives pending",
+       stats.uploadOnlyAccessors, stats.uploadOnlyFreedBytes,
+       stats.releasedBuffers, stats.bufferFreedBytes, stats.runtimeFreedBytes,
+       pendingPrimitives);
+}
+
+} // namespace digitalhumans
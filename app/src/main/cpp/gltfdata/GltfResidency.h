@@ -0,0 +1,57 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFRESIDENCY_H
+#define LIGHTDIGITALHUMAN_GLTFRESIDENCY_H
+
+#include <cstddef>
+
+namespace digitalhumans {
+
+class Gltf;
+
+/**
+ * @brief 各驻留策略释放的 CPU 内存
+ */
+struct GltfResidencyStats {
+  size_t runtimeAccessors = 0;     ///< 整理为单份 float 数据的运行时访问器数
+  size_t runtimeKeptBytes = 0;     ///< 运行时访问器保留的字节数
+  size_t runtimeFreedBytes = 0;    ///< 运行时访问器整理时释放的缓存字节数
+  size_t uploadOnlyAccessors = 0;  ///< 上传后释放了 CPU 数据的访问器数
+  size_t uploadOnlyFreedBytes = 0; ///< 上传访问器释放的字节数
+  size_t releasedBuffers = 0;      ///< 释放的 buffer 数
+  size_t bufferFreedBytes = 0;     ///< 释放的 buffer 字节数（仍被资源缓存共享的不计入）
+  size_t pendingPrimitives = 0;    ///< 最近一次释放时尚未上传的图元数
+  size_t releasePasses = 0;        ///< 上传后释放执行的次数
+  bool uploadedDataReleased = false; ///< 全部图元已上传且释放已完成
+};
+
+/**
+ * @brief 访问器 CPU 数据的驻留策略
+ *
+ * 转换完成后按引用关系为访问器设置策略: 未编译为片段的动画通道的采样器与逆绑定矩阵引用的
+ * 访问器在运行时由 CPU 读取, 整理为唯一一份紧密 float 数据, 不再在类型化、去交错、
+ * 标准化缓存间各留一份; 只被图元或动画片段引用的访问器在上传到 GPU 后释放全部 CPU 数据。
+ * 所有访问器都不再依赖某个 buffer 时, 模型对该 buffer 的引用一并释放。
+ */
+class GltfResidency {
+ public:
+  /**
+   * @brief 设置访问器的驻留策略并整理运行时访问器, 在转换完成后调用
+   */
+  static void classify(Gltf &gltf);
+
+  /**
+   * @brief 释放已上传图元的访问器与不再需要的 buffer, 需在上传完成后于 GL 线程调用
+   *
+   * 只处理 initGl 已执行且索引与顶点属性都已上传的图元。仍有图元未上传（其他场景、
+   * 尚未绘制的节点）时, 之后每次调用在又有图元上传后再释放一次, 全部上传后不再执行。
+   * 被图像引用的 buffer 保留, 纹理上传可能仍需读取。
+   */
+  static void releaseUploaded(Gltf &gltf);
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFRESIDENCY_H
@@ -4,7 +4,6 @@
 
 #include "GltfShader.h"
 
-#include <android/log.h>
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
@@ -28,6 +27,7 @@ GltfShader::GltfShader(GLuint shaderProgram,
       unknownAttributes(), reportedUnknownUniforms(),
       reportedUnknownAttributes(), gl(std::move(webgl)),
       uniformUpdateCount(0), attributeQueryCount(0) {
+  semanticLocations.fill(-1);
   if (program != 0 && gl) {
     initializeUniforms();
     initializeAttributes();
@@ -44,6 +44,8 @@ GltfShader::GltfShader(GltfShader &&other) noexcept
     : program(other.program), hash(std::move(other.hash)),
       uniforms(std::move(other.uniforms)),
       attributes(std::move(other.attributes)),
+      semanticLocations(other.semanticLocations),
+      reportedUnknownSemantics(other.reportedUnknownSemantics),
       unknownUniforms(std::move(other.unknownUniforms)),
       unknownAttributes(std::move(other.unknownAttributes)),
       reportedUnknownUniforms(std::move(other.reportedUnknownUniforms)),
@@ -64,6 +66,8 @@ GltfShader &GltfShader::operator=(GltfShader &&other) noexcept {
     hash = std::move(other.hash);
     uniforms = std::move(other.uniforms);
     attributes = std::move(other.attributes);
+    semanticLocations = other.semanticLocations;
+    reportedUnknownSemantics = other.reportedUnknownSemantics;
     unknownUniforms = std::move(other.unknownUniforms);
     unknownAttributes = std::move(other.unknownAttributes);
     reportedUnknownUniforms = std::move(other.reportedUnknownUniforms);
@@ -107,6 +111,21 @@ GLint GltfShader::getAttributeLocation(const std::string &name) {
   return it->second;
 }
 
+GLint GltfShader::getAttributeLocation(VertexSemantic semantic) {
+  attributeQueryCount++;
+
+  const auto index = static_cast<size_t>(semantic);
+  if (index >= kVertexSemanticCount) {
+    return -1;
+  }
+  const GLint location = semanticLocations[index];
+  if (location == -1 && !(reportedUnknownSemantics & (1u << index))) {
+    reportedUnknownSemantics |= 1u << index;
+    recordUnknownAttribute(vertex_semantic::shaderName(semantic));
+  }
+  return location;
+}
+
 GLint GltfShader::getUniformLocation(const std::string &name) {
   auto it = uniforms.find(name);
   if (it == uniforms.end()) {
@@ -622,6 +641,12 @@ void GltfShader::initializeAttributes() {
       attributes[name] = location;
     }
   }
+
+  for (size_t i = 0; i < kVertexSemanticCount; ++i) {
+    auto it = attributes.find(
+        vertex_semantic::shaderName(static_cast<VertexSemantic>(i)));
+    semanticLocations[i] = it != attributes.end() ? it->second : -1;
+  }
   checkGLError("initialize attributes");
 }
 
@@ -5,6 +5,7 @@
 #ifndef LIGHTDIGITALHUMAN_GLTFSHADER_H
 #define LIGHTDIGITALHUMAN_GLTFSHADER_H
 
+#include <array>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -15,6 +16,7 @@
 #include <GLES3/gl3.h>
 #include "glm.hpp"
 #include "UniformTypes.h"
+#include "VertexSemantic.h"
 
 namespace digitalhumans {
 
@@ -94,6 +96,13 @@ class GltfShader {
    */
   GLint getAttributeLocation(const std::string &name);
 
+  /**
+   * @brief 按语义获取attribute位置, 链接后解析一次, 查询只是查表
+   * @param semantic 顶点属性语义
+   * @return attribute位置，如果不存在返回-1
+   */
+  GLint getAttributeLocation(VertexSemantic semantic);
+
   /**
    * @brief 获取uniform位置
    * @param name uniform名称
@@ -329,6 +338,8 @@ class GltfShader {
   std::string hash;                                         ///< 着色器哈希值
   std::unordered_map<std::string, UniformInfo> uniforms;   ///< uniform信息映射
   std::unordered_map<std::string, GLint> attributes;       ///< attribute位置映射
+  std::array<GLint, kVertexSemanticCount> semanticLocations{}; ///< 语义 -> attribute位置
+  uint32_t reportedUnknownSemantics = 0;   ///< 已报告的未知语义（位掩码）
   std::vector<std::string> unknownUniforms;                ///< 未知uniform名称列表
   std::vector<std::string> unknownAttributes;              ///< 未知attribute名称列表
   std::unordered_set<std::string>
@@ -124,13 +124,24 @@ void GltfSkin::computeJoints(std::shared_ptr<Gltf> gltf,
     }
   }
 
+  // 逆绑定矩阵直接引用访问器数据
+  GltfAccessorView ibmView;
+  if (ibmAccessor) {
+    ibmView = ibmAccessor->getView(*gltf);
+    if (ibmView.componentType != GL_FLOAT || ibmView.componentCount != 16) {
+      ibmView = GltfAccessorView();
+    }
+  }
+
   jointMatrices.clear();
   jointNormalMatrices.clear();
   jointMatrices.reserve(joints.size());
   jointNormalMatrices.reserve(joints.size());
 
+  // 纹理数据缓冲逐帧复用, 只在关节数变化时重新分配
   const int width = static_cast<int>(std::ceil(std::sqrt(joints.size() * 8)));
-  std::vector<float> textureData(width * width * 4, 0.0f);
+  std::vector<float> &textureData = jointTextureData;
+  textureData.assign(static_cast<size_t>(width) * width * 4, 0.0f);
   int jointIndex = 0;
   for (const int joint: joints) {
     if (joint < 0 || joint >= static_cast<int>(gltf->getNodes().size())) {
@@ -143,20 +154,11 @@ void GltfSkin::computeJoints(std::shared_ptr<Gltf> gltf,
     }
     glm::mat4 jointMatrix = node->getWorldTransform();
 
-    if (ibmAccessor && jointIndex < ibmAccessor->getCount()) {
-      try {
-        const auto ibmData = ibmAccessor->getDeinterlacedView(*gltf);
-        if (ibmData.second >= (jointIndex + 1) * 16 * sizeof(float)) {
-          const auto *floatData = static_cast<const float *>(ibmData.first);
-          glm::mat4 ibm;
-          std::memcpy(glm::value_ptr(ibm),
-                      floatData + jointIndex * 16,
-                      16 * sizeof(float));
-          jointMatrix = jointMatrix * ibm;
-        }
-      } catch (const std::exception &e) {
-        LOGE("Error applying inverse bind matrix: %s", e.what());
-      }
+    if (jointIndex < static_cast<int>(ibmView.count)) {
+      glm::mat4 ibm;
+      std::memcpy(glm::value_ptr(ibm), ibmView.elementAs<float>(jointIndex),
+                  16 * sizeof(float));
+      jointMatrix = jointMatrix * ibm;
     }
 
     glm::mat4 normalMatrix = glm::transpose(glm::inverse(jointMatrix));
@@ -186,6 +186,7 @@ class GltfSkin: public GltfObject {
   GLenum jointWebGlTexture;                      ///< WebGL关节纹理对象
   std::vector<glm::mat4> jointMatrices;                ///< 关节变换矩阵
   std::vector<glm::mat4> jointNormalMatrices;          ///< 关节法线矩阵
+  std::vector<float> jointTextureData;                 ///< 关节纹理数据, 逐帧复用
   bool webglResourcesInitialized;                      ///< WebGL资源初始化标志
   glm::mat4 simulateShaderMatrixRead(const std::vector<float> &textureData,
                                      int width,
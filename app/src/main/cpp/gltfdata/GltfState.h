@@ -9,6 +9,9 @@
 #include "../utils/utils.h"
 #include "UserCamera.h"
 #include "GltfEnvironment.h"
+#include "GltfAnimationClip.h"
+#include "GltfAnimationMixer.h"
+#include "GltfAnimationLod.h"
 #include <vector>
 #include <string>
 #include <memory>
@@ -154,6 +157,14 @@ class GltfState {
    */
   void setGltf(std::shared_ptr<Gltf> gltf) {
     this->gltf = gltf;
+    animationPose.clear();
+    // 在动画修改节点之前记录静止姿态
+    if (gltf) {
+      animationMixer.bind(*gltf);
+      animationLod.bind(*gltf);
+    } else {
+      animationLod.clear();
+    }
     if (environment) {
       environment->setGltf(gltf);
     }
@@ -230,6 +241,23 @@ class GltfState {
    * @return 动画计时器引用
    */
   utils::AnimationTimer &getAnimationTimer() { return animationTimer; }
+
+  /**
+   * @brief 获取动画采样使用的姿态缓冲
+   * @return 姿态缓冲, 首次采样时按当前模型分配
+   */
+  GltfAnimationPose &getAnimationPose() { return animationPose; }
+
+  /**
+   * @brief 获取动画层栈, 层在切换模型后保留, 层上的片段与遮罩被清除
+   */
+  GltfAnimationMixer &getAnimationMixer() { return animationMixer; }
+
+  /**
+   * @brief 获取动画 LOD, 阈值在切换模型后保留
+   */
+  GltfAnimationLod &getAnimationLod() { return animationLod; }
+  const GltfAnimationLod &getAnimationLod() const { return animationLod; }
   const utils::AnimationTimer &
   getAnimationTimer() const { return animationTimer; }
 
@@ -325,6 +353,9 @@ class GltfState {
   int sceneIndex;                                 ///< 可见的glTF场景
   std::optional<int> cameraNodeIndex = {-1};             ///< 渲染视图的摄像机节点索引
   std::vector<AnimationEntry> animationIndices;              ///< 活动动画索引
+  GltfAnimationPose animationPose;                           ///< 动画姿态缓冲
+  GltfAnimationMixer animationMixer;                         ///< 动画层栈
+  GltfAnimationLod animationLod;                             ///< 动画 LOD
   utils::AnimationTimer animationTimer;           ///< 动画计时器
   std::optional<std::string> variant;             ///< KHR_materials_variants
 
@@ -3,7 +3,6 @@
 //
 #include "GltfTexture.h"
 #include "../utils/utils.h"
-#include <android/log.h>
 #include <stdexcept>
 
 #include "../utils/LogUtils.h"
@@ -75,7 +74,7 @@ GltfTexture::GltfTexture(std::optional<int> sampler,
                          std::optional<int> source,
                          GLenum type)
     : GltfObject(), sampler(sampler), source(source), glTexture(0), type(type),
-      initialized(false), mipLevelCount(0), linear(true) {
+      initialized(false), mipLevelCount(0), linear(true), external(false) {
 }
 
 GltfTexture::~GltfTexture() {
@@ -84,11 +83,11 @@ GltfTexture::~GltfTexture() {
 
 
 void GltfTexture::destroy() {
-  if (glTexture != 0) {
+  if (glTexture != 0 && !external) {
     // 尝试获取WebGL上下文
     glDeleteTextures(1, &glTexture);
-    glTexture = 0;
   }
+  glTexture = 0;
   initialized = false;
 }
 
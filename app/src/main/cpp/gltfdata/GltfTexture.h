@@ -166,6 +166,9 @@ class GltfTexture: public GltfObject {
   bool isLinear() const { return linear; }
   void setLinear(bool linear) { this->linear = linear; }
 
+  bool isExternal() const { return external; }
+  void setExternal(bool external) { this->external = external; }
+
 
  private:
   // === glTF标准属性 ===
@@ -178,6 +181,7 @@ class GltfTexture: public GltfObject {
   bool initialized;               ///< 是否已初始化
   int mipLevelCount;              ///< mip级别数量
   bool linear;                    ///< 是否线性空间
+  bool external;                  ///< 纹理对象由外部持有（如 IBL）, 销毁时不释放
 
 
 };
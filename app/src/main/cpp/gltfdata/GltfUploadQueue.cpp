@@ -0,0 +1,120 @@
+//
+// Created by vincentsyan on 2025/9/26.
+//
+
+#include "GltfUploadQueue.h"
+#include <chrono>
+#include <set>
+#include "Gltf.h"
+#include "GltfMaterial.h"
+#include "GltfMesh.h"
+#include "GltfOpenGLContext.h"
+#include "GltfPrimitive.h"
+#include "GltfSkin.h"
+#include "GltfTexture.h"
+#include "../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+void GltfUploadQueue::push(Task task) {
+  tasks.push_back(std::move(task));
+  ++totalCount;
+}
+
+void GltfUploadQueue::enqueueGltf(const std::shared_ptr<Gltf> &gltf,
+                                  const std::shared_ptr<GltfOpenGLContext> &context) {
+  if (!gltf || !context) {
+    return;
+  }
+
+  // 图元 initGl 可能追加访问器（如 unweld）, 因此缓冲上传放在 initGl 之后,
+  // 执行时再读取图元的属性列表
+  for (const auto &mesh: gltf->getMeshes()) {
+    if (!mesh) {
+      continue;
+    }
+    for (const auto &primitive: mesh->getPrimitives()) {
+      if (!primitive) {
+        continue;
+      }
+      push([gltf, context, primitive]() {
+        primitive->initGl(gltf, context);
+      });
+      push([gltf, context, primitive]() {
+        const auto &accessors = gltf->getAccessors();
+        auto indices = primitive->getIndices();
+        if (indices.has_value() && indices.value() >= 0
+            && indices.value() < static_cast<int>(accessors.size())) {
+          context->uploadAccessor(gltf, accessors[indices.value()],
+                                  GL_ELEMENT_ARRAY_BUFFER);
+        }
+        const auto &layout = primitive->getVertexLayout();
+        if (layout) {
+          context->uploadVertexLayout(*layout);
+        }
+        for (const auto &attribute: primitive->getGLAttributes()) {
+          if (layout && layout->find(attribute.semantic)) {
+            continue;
+          }
+          if (attribute.accessor >= 0
+              && attribute.accessor < static_cast<int>(accessors.size())) {
+            context->uploadAccessor(gltf, accessors[attribute.accessor],
+                                    GL_ARRAY_BUFFER);
+          }
+        }
+      });
+    }
+  }
+
+  for (const auto &skin: gltf->getSkins()) {
+    if (skin) {
+      push([gltf, context, skin]() { skin->initGl(gltf, context); });
+    }
+  }
+
+  // 每个纹理只上传一次（多个材质可能共用）
+  std::set<int> queuedTextures;
+  for (const auto &material: gltf->getMaterials()) {
+    if (!material) {
+      continue;
+    }
+    for (const auto &textureInfo: material->getTextures()) {
+      if (!textureInfo || !textureInfo->getIndex().has_value()
+          || !queuedTextures.insert(textureInfo->getIndex().value()).second) {
+        continue;
+      }
+      push([gltf, context, textureInfo]() {
+        context->prepareTexture(gltf, textureInfo);
+      });
+    }
+  }
+}
+
+bool GltfUploadQueue::process(double budgetMs) {
+  auto start = std::chrono::steady_clock::now();
+  while (!tasks.empty()) {
+    Task task = std::move(tasks.front());
+    tasks.pop_front();
+    try {
+      task();
+    } catch (const std::exception &e) {
+      LOGE("Upload task failed: %s", e.what());
+    }
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    if (elapsedMs >= budgetMs) {
+      break;
+    }
+  }
+  return tasks.empty();
+}
+
+float GltfUploadQueue::getProgress() const {
+  if (totalCount == 0) {
+    return 1.0f;
+  }
+  return static_cast<float>(totalCount - tasks.size()) /
+      static_cast<float>(totalCount);
+}
+
+} // namespace digitalhumans
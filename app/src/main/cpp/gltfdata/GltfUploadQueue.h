@@ -0,0 +1,69 @@
+//
+// Created by vincentsyan on 2025/9/26.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFUPLOADQUEUE_H
+#define LIGHTDIGITALHUMAN_GLTFUPLOADQUEUE_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+
+namespace digitalhumans {
+
+class Gltf;
+
+class GltfOpenGLContext;
+
+/**
+ * @brief 分帧执行的 GPU 上传队列
+ *
+ * 异步加载时转换在工作线程完成（不调用 GL）, 剩余的 GL 工作
+ * （图元/蒙皮 initGl、顶点与索引缓冲、纹理）拆分成小任务放入队列,
+ * 由渲染线程每帧在时间预算内执行一部分, 避免单帧长时间卡顿。
+ * 只能在持有 GL 上下文的渲染线程中调用 process()。
+ */
+class GltfUploadQueue {
+ public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief 添加任务
+   */
+  void push(Task task);
+
+  /**
+   * @brief 为延迟初始化的 Gltf 生成全部上传任务
+   * @param gltf 以 deferGlInit 方式转换得到的模型
+   * @param context OpenGL 上下文封装
+   */
+  void enqueueGltf(const std::shared_ptr<Gltf> &gltf,
+                   const std::shared_ptr<GltfOpenGLContext> &context);
+
+  /**
+   * @brief 在时间预算内执行任务, 每次至少执行一个任务以保证进度
+   * @param budgetMs 本帧可用时间（毫秒）
+   * @return 队列是否已清空
+   */
+  bool process(double budgetMs);
+
+  bool empty() const { return tasks.empty(); }
+
+  size_t getPendingCount() const { return tasks.size(); }
+
+  size_t getTotalCount() const { return totalCount; }
+
+  /**
+   * @brief 已完成任务比例 [0, 1]
+   */
+  float getProgress() const;
+
+ private:
+  std::deque<Task> tasks;
+  size_t totalCount = 0;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFUPLOADQUEUE_H
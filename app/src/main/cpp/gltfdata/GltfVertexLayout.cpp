@@ -0,0 +1,468 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#include "GltfVertexLayout.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "gtc/packing.hpp"
+#include "Gltf.h"
+#include "GltfAccessor.h"
+#include "GltfBufferArena.h"
+#include "../utils/ComponentConvert.h"
+#include "../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr float kPositionTolerance = 1.0f / 16384.0f;  ///< 相对包围盒对角线
+constexpr float kDirectionTolerance = 1.0f / 250.0f;
+constexpr float kTexcoordTolerance = 1.0f / 8192.0f;
+constexpr float kColorTolerance = 1.0f / 500.0f;
+constexpr float kWeightTolerance = 1.0f / 4096.0f;
+constexpr float kUnrepresentable = std::numeric_limits<float>::infinity();
+
+/**
+ * @brief 属性语义: 按偏好排序的候选格式与误差上限
+ */
+struct Semantic {
+  std::vector<VertexFormat> candidates;
+  float tolerance = 0.0f;
+};
+
+bool startsWith(const std::string &value, const char *prefix) {
+  return value.compare(0, std::strlen(prefix), prefix) == 0;
+}
+
+/**
+ * @return 不打包的属性返回 false
+ */
+bool findSemantic(const std::string &attribute, int componentCount,
+                  Semantic &semantic) {
+  if (attribute == "POSITION" && componentCount == 3) {
+    semantic = {{VertexFormat::QUANTIZED16, VertexFormat::HALF,
+                 VertexFormat::FLOAT}, kPositionTolerance};
+  } else if (attribute == "NORMAL" && componentCount == 3) {
+    semantic = {{VertexFormat::OCTAHEDRAL16, VertexFormat::SNORM8,
+                 VertexFormat::SNORM16, VertexFormat::FLOAT},
+                kDirectionTolerance};
+  } else if (attribute == "TANGENT") {
+    semantic = {{VertexFormat::SNORM8, VertexFormat::SNORM16,
+                 VertexFormat::FLOAT}, kDirectionTolerance};
+  } else if (startsWith(attribute, "TEXCOORD_")) {
+    semantic = {{VertexFormat::UNORM16, VertexFormat::HALF,
+                 VertexFormat::FLOAT}, kTexcoordTolerance};
+  } else if (startsWith(attribute, "COLOR_")) {
+    semantic = {{VertexFormat::UNORM8, VertexFormat::UNORM16,
+                 VertexFormat::FLOAT}, kColorTolerance};
+  } else if (startsWith(attribute, "JOINTS_")) {
+    semantic = {{VertexFormat::UINT8, VertexFormat::UINT16,
+                 VertexFormat::FLOAT}, 0.0f};
+  } else if (startsWith(attribute, "WEIGHTS_")) {
+    semantic = {{VertexFormat::UNORM8, VertexFormat::UNORM16,
+                 VertexFormat::FLOAT}, kWeightTolerance};
+  } else {
+    return false;
+  }
+  return true;
+}
+
+size_t componentBytes(VertexFormat format) {
+  switch (format) {
+    case VertexFormat::SNORM8:
+    case VertexFormat::UNORM8:
+    case VertexFormat::UINT8:
+      return 1;
+    case VertexFormat::FLOAT:
+      return 4;
+    default:
+      return 2;
+  }
+}
+
+GLenum glComponentType(VertexFormat format) {
+  switch (format) {
+    case VertexFormat::HALF:
+      return GL_HALF_FLOAT;
+    case VertexFormat::SNORM8:
+      return GL_BYTE;
+    case VertexFormat::SNORM16:
+    case VertexFormat::OCTAHEDRAL16:
+    case VertexFormat::QUANTIZED16:
+      return GL_SHORT;
+    case VertexFormat::UNORM8:
+    case VertexFormat::UINT8:
+      return GL_UNSIGNED_BYTE;
+    case VertexFormat::UNORM16:
+    case VertexFormat::UINT16:
+      return GL_UNSIGNED_SHORT;
+    default:
+      return GL_FLOAT;
+  }
+}
+
+bool isNormalizedFormat(VertexFormat format) {
+  return format != VertexFormat::FLOAT && format != VertexFormat::HALF &&
+      format != VertexFormat::UINT8 && format != VertexFormat::UINT16;
+}
+
+int storedComponents(VertexFormat format, int componentCount) {
+  return format == VertexFormat::OCTAHEDRAL16 ? 2 : componentCount;
+}
+
+/**
+ * @brief 每个顶点占用的字节数, 补齐到 4 字节
+ */
+size_t storedBytes(VertexFormat format, int componentCount) {
+  const size_t bytes = componentBytes(format) *
+      storedComponents(format, componentCount);
+  return (bytes + 3) & ~static_cast<size_t>(3);
+}
+
+// 以下编解码与 OpenGL ES 3.0 的定点数转换规则一致
+template<typename T>
+T toSnorm(float value) {
+  constexpr float kMax = std::numeric_limits<T>::max();
+  return static_cast<T>(std::lround(std::clamp(value, -1.0f, 1.0f) * kMax));
+}
+
+template<typename T>
+float fromSnorm(T value) {
+  constexpr float kMax = std::numeric_limits<T>::max();
+  return std::max(static_cast<float>(value) / kMax, -1.0f);
+}
+
+template<typename T>
+T toUnorm(float value) {
+  constexpr float kMax = std::numeric_limits<T>::max();
+  return static_cast<T>(std::lround(std::clamp(value, 0.0f, 1.0f) * kMax));
+}
+
+template<typename T>
+float fromUnorm(T value) {
+  return static_cast<float>(value) / std::numeric_limits<T>::max();
+}
+
+float signNotZero(float value) {
+  return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+glm::vec2 octEncode(const glm::vec3 &n) {
+  const float sum = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+  glm::vec3 v = n / sum;
+  if (v.z < 0.0f) {
+    return {(1.0f - std::fabs(v.y)) * signNotZero(v.x),
+            (1.0f - std::fabs(v.x)) * signNotZero(v.y)};
+  }
+  return {v.x, v.y};
+}
+
+/**
+ * @brief 与 primitive.vert 中的 octDecode 相同
+ */
+glm::vec3 octDecode(const glm::vec2 &e) {
+  glm::vec3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+  const float t = std::max(-n.z, 0.0f);
+  n.x += n.x >= 0.0f ? -t : t;
+  n.y += n.y >= 0.0f ? -t : t;
+  const float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+  return length > 0.0f ? n / length : n;
+}
+
+template<typename T>
+void storeValue(uint8_t *dst, T value) {
+  std::memcpy(dst, &value, sizeof(T));
+}
+
+/**
+ * @brief 编码单个分量并返回还原后的值
+ */
+float encodeComponent(VertexFormat format, float value, uint8_t *dst) {
+  switch (format) {
+    case VertexFormat::HALF: {
+      const uint16_t half = glm::packHalf1x16(value);
+      storeValue(dst, half);
+      return glm::unpackHalf1x16(half);
+    }
+    case VertexFormat::SNORM8: {
+      const auto q = toSnorm<int8_t>(value);
+      storeValue(dst, q);
+      return fromSnorm(q);
+    }
+    case VertexFormat::SNORM16: {
+      const auto q = toSnorm<int16_t>(value);
+      storeValue(dst, q);
+      return fromSnorm(q);
+    }
+    case VertexFormat::UNORM8: {
+      const auto q = toUnorm<uint8_t>(value);
+      storeValue(dst, q);
+      return fromUnorm(q);
+    }
+    case VertexFormat::UNORM16: {
+      const auto q = toUnorm<uint16_t>(value);
+      storeValue(dst, q);
+      return fromUnorm(q);
+    }
+    case VertexFormat::UINT8:
+    case VertexFormat::UINT16: {
+      const float limit = format == VertexFormat::UINT8 ? 255.0f : 65535.0f;
+      if (!(value >= 0.0f && value <= limit)) {
+        return kUnrepresentable;
+      }
+      const auto q = static_cast<uint16_t>(std::lround(value));
+      if (format == VertexFormat::UINT8) {
+        storeValue(dst, static_cast<uint8_t>(q));
+      } else {
+        storeValue(dst, q);
+      }
+      return static_cast<float>(q);
+    }
+    default:
+      storeValue(dst, value);
+      return value;
+  }
+}
+
+/**
+ * @brief 以 format 编码 count 个元素, 每个元素占 elementBytes 字节
+ * @param quantization POSITION 的包围盒（QUANTIZED16 使用）
+ * @return 最大分量误差, 超过 tolerance 时提前返回
+ */
+float encodeElements(VertexFormat format, const float *src, size_t count,
+                     int componentCount, const glm::vec3 *quantization,
+                     float tolerance, uint8_t *dst, size_t elementBytes) {
+  float maxError = 0.0f;
+  const size_t componentSize = componentBytes(format);
+  for (size_t i = 0; i < count; ++i) {
+    const float *value = src + i * componentCount;
+    uint8_t *element = dst + i * elementBytes;
+
+    if (format == VertexFormat::OCTAHEDRAL16) {
+      const glm::vec3 n(value[0], value[1], value[2]);
+      const glm::vec2 e = octEncode(n);
+      const glm::vec2 q(fromSnorm(toSnorm<int16_t>(e.x)),
+                        fromSnorm(toSnorm<int16_t>(e.y)));
+      storeValue(element, toSnorm<int16_t>(e.x));
+      storeValue(element + 2, toSnorm<int16_t>(e.y));
+      const glm::vec3 decoded = octDecode(q);
+      for (int c = 0; c < 3; ++c) {
+        maxError = std::max(maxError, std::fabs(decoded[c] - value[c]));
+      }
+    } else if (format == VertexFormat::QUANTIZED16) {
+      const glm::vec3 &scale = quantization[0];
+      const glm::vec3 &offset = quantization[1];
+      for (int c = 0; c < componentCount; ++c) {
+        const auto q = toSnorm<int16_t>((value[c] - offset[c]) / scale[c]);
+        storeValue(element + c * componentSize, q);
+        const float decoded = fromSnorm(q) * scale[c] + offset[c];
+        maxError = std::max(maxError, std::fabs(decoded - value[c]));
+      }
+    } else {
+      for (int c = 0; c < componentCount; ++c) {
+        const float decoded =
+            encodeComponent(format, value[c], element + c * componentSize);
+        maxError = std::max(maxError, std::fabs(decoded - value[c]));
+      }
+    }
+    // NaN 也视为超限
+    if (!(maxError <= tolerance)) {
+      return kUnrepresentable;
+    }
+  }
+  return maxError;
+}
+
+/**
+ * @brief 读取访问器数据并转换为 float
+ */
+bool readFloats(const Gltf &gltf, GltfAccessor &accessor,
+                std::vector<float> &values) {
+  const GltfAccessorView view = accessor.getView(gltf);
+  if (view.empty()) {
+    return false;
+  }
+  const size_t componentCount = view.count * view.componentCount;
+  values.resize(componentCount);
+  if (view.isTightlyPacked()) {
+    return component::toFloat(view.data, view.componentType, view.normalized,
+                              values.data(), componentCount);
+  }
+  std::vector<uint8_t> packed(view.count * view.elementSize());
+  component::gatherElements(view.data, view.byteStride, view.elementSize(),
+                            packed.data(), view.count);
+  return component::toFloat(packed.data(), view.componentType,
+                            view.normalized, values.data(), componentCount);
+}
+
+} // namespace
+
+GltfVertexLayout::GltfVertexLayout() {
+  slots.fill(-1);
+}
+
+GltfVertexLayout::~GltfVertexLayout() = default;
+
+void GltfVertexLayout::setGLAllocation(std::unique_ptr<GltfBufferAllocation> allocation) {
+  glAllocation = std::move(allocation);
+}
+
+std::shared_ptr<GltfVertexLayout>
+GltfVertexLayout::build(const Gltf &gltf,
+                        const std::map<std::string, int> &attributes) {
+  const auto &accessors = gltf.getAccessors();
+  auto findAccessor = [&](int index) -> GltfAccessor * {
+    return index >= 0 && index < static_cast<int>(accessors.size())
+           ? accessors[index].get() : nullptr;
+  };
+
+  // 顶点数以 POSITION 为准, 数量不一致的属性不打包
+  size_t vertexCount = 0;
+  auto position = attributes.find("POSITION");
+  if (position != attributes.end()) {
+    if (auto *accessor = findAccessor(position->second)) {
+      vertexCount = static_cast<size_t>(accessor->getCount().value_or(0));
+    }
+  }
+
+  auto layout = std::make_shared<GltfVertexLayout>();
+  std::vector<std::vector<uint8_t>> encoded;
+  std::vector<size_t> elementBytes;
+  std::vector<float> values;
+  for (const auto &[name, index]: attributes) {
+    GltfAccessor *accessor = findAccessor(index);
+    Semantic semantic;
+    if (!accessor || !findSemantic(name, accessor->getComponentCount(),
+                                   semantic)) {
+      continue;
+    }
+    const auto count = static_cast<size_t>(accessor->getCount().value_or(0));
+    if (count == 0 || (vertexCount != 0 && count != vertexCount)) {
+      continue;
+    }
+    if (!readFloats(gltf, *accessor, values)) {
+      LOGW("Attribute %s is not readable, not packed", name.c_str());
+      continue;
+    }
+    vertexCount = count;
+    const int componentCount = accessor->getComponentCount();
+
+    float tolerance = semantic.tolerance;
+    glm::vec3 quantization[2] = {glm::vec3(1.0f), glm::vec3(0.0f)};
+    if (name == "POSITION") {
+      glm::vec3 minValue(std::numeric_limits<float>::max());
+      glm::vec3 maxValue(std::numeric_limits<float>::lowest());
+      for (size_t i = 0; i < count; ++i) {
+        const glm::vec3 p(values[i * 3], values[i * 3 + 1], values[i * 3 + 2]);
+        minValue = glm::min(minValue, p);
+        maxValue = glm::max(maxValue, p);
+      }
+      const glm::vec3 extent = maxValue - minValue;
+      tolerance *= std::sqrt(extent.x * extent.x + extent.y * extent.y +
+          extent.z * extent.z);
+      for (int c = 0; c < 3; ++c) {
+        quantization[0][c] = extent[c] > 0.0f ? extent[c] * 0.5f : 1.0f;
+        quantization[1][c] = (minValue[c] + maxValue[c]) * 0.5f;
+      }
+    }
+
+    GltfPackedAttribute packed;
+    packed.attribute = name;
+    packed.semantic = vertex_semantic::fromName(name);
+    std::vector<uint8_t> data;
+    for (VertexFormat format: semantic.candidates) {
+      const size_t bytes = storedBytes(format, componentCount);
+      data.assign(count * bytes, 0);
+      // float 总是可用, 作为最后的候选
+      const bool lossless = format == VertexFormat::FLOAT;
+      const float error = encodeElements(
+          format, values.data(), count, componentCount, quantization,
+          lossless ? kUnrepresentable : tolerance, data.data(), bytes);
+      if (lossless || error <= tolerance) {
+        packed.format = format;
+        packed.maxError = format == VertexFormat::FLOAT ? 0.0f : error;
+        break;
+      }
+    }
+    packed.componentType = glComponentType(packed.format);
+    packed.componentCount = storedComponents(packed.format, componentCount);
+    packed.normalized = isNormalizedFormat(packed.format);
+    packed.offset = layout->stride;
+
+    if (packed.format == VertexFormat::QUANTIZED16) {
+      layout->quantizedPosition = true;
+      layout->positionScale = quantization[0];
+      layout->positionOffset = quantization[1];
+    } else if (packed.format == VertexFormat::OCTAHEDRAL16) {
+      layout->octahedralNormal = true;
+    }
+
+    const size_t bytes = storedBytes(packed.format, componentCount);
+    layout->stride += static_cast<uint32_t>(bytes);
+    layout->sourceBytes += count * accessor->getElementSize();
+    if (packed.semantic != VertexSemantic::COUNT) {
+      layout->slots[static_cast<size_t>(packed.semantic)] =
+          static_cast<int8_t>(layout->attributes.size());
+    }
+    layout->attributes.push_back(std::move(packed));
+    encoded.push_back(std::move(data));
+    elementBytes.push_back(bytes);
+  }
+
+  if (layout->attributes.empty()) {
+    return nullptr;
+  }
+
+  layout->vertexCount = vertexCount;
+  layout->vertices.resize(vertexCount * layout->stride);
+  for (size_t a = 0; a < layout->attributes.size(); ++a) {
+    uint8_t *dst = layout->vertices.data() + layout->attributes[a].offset;
+    const uint8_t *src = encoded[a].data();
+    const size_t bytes = elementBytes[a];
+    for (size_t i = 0; i < vertexCount; ++i) {
+      std::memcpy(dst + i * layout->stride, src + i * bytes, bytes);
+    }
+  }
+  return layout;
+}
+
+const GltfPackedAttribute *
+GltfVertexLayout::find(const std::string &attribute) const {
+  for (const auto &packed: attributes) {
+    if (packed.attribute == attribute) {
+      return &packed;
+    }
+  }
+  return nullptr;
+}
+
+const char *GltfVertexLayout::toString(VertexFormat format) {
+  switch (format) {
+    case VertexFormat::FLOAT:
+      return "float";
+    case VertexFormat::HALF:
+      return "half";
+    case VertexFormat::SNORM8:
+      return "snorm8";
+    case VertexFormat::SNORM16:
+      return "snorm16";
+    case VertexFormat::UNORM8:
+      return "unorm8";
+    case VertexFormat::UNORM16:
+      return "unorm16";
+    case VertexFormat::UINT8:
+      return "uint8";
+    case VertexFormat::UINT16:
+      return "uint16";
+    case VertexFormat::OCTAHEDRAL16:
+      return "oct16";
+    case VertexFormat::QUANTIZED16:
+      return "quantized16";
+  }
+  return "unknown";
+}
+
+} // namespace digitalhumans
@@ -0,0 +1,156 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFVERTEXLAYOUT_H
+#define LIGHTDIGITALHUMAN_GLTFVERTEXLAYOUT_H
+
+#include <GLES3/gl3.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "vec3.hpp"
+#include "VertexSemantic.h"
+
+namespace digitalhumans {
+
+class Gltf;
+
+class GltfBufferAllocation;
+
+/**
+ * @brief 顶点属性在交错缓冲中的存储格式
+ */
+enum class VertexFormat {
+  FLOAT,        ///< 32 位浮点
+  HALF,         ///< 16 位浮点
+  SNORM8,       ///< 有符号标准化 8 位
+  SNORM16,      ///< 有符号标准化 16 位
+  UNORM8,       ///< 无符号标准化 8 位
+  UNORM16,      ///< 无符号标准化 16 位
+  UINT8,        ///< 无符号整数 8 位（按数值转换为 float）
+  UINT16,       ///< 无符号整数 16 位（按数值转换为 float）
+  OCTAHEDRAL16, ///< 八面体映射的单位向量, 2 个 snorm16, 着色器中解码
+  QUANTIZED16   ///< 按包围盒量化的 snorm16, 着色器中用 u_PositionScale/u_PositionOffset 还原
+};
+
+/**
+ * @brief 交错顶点缓冲中的一个属性
+ */
+struct GltfPackedAttribute {
+  std::string attribute;           ///< 属性名称 (如 "POSITION")
+  VertexSemantic semantic = VertexSemantic::COUNT; ///< 渲染器不支持的属性为 COUNT
+  VertexFormat format = VertexFormat::FLOAT;
+  GLenum componentType = GL_FLOAT; ///< glVertexAttribPointer 的组件类型
+  int componentCount = 0;          ///< glVertexAttribPointer 的分量数
+  bool normalized = false;
+  uint32_t offset = 0;             ///< 顶点内的字节偏移
+  float maxError = 0.0f;           ///< 相对源数据的最大分量误差
+};
+
+/**
+ * @brief 图元静态顶点属性的交错、压缩布局
+ *
+ * 加载时（工作线程）把图元的各属性按误差上限选出最紧凑的格式,
+ * 写入同一个交错缓冲, 渲染时只绑定一个 GL 缓冲。每个属性按偏好顺序尝试候选格式,
+ * 编码后逐分量还原并与源数据比较, 最大误差不超过该语义的上限才采用:
+ *   POSITION   包围盒量化 snorm16 / half, 误差上限为包围盒对角线的 1/16384
+ *   NORMAL     八面体 snorm16 / snorm8, 单位向量每分量误差上限 1/250
+ *   TANGENT    snorm8 / snorm16, 同 NORMAL
+ *   TEXCOORD_n unorm16 / half, 上限 1/8192（4096 纹理的半个纹素）
+ *   COLOR_n    unorm8 / unorm16, 上限 1/500
+ *   JOINTS_n   uint8 / uint16, 必须无损
+ *   WEIGHTS_n  unorm8 / unorm16, 上限 1/4096
+ * 都不满足时保留 float。其余属性不打包, 仍按访问器单独上传。
+ */
+class GltfVertexLayout {
+ public:
+  GltfVertexLayout();
+
+  ~GltfVertexLayout();
+
+  GltfVertexLayout(const GltfVertexLayout &) = delete;
+
+  GltfVertexLayout &operator=(const GltfVertexLayout &) = delete;
+
+  /**
+   * @brief 为一组属性生成交错布局（不调用 GL）
+   * @param attributes 属性名称 -> 访问器索引
+   * @return 没有可打包的属性时返回 nullptr
+   */
+  static std::shared_ptr<GltfVertexLayout>
+  build(const Gltf &gltf, const std::map<std::string, int> &attributes);
+
+  /**
+   * @brief 查找已打包的属性, 未打包时返回 nullptr
+   */
+  const GltfPackedAttribute *find(const std::string &attribute) const;
+
+  /**
+   * @brief 按语义查找已打包的属性（查表）, 未打包时返回 nullptr
+   */
+  const GltfPackedAttribute *find(VertexSemantic semantic) const {
+    const auto index = static_cast<size_t>(semantic);
+    return index < kVertexSemanticCount && slots[index] >= 0
+           ? &attributes[slots[index]] : nullptr;
+  }
+
+  const std::vector<GltfPackedAttribute> &getAttributes() const {
+    return attributes;
+  }
+
+  uint32_t getStride() const { return stride; }
+
+  size_t getVertexCount() const { return vertexCount; }
+
+  /**
+   * @brief 交错顶点数据, 上传后释放
+   */
+  const std::vector<uint8_t> &getVertices() const { return vertices; }
+
+  void releaseVertices() { std::vector<uint8_t>().swap(vertices); }
+
+  size_t getPackedBytes() const { return vertexCount * stride; }
+
+  /**
+   * @brief 打包前各属性按访问器类型单独上传的字节数
+   */
+  size_t getSourceBytes() const { return sourceBytes; }
+
+  bool hasQuantizedPosition() const { return quantizedPosition; }
+
+  const glm::vec3 &getPositionScale() const { return positionScale; }
+
+  const glm::vec3 &getPositionOffset() const { return positionOffset; }
+
+  bool hasOctahedralNormal() const { return octahedralNormal; }
+
+  const GltfBufferAllocation *getGLAllocation() const {
+    return glAllocation.get();
+  }
+
+  void setGLAllocation(std::unique_ptr<GltfBufferAllocation> allocation);
+
+  static const char *toString(VertexFormat format);
+
+ private:
+  std::vector<GltfPackedAttribute> attributes;
+  std::array<int8_t, kVertexSemanticCount> slots;  ///< 语义 -> attributes 下标, 未打包为 -1
+  std::vector<uint8_t> vertices;
+  uint32_t stride = 0;
+  size_t vertexCount = 0;
+  size_t sourceBytes = 0;
+  bool quantizedPosition = false;
+  glm::vec3 positionScale{1.0f};
+  glm::vec3 positionOffset{0.0f};
+  bool octahedralNormal = false;
+  std::unique_ptr<GltfBufferAllocation> glAllocation;  ///< 缓冲区域中的分配
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFVERTEXLAYOUT_H
@@ -0,0 +1,128 @@
+//
+// Created by vincentsyan on 2025/9/23.
+//
+
+#include "RenderPassProfiler.h"
+#include <cstring>
+#include <EGL/egl.h>
+#include <GLES2/gl2ext.h>
+#include "../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+namespace {
+PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64vEXTPtr = nullptr;
+}
+
+RenderPassProfiler::~RenderPassProfiler() {
+  if (!queryPool.empty()) {
+    glDeleteQueries(static_cast<GLsizei>(queryPool.size()), queryPool.data());
+  }
+  for (const auto &pending: pendingQueries) {
+    glDeleteQueries(1, &pending.query);
+  }
+}
+
+void RenderPassProfiler::initGpuTimer() {
+  initialized = true;
+  GLint extensionCount = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+  for (GLint i = 0; i < extensionCount; ++i) {
+    const char *name =
+        reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+    if (name && std::strcmp(name, "GL_EXT_disjoint_timer_query") == 0) {
+      glGetQueryObjectui64vEXTPtr =
+          reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(
+              eglGetProcAddress("glGetQueryObjectui64vEXT"));
+      gpuTimerSupported = glGetQueryObjectui64vEXTPtr != nullptr;
+      break;
+    }
+  }
+  if (!gpuTimerSupported) {
+    LOGW("GL_EXT_disjoint_timer_query not available, GPU pass timings disabled");
+  }
+}
+
+GLuint RenderPassProfiler::acquireQuery() {
+  if (queryPool.empty()) {
+    GLuint query = 0;
+    glGenQueries(1, &query);
+    return query;
+  }
+  GLuint query = queryPool.back();
+  queryPool.pop_back();
+  return query;
+}
+
+void RenderPassProfiler::beginFrame() {
+  if (!initialized) {
+    initGpuTimer();
+  }
+  currentFrame = RenderPassTimings();
+  if (gpuTimerSupported) {
+    // 清除上一帧可能残留的 disjoint 标志
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+  }
+}
+
+void RenderPassProfiler::beginPass(RenderPass pass) {
+  if (inPass) {
+    LOGW("Nested render pass %s ignored", getPassName(pass));
+    return;
+  }
+  inPass = true;
+  if (gpuTimerSupported) {
+    GLuint query = acquireQuery();
+    glBeginQuery(GL_TIME_ELAPSED_EXT, query);
+    pendingQueries.push_back({query, pass});
+  }
+  passStart = std::chrono::steady_clock::now();
+}
+
+void RenderPassProfiler::endPass(RenderPass pass) {
+  if (!inPass) {
+    return;
+  }
+  inPass = false;
+  auto elapsed = std::chrono::steady_clock::now() - passStart;
+  currentFrame.cpuMs[static_cast<size_t>(pass)] +=
+      std::chrono::duration<double, std::milli>(elapsed).count();
+  if (gpuTimerSupported) {
+    glEndQuery(GL_TIME_ELAPSED_EXT);
+  }
+}
+
+void RenderPassProfiler::endFrame() {
+  if (gpuTimerSupported && !pendingQueries.empty()) {
+    for (const auto &pending: pendingQueries) {
+      GLuint64 elapsedNs = 0;
+      glGetQueryObjectui64vEXTPtr(pending.query, GL_QUERY_RESULT, &elapsedNs);
+      currentFrame.gpuMs[static_cast<size_t>(pending.pass)] +=
+          static_cast<double>(elapsedNs) / 1.0e6;
+      queryPool.push_back(pending.query);
+    }
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+    currentFrame.gpuValid = disjoint == 0;
+  }
+  pendingQueries.clear();
+  lastFrame = currentFrame;
+}
+
+const char *RenderPassProfiler::getPassName(RenderPass pass) {
+  switch (pass) {
+    case RenderPass::ENVIRONMENT:
+      return "environment";
+    case RenderPass::OPAQUE:
+      return "opaque";
+    case RenderPass::TRANSMISSION:
+      return "transmission";
+    case RenderPass::TRANSPARENT:
+      return "transparent";
+    default:
+      return "unknown";
+  }
+}
+
+} // namespace digitalhumans
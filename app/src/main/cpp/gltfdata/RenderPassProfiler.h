@@ -0,0 +1,131 @@
+//
+// Created by vincentsyan on 2025/9/23.
+//
+
+#ifndef LIGHTDIGITALHUMAN_RENDERPASSPROFILER_H
+#define LIGHTDIGITALHUMAN_RENDERPASSPROFILER_H
+
+#include <array>
+#include <chrono>
+#include <vector>
+#include <GLES3/gl3.h>
+
+namespace digitalhumans {
+
+/**
+ * @brief 渲染通道分类
+ */
+enum class RenderPass {
+  ENVIRONMENT = 0,  ///< 环境贴图（天空盒）
+  OPAQUE,           ///< 不透明物体
+  TRANSMISSION,     ///< 透射背景 + 透射物体
+  TRANSPARENT,      ///< 透明物体
+  COUNT
+};
+
+/**
+ * @brief 单帧各渲染通道耗时（毫秒）
+ */
+struct RenderPassTimings {
+  static constexpr size_t kPassCount = static_cast<size_t>(RenderPass::COUNT);
+
+  std::array<double, kPassCount> cpuMs{};  ///< CPU 提交耗时
+  std::array<double, kPassCount> gpuMs{};  ///< GPU 执行耗时（timer query）
+  bool gpuValid = false;                   ///< GPU 耗时是否有效
+
+  double cpu(RenderPass pass) const { return cpuMs[static_cast<size_t>(pass)]; }
+
+  double gpu(RenderPass pass) const { return gpuMs[static_cast<size_t>(pass)]; }
+};
+
+/**
+ * @brief 渲染通道耗时统计
+ *
+ * CPU 耗时由 steady_clock 统计; GPU 耗时使用 GL_EXT_disjoint_timer_query,
+ * 扩展不可用时只统计 CPU。同一通道在一帧内可多次进入, 耗时累加。
+ * 需在有效 GL 上下文中调用, endFrame() 会阻塞等待查询结果,
+ * 仅用于测试和性能分析, 渲染器未设置 profiler 时没有任何开销。
+ */
+class RenderPassProfiler {
+ public:
+  RenderPassProfiler() = default;
+
+  ~RenderPassProfiler();
+
+  RenderPassProfiler(const RenderPassProfiler &) = delete;
+
+  RenderPassProfiler &operator=(const RenderPassProfiler &) = delete;
+
+  /**
+   * @brief 开始一帧统计
+   */
+  void beginFrame();
+
+  /**
+   * @brief 结束一帧统计并读取 GPU 查询结果
+   */
+  void endFrame();
+
+  void beginPass(RenderPass pass);
+
+  void endPass(RenderPass pass);
+
+  /**
+   * @brief 获取最近一帧的耗时
+   */
+  const RenderPassTimings &getLastFrame() const { return lastFrame; }
+
+  bool isGpuTimerSupported() const { return gpuTimerSupported; }
+
+  static const char *getPassName(RenderPass pass);
+
+  /**
+   * @brief 通道作用域, profiler 为空时不做任何事
+   */
+  class Scope {
+   public:
+    Scope(RenderPassProfiler *profiler, RenderPass pass)
+        : profiler(profiler), pass(pass) {
+      if (profiler) {
+        profiler->beginPass(pass);
+      }
+    }
+
+    ~Scope() {
+      if (profiler) {
+        profiler->endPass(pass);
+      }
+    }
+
+    Scope(const Scope &) = delete;
+
+    Scope &operator=(const Scope &) = delete;
+
+   private:
+    RenderPassProfiler *profiler;
+    RenderPass pass;
+  };
+
+ private:
+  struct PendingQuery {
+    GLuint query;
+    RenderPass pass;
+  };
+
+  void initGpuTimer();
+
+  GLuint acquireQuery();
+
+  bool initialized = false;
+  bool gpuTimerSupported = false;
+  bool inPass = false;
+  std::chrono::steady_clock::time_point passStart;
+  std::vector<GLuint> queryPool;
+  std::vector<PendingQuery> pendingQueries;
+  RenderPassTimings currentFrame;
+  RenderPassTimings lastFrame;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_RENDERPASSPROFILER_H
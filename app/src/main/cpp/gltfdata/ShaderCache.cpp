@@ -4,7 +4,6 @@
 
 #include "ShaderCache.h"
 
-#include <android/log.h>
 #include <algorithm>
 #include <sstream>
 #include <regex>
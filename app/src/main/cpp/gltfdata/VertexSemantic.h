@@ -0,0 +1,76 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_VERTEXSEMANTIC_H
+#define LIGHTDIGITALHUMAN_VERTEXSEMANTIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace digitalhumans {
+
+/**
+ * @brief 渲染器支持的顶点属性语义
+ *
+ * 加载时由属性名称解析一次, 绘制时着色器属性位置与交错布局中的属性
+ * 都按语义下标查表, 不再比较字符串。
+ */
+enum class VertexSemantic : uint8_t {
+  POSITION,
+  NORMAL,
+  TANGENT,
+  TEXCOORD_0,
+  TEXCOORD_1,
+  COLOR_0,
+  JOINTS_0,
+  JOINTS_1,
+  WEIGHTS_0,
+  WEIGHTS_1,
+  COUNT  ///< 语义数量, 也表示未知属性
+};
+
+constexpr size_t kVertexSemanticCount = static_cast<size_t>(VertexSemantic::COUNT);
+
+namespace vertex_semantic {
+
+struct Entry {
+  const char *attribute;  ///< glTF 属性名称
+  const char *shaderName; ///< 着色器中的属性名称
+};
+
+constexpr Entry kEntries[kVertexSemanticCount] = {
+    {"POSITION", "a_position"},
+    {"NORMAL", "a_normal"},
+    {"TANGENT", "a_tangent"},
+    {"TEXCOORD_0", "a_texcoord_0"},
+    {"TEXCOORD_1", "a_texcoord_1"},
+    {"COLOR_0", "a_color_0"},
+    {"JOINTS_0", "a_joints_0"},
+    {"JOINTS_1", "a_joints_1"},
+    {"WEIGHTS_0", "a_weights_0"},
+    {"WEIGHTS_1", "a_weights_1"},
+};
+
+/**
+ * @brief 由 glTF 属性名称解析语义, 未知属性返回 VertexSemantic::COUNT
+ */
+inline VertexSemantic fromName(const std::string &attribute) {
+  for (size_t i = 0; i < kVertexSemanticCount; ++i) {
+    if (attribute == kEntries[i].attribute) {
+      return static_cast<VertexSemantic>(i);
+    }
+  }
+  return VertexSemantic::COUNT;
+}
+
+inline const char *shaderName(VertexSemantic semantic) {
+  return kEntries[static_cast<size_t>(semantic)].shaderName;
+}
+
+} // namespace vertex_semantic
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_VERTEXSEMANTIC_H
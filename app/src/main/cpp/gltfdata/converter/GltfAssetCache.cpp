@@ -0,0 +1,96 @@
+//
+// Created by vincentsyan on 2025/9/25.
+//
+
+#include "GltfAssetCache.h"
+#include "../../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+GltfAssetCache::GltfAssetCache(size_t budgetBytes) : budget(budgetBytes) {}
+
+std::shared_ptr<const GltfSharedAsset>
+GltfAssetCache::find(const std::string &key) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = index.find(key);
+  if (it == index.end()) {
+    return nullptr;
+  }
+  entries.splice(entries.begin(), entries, it->second);
+  return it->second->second;
+}
+
+void GltfAssetCache::insert(const std::string &key,
+                            std::shared_ptr<const GltfSharedAsset> asset) {
+  if (!asset) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = index.find(key);
+  if (it != index.end()) {
+    usedBytes -= it->second->second->byteSize;
+    entries.erase(it->second);
+    index.erase(it);
+  }
+  if (asset->byteSize > budget) {
+    LOGW("Asset %s (%zu bytes) exceeds cache budget (%zu bytes), not cached",
+         key.c_str(), asset->byteSize, budget);
+    return;
+  }
+  usedBytes += asset->byteSize;
+  entries.emplace_front(key, std::move(asset));
+  index[key] = entries.begin();
+  evictLocked();
+}
+
+void GltfAssetCache::erase(const std::string &key) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = index.find(key);
+  if (it == index.end()) {
+    return;
+  }
+  usedBytes -= it->second->second->byteSize;
+  entries.erase(it->second);
+  index.erase(it);
+}
+
+void GltfAssetCache::setBudget(size_t budgetBytes) {
+  std::lock_guard<std::mutex> lock(mutex);
+  budget = budgetBytes;
+  evictLocked();
+}
+
+size_t GltfAssetCache::getBudget() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return budget;
+}
+
+size_t GltfAssetCache::getUsedBytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return usedBytes;
+}
+
+size_t GltfAssetCache::getEntryCount() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+void GltfAssetCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  index.clear();
+  usedBytes = 0;
+}
+
+void GltfAssetCache::evictLocked() {
+  while (usedBytes > budget && !entries.empty()) {
+    const auto &victim = entries.back();
+    LOGI("Evicting cached asset %s (%zu bytes)", victim.first.c_str(),
+         victim.second->byteSize);
+    usedBytes -= victim.second->byteSize;
+    index.erase(victim.first);
+    entries.pop_back();
+  }
+}
+
+} // namespace digitalhumans
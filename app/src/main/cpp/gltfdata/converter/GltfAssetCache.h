@@ -0,0 +1,131 @@
+//
+// Created by vincentsyan on 2025/9/25.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFASSETCACHE_H
+#define LIGHTDIGITALHUMAN_GLTFASSETCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "tiny_gltf.h"
+#include "../GltfAnimationClip.h"
+
+namespace digitalhumans {
+
+class GltfAccessor;
+class GltfAnimation;
+class GltfBuffer;
+class GltfPrimitive;
+class ImageData;
+struct GltfMorphTargetTexture;
+
+/**
+ * @brief 源模型引用的外部资源（相对 uri, 如 .bin 与贴图）及其内容哈希
+ */
+struct GltfSourceDependency {
+  std::string uri;
+  uint64_t hash = 0;
+};
+
+/**
+ * @brief 首次转换中 Draco 解码、网格优化、索引打包与动画片段编译的结果
+ *
+ * 在图元 initGl 之前记录, 不含 GL 状态。缓存命中时访问器与图元按此复制,
+ * 动画用 clone 共享编译好的片段, 不再重复这些步骤; 交错顶点布局仍按实例生成。
+ */
+struct GltfConvertedData {
+  std::vector<std::shared_ptr<const GltfAccessor>> accessors;  ///< 处理后的全部访问器（含新增的）
+  /// 按 [mesh] 索引的处理后图元（含索引切分追加的图元）
+  std::vector<std::vector<std::shared_ptr<const GltfPrimitive>>> primitives;
+  bool optimizedMeshes = false;                      ///< 访问器数据是否经过网格优化
+  std::vector<std::shared_ptr<const GltfAnimation>> animations;
+  GltfAnimationCompression compression;              ///< 编译片段时的压缩参数
+  size_t byteSize = 0;                               ///< 访问器解码数据的字节数
+};
+
+/**
+ * @brief 可在多个 Gltf 实例之间共享的只读转换结果
+ *
+ * document 只保留 glTF 结构描述（buffer 数据与图像像素已清空）,
+ * 二进制数据与解码后的像素由 buffers / images 持有, 多次加载同一模型时直接复用。
+ * 带 GL 状态或运行时可变的对象（网格、节点、蒙皮、动画等）仍按实例创建,
+ * 其中访问器、图元与动画片段从 converted 复制, 不再重新处理。
+ */
+struct GltfSharedAsset {
+  std::shared_ptr<const tinygltf::Model> document;   ///< 结构描述
+  std::vector<std::shared_ptr<GltfBuffer>> buffers;  ///< 与 document.buffers 一一对应
+  std::vector<std::shared_ptr<ImageData>> images;    ///< 与 document.images 一一对应, 可为空
+  /// 按 [mesh][primitive] 索引的预组装变形目标纹理, 可为空（烘焙文件提供）
+  std::vector<std::vector<std::shared_ptr<const GltfMorphTargetTexture>>>
+      morphTargets;
+  bool optimizedMeshes = false;                      ///< 访问器数据已经过网格优化（烘焙文件提供）
+  std::shared_ptr<const GltfConvertedData> converted;  ///< 首次转换的处理结果, 可为空
+  size_t byteSize = 0;                               ///< 占用字节数（用于预算统计）
+  /// 转换时源文件与外部资源的内容哈希, 命中缓存时重新计算比较, 不一致则不复用
+  uint64_t sourceHash = 0;
+  std::vector<GltfSourceDependency> dependencies;
+};
+
+/**
+ * @brief 带字节预算的 LRU 转换资源缓存
+ *
+ * 超出预算时淘汰最久未使用的条目。被淘汰的资源若仍被已加载的模型引用,
+ * 会随引用释放, 不会产生额外拷贝。线程安全。
+ */
+class GltfAssetCache {
+ public:
+  static constexpr size_t kDefaultBudgetBytes = 256u * 1024u * 1024u;
+
+  explicit GltfAssetCache(size_t budgetBytes = kDefaultBudgetBytes);
+
+  /**
+   * @brief 查找缓存, 命中时将条目移到最近使用位置
+   * @return 命中返回共享资源, 否则返回 nullptr
+   */
+  std::shared_ptr<const GltfSharedAsset> find(const std::string &key);
+
+  /**
+   * @brief 插入或替换条目, 之后按预算淘汰
+   */
+  void insert(const std::string &key,
+              std::shared_ptr<const GltfSharedAsset> asset);
+
+  /**
+   * @brief 移除条目（如源文件已变化）
+   */
+  void erase(const std::string &key);
+
+  /**
+   * @brief 设置字节预算, 0 表示禁用缓存
+   */
+  void setBudget(size_t budgetBytes);
+
+  size_t getBudget() const;
+
+  size_t getUsedBytes() const;
+
+  size_t getEntryCount() const;
+
+  void clear();
+
+ private:
+  using Entry = std::pair<std::string, std::shared_ptr<const GltfSharedAsset>>;
+
+  void evictLocked();
+
+  mutable std::mutex mutex;
+  size_t budget;
+  size_t usedBytes = 0;
+  std::list<Entry> entries;  ///< 头部为最近使用
+  std::unordered_map<std::string, std::list<Entry>::iterator> index;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFASSETCACHE_H
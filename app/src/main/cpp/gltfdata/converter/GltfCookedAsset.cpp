@@ -0,0 +1,1150 @@
+//
+// Created by vincentsyan on 2025/9/29.
+//
+
+#include "GltfCookedAsset.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "GltfAssetCache.h"
+#include "GltfDracoDecoder.h"
+#include "../Gltf.h"
+#include "../GltfAccessor.h"
+#include "../GltfBuffer.h"
+#include "../GltfImage.h"
+#include "../GltfMesh.h"
+#include "../GltfPrimitive.h"
+#include "../../utils/LogUtils.h"
+#include "../../utils/MappedFile.h"
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr uint32_t kCookedMagic = 0x43484C44;  // "LDHC"
+constexpr size_t kCookedAlignment = 16;
+
+/**
+ * @brief 文件头, 位于文件起始处
+ */
+struct CookedHeader {
+  uint32_t magic = kCookedMagic;
+  uint32_t version = GltfCookedAsset::kVersion;
+  uint64_t sourceHash = 0;
+  uint64_t fileSize = 0;
+  uint64_t structureOffset = 0;   ///< 结构描述（CookedStructure 序列化）
+  uint64_t structureSize = 0;
+};
+
+/**
+ * @brief 文件内数据块的位置（相对文件起始）
+ */
+struct CookedRange {
+  uint64_t offset = 0;
+  uint64_t size = 0;
+};
+
+struct CookedImage {
+  bool present = false;
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  CookedRange pixels;
+};
+
+struct CookedMorphTarget {
+  bool present = false;
+  int width = 0;
+  int vertexCount = 0;
+  int targetCount = 0;
+  std::vector<std::string> attributes;
+  CookedRange texels;
+};
+
+/**
+ * @brief 结构描述, 位于数据块之后
+ */
+struct CookedStructure {
+  std::vector<GltfSourceDependency> dependencies;
+  tinygltf::Model model;          ///< 访问器与 bufferView 已改写为指向 buffer
+  CookedRange buffer;             ///< 唯一的 buffer（全部访问器数据）
+  std::vector<CookedImage> images;
+  std::vector<std::vector<CookedMorphTarget>> morphTargets;
+  bool optimizedMeshes = false;
+};
+
+// ==================== 二进制序列化 ====================
+// 同一组 io 函数既用于写入也用于读取, 由 Ar::kReading 区分方向。
+// 写入时传入的对象不会被修改。
+
+class ArchiveWriter {
+ public:
+  static constexpr bool kReading = false;
+
+  void data(const void *src, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(src);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+  }
+
+  template<typename T>
+  void raw(const T &value) { data(&value, sizeof(T)); }
+
+  void check(size_t) const {}
+
+  const std::vector<uint8_t> &getBuffer() const { return buffer; }
+
+ private:
+  std::vector<uint8_t> buffer;
+};
+
+class ArchiveReader {
+ public:
+  static constexpr bool kReading = true;
+
+  ArchiveReader(const uint8_t *data, size_t size)
+      : cursor(data), end(data + size) {}
+
+  void data(void *dst, size_t size) {
+    check(size);
+    std::memcpy(dst, cursor, size);
+    cursor += size;
+  }
+
+  template<typename T>
+  void raw(T &value) { data(&value, sizeof(T)); }
+
+  /**
+   * @brief 确认剩余数据不少于 size 字节, 防止损坏的长度字段导致越界或巨量分配
+   */
+  void check(size_t size) const {
+    if (size > static_cast<size_t>(end - cursor)) {
+      throw std::runtime_error("structure data truncated");
+    }
+  }
+
+ private:
+  const uint8_t *cursor;
+  const uint8_t *end;
+};
+
+template<typename Ar, typename T>
+std::enable_if_t<std::is_arithmetic_v<T>> io(Ar &ar, T &value) {
+  ar.raw(value);
+}
+
+/**
+ * @brief size_t 统一按 64 位存储, 32 位与 64 位 ABI 读写一致
+ */
+template<typename Ar>
+void ioSize(Ar &ar, size_t &value) {
+  uint64_t stored = value;
+  ar.raw(stored);
+  if constexpr (Ar::kReading) {
+    value = static_cast<size_t>(stored);
+  }
+}
+
+template<typename Ar>
+void io(Ar &ar, std::string &value) {
+  uint32_t size = static_cast<uint32_t>(value.size());
+  ar.raw(size);
+  if constexpr (Ar::kReading) {
+    ar.check(size);
+    value.resize(size);
+  }
+  ar.data(value.data(), size);
+}
+
+template<typename Ar, typename T>
+void io(Ar &ar, std::vector<T> &values) {
+  uint32_t size = static_cast<uint32_t>(values.size());
+  ar.raw(size);
+  if constexpr (Ar::kReading) {
+    // 每个元素至少占 1 字节
+    ar.check(size);
+    values.resize(size);
+  }
+  for (auto &value: values) {
+    io(ar, value);
+  }
+}
+
+template<typename Ar, typename K, typename V>
+void io(Ar &ar, std::map<K, V> &values) {
+  uint32_t size = static_cast<uint32_t>(values.size());
+  ar.raw(size);
+  if constexpr (Ar::kReading) {
+    ar.check(size);
+    values.clear();
+    for (uint32_t i = 0; i < size; ++i) {
+      K key;
+      V value;
+      io(ar, key);
+      io(ar, value);
+      values.emplace(std::move(key), std::move(value));
+    }
+  } else {
+    for (auto &[key, value]: values) {
+      K storedKey = key;
+      io(ar, storedKey);
+      io(ar, value);
+    }
+  }
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Value &value) {
+  uint8_t type = static_cast<uint8_t>(value.Type());
+  ar.raw(type);
+  if constexpr (Ar::kReading) {
+    switch (type) {
+      case tinygltf::NULL_TYPE:
+        value = tinygltf::Value();
+        break;
+      case tinygltf::REAL_TYPE: {
+        double number = 0.0;
+        ar.raw(number);
+        value = tinygltf::Value(number);
+        break;
+      }
+      case tinygltf::INT_TYPE: {
+        int number = 0;
+        ar.raw(number);
+        value = tinygltf::Value(number);
+        break;
+      }
+      case tinygltf::BOOL_TYPE: {
+        bool flag = false;
+        ar.raw(flag);
+        value = tinygltf::Value(flag);
+        break;
+      }
+      case tinygltf::STRING_TYPE: {
+        std::string text;
+        io(ar, text);
+        value = tinygltf::Value(std::move(text));
+        break;
+      }
+      case tinygltf::ARRAY_TYPE: {
+        tinygltf::Value::Array array;
+        io(ar, array);
+        value = tinygltf::Value(std::move(array));
+        break;
+      }
+      case tinygltf::BINARY_TYPE: {
+        std::vector<unsigned char> binary;
+        io(ar, binary);
+        value = tinygltf::Value(std::move(binary));
+        break;
+      }
+      case tinygltf::OBJECT_TYPE: {
+        tinygltf::Value::Object object;
+        io(ar, object);
+        value = tinygltf::Value(std::move(object));
+        break;
+      }
+      default:
+        throw std::runtime_error("invalid value type");
+    }
+  } else {
+    switch (type) {
+      case tinygltf::REAL_TYPE:
+        ar.raw(value.Get<double>());
+        break;
+      case tinygltf::INT_TYPE:
+        ar.raw(value.Get<int>());
+        break;
+      case tinygltf::BOOL_TYPE:
+        ar.raw(value.Get<bool>());
+        break;
+      case tinygltf::STRING_TYPE:
+        io(ar, value.Get<std::string>());
+        break;
+      case tinygltf::ARRAY_TYPE:
+        io(ar, value.Get<tinygltf::Value::Array>());
+        break;
+      case tinygltf::BINARY_TYPE:
+        io(ar, value.Get<std::vector<unsigned char>>());
+        break;
+      case tinygltf::OBJECT_TYPE:
+        io(ar, value.Get<tinygltf::Value::Object>());
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Parameter &parameter) {
+  io(ar, parameter.bool_value);
+  io(ar, parameter.has_number_value);
+  io(ar, parameter.string_value);
+  io(ar, parameter.number_array);
+  io(ar, parameter.json_double_value);
+  io(ar, parameter.number_value);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Asset &asset) {
+  io(ar, asset.version);
+  io(ar, asset.generator);
+  io(ar, asset.minVersion);
+  io(ar, asset.copyright);
+  io(ar, asset.extensions);
+  io(ar, asset.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Buffer &buffer) {
+  io(ar, buffer.name);
+  io(ar, buffer.uri);
+  io(ar, buffer.extensions);
+  io(ar, buffer.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::BufferView &view) {
+  io(ar, view.name);
+  io(ar, view.buffer);
+  ioSize(ar, view.byteOffset);
+  ioSize(ar, view.byteLength);
+  ioSize(ar, view.byteStride);
+  io(ar, view.target);
+  io(ar, view.dracoDecoded);
+  io(ar, view.extensions);
+  io(ar, view.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Accessor::Sparse &sparse) {
+  io(ar, sparse.count);
+  io(ar, sparse.isSparse);
+  ioSize(ar, sparse.indices.byteOffset);
+  io(ar, sparse.indices.bufferView);
+  io(ar, sparse.indices.componentType);
+  io(ar, sparse.indices.extensions);
+  io(ar, sparse.indices.extras);
+  io(ar, sparse.values.bufferView);
+  ioSize(ar, sparse.values.byteOffset);
+  io(ar, sparse.values.extensions);
+  io(ar, sparse.values.extras);
+  io(ar, sparse.extensions);
+  io(ar, sparse.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Accessor &accessor) {
+  io(ar, accessor.bufferView);
+  io(ar, accessor.name);
+  ioSize(ar, accessor.byteOffset);
+  io(ar, accessor.normalized);
+  io(ar, accessor.componentType);
+  ioSize(ar, accessor.count);
+  io(ar, accessor.type);
+  io(ar, accessor.minValues);
+  io(ar, accessor.maxValues);
+  io(ar, accessor.sparse);
+  io(ar, accessor.extensions);
+  io(ar, accessor.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Image &image) {
+  io(ar, image.name);
+  io(ar, image.width);
+  io(ar, image.height);
+  io(ar, image.component);
+  io(ar, image.bits);
+  io(ar, image.pixel_type);
+  io(ar, image.bufferView);
+  io(ar, image.mimeType);
+  io(ar, image.uri);
+  io(ar, image.as_is);
+  io(ar, image.extensions);
+  io(ar, image.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Sampler &sampler) {
+  io(ar, sampler.name);
+  io(ar, sampler.minFilter);
+  io(ar, sampler.magFilter);
+  io(ar, sampler.wrapS);
+  io(ar, sampler.wrapT);
+  io(ar, sampler.extensions);
+  io(ar, sampler.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Texture &texture) {
+  io(ar, texture.name);
+  io(ar, texture.sampler);
+  io(ar, texture.source);
+  io(ar, texture.extensions);
+  io(ar, texture.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::TextureInfo &info) {
+  io(ar, info.index);
+  io(ar, info.texCoord);
+  io(ar, info.extensions);
+  io(ar, info.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::NormalTextureInfo &info) {
+  io(ar, info.index);
+  io(ar, info.texCoord);
+  io(ar, info.scale);
+  io(ar, info.extensions);
+  io(ar, info.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::OcclusionTextureInfo &info) {
+  io(ar, info.index);
+  io(ar, info.texCoord);
+  io(ar, info.strength);
+  io(ar, info.extensions);
+  io(ar, info.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::PbrMetallicRoughness &pbr) {
+  io(ar, pbr.baseColorFactor);
+  io(ar, pbr.baseColorTexture);
+  io(ar, pbr.metallicFactor);
+  io(ar, pbr.roughnessFactor);
+  io(ar, pbr.metallicRoughnessTexture);
+  io(ar, pbr.extensions);
+  io(ar, pbr.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Material &material) {
+  io(ar, material.name);
+  io(ar, material.emissiveFactor);
+  io(ar, material.alphaMode);
+  io(ar, material.alphaCutoff);
+  io(ar, material.doubleSided);
+  io(ar, material.lods);
+  io(ar, material.pbrMetallicRoughness);
+  io(ar, material.normalTexture);
+  io(ar, material.occlusionTexture);
+  io(ar, material.emissiveTexture);
+  io(ar, material.values);
+  io(ar, material.additionalValues);
+  io(ar, material.extensions);
+  io(ar, material.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Primitive &primitive) {
+  io(ar, primitive.attributes);
+  io(ar, primitive.material);
+  io(ar, primitive.indices);
+  io(ar, primitive.mode);
+  io(ar, primitive.targets);
+  io(ar, primitive.extensions);
+  io(ar, primitive.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Mesh &mesh) {
+  io(ar, mesh.name);
+  io(ar, mesh.primitives);
+  io(ar, mesh.weights);
+  io(ar, mesh.extensions);
+  io(ar, mesh.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Node &node) {
+  io(ar, node.camera);
+  io(ar, node.name);
+  io(ar, node.skin);
+  io(ar, node.mesh);
+  io(ar, node.light);
+  io(ar, node.emitter);
+  io(ar, node.lods);
+  io(ar, node.children);
+  io(ar, node.rotation);
+  io(ar, node.scale);
+  io(ar, node.translation);
+  io(ar, node.matrix);
+  io(ar, node.weights);
+  io(ar, node.extensions);
+  io(ar, node.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Skin &skin) {
+  io(ar, skin.name);
+  io(ar, skin.inverseBindMatrices);
+  io(ar, skin.skeleton);
+  io(ar, skin.joints);
+  io(ar, skin.extensions);
+  io(ar, skin.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::AnimationChannel &channel) {
+  io(ar, channel.sampler);
+  io(ar, channel.target_node);
+  io(ar, channel.target_path);
+  io(ar, channel.extensions);
+  io(ar, channel.extras);
+  io(ar, channel.target_extensions);
+  io(ar, channel.target_extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::AnimationSampler &sampler) {
+  io(ar, sampler.input);
+  io(ar, sampler.output);
+  io(ar, sampler.interpolation);
+  io(ar, sampler.extensions);
+  io(ar, sampler.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Animation &animation) {
+  io(ar, animation.name);
+  io(ar, animation.channels);
+  io(ar, animation.samplers);
+  io(ar, animation.extensions);
+  io(ar, animation.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::PerspectiveCamera &camera) {
+  io(ar, camera.aspectRatio);
+  io(ar, camera.yfov);
+  io(ar, camera.zfar);
+  io(ar, camera.znear);
+  io(ar, camera.extensions);
+  io(ar, camera.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::OrthographicCamera &camera) {
+  io(ar, camera.xmag);
+  io(ar, camera.ymag);
+  io(ar, camera.zfar);
+  io(ar, camera.znear);
+  io(ar, camera.extensions);
+  io(ar, camera.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Camera &camera) {
+  io(ar, camera.type);
+  io(ar, camera.name);
+  io(ar, camera.perspective);
+  io(ar, camera.orthographic);
+  io(ar, camera.extensions);
+  io(ar, camera.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Scene &scene) {
+  io(ar, scene.name);
+  io(ar, scene.nodes);
+  io(ar, scene.audioEmitters);
+  io(ar, scene.extensions);
+  io(ar, scene.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::SpotLight &spot) {
+  io(ar, spot.innerConeAngle);
+  io(ar, spot.outerConeAngle);
+  io(ar, spot.extensions);
+  io(ar, spot.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Light &light) {
+  io(ar, light.name);
+  io(ar, light.color);
+  io(ar, light.intensity);
+  io(ar, light.type);
+  io(ar, light.range);
+  io(ar, light.spot);
+  io(ar, light.extensions);
+  io(ar, light.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, tinygltf::Model &model) {
+  io(ar, model.asset);
+  io(ar, model.accessors);
+  io(ar, model.animations);
+  io(ar, model.buffers);
+  io(ar, model.bufferViews);
+  io(ar, model.materials);
+  io(ar, model.meshes);
+  io(ar, model.nodes);
+  io(ar, model.textures);
+  io(ar, model.images);
+  io(ar, model.skins);
+  io(ar, model.samplers);
+  io(ar, model.cameras);
+  io(ar, model.scenes);
+  io(ar, model.lights);
+  io(ar, model.defaultScene);
+  io(ar, model.extensionsUsed);
+  io(ar, model.extensionsRequired);
+  io(ar, model.extensions);
+  io(ar, model.extras);
+}
+
+template<typename Ar>
+void io(Ar &ar, CookedRange &range) {
+  io(ar, range.offset);
+  io(ar, range.size);
+}
+
+template<typename Ar>
+void io(Ar &ar, GltfSourceDependency &dependency) {
+  io(ar, dependency.uri);
+  io(ar, dependency.hash);
+}
+
+template<typename Ar>
+void io(Ar &ar, CookedImage &image) {
+  io(ar, image.present);
+  io(ar, image.width);
+  io(ar, image.height);
+  io(ar, image.channels);
+  io(ar, image.pixels);
+}
+
+template<typename Ar>
+void io(Ar &ar, CookedMorphTarget &morph) {
+  io(ar, morph.present);
+  io(ar, morph.width);
+  io(ar, morph.vertexCount);
+  io(ar, morph.targetCount);
+  io(ar, morph.attributes);
+  io(ar, morph.texels);
+}
+
+template<typename Ar>
+void io(Ar &ar, CookedStructure &structure) {
+  io(ar, structure.dependencies);
+  io(ar, structure.model);
+  io(ar, structure.buffer);
+  io(ar, structure.images);
+  io(ar, structure.morphTargets);
+  io(ar, structure.optimizedMeshes);
+}
+
+// ==================== 写入 ====================
+
+/**
+ * @brief 顺序写入对齐的数据块并记录位置
+ */
+class CookedFileWriter {
+ public:
+  explicit CookedFileWriter(std::ofstream &out) : out(out) {}
+
+  CookedRange append(const void *data, size_t size) {
+    align();
+    CookedRange range{offset, size};
+    if (size > 0) {
+      out.write(static_cast<const char *>(data),
+                static_cast<std::streamsize>(size));
+      offset += size;
+    }
+    return range;
+  }
+
+  uint64_t align() {
+    static const char kPadding[kCookedAlignment] = {};
+    size_t padding = (kCookedAlignment - offset % kCookedAlignment)
+        % kCookedAlignment;
+    out.write(kPadding, static_cast<std::streamsize>(padding));
+    offset += padding;
+    return offset;
+  }
+
+  uint64_t getOffset() const { return offset; }
+
+ private:
+  std::ofstream &out;
+  uint64_t offset = 0;
+};
+
+bool isExternalUri(const std::string &uri) {
+  return !uri.empty() && uri.compare(0, 5, "data:") != 0;
+}
+
+/**
+ * @brief 复制结构描述, 不复制 buffer 数据与像素
+ */
+void copyStructure(const tinygltf::Model &model, tinygltf::Model &out) {
+  out.asset = model.asset;
+  out.accessors = model.accessors;
+  out.animations = model.animations;
+  out.materials = model.materials;
+  out.meshes = model.meshes;
+  out.nodes = model.nodes;
+  out.textures = model.textures;
+  out.skins = model.skins;
+  out.samplers = model.samplers;
+  out.cameras = model.cameras;
+  out.scenes = model.scenes;
+  out.lights = model.lights;
+  out.defaultScene = model.defaultScene;
+  out.extensionsUsed = model.extensionsUsed;
+  out.extensionsRequired = model.extensionsRequired;
+  out.extensions = model.extensions;
+  out.extras = model.extras;
+
+  out.images.resize(model.images.size());
+  for (size_t i = 0; i < model.images.size(); ++i) {
+    const auto &image = model.images[i];
+    auto &copy = out.images[i];
+    copy.name = image.name;
+    copy.mimeType = image.mimeType;
+    copy.uri = image.uri;
+    copy.as_is = image.as_is;
+    copy.extensions = image.extensions;
+    copy.extras = image.extras;
+  }
+}
+
+/**
+ * @brief 只被动画采样器引用的访问器, 烘焙时反量化为 float
+ */
+std::vector<bool> findAnimationAccessors(const tinygltf::Model &model) {
+  std::vector<bool> animationOnly(model.accessors.size(), false);
+  auto mark = [&](int index, bool value) {
+    if (index >= 0 && index < static_cast<int>(animationOnly.size())) {
+      animationOnly[index] = value;
+    }
+  };
+  for (const auto &animation: model.animations) {
+    for (const auto &sampler: animation.samplers) {
+      mark(sampler.input, true);
+      mark(sampler.output, true);
+    }
+  }
+  for (const auto &mesh: model.meshes) {
+    for (const auto &primitive: mesh.primitives) {
+      mark(primitive.indices, false);
+      for (const auto &[_, index]: primitive.attributes) {
+        mark(index, false);
+      }
+      for (const auto &target: primitive.targets) {
+        for (const auto &[_, index]: target) {
+          mark(index, false);
+        }
+      }
+    }
+  }
+  for (const auto &skin: model.skins) {
+    mark(skin.inverseBindMatrices, false);
+  }
+  return animationOnly;
+}
+
+bool canCookImage(const std::shared_ptr<GltfImage> &image) {
+  auto data = image ? image->getImageData() : nullptr;
+  return data && data->getData() && !data->isCompressed() &&
+      data->getType() == GL_UNSIGNED_BYTE && data->getLevelCount() == 1 &&
+      data->getDataSize() == static_cast<size_t>(data->getWidth()) *
+          data->getHeight() * data->getChannels();
+}
+
+/**
+ * @brief 写入的数据按转换后的访问器排列, 组件类型、标准化与边界值随之更新
+ */
+void syncAccessorLayout(const GltfAccessor &gltfAccessor,
+                        tinygltf::Accessor &accessor) {
+  accessor.componentType =
+      gltfAccessor.getComponentType().value_or(accessor.componentType);
+  accessor.normalized = gltfAccessor.isNormalized();
+  accessor.minValues = gltfAccessor.getMin();
+  accessor.maxValues = gltfAccessor.getMax();
+}
+
+/**
+ * @brief 写入数据块并填充结构描述中的位置信息
+ */
+void writePayloads(CookedFileWriter &file,
+                   const tinygltf::Model &model,
+                   const Gltf &gltf,
+                   CookedStructure &structure) {
+  // 访问器: 每个访问器一个紧密排列的 bufferView, 全部位于同一个 buffer
+  auto &cooked = structure.model;
+  const auto &accessors = gltf.getAccessors();
+  const auto animationOnly = findAnimationAccessors(model);
+  const uint64_t bufferStart = file.align();
+  for (size_t i = 0; i < cooked.accessors.size(); ++i) {
+    const auto &source = model.accessors[i];
+    auto &accessor = cooked.accessors[i];
+    accessor.byteOffset = 0;
+    accessor.sparse = tinygltf::Accessor::Sparse();
+    accessor.bufferView = -1;
+
+    auto gltfAccessor = i < accessors.size() ? accessors[i] : nullptr;
+    if (!gltfAccessor || (source.bufferView < 0 && !source.sparse.isSparse &&
+        !gltfAccessor->hasDecodedData())) {
+      continue;
+    }
+
+    CookedRange range;
+    if (source.bufferView < 0) {
+      // 只有稀疏数据或解码数据（Draco）: 稀疏数据在零值基础上应用
+      auto [data, size] = gltfAccessor->getTypedView(gltf);
+      range = file.append(data, size);
+      syncAccessorLayout(*gltfAccessor, accessor);
+    } else if (animationOnly[i] &&
+        source.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) {
+      ArrayView<float> values =
+          gltfAccessor->getNormalizedDeinterlacedSpan(gltf);
+      range = file.append(values.data(), values.size() * sizeof(float));
+      accessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+      accessor.normalized = false;
+      // 边界值是量化前的整数, 不再适用
+      accessor.minValues.clear();
+      accessor.maxValues.clear();
+    } else {
+      // 组件类型可能已被改写（16 位索引、整理后的运行时访问器）
+      auto [data, size] = gltfAccessor->getDeinterlacedView(gltf);
+      range = file.append(data, size);
+      syncAccessorLayout(*gltfAccessor, accessor);
+    }
+    if (range.size == 0) {
+      continue;
+    }
+
+    tinygltf::BufferView view;
+    view.buffer = 0;
+    view.byteOffset = static_cast<size_t>(range.offset - bufferStart);
+    view.byteLength = static_cast<size_t>(range.size);
+    if (source.bufferView >= 0 &&
+        source.bufferView < static_cast<int>(model.bufferViews.size())) {
+      view.target = model.bufferViews[source.bufferView].target;
+    }
+    accessor.bufferView = static_cast<int>(cooked.bufferViews.size());
+    cooked.bufferViews.push_back(std::move(view));
+  }
+  structure.buffer = {bufferStart, file.getOffset() - bufferStart};
+
+  tinygltf::Buffer buffer;
+  buffer.name = "cooked";
+  cooked.buffers.push_back(std::move(buffer));
+
+  // Draco 图元的数据已写入访问器, 读取时不再解码; 被跳过的图元保留扩展
+  const auto &gltfMeshes = gltf.getMeshes();
+  for (size_t m = 0; m < cooked.meshes.size() && m < gltfMeshes.size(); ++m) {
+    if (!gltfMeshes[m]) {
+      continue;
+    }
+    const auto &primitives = gltfMeshes[m]->getPrimitives();
+    auto &cookedPrimitives = cooked.meshes[m].primitives;
+    for (size_t p = 0; p < cookedPrimitives.size() && p < primitives.size(); ++p) {
+      if (primitives[p] && !primitives[p]->shouldSkip()) {
+        cookedPrimitives[p].extensions.erase(GltfDracoDecoder::kExtensionName);
+      }
+    }
+  }
+
+  // 图像: 解码后的像素
+  const auto &images = gltf.getImages();
+  structure.images.resize(cooked.images.size());
+  for (size_t i = 0; i < cooked.images.size(); ++i) {
+    const auto &data = images[i]->getImageData();
+    auto &entry = structure.images[i];
+    entry.present = true;
+    entry.width = data->getWidth();
+    entry.height = data->getHeight();
+    entry.channels = data->getChannels();
+    entry.pixels = file.append(data->getData(), data->getDataSize());
+
+    auto &image = cooked.images[i];
+    image.width = entry.width;
+    image.height = entry.height;
+    image.component = entry.channels;
+    image.bits = 8;
+    image.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+  }
+
+  // 变形目标纹理: 不受设备层数限制组装, 读取时超限则重新组装。
+  // 切分后的图元读取时重新生成, 不写入
+  const auto &meshes = gltf.getMeshes();
+  structure.morphTargets.resize(cooked.meshes.size());
+  for (size_t m = 0; m < cooked.meshes.size() && m < meshes.size(); ++m) {
+    if (!meshes[m]) {
+      continue;
+    }
+    const auto &primitives = meshes[m]->getPrimitives();
+    const auto &cookedPrimitives = cooked.meshes[m].primitives;
+    auto &entries = structure.morphTargets[m];
+    entries.resize(std::min(primitives.size(), cookedPrimitives.size()));
+    for (size_t p = 0; p < entries.size(); ++p) {
+      auto texture = primitives[p] && primitives[p]->getAttributes() ==
+                                      cookedPrimitives[p].attributes
+                     ? primitives[p]->assembleMorphTargets(gltf, INT_MAX)
+                     : nullptr;
+      if (!texture) {
+        continue;
+      }
+      auto &entry = entries[p];
+      entry.present = true;
+      entry.width = texture->width;
+      entry.vertexCount = texture->vertexCount;
+      entry.targetCount = texture->targetCount;
+      entry.attributes = texture->attributes;
+      entry.texels = file.append(texture->texels.data, texture->texels.size);
+    }
+  }
+}
+
+} // namespace
+
+bool GltfCookedAsset::hashDependencies(
+    const GltfCookedSource &source, const tinygltf::Model &model,
+    std::vector<GltfSourceDependency> &out) {
+  out.clear();
+  if (!source.hashDependency) {
+    return true;
+  }
+  std::vector<std::string> uris;
+  for (const auto &buffer: model.buffers) {
+    uris.push_back(buffer.uri);
+  }
+  for (const auto &image: model.images) {
+    uris.push_back(image.uri);
+  }
+  for (const auto &uri: uris) {
+    if (!isExternalUri(uri)) {
+      continue;
+    }
+    GltfSourceDependency dependency;
+    dependency.uri = uri;
+    if (!source.hashDependency(uri, dependency.hash)) {
+      LOGW("无法读取外部资源 %s", uri.c_str());
+      return false;
+    }
+    out.push_back(std::move(dependency));
+  }
+  return true;
+}
+
+bool GltfCookedAsset::isCurrent(
+    const GltfCookedSource &source,
+    const std::vector<GltfSourceDependency> &dependencies) {
+  for (const auto &dependency: dependencies) {
+    uint64_t hash = 0;
+    if (!source.hashDependency || !source.hashDependency(dependency.uri, hash)
+        || hash != dependency.hash) {
+      LOGI("外部资源已变化: %s", dependency.uri.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool GltfCookedAsset::write(const GltfCookedSource &source,
+                            const tinygltf::Model &model,
+                            const Gltf &gltf) {
+  const auto &images = gltf.getImages();
+  for (size_t i = 0; i < model.images.size(); ++i) {
+    if (i >= images.size() || !canCookImage(images[i])) {
+      LOGW("图像 %zu 没有可烘焙的像素数据, 跳过烘焙", i);
+      return false;
+    }
+  }
+
+  CookedStructure structure;
+  if (!hashDependencies(source, model, structure.dependencies)) {
+    LOGW("无法读取外部资源, 跳过烘焙");
+    return false;
+  }
+  copyStructure(model, structure.model);
+  structure.optimizedMeshes = source.optimizedMeshes;
+
+  std::error_code error;
+  const std::filesystem::path cookedPath(source.cookedPath);
+  if (cookedPath.has_parent_path()) {
+    std::filesystem::create_directories(cookedPath.parent_path(), error);
+  }
+  const std::string tempPath = source.cookedPath + ".tmp";
+  std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    LOGE("无法创建烘焙文件: %s", tempPath.c_str());
+    return false;
+  }
+
+  CookedHeader header;
+  header.sourceHash = source.hash;
+  CookedFileWriter file(out);
+  file.append(&header, sizeof(header));
+
+  try {
+    writePayloads(file, model, gltf, structure);
+  } catch (const std::exception &e) {
+    LOGE("烘焙数据写入异常: %s", e.what());
+    out.close();
+    std::filesystem::remove(tempPath, error);
+    return false;
+  }
+
+  ArchiveWriter archive;
+  io(archive, structure);
+  CookedRange structureRange =
+      file.append(archive.getBuffer().data(), archive.getBuffer().size());
+
+  header.fileSize = file.getOffset();
+  header.structureOffset = structureRange.offset;
+  header.structureSize = structureRange.size;
+  out.seekp(0);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.close();
+
+  if (!out.good()) {
+    LOGE("烘焙文件写入失败: %s", tempPath.c_str());
+    std::filesystem::remove(tempPath, error);
+    return false;
+  }
+  std::filesystem::rename(tempPath, cookedPath, error);
+  if (error) {
+    LOGE("烘焙文件替换失败: %s (%s)", source.cookedPath.c_str(),
+         error.message().c_str());
+    std::filesystem::remove(tempPath, error);
+    return false;
+  }
+  LOGI("已写入烘焙文件: %s (%llu bytes)", source.cookedPath.c_str(),
+       static_cast<unsigned long long>(header.fileSize));
+  return true;
+}
+
+std::shared_ptr<GltfSharedAsset>
+GltfCookedAsset::read(const GltfCookedSource &source) {
+  std::error_code error;
+  if (!std::filesystem::is_regular_file(source.cookedPath, error)) {
+    return nullptr;
+  }
+  auto file = MappedFile::open(source.cookedPath);
+  if (!file || file->size() < sizeof(CookedHeader)) {
+    return nullptr;
+  }
+
+  CookedHeader header;
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (header.magic != kCookedMagic || header.version != kVersion ||
+      header.sourceHash != source.hash || header.fileSize != file->size()) {
+    LOGW("烘焙文件与源模型不匹配: %s", source.cookedPath.c_str());
+    return nullptr;
+  }
+
+  auto inFile = [&file](const CookedRange &range) {
+    return range.offset <= file->size() &&
+        range.size <= file->size() - range.offset;
+  };
+  auto rangeData = [&file](const CookedRange &range) {
+    return file->data() + range.offset;
+  };
+
+  const CookedRange structureRange{header.structureOffset,
+                                   header.structureSize};
+  if (!inFile(structureRange)) {
+    LOGW("烘焙文件结构描述越界: %s", source.cookedPath.c_str());
+    return nullptr;
+  }
+
+  CookedStructure structure;
+  try {
+    ArchiveReader archive(rangeData(structureRange),
+                          static_cast<size_t>(structureRange.size));
+    io(archive, structure);
+  } catch (const std::exception &e) {
+    LOGW("烘焙文件已损坏: %s (%s)", source.cookedPath.c_str(), e.what());
+    return nullptr;
+  }
+
+  if (!isCurrent(source, structure.dependencies)) {
+    LOGI("烘焙文件失效: %s", source.cookedPath.c_str());
+    return nullptr;
+  }
+
+  auto asset = std::make_shared<GltfSharedAsset>();
+  asset->sourceHash = source.hash;
+  asset->dependencies = structure.dependencies;
+  if (!inFile(structure.buffer)) {
+    LOGW("烘焙文件数据越界: %s", source.cookedPath.c_str());
+    return nullptr;
+  }
+  GltfBinaryChunk chunk;
+  chunk.owner = file;
+  chunk.data = rangeData(structure.buffer);
+  chunk.size = static_cast<size_t>(structure.buffer.size);
+  auto buffer = std::make_shared<GltfBuffer>();
+  buffer->setName("cooked");
+  buffer->setExternalData(chunk);
+  asset->buffers.push_back(buffer);
+
+  asset->images.resize(structure.images.size());
+  for (size_t i = 0; i < structure.images.size(); ++i) {
+    const auto &entry = structure.images[i];
+    if (!entry.present) {
+      continue;
+    }
+    const uint64_t expected = static_cast<uint64_t>(entry.width) *
+        entry.height * entry.channels;
+    if (!inFile(entry.pixels) || entry.pixels.size != expected) {
+      LOGW("烘焙文件图像数据无效: image[%zu]", i);
+      return nullptr;
+    }
+    // 像素引用映射内存, 随 ImageData 一起保持映射存活
+    std::shared_ptr<const uint8_t> pixels(file, rangeData(entry.pixels));
+    asset->images[i] = std::make_shared<BasicImageData>(
+        entry.width, entry.height, entry.channels, std::move(pixels),
+        static_cast<size_t>(entry.pixels.size));
+  }
+
+  asset->morphTargets.resize(structure.morphTargets.size());
+  for (size_t m = 0; m < structure.morphTargets.size(); ++m) {
+    const auto &entries = structure.morphTargets[m];
+    asset->morphTargets[m].resize(entries.size());
+    for (size_t p = 0; p < entries.size(); ++p) {
+      const auto &entry = entries[p];
+      if (!entry.present) {
+        continue;
+      }
+      auto texture = std::make_shared<GltfMorphTargetTexture>();
+      texture->width = entry.width;
+      texture->vertexCount = entry.vertexCount;
+      texture->targetCount = entry.targetCount;
+      texture->attributes = entry.attributes;
+      texture->texels.owner = file;
+      texture->texels.data = rangeData(entry.texels);
+      texture->texels.size = static_cast<size_t>(entry.texels.size);
+      if (!inFile(entry.texels) ||
+          entry.texels.size != texture->getTexelBytes()) {
+        LOGW("烘焙文件变形目标数据无效: mesh[%zu] primitive[%zu]", m, p);
+        return nullptr;
+      }
+      asset->morphTargets[m][p] = std::move(texture);
+    }
+  }
+
+  asset->optimizedMeshes = structure.optimizedMeshes;
+  asset->byteSize = file->size();
+  asset->document =
+      std::make_shared<const tinygltf::Model>(std::move(structure.model));
+  return asset;
+}
+
+} // namespace digitalhumans
@@ -0,0 +1,87 @@
+//
+// Created by vincentsyan on 2025/9/29.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFCOOKEDASSET_H
+#define LIGHTDIGITALHUMAN_GLTFCOOKEDASSET_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "tiny_gltf.h"
+
+namespace digitalhumans {
+
+class Gltf;
+
+struct GltfSharedAsset;
+
+struct GltfSourceDependency;
+
+/**
+ * @brief 烘焙文件对应的源模型
+ */
+struct GltfCookedSource {
+  uint64_t hash = 0;              ///< 源文件内容哈希（hash::hashBytes）
+  std::string cookedPath;         ///< 烘焙文件路径: <缓存目录>/<哈希>.ldhc
+  /**
+   * 计算源文件引用的外部资源（相对 uri, 如 .bin 与贴图）的内容哈希,
+   * 资源不存在时返回 false
+   */
+  std::function<bool(const std::string &uri, uint64_t &hash)> hashDependency;
+  bool optimizedMeshes = false;   ///< 转换时是否做了网格优化（GltfMeshOptimizer）
+};
+
+/**
+ * @brief 烘焙资源文件（.ldhc）
+ *
+ * 首次转换后把可直接用于 GPU 上传的数据写入扁平文件, 以后启动时映射该文件,
+ * 跳过 JSON 解析、图像解码、访问器去交错和变形目标纹理组装:
+ *   - 结构描述: tinygltf::Model 的二进制序列化（不含 buffer 数据与像素）
+ *   - 访问器: 去交错后紧密排列（已应用稀疏数据）, 动画数据反量化为 float
+ *   - 图像: 解码后的像素
+ *   - 变形目标: 组装好的 RGBA32F 纹理数组数据
+ *   - 网格优化: 开启时访问器保存重排后的数据, 读取后不再重复优化
+ * 数据块按 16 字节对齐, 读取时 GltfBuffer、ImageData 与变形目标纹理直接引用映射内存。
+ * 文件头记录源内容哈希, 源文件或其外部资源变化后烘焙文件失效。
+ */
+class GltfCookedAsset {
+ public:
+  static constexpr uint32_t kVersion = 2;
+
+  /**
+   * @brief 写入烘焙文件（先写临时文件再替换, 不会留下不完整的文件）
+   * @param model 解析得到的源模型
+   * @param gltf 由 model 转换得到的 Gltf
+   * @return 模型含无法烘焙的数据（如未解码的图像）或写入失败时返回 false
+   */
+  static bool write(const GltfCookedSource &source,
+                    const tinygltf::Model &model,
+                    const Gltf &gltf);
+
+  /**
+   * @brief 映射并读取烘焙文件
+   * @return 文件不存在、版本或哈希不匹配、外部资源已变化或数据损坏时返回 nullptr
+   */
+  static std::shared_ptr<GltfSharedAsset> read(const GltfCookedSource &source);
+
+  /**
+   * @brief 计算 model 引用的外部资源的内容哈希, source 没有 hashDependency 时输出为空
+   * @return 有外部资源无法读取时返回 false
+   */
+  static bool hashDependencies(const GltfCookedSource &source,
+                               const tinygltf::Model &model,
+                               std::vector<GltfSourceDependency> &out);
+
+  /**
+   * @brief 重新计算外部资源的内容哈希, 与 dependencies 中记录的全部一致时返回 true
+   */
+  static bool isCurrent(const GltfCookedSource &source,
+                        const std::vector<GltfSourceDependency> &dependencies);
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFCOOKEDASSET_H
@@ -0,0 +1,177 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#include "GltfDracoDecoder.h"
+#include <GLES3/gl3.h>
+#include <limits>
+#include "../GltfAccessor.h"
+
+#ifdef LIGHTDIGITALHUMAN_HAS_DRACO
+#include "draco/compression/decode.h"
+#include "draco/core/decoder_buffer.h"
+#endif
+
+namespace digitalhumans {
+
+#ifdef LIGHTDIGITALHUMAN_HAS_DRACO
+namespace {
+
+template<typename T>
+bool readAttribute(const draco::PointAttribute &attribute, uint32_t pointCount,
+                   int components, uint8_t *dst) {
+  auto *out = reinterpret_cast<T *>(dst);
+  for (uint32_t i = 0; i < pointCount; ++i) {
+    const auto value = attribute.mapped_index(draco::PointIndex(i));
+    if (!attribute.ConvertValue<T>(value, static_cast<int8_t>(components),
+                                   out + static_cast<size_t>(i) * components)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 按访问器的组件类型读取全部顶点的属性值
+ */
+bool readAttribute(const draco::PointAttribute &attribute, uint32_t pointCount,
+                   int componentType, int components, uint8_t *dst) {
+  switch (componentType) {
+    case GL_BYTE:
+      return readAttribute<int8_t>(attribute, pointCount, components, dst);
+    case GL_UNSIGNED_BYTE:
+      return readAttribute<uint8_t>(attribute, pointCount, components, dst);
+    case GL_SHORT:
+      return readAttribute<int16_t>(attribute, pointCount, components, dst);
+    case GL_UNSIGNED_SHORT:
+      return readAttribute<uint16_t>(attribute, pointCount, components, dst);
+    case GL_UNSIGNED_INT:
+      return readAttribute<uint32_t>(attribute, pointCount, components, dst);
+    case GL_FLOAT:
+      return readAttribute<float>(attribute, pointCount, components, dst);
+    default:
+      return false;
+  }
+}
+
+template<typename T>
+void readIndices(const draco::Mesh &mesh, uint8_t *dst) {
+  auto *out = reinterpret_cast<T *>(dst);
+  for (uint32_t f = 0; f < mesh.num_faces(); ++f) {
+    const auto &face = mesh.face(draco::FaceIndex(f));
+    for (int k = 0; k < 3; ++k) {
+      out[f * 3 + k] = static_cast<T>(face[k].value());
+    }
+  }
+}
+
+/**
+ * @brief 索引类型能否表示全部顶点
+ */
+bool fitsIndexType(int componentType, uint32_t pointCount) {
+  switch (componentType) {
+    case GL_UNSIGNED_BYTE:
+      return pointCount <= std::numeric_limits<uint8_t>::max() + 1u;
+    case GL_UNSIGNED_SHORT:
+      return pointCount <= std::numeric_limits<uint16_t>::max() + 1u;
+    case GL_UNSIGNED_INT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+#endif
+
+bool GltfDracoDecoder::isAvailable() {
+#ifdef LIGHTDIGITALHUMAN_HAS_DRACO
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool GltfDracoDecoder::decode(const uint8_t *data, size_t size,
+                              GltfAccessor *indices,
+                              const std::vector<std::pair<int, GltfAccessor *>> &attributes,
+                              std::string &error) {
+#ifdef LIGHTDIGITALHUMAN_HAS_DRACO
+  draco::DecoderBuffer buffer;
+  buffer.Init(reinterpret_cast<const char *>(data), size);
+  draco::Decoder decoder;
+  auto result = decoder.DecodeMeshFromBuffer(&buffer);
+  if (!result.ok()) {
+    error = result.status().error_msg_string();
+    return false;
+  }
+  const std::unique_ptr<draco::Mesh> mesh = std::move(result).value();
+  const uint32_t pointCount = mesh->num_points();
+
+  // 全部解码成功后再写入访问器
+  std::vector<std::pair<GltfAccessor *, std::vector<uint8_t>>> decoded;
+  decoded.reserve(attributes.size() + 1);
+
+  if (indices) {
+    const int componentType = indices->getComponentType().value_or(0);
+    const size_t indexCount = static_cast<size_t>(mesh->num_faces()) * 3;
+    if (static_cast<size_t>(indices->getCount().value_or(0)) != indexCount) {
+      error = "index count mismatch";
+      return false;
+    }
+    if (!fitsIndexType(componentType, pointCount)) {
+      error = "index component type cannot address all vertices";
+      return false;
+    }
+    std::vector<uint8_t> values(indexCount * indices->getComponentSize());
+    switch (componentType) {
+      case GL_UNSIGNED_BYTE:
+        readIndices<uint8_t>(*mesh, values.data());
+        break;
+      case GL_UNSIGNED_SHORT:
+        readIndices<uint16_t>(*mesh, values.data());
+        break;
+      default:
+        readIndices<uint32_t>(*mesh, values.data());
+        break;
+    }
+    decoded.emplace_back(indices, std::move(values));
+  }
+
+  for (const auto &[uniqueId, accessor]: attributes) {
+    const draco::PointAttribute *attribute =
+        mesh->GetAttributeByUniqueId(static_cast<uint32_t>(uniqueId));
+    if (!attribute) {
+      error = "missing attribute " + std::to_string(uniqueId);
+      return false;
+    }
+    if (static_cast<uint32_t>(accessor->getCount().value_or(0)) != pointCount) {
+      error = "vertex count mismatch for attribute " + std::to_string(uniqueId);
+      return false;
+    }
+    std::vector<uint8_t> values(
+        static_cast<size_t>(pointCount) * accessor->getElementSize());
+    if (!readAttribute(*attribute, pointCount,
+                       accessor->getComponentType().value_or(0),
+                       accessor->getComponentCount(), values.data())) {
+      error = "cannot convert attribute " + std::to_string(uniqueId);
+      return false;
+    }
+    decoded.emplace_back(accessor, std::move(values));
+  }
+
+  for (auto &[accessor, values]: decoded) {
+    accessor->setDecodedData(std::move(values));
+  }
+  return true;
+#else
+  (void) data;
+  (void) size;
+  (void) indices;
+  (void) attributes;
+  error = "Draco decoder is not included in this build";
+  return false;
+#endif
+}
+
+} // namespace digitalhumans
@@ -0,0 +1,51 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFDRACODECODER_H
+#define LIGHTDIGITALHUMAN_GLTFDRACODECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace digitalhumans {
+
+class GltfAccessor;
+
+/**
+ * @brief KHR_draco_mesh_compression 解码器
+ *
+ * 解码结果按访问器的组件类型直接写入图元的索引与属性访问器（GltfAccessor::setDecodedData）,
+ * 不经过中间的 glTF buffer。只访问 CPU 数据, 可在加载的工作线程中执行。
+ *
+ * 解码依赖 Draco 库, 构建中包含 Draco 时才会启用（LIGHTDIGITALHUMAN_HAS_DRACO, 见 cmake/Draco.cmake）。
+ */
+class GltfDracoDecoder {
+ public:
+  static constexpr const char *kExtensionName = "KHR_draco_mesh_compression";
+
+  /**
+   * @brief 当前构建是否包含 Draco 解码
+   */
+  static bool isAvailable();
+
+  /**
+   * @brief 解码一个压缩的图元
+   * @param data 扩展 bufferView 指向的压缩数据
+   * @param indices 索引访问器, 非索引图元为空
+   * @param attributes Draco 属性唯一 ID 与对应的属性访问器
+   * @param error 失败原因
+   * @return 任一访问器无法填充时返回 false, 已写入的访问器保持不变
+   */
+  static bool decode(const uint8_t *data, size_t size,
+                     GltfAccessor *indices,
+                     const std::vector<std::pair<int, GltfAccessor *>> &attributes,
+                     std::string &error);
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFDRACODECODER_H
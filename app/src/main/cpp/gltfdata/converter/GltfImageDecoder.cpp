@@ -0,0 +1,161 @@
+//
+// Created by vincentsyan on 2025/9/27.
+//
+
+#include "GltfImageDecoder.h"
+#include <climits>
+#include <future>
+#include <utility>
+#include "stb_image.h"
+#include "KtxTextureDecoder.h"
+#include "../GltfImage.h"
+#include "../../utils/LogUtils.h"
+#include "../../utils/PixelConvert.h"
+#include "../../utils/ThreadPool.h"
+
+namespace digitalhumans {
+
+void GltfImageDecoder::install(tinygltf::TinyGLTF &loader) {
+  loader.SetImageLoader(deferImage, this);
+}
+
+void GltfImageDecoder::setExternalSource(int imageIndex, const uint8_t *data,
+                                         size_t size) {
+  EncodedImage &encoded = images[imageIndex];
+  encoded.data = data;
+  encoded.size = size;
+}
+
+bool GltfImageDecoder::deferImage(tinygltf::Image *image, const int imageIndex,
+                                  std::string * /*err*/,
+                                  std::string * /*warn*/, int /*reqWidth*/,
+                                  int /*reqHeight*/,
+                                  const unsigned char *bytes, int size,
+                                  void *userData) {
+  auto *decoder = static_cast<GltfImageDecoder *>(userData);
+  EncodedImage &encoded = decoder->images[imageIndex];
+  if (encoded.data) {
+    // 外部数据已登记, 忽略占位内容
+    return true;
+  }
+  if (image->bufferView >= 0) {
+    // bytes 指向模型 buffer, 解析完成后仍然有效, 届时再定位
+    encoded.bufferView = image->bufferView;
+    return true;
+  }
+  // data URI 与外部文件由 tinygltf 读入临时内存, 需要保留一份
+  encoded.storage.assign(bytes, bytes + size);
+  return true;
+}
+
+bool GltfImageDecoder::decodeAll(const tinygltf::Model &model,
+                                 std::vector<std::shared_ptr<ImageData>> &out) {
+  using Result = std::pair<std::shared_ptr<ImageData>, std::string>;
+  // 在当前（GL）线程确定 KTX2 转码目标, 工作线程无法查询
+  KtxTextureDecoder::getTranscodeTarget();
+  out.assign(model.images.size(), nullptr);
+
+  struct Job {
+    int index;
+    bool ktx2;
+    std::future<Result> result;
+  };
+  std::vector<Job> jobs;
+  jobs.reserve(images.size());
+  bool success = true;
+  for (const auto &[index, encoded]: images) {
+    if (index < 0 || index >= static_cast<int>(out.size())) {
+      continue;
+    }
+
+    const uint8_t *data = encoded.data;
+    size_t size = encoded.size;
+    if (!encoded.storage.empty()) {
+      data = encoded.storage.data();
+      size = encoded.storage.size();
+    } else if (!data && encoded.bufferView >= 0) {
+      // tinygltf 已校验过 bufferView 与 buffer 的范围
+      const auto &view = model.bufferViews[encoded.bufferView];
+      const auto &buffer = model.buffers[view.buffer];
+      if (view.byteOffset + view.byteLength > buffer.data.size()) {
+        LOGE("Image %d bufferView out of range", index);
+        success = false;
+        continue;
+      }
+      data = buffer.data.data() + view.byteOffset;
+      size = view.byteLength;
+    }
+
+    jobs.push_back({index, KtxTextureDecoder::isKtx2(data, size),
+                    ThreadPool::shared().submit([data, size]() {
+                      std::string error;
+                      auto decoded = decode(data, size, error);
+                      return Result(std::move(decoded), std::move(error));
+                    })});
+  }
+
+  for (auto &[index, ktx2, job]: jobs) {
+    Result result = job.get();
+    if (!result.first && ktx2) {
+      // KHR_texture_basisu 纹理可回退到 texture.source
+      LOGW("Failed to decode KTX2 image %d (%s): %s", index,
+           model.images[index].name.c_str(), result.second.c_str());
+      continue;
+    }
+    if (!result.first) {
+      LOGE("Failed to decode image %d (%s): %s", index,
+           model.images[index].name.c_str(), result.second.c_str());
+      success = false;
+      continue;
+    }
+    out[index] = std::move(result.first);
+  }
+
+  // 编码数据的副本在解码后不再需要
+  images.clear();
+  return success;
+}
+
+std::shared_ptr<ImageData>
+GltfImageDecoder::decode(const uint8_t *data, size_t size,
+                         std::string &error) {
+  if (!data || size == 0 || size > static_cast<size_t>(INT_MAX)) {
+    error = "empty or oversized image data";
+    return nullptr;
+  }
+
+  if (KtxTextureDecoder::isKtx2(data, size)) {
+    return KtxTextureDecoder::decode(data, size, error);
+  }
+
+  // 按文件中的通道数解码, 16 位图像由 stb 转为 8 位
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  stbi_uc *decoded = stbi_load_from_memory(data, static_cast<int>(size),
+                                           &width, &height, &channels, 0);
+  if (!decoded) {
+    const char *reason = stbi_failure_reason();
+    error = reason ? reason : "unknown image format";
+    return nullptr;
+  }
+  std::shared_ptr<const uint8_t> pixels(decoded, stbi_image_free);
+
+  const size_t pixelCount = static_cast<size_t>(width) * height;
+  if (channels == 4) {
+    return std::make_shared<BasicImageData>(width, height, 4,
+                                            std::move(pixels),
+                                            pixelCount * 4);
+  }
+
+  std::shared_ptr<uint8_t> rgba(new uint8_t[pixelCount * 4],
+                                std::default_delete<uint8_t[]>());
+  if (!pixel::expandToRgba(pixels.get(), channels, rgba.get(), pixelCount)) {
+    error = "unsupported channel count " + std::to_string(channels);
+    return nullptr;
+  }
+  return std::make_shared<BasicImageData>(width, height, 4, std::move(rgba),
+                                          pixelCount * 4);
+}
+
+} // namespace digitalhumans
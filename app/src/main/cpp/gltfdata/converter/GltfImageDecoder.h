@@ -0,0 +1,84 @@
+//
+// Created by vincentsyan on 2025/9/27.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFIMAGEDECODER_H
+#define LIGHTDIGITALHUMAN_GLTFIMAGEDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "tiny_gltf.h"
+
+namespace digitalhumans {
+
+class ImageData;
+
+/**
+ * @brief glTF 图像并行解码器
+ *
+ * 安装到 tinygltf 后, 解析过程中只记录每张图像的编码数据而不解码;
+ * 解析完成后由 decodeAll 在共享线程池中每张图像一个任务并行解码。
+ * 解码结果统一为 RGBA8（与 tinygltf 默认行为一致）,
+ * 四通道图像直接接管 stb 分配的内存, 其余通道数经 pixel::expandToRgba 展开。
+ * KTX2 图像交给 KtxTextureDecoder 转码为设备支持的压缩格式。
+ */
+class GltfImageDecoder {
+ public:
+  /**
+   * @brief 将解码器设为 loader 的图像加载回调, 解码器需在解析期间保持存活
+   */
+  void install(tinygltf::TinyGLTF &loader);
+
+  /**
+   * @brief 登记位于外部内存中的编码数据（如映射的 GLB BIN 块）
+   *
+   * 该图像在解析时传入的数据（占位 URI）将被忽略, 解码直接读取 data,
+   * data 需在 decodeAll 返回前保持有效。
+   */
+  void setExternalSource(int imageIndex, const uint8_t *data, size_t size);
+
+  /**
+   * @brief 并行解码解析过程中记录的全部图像
+   * @param model 解析完成的模型, 用于定位引用 bufferView 的图像数据
+   * @param out 按图像索引输出的解码结果, 未记录的图像为 nullptr
+   * @return 任一图像解码失败时返回 false
+   */
+  bool decodeAll(const tinygltf::Model &model,
+                 std::vector<std::shared_ptr<ImageData>> &out);
+
+  /**
+   * @brief 解码单张 PNG/JPEG 图像为 RGBA8, KTX2 图像转码为 GPU 格式
+   * @param error 失败原因
+   * @return 失败返回 nullptr
+   */
+  static std::shared_ptr<ImageData> decode(const uint8_t *data, size_t size,
+                                           std::string &error);
+
+  size_t getPendingCount() const { return images.size(); }
+
+ private:
+  /**
+   * @brief 一张图像的编码数据来源
+   */
+  struct EncodedImage {
+    const uint8_t *data = nullptr;  ///< 外部数据（setExternalSource）
+    size_t size = 0;
+    int bufferView = -1;            ///< 引用模型 buffer, 解析完成后再定位
+    std::vector<uint8_t> storage;   ///< data URI 或外部文件内容的副本
+  };
+
+  static bool deferImage(tinygltf::Image *image, const int imageIndex,
+                         std::string *err, std::string *warn, int reqWidth,
+                         int reqHeight, const unsigned char *bytes, int size,
+                         void *userData);
+
+  std::unordered_map<int, EncodedImage> images;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFIMAGEDECODER_H
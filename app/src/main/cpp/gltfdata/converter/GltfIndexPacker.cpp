@@ -0,0 +1,177 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#include "GltfIndexPacker.h"
+#include <GLES3/gl3.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include "../Gltf.h"
+#include "../GltfAccessor.h"
+#include "../GltfPrimitive.h"
+#include "../../utils/ComponentConvert.h"
+#include "../../utils/ContentHash.h"
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+/**
+ * @brief 顶点的全部属性与变形目标按顺序拼接成一行
+ */
+bool gatherVertexRows(const Gltf &gltf, const GltfPrimitive &primitive,
+                      std::vector<uint8_t> &rows, size_t &rowSize,
+                      size_t &vertexCount) {
+  std::vector<GltfAccessorView> views;
+  std::vector<const std::map<std::string, int> *> streams{
+      &primitive.getAttributes()};
+  for (const auto &target: primitive.getTargets()) {
+    streams.push_back(&target);
+  }
+  const auto &accessors = gltf.getAccessors();
+  vertexCount = 0;
+  rowSize = 0;
+  for (const auto *stream: streams) {
+    for (const auto &[_, index]: *stream) {
+      if (index < 0 || index >= static_cast<int>(accessors.size()) ||
+          !accessors[index]) {
+        return false;
+      }
+      GltfAccessorView view = accessors[index]->getView(gltf);
+      if (view.empty() || (vertexCount != 0 && view.count != vertexCount)) {
+        return false;
+      }
+      vertexCount = view.count;
+      rowSize += view.elementSize();
+      views.push_back(view);
+    }
+  }
+  if (views.empty()) {
+    return false;
+  }
+
+  rows.resize(vertexCount * rowSize);
+  size_t column = 0;
+  for (const auto &view: views) {
+    const size_t elementSize = view.elementSize();
+    for (size_t v = 0; v < vertexCount; ++v) {
+      std::memcpy(rows.data() + v * rowSize + column,
+                  view.data + v * view.byteStride, elementSize);
+    }
+    column += elementSize;
+  }
+  return true;
+}
+
+} // namespace
+
+bool GltfIndexPacker::narrow(const Gltf &gltf, GltfAccessor &accessor) {
+  const int componentType = accessor.getComponentType().value_or(0);
+  if (componentType != GL_UNSIGNED_BYTE && componentType != GL_UNSIGNED_INT) {
+    return false;
+  }
+  const size_t count = static_cast<size_t>(accessor.getCount().value_or(0));
+  auto [data, size] = accessor.getDeinterlacedView(gltf);
+  if (!data || count == 0 || size < count * accessor.getComponentSize()) {
+    return false;
+  }
+  std::vector<uint32_t> indices(count);
+  if (!component::widenIndices(data, componentType, indices.data(), count) ||
+      *std::max_element(indices.begin(), indices.end()) > kMaxShortIndex) {
+    return false;
+  }
+
+  std::vector<uint8_t> narrowed(count * sizeof(uint16_t));
+  auto *dst = reinterpret_cast<uint16_t *>(narrowed.data());
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = static_cast<uint16_t>(indices[i]);
+  }
+  accessor.setComponentType(GL_UNSIGNED_SHORT);
+  accessor.setDecodedData(std::move(narrowed));
+  // 边界值与组件类型无关, 保留
+  return true;
+}
+
+std::vector<uint32_t>
+GltfIndexPacker::generate(const Gltf &gltf, const GltfPrimitive &primitive) {
+  std::vector<uint8_t> rows;
+  size_t rowSize = 0;
+  size_t vertexCount = 0;
+  if (!gatherVertexRows(gltf, primitive, rows, rowSize, vertexCount)) {
+    return {};
+  }
+
+  // 开放寻址哈希表: 槽位记录第一次出现的顶点
+  size_t capacity = 1;
+  while (capacity < vertexCount * 2) {
+    capacity <<= 1;
+  }
+  std::vector<uint32_t> table(capacity, kEmptySlot);
+  std::vector<uint32_t> indices(vertexCount);
+  size_t unique = 0;
+  for (size_t v = 0; v < vertexCount; ++v) {
+    const uint8_t *row = rows.data() + v * rowSize;
+    size_t slot = hash::hashBytes(row, rowSize) & (capacity - 1);
+    while (table[slot] != kEmptySlot &&
+        std::memcmp(rows.data() + table[slot] * rowSize, row, rowSize) != 0) {
+      slot = (slot + 1) & (capacity - 1);
+    }
+    if (table[slot] == kEmptySlot) {
+      table[slot] = static_cast<uint32_t>(v);
+      ++unique;
+    }
+    indices[v] = table[slot];
+  }
+  if (unique == vertexCount) {
+    return {};
+  }
+  return indices;
+}
+
+std::vector<GltfIndexPacker::Chunk>
+GltfIndexPacker::split(const std::vector<uint32_t> &indices,
+                       size_t vertexCount) {
+  std::vector<Chunk> chunks;
+  if (indices.size() % 3 != 0) {
+    return chunks;
+  }
+  // 顶点在当前块中的序号, 块号不同即视为未加入
+  std::vector<uint32_t> localIndex(vertexCount, 0);
+  std::vector<uint32_t> localChunk(vertexCount, UINT32_MAX);
+  for (size_t t = 0; t < indices.size(); t += 3) {
+    const uint32_t *triangle = indices.data() + t;
+    if (triangle[0] >= vertexCount || triangle[1] >= vertexCount ||
+        triangle[2] >= vertexCount) {
+      return {};
+    }
+    size_t added = 0;
+    if (!chunks.empty()) {
+      const auto current = static_cast<uint32_t>(chunks.size() - 1);
+      for (int k = 0; k < 3; ++k) {
+        added += localChunk[triangle[k]] != current ? 1 : 0;
+      }
+    }
+    if (chunks.empty() ||
+        chunks.back().vertices.size() + added > kMaxShortVertices) {
+      chunks.emplace_back();
+    }
+    const auto current = static_cast<uint32_t>(chunks.size() - 1);
+    auto &chunk = chunks.back();
+    for (int k = 0; k < 3; ++k) {
+      const uint32_t v = triangle[k];
+      if (localChunk[v] != current) {
+        localChunk[v] = current;
+        localIndex[v] = static_cast<uint32_t>(chunk.vertices.size());
+        chunk.vertices.push_back(v);
+      }
+      chunk.indices.push_back(static_cast<uint16_t>(localIndex[v]));
+    }
+  }
+  return chunks;
+}
+
+} // namespace digitalhumans
@@ -0,0 +1,75 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFINDEXPACKER_H
+#define LIGHTDIGITALHUMAN_GLTFINDEXPACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace digitalhumans {
+
+class Gltf;
+
+class GltfAccessor;
+
+class GltfPrimitive;
+
+/**
+ * @brief 索引存储的转换统计
+ */
+struct GltfIndexPackerStats {
+  size_t narrowed = 0;     ///< 改写为 16 位的索引访问器数
+  size_t generated = 0;    ///< 生成了索引的无索引图元数
+  size_t split = 0;        ///< 切分为多个 16 位图元的图元数
+  size_t bytesBefore = 0;  ///< 改写前的索引字节数
+  size_t bytesAfter = 0;   ///< 改写后的索引字节数
+};
+
+/**
+ * @brief 加载时的索引存储转换, 使绘制尽量使用 16 位索引
+ *
+ * 16 位索引占用的带宽与内存是 32 位的一半, 部分移动 GPU 对 8 位索引走转换路径,
+ * 因此 8/32 位索引在值域允许时统一改写为 16 位。0xFFFF 保留给图元重启
+ * （GL_PRIMITIVE_RESTART_FIXED_INDEX）, 改写后的索引不会出现该值。
+ * 只访问 CPU 数据, 结果写入访问器的解码数据。
+ */
+class GltfIndexPacker {
+ public:
+  static constexpr uint32_t kMaxShortIndex = 0xFFFE;
+  static constexpr size_t kMaxShortVertices = kMaxShortIndex + 1;
+
+  /**
+   * @brief 16 位索引能表示全部索引时改写访问器
+   * @return 改写了访问器时返回 true
+   */
+  static bool narrow(const Gltf &gltf, GltfAccessor &accessor);
+
+  /**
+   * @brief 为无索引图元生成索引, 属性与变形目标完全相同的顶点共用一个索引,
+   * 使顶点缓存生效。顶点数据保持不变
+   * @return 没有重复顶点或数据无效时返回空
+   */
+  static std::vector<uint32_t> generate(const Gltf &gltf,
+                                        const GltfPrimitive &primitive);
+
+  /**
+   * @brief 超出 16 位范围的三角形列表按三角形顺序切分后的一块
+   */
+  struct Chunk {
+    std::vector<uint32_t> vertices;  ///< 块内顶点对应的原顶点序号
+    std::vector<uint16_t> indices;   ///< 块内索引
+  };
+
+  /**
+   * @brief 把三角形列表切分为每块最多 kMaxShortVertices 个顶点的块
+   */
+  static std::vector<Chunk> split(const std::vector<uint32_t> &indices,
+                                  size_t vertexCount);
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFINDEXPACKER_H
@@ -0,0 +1,94 @@
+//
+// Created by vincentsyan on 2025/9/26.
+//
+
+#include "GltfLoadTask.h"
+#include <chrono>
+#include "../Gltf.h"
+#include "../GltfResidency.h"
+#include "../../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+GltfLoadTask::GltfLoadTask(std::string name) : name(std::move(name)) {}
+
+GltfLoadTask::~GltfLoadTask() {
+  if (conversion.valid()) {
+    conversion.wait();
+  }
+}
+
+void GltfLoadTask::start(Producer producer) {
+  setStage(LoadStage::PARSING, 0.0f);
+  conversion = std::async(std::launch::async, [this, producer]() {
+    try {
+      return producer(*this);
+    } catch (const std::exception &e) {
+      LOGE("Async load of %s failed: %s", name.c_str(), e.what());
+    } catch (...) {
+      LOGE("Async load of %s failed", name.c_str());
+    }
+    return std::shared_ptr<Gltf>();
+  });
+}
+
+bool GltfLoadTask::update(const std::shared_ptr<GltfOpenGLContext> &context,
+                          double budgetMs) {
+  LoadStage current = stage.load();
+  if (current == LoadStage::READY) {
+    return true;
+  }
+  if (current == LoadStage::FAILED) {
+    return false;
+  }
+
+  if (!gltf) {
+    if (!conversion.valid() ||
+        conversion.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready) {
+      return false;
+    }
+    gltf = conversion.get();
+    if (!gltf) {
+      LOGE("Failed to load model: %s", name.c_str());
+      setStage(LoadStage::FAILED, -1.0f);
+      return false;
+    }
+    uploads.enqueueGltf(gltf, context);
+    setStage(LoadStage::UPLOADING, kWorkerProgressWeight);
+    // 本帧剩余时间交给上传
+  }
+
+  bool done = uploads.process(budgetMs);
+  if (!done) {
+    setStage(LoadStage::UPLOADING,
+             kWorkerProgressWeight +
+                 (1.0f - kWorkerProgressWeight) * uploads.getProgress());
+    return false;
+  }
+
+  // 全部图元已上传, 释放只用于上传的 CPU 数据
+  GltfResidency::releaseUploaded(*gltf);
+  LOGI("Model ready: %s (%zu upload tasks)", name.c_str(),
+       uploads.getTotalCount());
+  setStage(LoadStage::READY, 1.0f);
+  return true;
+}
+
+void GltfLoadTask::setStage(LoadStage newStage, float newProgress) {
+  progress.store(newProgress);
+  stage.store(newStage);
+}
+
+float GltfLoadTask::getProgress() const {
+  if (stage.load() == LoadStage::FAILED) {
+    return -1.0f;
+  }
+  return progress.load();
+}
+
+std::shared_ptr<Gltf> GltfLoadTask::getGltf() const {
+  return stage.load() == LoadStage::READY ? gltf : nullptr;
+}
+
+} // namespace digitalhumans
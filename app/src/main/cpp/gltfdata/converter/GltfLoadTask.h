@@ -0,0 +1,105 @@
+//
+// Created by vincentsyan on 2025/9/26.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFLOADTASK_H
+#define LIGHTDIGITALHUMAN_GLTFLOADTASK_H
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include "../GltfUploadQueue.h"
+
+namespace digitalhumans {
+
+class Gltf;
+
+class GltfOpenGLContext;
+
+/**
+ * @brief 异步加载阶段
+ */
+enum class LoadStage {
+  PARSING,     ///< 工作线程: 读取文件、解析 glTF、解码图像
+  CONVERTING,  ///< 工作线程: 转换为 Gltf（不调用 GL）
+  UPLOADING,   ///< 渲染线程: 分帧上传 GPU 资源
+  READY,       ///< 全部完成, 可替换到 GltfState
+  FAILED       ///< 加载失败
+};
+
+/**
+ * @brief 异步模型加载任务
+ *
+ * 解析、解码与转换在工作线程执行; 转换完成后由渲染线程调用 update()
+ * 在每帧时间预算内完成 GPU 上传。进度可在任意线程查询。
+ */
+class GltfLoadTask {
+ public:
+  using Producer = std::function<std::shared_ptr<Gltf>(GltfLoadTask &)>;
+
+  explicit GltfLoadTask(std::string name);
+
+  /**
+   * @brief 析构时等待工作线程结束
+   */
+  ~GltfLoadTask();
+
+  GltfLoadTask(const GltfLoadTask &) = delete;
+  GltfLoadTask &operator=(const GltfLoadTask &) = delete;
+
+  /**
+   * @brief 在工作线程中启动解析与转换
+   * @param producer 返回以 deferGlInit 方式转换的 Gltf, 失败返回 nullptr
+   */
+  void start(Producer producer);
+
+  /**
+   * @brief 渲染线程每帧调用, 推进 GPU 上传
+   * @param context OpenGL 上下文封装
+   * @param budgetMs 本帧上传时间预算（毫秒）
+   * @return 是否已进入 READY 状态
+   */
+  bool update(const std::shared_ptr<GltfOpenGLContext> &context,
+              double budgetMs);
+
+  /**
+   * @brief 工作线程报告阶段与进度
+   */
+  void setStage(LoadStage stage, float progress);
+
+  LoadStage getStage() const { return stage.load(); }
+
+  /**
+   * @brief 加载进度 [0, 1], 失败时返回 -1
+   */
+  float getProgress() const;
+
+  bool isFinished() const {
+    LoadStage current = stage.load();
+    return current == LoadStage::READY || current == LoadStage::FAILED;
+  }
+
+  /**
+   * @brief 加载完成的模型, READY 之前返回 nullptr
+   */
+  std::shared_ptr<Gltf> getGltf() const;
+
+  const std::string &getName() const { return name; }
+
+  // 工作线程阶段在总进度中的占比, 其余为 GPU 上传
+  static constexpr float kWorkerProgressWeight = 0.6f;
+
+ private:
+  std::string name;
+  std::atomic<LoadStage> stage{LoadStage::PARSING};
+  std::atomic<float> progress{0.0f};
+  std::future<std::shared_ptr<Gltf>> conversion;
+  std::shared_ptr<Gltf> gltf;
+  GltfUploadQueue uploads;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFLOADTASK_H
@@ -8,79 +8,219 @@
 
 #include <algorithm>
 #include <cstddef>
-#include <android/asset_manager.h>
-#include <__filesystem/operations.h>
+#include <filesystem>
 #include "../../../engine/Engine.h"
 #include "../GltfConverter.h"
 #include "../GltfState.h"
+#include "../GltfBuffer.h"
+#include "GltfImageDecoder.h"
+#include "GltfMeshoptDecoder.h"
+#include "../../utils/ContentHash.h"
 #include "../../utils/LogUtils.h"
+#include "../../utils/MappedFile.h"
+#include "json.hpp"
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace digitalhumans {
-bool GltfLoader::loadGltfFromAssets(AAssetManager *assetManager,
-                                    const std::string &filename,
-                                    Engine &outAssetData) {
 
-  std::lock_guard<std::mutex> lock(modelsMutex);
-  auto it = loadedModels.find(filename);
-  if (it != loadedModels.end()) {
-    auto gltf = GltfConverter::convert(*it->second, outAssetData, "");
-    outAssetData.state->setGltf(gltf);
-    return true;
-  }
-  AAsset *asset =
-      AAssetManager_open(assetManager, filename.c_str(), AASSET_MODE_STREAMING);
-  if (!asset) {
+/**
+ * @brief GLB 文件中 JSON 块与 BIN 块的位置
+ */
+struct GlbChunks {
+  const uint8_t *json = nullptr;
+  size_t jsonSize = 0;
+  const uint8_t *bin = nullptr;
+  size_t binSize = 0;
+};
+
+namespace {
+
+constexpr uint32_t kGlbMagic = 0x46546C67;      // "glTF"
+constexpr uint32_t kGlbChunkJson = 0x4E4F534A;  // "JSON"
+constexpr uint32_t kGlbChunkBin = 0x004E4942;   // "BIN\0"
+constexpr size_t kGlbHeaderSize = 12;
+constexpr size_t kGlbChunkHeaderSize = 8;
+
+// tinygltf 不接受空的 data URI, 用 1 字节的占位数据代替 BIN 块引用
+const char *const kPlaceholderBufferUri =
+    "data:application/octet-stream;base64,AA==";
+const char *const kPlaceholderImageUri = "data:image/png;base64,AA==";
+
+/**
+ * @brief 引用 BIN 块的图像, 解析后需还原的字段
+ */
+struct MappedImage {
+  int bufferView = -1;
+  std::string mimeType;
+};
+
+using MappedImageTable = std::unordered_map<int, MappedImage>;
+
+uint32_t readLE32(const uint8_t *data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+bool isGlbData(const uint8_t *data, size_t size) {
+  return size >= kGlbHeaderSize + kGlbChunkHeaderSize &&
+      readLE32(data) == kGlbMagic;
+}
+
+bool parseGlbChunks(const uint8_t *data, size_t size, const std::string &name,
+                    GlbChunks &out) {
+  if (!isGlbData(data, size)) {
+    LOGE("不是有效的GLB文件: %s", name.c_str());
     return false;
   }
-
-  size_t length = AAsset_getLength(asset);
-  if (length == 0) {
-    AAsset_close(asset);
+  if (readLE32(data + 4) != 2) {
+    LOGE("不支持的GLB版本: %u", readLE32(data + 4));
     return false;
   }
+  size_t totalSize = std::min<size_t>(readLE32(data + 8), size);
 
-  std::vector<uint8_t> buffer(length);
-  int bytesRead = AAsset_read(asset, buffer.data(), length);
-  AAsset_close(asset);
+  size_t offset = kGlbHeaderSize;
+  while (offset + kGlbChunkHeaderSize <= totalSize) {
+    size_t chunkSize = readLE32(data + offset);
+    uint32_t chunkType = readLE32(data + offset + 4);
+    offset += kGlbChunkHeaderSize;
+    if (chunkSize > totalSize - offset) {
+      LOGE("GLB块长度超出文件大小: %zu", chunkSize);
+      return false;
+    }
+    if (chunkType == kGlbChunkJson && !out.json) {
+      out.json = data + offset;
+      out.jsonSize = chunkSize;
+    } else if (chunkType == kGlbChunkBin && !out.bin) {
+      out.bin = data + offset;
+      out.binSize = chunkSize;
+    }
+    // 块按 4 字节对齐
+    offset += (chunkSize + 3) & ~static_cast<size_t>(3);
+  }
 
-  if (bytesRead != static_cast<int>(length)) {
+  if (!out.json) {
+    LOGE("GLB缺少JSON块: %s", name.c_str());
     return false;
   }
+  return true;
+}
 
-  auto model = std::make_shared<tinygltf::Model>();
-  tinygltf::TinyGLTF loader;
-  std::string err;
-  std::string warn;
-  bool success = loader.LoadBinaryFromMemory(model.get(), &err, &warn,
-                                             buffer.data(), buffer.size());
+/**
+ * @brief 是否为 EXT_meshopt_compression 的回退 buffer
+ */
+bool isMeshoptFallback(const nlohmann::json &buffer) {
+  auto extensions = buffer.find("extensions");
+  if (extensions == buffer.end() || !extensions->is_object()) {
+    return false;
+  }
+  auto extension = extensions->find(GltfMeshoptDecoder::kExtensionName);
+  return extension != extensions->end() && extension->is_object() &&
+      extension->value("fallback", false);
+}
 
-  if (!warn.empty()) {
-    LOGW("GLTF warn: %s", warn.c_str());
+/**
+ * @brief 没有 uri 的 meshopt 回退 buffer 不含数据（GLB 中也不对应 BIN 块）,
+ * 替换为占位 data URI 以通过 tinygltf 的检查, 解析后由 clearPlaceholderBuffers 清空
+ * @return 每个 buffer 是否被替换
+ */
+std::vector<bool> patchFallbackBuffers(nlohmann::json &document) {
+  std::vector<bool> patched;
+  auto buffersIt = document.find("buffers");
+  if (buffersIt == document.end() || !buffersIt->is_array()) {
+    return patched;
   }
-  if (!err.empty()) {
-    LOGE("GLTF error: %s", err.c_str());
+  patched.resize(buffersIt->size(), false);
+  for (size_t i = 0; i < buffersIt->size(); ++i) {
+    auto &buffer = (*buffersIt)[i];
+    if (buffer.is_object() && !buffer.contains("uri") &&
+        isMeshoptFallback(buffer)) {
+      buffer["uri"] = kPlaceholderBufferUri;
+      buffer["byteLength"] = 1;
+      patched[i] = true;
+    }
   }
-  if (!success) {
+  return patched;
+}
+
+void clearPlaceholderBuffers(tinygltf::Model &model,
+                             const std::vector<bool> &placeholders) {
+  for (size_t i = 0; i < placeholders.size() && i < model.buffers.size();
+       ++i) {
+    if (placeholders[i]) {
+      model.buffers[i].uri.clear();
+      std::vector<unsigned char>().swap(model.buffers[i].data);
+    }
+  }
+}
+
+/**
+ * @brief 解析 .gltf 文件, 其中没有 uri 的 meshopt 回退 buffer 先替换为占位数据
+ */
+bool loadAsciiFile(tinygltf::TinyGLTF &loader, tinygltf::Model &model,
+                   std::string &error, std::string &warning,
+                   const std::string &filePath) {
+  std::ifstream file(filePath, std::ios::binary);
+  if (!file) {
+    error = "无法读取文件: " + filePath;
     return false;
   }
+  std::string text((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+  const std::string baseDir =
+      std::filesystem::path(filePath).parent_path().string();
 
-  try {
-    auto gltf = GltfConverter::convert(*model, outAssetData, "");
-    if (!gltf) {
-      return false;
+  std::vector<bool> placeholders;
+  if (text.find(GltfMeshoptDecoder::kExtensionName) != std::string::npos) {
+    nlohmann::json document = nlohmann::json::parse(text, nullptr, false);
+    if (!document.is_discarded() && document.is_object()) {
+      placeholders = patchFallbackBuffers(document);
+      if (std::find(placeholders.begin(), placeholders.end(), true) !=
+          placeholders.end()) {
+        text = document.dump();
+      }
     }
-    loadedModels[filename] = model;
-    outAssetData.state->setGltf(gltf);
-    return true;
-  } catch (const std::exception &e) {
+  }
+  if (!loader.LoadASCIIFromString(&model, &error, &warning, text.c_str(),
+                                  static_cast<unsigned int>(text.size()),
+                                  baseDir)) {
     return false;
-  } catch (...) {
+  }
+  clearPlaceholderBuffers(model, placeholders);
+  return true;
+}
+
+} // namespace
+#ifdef __ANDROID__
+bool GltfLoader::loadGltfFromAssets(AAssetManager *assetManager,
+                                    const std::string &filename,
+                                    Engine &outAssetData) {
+  AndroidAssetProvider provider(assetManager);
+  return loadGltfFromProvider(provider, filename, outAssetData);
+}
+#endif
+
+/**
+ * @brief 通过资源读取接口加载GLB模型
+ * @param provider 资源读取接口（APK assets 或主机文件系统）
+ * @param filename 资源相对路径
+ * @param outAssetData 输出的引擎对象
+ * @return 是否加载成功
+ */
+bool GltfLoader::loadGltfFromProvider(const AssetProvider &provider,
+                                      const std::string &filename,
+                                      Engine &outAssetData) {
+  auto gltf = readFromProvider(provider, filename, outAssetData, nullptr);
+  if (!gltf) {
     return false;
   }
+  outAssetData.state->setGltf(gltf);
+  return true;
 }
 
 /**
@@ -94,42 +234,496 @@ GltfLoader::loadFromFile(const std::string &filePath, Engine &outAssetData) {
   if (!validateFile(filePath)) {
     return false;
   }
-  auto model = std::make_shared<tinygltf::Model>();
+  auto gltf = readFromFile(filePath, outAssetData, nullptr);
+  if (!gltf) {
+    return false;
+  }
+  outAssetData.state->setGltf(gltf);
+  return true;
+}
+
+/**
+ * @brief 以内存映射方式加载GLB文件
+ * @param filePath GLB文件完整路径
+ * @param outAssetData 输出的引擎对象
+ * @return 是否加载成功
+ */
+bool
+GltfLoader::loadGlbMapped(const std::string &filePath, Engine &outAssetData) {
+  auto gltf = readGlbMapped(filePath, outAssetData, nullptr, nullptr);
+  if (!gltf) {
+    return false;
+  }
+  outAssetData.state->setGltf(gltf);
+  return true;
+}
+
+/**
+ * @brief 异步加载资源中的模型, 完成后由 Engine 在渲染线程中替换当前模型
+ * @param provider 资源读取接口, 在加载结束前保持存活
+ * @param filename 资源相对路径
+ * @param outAssetData 接收模型的引擎对象
+ * @return 加载任务
+ */
+std::shared_ptr<GltfLoadTask>
+GltfLoader::loadGltfFromProviderAsync(std::shared_ptr<const AssetProvider> provider,
+                                      const std::string &filename,
+                                      Engine &outAssetData) {
+  auto task = std::make_shared<GltfLoadTask>(filename);
+  task->start([this, provider, filename, &outAssetData](GltfLoadTask &task) {
+    return readFromProvider(*provider, filename, outAssetData, &task);
+  });
+  outAssetData.setPendingLoad(task);
+  return task;
+}
+
+/**
+ * @brief 异步加载文件中的模型, 完成后由 Engine 在渲染线程中替换当前模型
+ * @param filePath 模型文件完整路径
+ * @param outAssetData 接收模型的引擎对象
+ * @return 加载任务, 文件无效时返回 nullptr
+ */
+std::shared_ptr<GltfLoadTask>
+GltfLoader::loadFromFileAsync(const std::string &filePath,
+                              Engine &outAssetData) {
+  if (!validateFile(filePath)) {
+    return nullptr;
+  }
+  auto task = std::make_shared<GltfLoadTask>(filePath);
+  task->start([this, filePath, &outAssetData](GltfLoadTask &task) {
+    return readFromFile(filePath, outAssetData, &task);
+  });
+  outAssetData.setPendingLoad(task);
+  return task;
+}
+
+std::shared_ptr<Gltf>
+GltfLoader::readFromProvider(const AssetProvider &provider,
+                             const std::string &filename,
+                             Engine &outAssetData,
+                             GltfLoadTask *task) {
+  std::vector<uint8_t> buffer;
+  if (!provider.readFile(filename, buffer)) {
+    return nullptr;
+  }
+
+  // 转换资源缓存与烘焙文件都按内容识别, 资源被替换后不会复用旧的转换结果
+  GltfCookedSource source;
+  const GltfCookedSource *sourcePtr = nullptr;
+  if (assetCache.getBudget() > 0 || !cookedCacheDir.empty()) {
+    const std::string dir =
+        std::filesystem::path(filename).parent_path().string();
+    source = makeCookedSource(
+        hash::hashBytes(buffer.data(), buffer.size()),
+        [&provider, dir](const std::string &uri, uint64_t &out) {
+          std::vector<uint8_t> data;
+          if (!provider.readFile(dir.empty() ? uri : dir + "/" + uri, data)) {
+            return false;
+          }
+          out = hash::hashBytes(data.data(), data.size());
+          return true;
+        });
+    sourcePtr = &source;
+    if (auto gltf = convertFromCache(filename, source, outAssetData, task)) {
+      return gltf;
+    }
+    if (!cookedCacheDir.empty()) {
+      if (auto gltf = convertFromCooked(filename, source, outAssetData, task)) {
+        return gltf;
+      }
+    }
+  }
+
+  if (isGlbData(buffer.data(), buffer.size())) {
+    // 与映射加载相同只解析 JSON 块, BIN 块由读入的内存直接提供
+    auto data = std::make_shared<std::vector<uint8_t>>(std::move(buffer));
+    GlbChunks chunks;
+    if (!parseGlbChunks(data->data(), data->size(), filename, chunks)) {
+      return nullptr;
+    }
+    return readGlb(chunks, data, filename, "", outAssetData, sourcePtr, task);
+  }
+
+  tinygltf::Model model;
   tinygltf::TinyGLTF loader;
+  GltfImageDecoder decoder;
+  decoder.install(loader);
+  std::string err;
+  std::string warn;
+  bool success = loader.LoadBinaryFromMemory(&model, &err, &warn,
+                                             buffer.data(), buffer.size());
+  // 文件内容已解析进 model, 提前释放
+  std::vector<uint8_t>().swap(buffer);
+
+  if (!warn.empty()) {
+    LOGW("GLTF warn: %s", warn.c_str());
+  }
+  if (!err.empty()) {
+    LOGE("GLTF error: %s", err.c_str());
+  }
+  if (!success) {
+    return nullptr;
+  }
+  return convertAndCache(filename, std::move(model), decoder, outAssetData,
+                         nullptr, sourcePtr, task);
+}
+
+std::shared_ptr<Gltf>
+GltfLoader::readFromFile(const std::string &filePath, Engine &outAssetData,
+                         GltfLoadTask *task) {
+  // 转换资源缓存与烘焙文件都按内容识别, 文件被替换后不会复用旧的转换结果
+  GltfCookedSource source;
+  const GltfCookedSource *sourcePtr = nullptr;
+  uint64_t sourceHash = 0;
+  if ((assetCache.getBudget() > 0 || !cookedCacheDir.empty()) &&
+      hash::hashFile(filePath, sourceHash)) {
+    const auto dir = std::filesystem::path(filePath).parent_path();
+    source = makeCookedSource(
+        sourceHash, [dir](const std::string &uri, uint64_t &out) {
+          return hash::hashFile((dir / uri).string(), out);
+        });
+    sourcePtr = &source;
+    if (auto gltf = convertFromCache(filePath, source, outAssetData, task)) {
+      return gltf;
+    }
+    if (!cookedCacheDir.empty()) {
+      if (auto gltf = convertFromCooked(filePath, source, outAssetData, task)) {
+        return gltf;
+      }
+    }
+  }
+
+  tinygltf::Model model;
+  tinygltf::TinyGLTF loader;
+  GltfImageDecoder decoder;
+  decoder.install(loader);
   std::string error, warning;
   bool success = false;
 
   if (isGlbFile(filePath)) {
-    success =
-        loader.LoadBinaryFromFile(model.get(), &error, &warning, filePath);
-    if (!success) {
-      LOGE("GLTF加载失败: %s", error.c_str());
-      return false;
+    if (useMappedGlb) {
+      if (auto gltf =
+          readGlbMapped(filePath, outAssetData, sourcePtr, task)) {
+        return gltf;
+      }
+      LOGW("GLB映射加载失败, 回退到完整读取: %s", filePath.c_str());
     }
+    success =
+        loader.LoadBinaryFromFile(&model, &error, &warning, filePath);
   } else if (isGltfFile(filePath)) {
-    success = loader.LoadASCIIFromFile(model.get(), &error, &warning, filePath);
+    success = loadAsciiFile(loader, model, error, warning, filePath);
   } else {
     LOGE("不支持的文件格式: %s", filePath.c_str());
-    return false;
+    return nullptr;
+  }
+  if (!warning.empty()) {
+    LOGW("GLTF警告: %s", warning.c_str());
   }
+  if (!success) {
+    LOGE("GLTF加载失败: %s", error.c_str());
+    return nullptr;
+  }
+  return convertAndCache(filePath, std::move(model), decoder, outAssetData,
+                         nullptr, sourcePtr, task);
+}
+
+/**
+ * @brief 以内存映射方式读取GLB文件
+ */
+std::shared_ptr<Gltf>
+GltfLoader::readGlbMapped(const std::string &filePath, Engine &outAssetData,
+                          const GltfCookedSource *source,
+                          GltfLoadTask *task) {
+  auto file = MappedFile::open(filePath);
+  if (!file) {
+    return nullptr;
+  }
+  GlbChunks chunks;
+  if (!parseGlbChunks(file->data(), file->size(), filePath, chunks)) {
+    return nullptr;
+  }
+  return readGlb(chunks, file, filePath,
+                 std::filesystem::path(filePath).parent_path().string(),
+                 outAssetData, source, task);
+}
+
+/**
+ * @brief 读取已定位各块的GLB数据
+ *
+ * 只把JSON块交给 tinygltf 解析: 引用BIN块的 buffer 与 image 先替换为占位
+ * data URI, 解析完成后再还原。图像直接从BIN块解码,
+ * GltfBuffer 通过 GltfBinaryChunk 引用BIN块, 整个加载过程不复制BIN块。
+ * @param owner 持有 chunks 所指内存（映射文件或读入的数据）
+ * @param name 用于日志的文件名
+ * @param baseDir 外部资源的查找目录
+ */
+std::shared_ptr<Gltf>
+GltfLoader::readGlb(const GlbChunks &chunks,
+                    std::shared_ptr<const void> owner,
+                    const std::string &name, const std::string &baseDir,
+                    Engine &outAssetData, const GltfCookedSource *source,
+                    GltfLoadTask *task) {
+  nlohmann::json document = nlohmann::json::parse(
+      chunks.json, chunks.json + chunks.jsonSize, nullptr, false);
+  if (document.is_discarded() || !document.is_object()) {
+    LOGE("GLB JSON块解析失败: %s", name.c_str());
+    return nullptr;
+  }
+
+  // 没有 uri 的 buffer 即 BIN 块（meshopt 回退 buffer 除外）
+  std::vector<bool> isFallbackBuffer = patchFallbackBuffers(document);
+  std::vector<bool> isBinBuffer;
+  auto buffersIt = document.find("buffers");
+  if (buffersIt != document.end() && buffersIt->is_array()) {
+    isBinBuffer.resize(buffersIt->size(), false);
+    for (size_t i = 0; i < buffersIt->size(); ++i) {
+      auto &buffer = (*buffersIt)[i];
+      if (!buffer.is_object() || buffer.contains("uri")) {
+        continue;
+      }
+      size_t byteLength = buffer.value("byteLength", static_cast<size_t>(0));
+      if (!chunks.bin || byteLength > chunks.binSize) {
+        LOGE("GLB BIN块缺失或长度不足: buffer[%zu]", i);
+        return nullptr;
+      }
+      buffer["uri"] = kPlaceholderBufferUri;
+      buffer["byteLength"] = 1;
+      isBinBuffer[i] = true;
+    }
+  }
+
+  GltfImageDecoder decoder;
+  MappedImageTable mappedImages;
+  auto imagesIt = document.find("images");
+  auto viewsIt = document.find("bufferViews");
+  if (imagesIt != document.end() && imagesIt->is_array() &&
+      viewsIt != document.end() && viewsIt->is_array()) {
+    for (size_t i = 0; i < imagesIt->size(); ++i) {
+      auto &image = (*imagesIt)[i];
+      if (!image.is_object() || !image.contains("bufferView") ||
+          !image["bufferView"].is_number_integer()) {
+        continue;
+      }
+      int viewIndex = image["bufferView"].get<int>();
+      if (viewIndex < 0 || viewIndex >= static_cast<int>(viewsIt->size())) {
+        continue;
+      }
+      const auto &view = (*viewsIt)[viewIndex];
+      int bufferIndex = view.value("buffer", -1);
+      if (bufferIndex < 0 || bufferIndex >= static_cast<int>(isBinBuffer.size())
+          || !isBinBuffer[bufferIndex]) {
+        continue;
+      }
+      size_t byteOffset = view.value("byteOffset", static_cast<size_t>(0));
+      size_t byteLength = view.value("byteLength", static_cast<size_t>(0));
+      if (byteOffset + byteLength > chunks.binSize) {
+        LOGE("图像bufferView越界: image[%zu]", i);
+        return nullptr;
+      }
+
+      decoder.setExternalSource(static_cast<int>(i), chunks.bin + byteOffset,
+                                byteLength);
+      MappedImage mapped;
+      mapped.bufferView = viewIndex;
+      mapped.mimeType = image.value("mimeType", std::string());
+      mappedImages[static_cast<int>(i)] = mapped;
+
+      image.erase("bufferView");
+      image.erase("mimeType");
+      image["uri"] = kPlaceholderImageUri;
+    }
+  }
+
+  const std::string json = document.dump();
+  document = nlohmann::json();
+
+  tinygltf::Model model;
+  tinygltf::TinyGLTF loader;
+  decoder.install(loader);
+  std::string error, warning;
+  bool success = loader.LoadASCIIFromString(
+      &model, &error, &warning, json.c_str(),
+      static_cast<unsigned int>(json.size()), baseDir);
   if (!warning.empty()) {
     LOGW("GLTF警告: %s", warning.c_str());
   }
+  if (!success) {
+    LOGE("GLTF加载失败: %s", error.c_str());
+    return nullptr;
+  }
+
+  // 还原占位数据
+  clearPlaceholderBuffers(model, isBinBuffer);
+  clearPlaceholderBuffers(model, isFallbackBuffer);
+  for (const auto &[index, mapped]: mappedImages) {
+    if (index < static_cast<int>(model.images.size())) {
+      auto &image = model.images[index];
+      image.bufferView = mapped.bufferView;
+      image.mimeType = mapped.mimeType;
+      image.uri.clear();
+    }
+  }
+
+  GltfBinaryChunk binChunk;
+  binChunk.owner = std::move(owner);
+  binChunk.data = chunks.bin;
+  binChunk.size = chunks.binSize;
+
+  return convertAndCache(name, std::move(model), decoder, outAssetData,
+                         &binChunk, source, task);
+}
+
+/**
+ * @brief 从转换资源缓存创建模型实例
+ * @param source 当前源文件描述, 与缓存条目记录的内容哈希不一致时丢弃该条目
+ * @return 缓存未命中、条目已失效或创建失败返回 nullptr
+ */
+std::shared_ptr<Gltf>
+GltfLoader::convertFromCache(const std::string &key,
+                             const GltfCookedSource &source,
+                             Engine &outAssetData, GltfLoadTask *task) {
+  auto asset = assetCache.find(key);
+  if (!asset) {
+    return nullptr;
+  }
+  if (asset->sourceHash != source.hash ||
+      !GltfCookedAsset::isCurrent(source, asset->dependencies)) {
+    LOGI("源文件已变化, 丢弃缓存的转换结果: %s", key.c_str());
+    assetCache.erase(key);
+    return nullptr;
+  }
+  if (task) {
+    task->setStage(LoadStage::CONVERTING, 0.3f);
+  }
   try {
-    auto gltf = GltfConverter::convert(*model, outAssetData, "");
-    if (!gltf) {
-      return false;
+    return GltfConverter::convert(*asset, outAssetData, task != nullptr,
+                                  optimizeMeshes, animationCompression);
+  } catch (const std::exception &e) {
+    LOGE("GLTF转换异常: %s", e.what());
+    return nullptr;
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+/**
+ * @brief 生成烘焙文件描述, 文件名由源内容哈希决定
+ * @param hash 源文件内容哈希
+ * @param hashDependency 计算外部资源内容哈希
+ */
+GltfCookedSource GltfLoader::makeCookedSource(
+    uint64_t hash,
+    std::function<bool(const std::string &, uint64_t &)> hashDependency) const {
+  GltfCookedSource source;
+  source.hash = hash;
+  source.cookedPath = (std::filesystem::path(cookedCacheDir) /
+      (hash::toHex(hash) + ".ldhc")).string();
+  source.hashDependency = std::move(hashDependency);
+  source.optimizedMeshes = optimizeMeshes;
+  return source;
+}
+
+/**
+ * @brief 从烘焙文件创建模型实例, 并放入转换资源缓存
+ * @return 烘焙文件不存在或已失效时返回 nullptr
+ */
+std::shared_ptr<Gltf>
+GltfLoader::convertFromCooked(const std::string &key,
+                              const GltfCookedSource &cooked,
+                              Engine &outAssetData,
+                              GltfLoadTask *task) {
+  auto asset = GltfCookedAsset::read(cooked);
+  if (!asset) {
+    return nullptr;
+  }
+  if (task) {
+    task->setStage(LoadStage::CONVERTING, 0.3f);
+  }
+  try {
+    const bool cache = assetCache.getBudget() > 0;
+    std::shared_ptr<const GltfConvertedData> converted;
+    auto gltf = GltfConverter::convert(*asset, outAssetData, task != nullptr,
+                                       optimizeMeshes, animationCompression,
+                                       cache ? &converted : nullptr);
+    if (gltf && cache) {
+      if (converted) {
+        asset->byteSize += converted->byteSize;
+        asset->converted = std::move(converted);
+      }
+      assetCache.insert(key, std::move(asset));
     }
-    loadedModels[filePath] = model;
-    outAssetData.state->setGltf(gltf);
-    return true;
+    return gltf;
+  } catch (const std::exception &e) {
+    LOGE("GLTF转换异常: %s", e.what());
+    return nullptr;
+  } catch (...) {
+    return nullptr;
+  }
+}
 
+/**
+ * @brief 转换模型并把可共享部分放入缓存
+ * @param key 缓存键（文件路径）
+ * @param model 解析得到的模型, 转换后只保留结构描述
+ * @param decoder 解析期间记录了图像编码数据的解码器, 转换前并行解码
+ * @param outAssetData 输出的引擎对象
+ * @param binChunk 映射加载时的 BIN 块, 其余情况为 nullptr
+ * @param source 源文件描述, 非空时转换结果放入缓存, 设置了烘焙目录时同时写入烘焙文件
+ * @param task 异步加载任务, 非空时跳过 GL 初始化并报告进度
+ */
+std::shared_ptr<Gltf>
+GltfLoader::convertAndCache(const std::string &key,
+                            tinygltf::Model &&model,
+                            GltfImageDecoder &decoder,
+                            Engine &outAssetData,
+                            const GltfBinaryChunk *binChunk,
+                            const GltfCookedSource *source,
+                            GltfLoadTask *task) {
+  if (task) {
+    task->setStage(LoadStage::PARSING, 0.2f);
+  }
+  if (!GltfMeshoptDecoder::decodeAll(model, binChunk)) {
+    LOGE("GLTF网格数据解码失败: %s", key.c_str());
+    return nullptr;
+  }
+  std::vector<std::shared_ptr<ImageData>> decodedImages;
+  if (!decoder.decodeAll(model, decodedImages)) {
+    LOGE("GLTF图像解码失败: %s", key.c_str());
+    return nullptr;
+  }
+
+  if (task) {
+    task->setStage(LoadStage::CONVERTING, 0.4f);
+  }
+  try {
+    const bool cache = source && assetCache.getBudget() > 0;
+    std::shared_ptr<const GltfConvertedData> converted;
+    auto gltf = GltfConverter::convert(model, outAssetData, "", binChunk,
+                                       task != nullptr, &decodedImages,
+                                       optimizeMeshes, animationCompression,
+                                       cache ? &converted : nullptr);
+    if (!gltf) {
+      return nullptr;
+    }
+    if (source && !cookedCacheDir.empty()) {
+      GltfCookedAsset::write(*source, model, *gltf);
+    }
+    std::vector<GltfSourceDependency> dependencies;
+    if (cache &&
+        GltfCookedAsset::hashDependencies(*source, model, dependencies)) {
+      auto shared = GltfConverter::createSharedAsset(std::move(model), *gltf,
+                                                     std::move(converted));
+      shared->sourceHash = source->hash;
+      shared->dependencies = std::move(dependencies);
+      assetCache.insert(key, std::move(shared));
+    }
+    return gltf;
   } catch (const std::exception &e) {
-    return false;
+    LOGE("GLTF转换异常: %s", e.what());
+    return nullptr;
   } catch (...) {
-    return false;
+    return nullptr;
   }
-  return true;
 }
 
 /**
@@ -183,8 +777,7 @@ std::string GltfLoader::getFileExtension(const std::string &filePath) {
  * @brief 清理已加载的模型缓存
  */
 void GltfLoader::clearModelCache() {
-  std::lock_guard<std::mutex> lock(modelsMutex);
-  loadedModels.clear();
+  assetCache.clear();
 }
 
 } // digitahuman
\ No newline at end of file
@@ -5,26 +5,102 @@
 #ifndef LIGHTDIGITALHUMAN_GLTFLOADER_H
 #define LIGHTDIGITALHUMAN_GLTFLOADER_H
 
-#include <android/asset_manager.h>
 #include <iostream>
 #include "../../../engine/Engine.h"
+#include "../../utils/AssetProvider.h"
+#include "GltfAssetCache.h"
+#include "GltfCookedAsset.h"
+#include "GltfLoadTask.h"
+#include "../GltfAnimationClip.h"
 #include "tiny_gltf.h"
 
 namespace digitalhumans {
 
+struct GltfBinaryChunk;
+
+struct GlbChunks;
+
+class GltfImageDecoder;
+
+class Gltf;
+
 class GltfLoader {
 
  public:
+#ifdef __ANDROID__
   bool loadGltfFromAssets(AAssetManager *assetManager,
                           const std::string &filename,
                           Engine
                           &outAssetData);
+#endif
+
+  bool loadGltfFromProvider(const AssetProvider &provider,
+                            const std::string &filename,
+                            Engine &outAssetData);
 
   bool loadFromFile(const std::string &filePath, Engine &outAssetData);
 
+  /**
+   * @brief 以内存映射方式加载GLB文件（零拷贝）
+   * 只解析JSON块, BIN块不复制, GltfBuffer 直接引用映射内存
+   */
+  bool loadGlbMapped(const std::string &filePath, Engine &outAssetData);
+
+  /**
+   * @brief 异步加载: 解析与转换在工作线程执行, GPU 上传由 Engine 分帧完成,
+   * 完成后在渲染线程中替换当前模型
+   */
+  std::shared_ptr<GltfLoadTask>
+  loadGltfFromProviderAsync(std::shared_ptr<const AssetProvider> provider,
+                            const std::string &filename,
+                            Engine &outAssetData);
+
+  std::shared_ptr<GltfLoadTask> loadFromFileAsync(const std::string &filePath,
+                                                  Engine &outAssetData);
+
+  /**
+   * @brief 设置 loadFromFile 加载GLB时是否使用内存映射（默认开启）
+   */
+  void setUseMappedGlb(bool enabled) { useMappedGlb = enabled; }
+
 
   void clearModelCache();
 
+  /**
+   * @brief 设置转换资源缓存的字节预算, 0 表示不缓存
+   */
+  void setCacheBudget(size_t budgetBytes) { assetCache.setBudget(budgetBytes); }
+
+  const GltfAssetCache &getAssetCache() const { return assetCache; }
+
+  /**
+   * @brief 设置烘焙文件目录, 首次加载后把转换结果写入该目录,
+   * 之后加载内容相同的模型时直接映射烘焙文件。空字符串表示不使用烘焙（默认）
+   */
+  void setCookedCacheDir(const std::string &dir) { cookedCacheDir = dir; }
+
+  const std::string &getCookedCacheDir() const { return cookedCacheDir; }
+
+  /**
+   * @brief 设置转换时是否重排三角形与顶点以提高顶点缓存命中率、减少过度绘制（默认关闭）,
+   * 开启时优化结果一并写入烘焙文件
+   */
+  void setOptimizeMeshes(bool enabled) { optimizeMeshes = enabled; }
+
+  bool getOptimizeMeshes() const { return optimizeMeshes; }
+
+  /**
+   * @brief 设置动画片段的关键帧压缩参数（默认开启）, 压缩在每次转换时进行,
+   * 不写入烘焙文件
+   */
+  void setAnimationCompression(const GltfAnimationCompression &compression) {
+    animationCompression = compression;
+  }
+
+  const GltfAnimationCompression &getAnimationCompression() const {
+    return animationCompression;
+  }
+
  private:
 
   bool validateFile(const std::string &filePath);
@@ -35,9 +111,55 @@ class GltfLoader {
 
   std::string getFileExtension(const std::string &filePath);
 
-  std::unordered_map<std::string, std::shared_ptr<tinygltf::Model>>
-      loadedModels;
-  std::mutex modelsMutex;
+  std::shared_ptr<Gltf> readFromProvider(const AssetProvider &provider,
+                                         const std::string &filename,
+                                         Engine &outAssetData,
+                                         GltfLoadTask *task);
+
+  std::shared_ptr<Gltf> readFromFile(const std::string &filePath,
+                                     Engine &outAssetData,
+                                     GltfLoadTask *task);
+
+  std::shared_ptr<Gltf> readGlbMapped(const std::string &filePath,
+                                      Engine &outAssetData,
+                                      const GltfCookedSource *source,
+                                      GltfLoadTask *task);
+
+  std::shared_ptr<Gltf> readGlb(const GlbChunks &chunks,
+                                std::shared_ptr<const void> owner,
+                                const std::string &name,
+                                const std::string &baseDir,
+                                Engine &outAssetData,
+                                const GltfCookedSource *source,
+                                GltfLoadTask *task);
+
+  GltfCookedSource makeCookedSource(
+      uint64_t hash,
+      std::function<bool(const std::string &, uint64_t &)> hashDependency) const;
+
+  std::shared_ptr<Gltf> convertFromCooked(const std::string &key,
+                                          const GltfCookedSource &cooked,
+                                          Engine &outAssetData,
+                                          GltfLoadTask *task);
+
+  std::shared_ptr<Gltf> convertFromCache(const std::string &key,
+                                         const GltfCookedSource &source,
+                                         Engine &outAssetData,
+                                         GltfLoadTask *task);
+
+  std::shared_ptr<Gltf> convertAndCache(const std::string &key,
+                                        tinygltf::Model &&model,
+                                        GltfImageDecoder &decoder,
+                                        Engine &outAssetData,
+                                        const GltfBinaryChunk *binChunk,
+                                        const GltfCookedSource *source,
+                                        GltfLoadTask *task);
+
+  GltfAssetCache assetCache;
+  bool useMappedGlb = true;
+  std::string cookedCacheDir;
+  bool optimizeMeshes = false;
+  GltfAnimationCompression animationCompression;
 
 };
 
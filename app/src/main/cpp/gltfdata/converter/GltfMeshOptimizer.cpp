@@ -0,0 +1,509 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#include "GltfMeshOptimizer.h"
+#include <GLES3/gl3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include "../Gltf.h"
+#include "../GltfAccessor.h"
+#include "../GltfMaterial.h"
+#include "../GltfPrimitive.h"
+#include "../../utils/ComponentConvert.h"
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr int kModeTriangles = 4;
+
+/**
+ * @brief 读取索引并转换为 uint32
+ */
+bool readIndices(const Gltf &gltf, GltfAccessor &accessor,
+                 std::vector<uint32_t> &indices) {
+  const int componentType = accessor.getComponentType().value_or(0);
+  const size_t count = static_cast<size_t>(accessor.getCount().value_or(0));
+  auto [data, size] = accessor.getDeinterlacedView(gltf);
+  if (!data || count == 0 || size < count * accessor.getComponentSize()) {
+    return false;
+  }
+  indices.resize(count);
+  return component::widenIndices(data, componentType, indices.data(), count);
+}
+
+/**
+ * @brief 读取 POSITION 为 float3
+ */
+bool readPositions(const Gltf &gltf, GltfAccessor &accessor,
+                   std::vector<float> &positions) {
+  const GltfAccessorView view = accessor.getView(gltf);
+  if (view.empty() || view.componentCount != 3) {
+    return false;
+  }
+  const size_t componentCount = view.count * 3;
+  positions.resize(componentCount);
+  if (view.isTightlyPacked()) {
+    return component::toFloat(view.data, view.componentType, view.normalized,
+                              positions.data(), componentCount);
+  }
+  std::vector<uint8_t> packed(view.count * view.elementSize());
+  component::gatherElements(view.data, view.byteStride, view.elementSize(),
+                            packed.data(), view.count);
+  return component::toFloat(packed.data(), view.componentType,
+                            view.normalized, positions.data(), componentCount);
+}
+
+/**
+ * @brief 按映射重排顶点数据, 写入访问器的解码数据（调用方已检查元素数量）
+ */
+void remapVertices(const Gltf &gltf, GltfAccessor &accessor,
+                   const std::vector<uint32_t> &remap) {
+  const GltfAccessorView view = accessor.getView(gltf);
+  const size_t elementSize = view.elementSize();
+  std::vector<uint8_t> data(view.count * elementSize);
+  for (size_t i = 0; i < view.count; ++i) {
+    std::memcpy(data.data() + static_cast<size_t>(remap[i]) * elementSize,
+                view.data + i * view.byteStride, elementSize);
+  }
+  accessor.setDecodedData(std::move(data));
+}
+
+/**
+ * @brief 按访问器的组件类型写回索引
+ */
+void writeIndices(GltfAccessor &accessor, const std::vector<uint32_t> &indices) {
+  const size_t componentSize = accessor.getComponentSize();
+  std::vector<uint8_t> data(indices.size() * componentSize);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    switch (accessor.getComponentType().value_or(0)) {
+      case GL_UNSIGNED_BYTE:
+        data[i] = static_cast<uint8_t>(indices[i]);
+        break;
+      case GL_UNSIGNED_SHORT: {
+        const auto value = static_cast<uint16_t>(indices[i]);
+        std::memcpy(data.data() + i * 2, &value, 2);
+        break;
+      }
+      default:
+        std::memcpy(data.data() + i * 4, &indices[i], 4);
+        break;
+    }
+  }
+  accessor.setDecodedData(std::move(data));
+}
+
+bool usesBlending(const Gltf &gltf, const GltfPrimitive &primitive) {
+  const auto &materials = gltf.getMaterials();
+  auto isBlend = [&materials](int index) {
+    return index >= 0 && index < static_cast<int>(materials.size()) &&
+        materials[index] &&
+        materials[index]->getAlphaMode() == AlphaMode::BLEND;
+  };
+  if (isBlend(primitive.getMaterial().value_or(-1))) {
+    return true;
+  }
+  for (const auto &mapping: primitive.getMappings()) {
+    if (isBlend(mapping.material)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 同一个索引访问器的数据与用法
+ */
+struct IndexList {
+  std::shared_ptr<GltfAccessor> accessor;
+  std::vector<uint32_t> indices;
+  bool reorder = true;  ///< 全部使用者都是不混合的三角形列表
+};
+
+} // namespace
+
+size_t GltfMeshOptimizer::simulateCache(const uint32_t *indices,
+                                        size_t indexCount, size_t vertexCount,
+                                        size_t cacheSize) {
+  // 时间戳只在未命中时递增, 与最近 cacheSize 次写入之内的顶点命中
+  std::vector<size_t> cacheTime(vertexCount, 0);
+  size_t time = cacheSize + 1;
+  size_t misses = 0;
+  for (size_t i = 0; i < indexCount; ++i) {
+    const uint32_t v = indices[i];
+    if (time - cacheTime[v] > cacheSize) {
+      cacheTime[v] = time++;
+      ++misses;
+    }
+  }
+  return misses;
+}
+
+std::vector<uint32_t>
+GltfMeshOptimizer::optimizeVertexCache(const uint32_t *indices,
+                                       size_t indexCount, size_t vertexCount,
+                                       std::vector<uint32_t> *clusters) {
+  const size_t triangleCount = indexCount / 3;
+  std::vector<uint32_t> result;
+  result.reserve(triangleCount * 3);
+  if (clusters) {
+    clusters->clear();
+  }
+  if (triangleCount == 0) {
+    return result;
+  }
+
+  // 顶点 -> 相邻三角形
+  std::vector<uint32_t> offsets(vertexCount + 1, 0);
+  for (size_t i = 0; i < triangleCount * 3; ++i) {
+    ++offsets[indices[i] + 1];
+  }
+  for (size_t v = 0; v < vertexCount; ++v) {
+    offsets[v + 1] += offsets[v];
+  }
+  std::vector<uint32_t> adjacency(triangleCount * 3);
+  std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+  for (size_t t = 0; t < triangleCount; ++t) {
+    for (size_t k = 0; k < 3; ++k) {
+      adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+    }
+  }
+
+  std::vector<uint32_t> live(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    live[v] = offsets[v + 1] - offsets[v];
+  }
+  std::vector<size_t> cacheTime(vertexCount, 0);
+  std::vector<uint8_t> emitted(triangleCount, 0);
+  std::vector<uint32_t> deadEnd;
+  std::vector<uint32_t> candidates;
+  size_t time = kCacheSize + 1;
+  size_t cursor = 0;
+
+  // 没有可用的候选顶点时, 先回退到最近输出的顶点, 再按序号扫描
+  auto skipDeadEnd = [&]() -> int64_t {
+    while (!deadEnd.empty()) {
+      const uint32_t v = deadEnd.back();
+      deadEnd.pop_back();
+      if (live[v] > 0) {
+        return v;
+      }
+    }
+    for (; cursor < vertexCount; ++cursor) {
+      if (live[cursor] > 0) {
+        return static_cast<int64_t>(cursor);
+      }
+    }
+    return -1;
+  };
+
+  if (clusters) {
+    clusters->push_back(0);
+  }
+  int64_t fanning = skipDeadEnd();
+  while (fanning >= 0) {
+    candidates.clear();
+    for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; ++a) {
+      const uint32_t t = adjacency[a];
+      if (emitted[t]) {
+        continue;
+      }
+      for (size_t k = 0; k < 3; ++k) {
+        const uint32_t v = indices[t * 3 + k];
+        result.push_back(v);
+        deadEnd.push_back(v);
+        candidates.push_back(v);
+        --live[v];
+        if (time - cacheTime[v] > kCacheSize) {
+          cacheTime[v] = time++;
+        }
+      }
+      emitted[t] = 1;
+    }
+
+    // 选择输出剩余三角形后仍在缓存中、且在缓存中最久的候选顶点
+    int64_t next = -1;
+    int64_t best = -1;
+    for (const uint32_t v: candidates) {
+      if (live[v] == 0) {
+        continue;
+      }
+      int64_t priority = 0;
+      if (time - cacheTime[v] + 2 * live[v] <= kCacheSize) {
+        priority = static_cast<int64_t>(time - cacheTime[v]);
+      }
+      if (priority > best) {
+        best = priority;
+        next = v;
+      }
+    }
+    if (next < 0) {
+      next = skipDeadEnd();
+      if (next >= 0 && clusters && result.size() / 3 < triangleCount) {
+        clusters->push_back(static_cast<uint32_t>(result.size() / 3));
+      }
+    }
+    fanning = next;
+  }
+  return result;
+}
+
+void GltfMeshOptimizer::optimizeOverdraw(std::vector<uint32_t> &indices,
+                                         const float *positions,
+                                         size_t vertexCount,
+                                         const std::vector<uint32_t> &clusters) {
+  const size_t triangleCount = indices.size() / 3;
+  if (clusters.size() < 2 || !positions) {
+    return;
+  }
+
+  struct Cluster {
+    uint32_t begin = 0;
+    uint32_t end = 0;
+    float centroid[3] = {0.0f, 0.0f, 0.0f};  ///< 面积加权
+    float normal[3] = {0.0f, 0.0f, 0.0f};    ///< 面积加权
+    float area = 0.0f;
+    float sortKey = 0.0f;
+  };
+  std::vector<Cluster> sorted(clusters.size());
+  float meshCentroid[3] = {0.0f, 0.0f, 0.0f};
+  float meshArea = 0.0f;
+  for (size_t c = 0; c < clusters.size(); ++c) {
+    auto &cluster = sorted[c];
+    cluster.begin = clusters[c];
+    cluster.end = c + 1 < clusters.size() ? clusters[c + 1]
+                                          : static_cast<uint32_t>(triangleCount);
+    for (uint32_t t = cluster.begin; t < cluster.end; ++t) {
+      const uint32_t a = indices[t * 3];
+      const uint32_t b = indices[t * 3 + 1];
+      const uint32_t d = indices[t * 3 + 2];
+      if (a >= vertexCount || b >= vertexCount || d >= vertexCount) {
+        return;
+      }
+      const float *p0 = positions + a * 3;
+      const float *p1 = positions + b * 3;
+      const float *p2 = positions + d * 3;
+      const float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+      const float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+      const float n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                          e1[2] * e2[0] - e1[0] * e2[2],
+                          e1[0] * e2[1] - e1[1] * e2[0]};
+      const float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      for (int k = 0; k < 3; ++k) {
+        const float center = (p0[k] + p1[k] + p2[k]) / 3.0f;
+        cluster.centroid[k] += center * area;
+        cluster.normal[k] += n[k];
+        meshCentroid[k] += center * area;
+      }
+      cluster.area += area;
+      meshArea += area;
+    }
+  }
+  if (meshArea <= 0.0f) {
+    return;
+  }
+  for (auto &value: meshCentroid) {
+    value /= meshArea;
+  }
+
+  // 朝外且远离中心的簇更可能遮挡其他簇, 先绘制
+  for (auto &cluster: sorted) {
+    if (cluster.area <= 0.0f) {
+      continue;
+    }
+    const float length = std::sqrt(cluster.normal[0] * cluster.normal[0] +
+        cluster.normal[1] * cluster.normal[1] +
+        cluster.normal[2] * cluster.normal[2]);
+    if (length <= 0.0f) {
+      continue;
+    }
+    for (int k = 0; k < 3; ++k) {
+      cluster.sortKey += (cluster.centroid[k] / cluster.area - meshCentroid[k]) *
+          cluster.normal[k] / length;
+    }
+  }
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const Cluster &a, const Cluster &b) {
+                     return a.sortKey > b.sortKey;
+                   });
+
+  std::vector<uint32_t> result;
+  result.reserve(indices.size());
+  for (const auto &cluster: sorted) {
+    result.insert(result.end(), indices.begin() + cluster.begin * 3,
+                  indices.begin() + cluster.end * 3);
+  }
+  indices.swap(result);
+}
+
+std::vector<uint32_t>
+GltfMeshOptimizer::optimizeVertexFetch(
+    const std::vector<std::vector<uint32_t>> &indexLists, size_t vertexCount) {
+  constexpr uint32_t kUnassigned = UINT32_MAX;
+  std::vector<uint32_t> remap(vertexCount, kUnassigned);
+  uint32_t next = 0;
+  for (const auto &indices: indexLists) {
+    for (const uint32_t v: indices) {
+      if (v < vertexCount && remap[v] == kUnassigned) {
+        remap[v] = next++;
+      }
+    }
+  }
+  for (auto &value: remap) {
+    if (value == kUnassigned) {
+      value = next++;
+    }
+  }
+  return remap;
+}
+
+bool GltfMeshOptimizer::optimize(
+    const Gltf &gltf,
+    const std::vector<std::shared_ptr<GltfPrimitive>> &primitives,
+    GltfMeshOptimizerStats &stats) {
+  const auto &accessors = gltf.getAccessors();
+  auto accessorAt = [&accessors](int index) -> std::shared_ptr<GltfAccessor> {
+    return index >= 0 && index < static_cast<int>(accessors.size())
+           ? accessors[index] : nullptr;
+  };
+
+  // 顶点访问器: 属性与变形目标, 数量必须一致
+  std::map<int, std::shared_ptr<GltfAccessor>> vertexAccessors;
+  std::map<int, IndexList> indexLists;
+  std::vector<int> indexOrder;
+  size_t vertexCount = 0;
+  for (const auto &primitive: primitives) {
+    if (!primitive->getIndices().has_value()) {
+      return false;
+    }
+    std::vector<const std::map<std::string, int> *> streams{
+        &primitive->getAttributes()};
+    for (const auto &target: primitive->getTargets()) {
+      streams.push_back(&target);
+    }
+    for (const auto *stream: streams) {
+      for (const auto &[_, index]: *stream) {
+        auto accessor = accessorAt(index);
+        const size_t count = accessor
+                             ? static_cast<size_t>(accessor->getCount().value_or(0))
+                             : 0;
+        if (count == 0 || (vertexCount != 0 && count != vertexCount)) {
+          return false;
+        }
+        vertexCount = count;
+        vertexAccessors[index] = accessor;
+      }
+    }
+
+    const int index = primitive->getIndices().value();
+    const bool reorder = primitive->getMode() == kModeTriangles &&
+        !usesBlending(gltf, *primitive);
+    auto it = indexLists.find(index);
+    if (it == indexLists.end()) {
+      IndexList list;
+      list.accessor = accessorAt(index);
+      if (!list.accessor || !readIndices(gltf, *list.accessor, list.indices)) {
+        return false;
+      }
+      list.reorder = reorder;
+      indexLists.emplace(index, std::move(list));
+      indexOrder.push_back(index);
+    } else {
+      it->second.reorder = it->second.reorder && reorder;
+    }
+  }
+  if (vertexCount == 0 || indexLists.empty()) {
+    return false;
+  }
+  for (const auto &[_, accessor]: vertexAccessors) {
+    if (accessor->getView(gltf).count != vertexCount) {
+      return false;
+    }
+  }
+  for (const auto &[index, list]: indexLists) {
+    if (vertexAccessors.count(index) != 0) {
+      return false;
+    }
+    for (const uint32_t v: list.indices) {
+      if (v >= vertexCount) {
+        return false;
+      }
+    }
+  }
+
+  std::vector<float> positions;
+  const auto &attributes = primitives.front()->getAttributes();
+  auto position = attributes.find("POSITION");
+  if (position == attributes.end() ||
+      !readPositions(gltf, *accessorAt(position->second), positions)) {
+    positions.clear();
+  }
+
+  // 三角形重排
+  GltfMeshOptimizerStats local;
+  for (const int index: indexOrder) {
+    auto &list = indexLists[index];
+    if (!list.reorder || list.indices.size() % 3 != 0) {
+      continue;
+    }
+    const size_t before = simulateCache(list.indices.data(),
+                                        list.indices.size(), vertexCount);
+    std::vector<uint32_t> clusters;
+    auto reordered = optimizeVertexCache(list.indices.data(),
+                                         list.indices.size(), vertexCount,
+                                         &clusters);
+    if (!positions.empty()) {
+      optimizeOverdraw(reordered, positions.data(), vertexCount, clusters);
+    }
+    const size_t after = simulateCache(reordered.data(), reordered.size(),
+                                       vertexCount);
+    local.triangles += list.indices.size() / 3;
+    local.missesBefore += before;
+    if (after < before) {
+      list.indices.swap(reordered);
+      local.missesAfter += after;
+      ++local.primitives;
+    } else {
+      local.missesAfter += before;
+    }
+  }
+
+  // 顶点重排: 所有流使用同一个映射
+  std::vector<std::vector<uint32_t>> orderedLists;
+  orderedLists.reserve(indexOrder.size());
+  for (const int index: indexOrder) {
+    orderedLists.push_back(std::move(indexLists[index].indices));
+  }
+  const auto remap = optimizeVertexFetch(orderedLists, vertexCount);
+  bool identity = local.primitives == 0;
+  for (size_t v = 0; identity && v < vertexCount; ++v) {
+    identity = remap[v] == v;
+  }
+  if (identity) {
+    stats.merge(local);
+    return false;
+  }
+  for (const auto &[_, accessor]: vertexAccessors) {
+    remapVertices(gltf, *accessor, remap);
+  }
+  for (size_t i = 0; i < indexOrder.size(); ++i) {
+    auto &indices = orderedLists[i];
+    for (auto &v: indices) {
+      v = remap[v];
+    }
+    writeIndices(*indexLists[indexOrder[i]].accessor, indices);
+  }
+
+  // 预先组装的变形目标纹理按原顶点顺序排列, 需重新组装
+  for (const auto &primitive: primitives) {
+    primitive->setMorphTargetTexture(nullptr);
+  }
+  stats.merge(local);
+  return true;
+}
+
+} // namespace digitalhumans
@@ -0,0 +1,111 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFMESHOPTIMIZER_H
+#define LIGHTDIGITALHUMAN_GLTFMESHOPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace digitalhumans {
+
+class Gltf;
+
+class GltfPrimitive;
+
+/**
+ * @brief 网格优化的顶点缓存统计
+ */
+struct GltfMeshOptimizerStats {
+  size_t primitives = 0;    ///< 重排了三角形的图元数
+  size_t triangles = 0;     ///< 参与统计的三角形数
+  size_t missesBefore = 0;  ///< 优化前 FIFO 缓存模拟的未命中次数
+  size_t missesAfter = 0;   ///< 优化后 FIFO 缓存模拟的未命中次数
+
+  /**
+   * @brief 平均每个三角形的缓存未命中次数（ACMR）
+   */
+  double acmrBefore() const {
+    return triangles ? static_cast<double>(missesBefore) / triangles : 0.0;
+  }
+
+  double acmrAfter() const {
+    return triangles ? static_cast<double>(missesAfter) / triangles : 0.0;
+  }
+
+  void merge(const GltfMeshOptimizerStats &other) {
+    primitives += other.primitives;
+    triangles += other.triangles;
+    missesBefore += other.missesBefore;
+    missesAfter += other.missesAfter;
+  }
+};
+
+/**
+ * @brief 加载时的三角形与顶点重排
+ *
+ * 1. 三角形按 Tipsify（Sander 2007）重排以提高变换后顶点缓存命中率,
+ *    再把 Tipsify 跳转处划分的簇按遮挡潜力（簇中心相对网格中心沿簇法线的距离）
+ *    从外到内排序, 减少过度绘制;
+ * 2. 顶点按索引中首次出现的顺序重排, 提高顶点读取的局部性。
+ * 共享同一组顶点属性的图元一起处理, 属性、变形目标（含蒙皮的 JOINTS/WEIGHTS）
+ * 按同一映射重排。结果写入访问器的解码数据, 之后的顶点布局、上传与烘焙直接使用。
+ * 只访问 CPU 数据, 可在加载的工作线程中执行。
+ */
+class GltfMeshOptimizer {
+ public:
+  static constexpr size_t kCacheSize = 16;  ///< 模拟的 FIFO 顶点缓存大小
+
+  /**
+   * @brief 用 FIFO 缓存模拟统计顶点缓存未命中次数
+   */
+  static size_t simulateCache(const uint32_t *indices, size_t indexCount,
+                              size_t vertexCount,
+                              size_t cacheSize = kCacheSize);
+
+  /**
+   * @brief Tipsify 三角形重排
+   * @param clusters 非空时输出各簇起始三角形序号（第一个为 0）
+   * @return 重排后的索引
+   */
+  static std::vector<uint32_t>
+  optimizeVertexCache(const uint32_t *indices, size_t indexCount,
+                      size_t vertexCount,
+                      std::vector<uint32_t> *clusters = nullptr);
+
+  /**
+   * @brief 按遮挡潜力对簇排序, 簇内顺序不变
+   * @param positions 每个顶点 3 个 float
+   * @param clusters optimizeVertexCache 输出的簇起始三角形序号
+   */
+  static void optimizeOverdraw(std::vector<uint32_t> &indices,
+                               const float *positions, size_t vertexCount,
+                               const std::vector<uint32_t> &clusters);
+
+  /**
+   * @brief 按顶点在索引中首次出现的顺序生成映射（旧序号 -> 新序号）,
+   * 未被引用的顶点保持原有相对顺序排在最后
+   */
+  static std::vector<uint32_t>
+  optimizeVertexFetch(const std::vector<std::vector<uint32_t>> &indexLists,
+                      size_t vertexCount);
+
+  /**
+   * @brief 重排共享同一组顶点属性的图元
+   *
+   * 调用方保证这些图元引用的访问器不被其他图元、动画或蒙皮使用。
+   * 任一图元没有索引或索引越界时不做修改。混合材质的图元保留三角形顺序,
+   * 重排后缓存命中率变差时也保留原顺序。
+   * @return 修改了访问器数据时返回 true
+   */
+  static bool optimize(const Gltf &gltf,
+                       const std::vector<std::shared_ptr<GltfPrimitive>> &primitives,
+                       GltfMeshOptimizerStats &stats);
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFMESHOPTIMIZER_H
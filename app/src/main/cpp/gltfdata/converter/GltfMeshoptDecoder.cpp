@@ -0,0 +1,685 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#include "GltfMeshoptDecoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <vector>
+#include "../GltfBuffer.h"
+#include "../../utils/LogUtils.h"
+#include "../../utils/ThreadPool.h"
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr uint8_t kVertexHeader = 0xa0;
+constexpr uint8_t kIndexHeader = 0xe0;
+constexpr uint8_t kSequenceHeader = 0xd0;
+
+constexpr size_t kByteGroupSize = 16;
+constexpr size_t kByteGroupDecodeLimit = 24;  ///< 一组字节解码最多读取的字节数
+constexpr size_t kVertexBlockSizeBytes = 8192;
+constexpr size_t kVertexBlockMaxSize = 256;
+constexpr size_t kTailMaxSize = 32;
+constexpr size_t kDecodedAlignment = 16;  ///< 解码结果在输出 buffer 中的对齐
+
+/**
+ * @brief bufferView 上的扩展参数
+ */
+struct CompressedView {
+  int view = -1;
+  int buffer = -1;
+  size_t byteOffset = 0;
+  size_t byteLength = 0;
+  size_t byteStride = 0;
+  size_t count = 0;
+  GltfMeshoptDecoder::Mode mode = GltfMeshoptDecoder::Mode::ATTRIBUTES;
+  GltfMeshoptDecoder::Filter filter = GltfMeshoptDecoder::Filter::NONE;
+  size_t outputOffset = 0;
+};
+
+size_t getVertexBlockSize(size_t vertexSize) {
+  size_t result = (kVertexBlockSizeBytes / vertexSize) & ~(kByteGroupSize - 1);
+  return std::min(result, kVertexBlockMaxSize);
+}
+
+uint8_t unzigzag8(uint8_t v) {
+  return static_cast<uint8_t>(-(v & 1) ^ (v >> 1));
+}
+
+/**
+ * @brief 解码一组 16 个字节, 每个值占 2^bitsLog2 位, 全 1 表示值存放在组后的字节中
+ */
+const uint8_t *decodeBytesGroup(const uint8_t *data, uint8_t *buffer,
+                                int bitsLog2) {
+  switch (bitsLog2) {
+    case 0:
+      std::memset(buffer, 0, kByteGroupSize);
+      return data;
+    case 1: {
+      const uint8_t *variable = data + 4;
+      for (int i = 0; i < 4; ++i) {
+        uint8_t byte = data[i];
+        for (int j = 0; j < 4; ++j) {
+          uint8_t encoded = byte >> 6;
+          byte = static_cast<uint8_t>(byte << 2);
+          const bool escaped = encoded == 3;
+          *buffer++ = escaped ? *variable : encoded;
+          variable += escaped;
+        }
+      }
+      return variable;
+    }
+    case 2: {
+      const uint8_t *variable = data + 8;
+      for (int i = 0; i < 8; ++i) {
+        uint8_t byte = data[i];
+        for (int j = 0; j < 2; ++j) {
+          uint8_t encoded = byte >> 4;
+          byte = static_cast<uint8_t>(byte << 4);
+          const bool escaped = encoded == 15;
+          *buffer++ = escaped ? *variable : encoded;
+          variable += escaped;
+        }
+      }
+      return variable;
+    }
+    default:
+      std::memcpy(buffer, data, kByteGroupSize);
+      return data + kByteGroupSize;
+  }
+}
+
+const uint8_t *decodeBytes(const uint8_t *data, const uint8_t *dataEnd,
+                           uint8_t *buffer, size_t bufferSize) {
+  // 每组 2 位的头, 4 组共用一个字节
+  const uint8_t *header = data;
+  const size_t headerSize = (bufferSize / kByteGroupSize + 3) / 4;
+  if (static_cast<size_t>(dataEnd - data) < headerSize) {
+    return nullptr;
+  }
+  data += headerSize;
+
+  for (size_t i = 0; i < bufferSize; i += kByteGroupSize) {
+    // 码流末尾至少有 kTailMaxSize 字节, 检查后组内读取不会越界
+    if (static_cast<size_t>(dataEnd - data) < kByteGroupDecodeLimit) {
+      return nullptr;
+    }
+    const size_t group = i / kByteGroupSize;
+    const int bitsLog2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+    data = decodeBytesGroup(data, buffer + i, bitsLog2);
+  }
+  return data;
+}
+
+/**
+ * @brief 解码一块顶点: 按字节位置分别解码, 再与上一个顶点的同一字节做差分还原
+ */
+const uint8_t *decodeVertexBlock(const uint8_t *data, const uint8_t *dataEnd,
+                                 uint8_t *vertexData, size_t vertexCount,
+                                 size_t vertexSize, uint8_t lastVertex[256]) {
+  uint8_t buffer[kVertexBlockMaxSize];
+  const size_t alignedCount =
+      (vertexCount + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+  for (size_t k = 0; k < vertexSize; ++k) {
+    data = decodeBytes(data, dataEnd, buffer, alignedCount);
+    if (!data) {
+      return nullptr;
+    }
+    uint8_t previous = lastVertex[k];
+    uint8_t *output = vertexData + k;
+    for (size_t i = 0; i < vertexCount; ++i) {
+      const uint8_t value = static_cast<uint8_t>(unzigzag8(buffer[i]) + previous);
+      *output = value;
+      output += vertexSize;
+      previous = value;
+    }
+    lastVertex[k] = previous;
+  }
+  return data;
+}
+
+uint32_t decodeVByte(const uint8_t *&data) {
+  uint8_t lead = *data++;
+  if (lead < 128) {
+    return lead;
+  }
+  // 小端 7 位分组, 最多 5 个字节
+  uint32_t result = lead & 127;
+  uint32_t shift = 7;
+  for (int i = 0; i < 4; ++i) {
+    uint8_t group = *data++;
+    result |= static_cast<uint32_t>(group & 127) << shift;
+    shift += 7;
+    if (group < 128) {
+      break;
+    }
+  }
+  return result;
+}
+
+uint32_t decodeIndex(const uint8_t *&data, uint32_t last) {
+  uint32_t v = decodeVByte(data);
+  uint32_t delta = (v >> 1) ^ (0u - (v & 1));
+  return last + delta;
+}
+
+void writeIndex(uint8_t *dst, size_t index, size_t indexSize, uint32_t value) {
+  if (indexSize == 2) {
+    const auto narrow = static_cast<uint16_t>(value);
+    std::memcpy(dst + index * 2, &narrow, sizeof(narrow));
+  } else {
+    std::memcpy(dst + index * 4, &value, sizeof(value));
+  }
+}
+
+void pushEdge(uint32_t fifo[16][2], uint32_t a, uint32_t b, size_t &offset) {
+  fifo[offset][0] = a;
+  fifo[offset][1] = b;
+  offset = (offset + 1) & 15;
+}
+
+void pushVertex(uint32_t fifo[16], uint32_t v, size_t &offset,
+                bool condition = true) {
+  fifo[offset] = v;
+  offset = (offset + condition) & 15;
+}
+
+/**
+ * @brief 八面体编码的法线, 第 4 个分量不变
+ */
+template<typename T>
+void decodeOctahedral(T *data, size_t count) {
+  const float max = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+  for (size_t i = 0; i < count; ++i) {
+    T *v = data + i * 4;
+    // z 与 x、y 使用相同的位数, 编码 1.0
+    float x = static_cast<float>(v[0]);
+    float y = static_cast<float>(v[1]);
+    float z = static_cast<float>(v[2]) - std::fabs(x) - std::fabs(y);
+
+    // z < 0 时折回八面体的下半部分
+    float t = z >= 0.0f ? 0.0f : z;
+    x += x >= 0.0f ? t : -t;
+    y += y >= 0.0f ? t : -t;
+
+    float length = std::sqrt(x * x + y * y + z * z);
+    float scale = max / length;
+    v[0] = static_cast<T>(static_cast<int>(x * scale + (x >= 0.0f ? 0.5f : -0.5f)));
+    v[1] = static_cast<T>(static_cast<int>(y * scale + (y >= 0.0f ? 0.5f : -0.5f)));
+    v[2] = static_cast<T>(static_cast<int>(z * scale + (z >= 0.0f ? 0.5f : -0.5f)));
+  }
+}
+
+/**
+ * @brief 省略最大分量的四元数, 第 4 个分量的低 2 位是被省略分量的位置, 其余位是缩放
+ */
+void decodeQuaternion(int16_t *data, size_t count) {
+  const float scale = 1.0f / std::sqrt(2.0f);
+  for (size_t i = 0; i < count; ++i) {
+    int16_t *q = data + i * 4;
+    const int scaleBits = q[3] | 3;
+    const float s = scale / static_cast<float>(scaleBits);
+
+    float x = static_cast<float>(q[0]) * s;
+    float y = static_cast<float>(q[1]) * s;
+    float z = static_cast<float>(q[2]) * s;
+    // 精度误差可能导致平方和略大于 1
+    float ww = 1.0f - x * x - y * y - z * z;
+    float w = std::sqrt(ww >= 0.0f ? ww : 0.0f);
+
+    const int xf = static_cast<int>(x * 32767.0f + (x >= 0.0f ? 0.5f : -0.5f));
+    const int yf = static_cast<int>(y * 32767.0f + (y >= 0.0f ? 0.5f : -0.5f));
+    const int zf = static_cast<int>(z * 32767.0f + (z >= 0.0f ? 0.5f : -0.5f));
+    const int wf = static_cast<int>(w * 32767.0f + 0.5f);
+
+    const int omitted = q[3] & 3;
+    q[(omitted + 1) & 3] = static_cast<int16_t>(xf);
+    q[(omitted + 2) & 3] = static_cast<int16_t>(yf);
+    q[(omitted + 3) & 3] = static_cast<int16_t>(zf);
+    q[(omitted + 0) & 3] = static_cast<int16_t>(wf);
+  }
+}
+
+/**
+ * @brief 8 位指数 + 24 位尾数的浮点数
+ */
+void decodeExponential(uint32_t *data, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t v = data[i];
+    const int mantissa = static_cast<int32_t>(v << 8) >> 8;
+    const int exponent = static_cast<int32_t>(v) >> 24;
+
+    // ldexp(mantissa, exponent), 指数范围 [-100, 100] 内直接构造 2^exponent
+    const uint32_t powerBits = static_cast<uint32_t>(exponent + 127) << 23;
+    float power;
+    std::memcpy(&power, &powerBits, sizeof(power));
+    const float value = power * static_cast<float>(mantissa);
+    std::memcpy(&data[i], &value, sizeof(value));
+  }
+}
+
+bool parseMode(const std::string &value, GltfMeshoptDecoder::Mode &mode) {
+  if (value == "ATTRIBUTES") {
+    mode = GltfMeshoptDecoder::Mode::ATTRIBUTES;
+  } else if (value == "TRIANGLES") {
+    mode = GltfMeshoptDecoder::Mode::TRIANGLES;
+  } else if (value == "INDICES") {
+    mode = GltfMeshoptDecoder::Mode::INDICES;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parseFilter(const std::string &value, GltfMeshoptDecoder::Filter &filter) {
+  if (value.empty() || value == "NONE") {
+    filter = GltfMeshoptDecoder::Filter::NONE;
+  } else if (value == "OCTAHEDRAL") {
+    filter = GltfMeshoptDecoder::Filter::OCTAHEDRAL;
+  } else if (value == "QUATERNION") {
+    filter = GltfMeshoptDecoder::Filter::QUATERNION;
+  } else if (value == "EXPONENTIAL") {
+    filter = GltfMeshoptDecoder::Filter::EXPONENTIAL;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+size_t getSize(const tinygltf::Value &object, const char *key) {
+  if (!object.Has(key)) {
+    return 0;
+  }
+  const int value = object.Get(key).GetNumberAsInt();
+  return value > 0 ? static_cast<size_t>(value) : 0;
+}
+
+/**
+ * @brief 读取 bufferView 上的扩展参数
+ * @return 没有扩展返回 false; 参数无效时 error 非空
+ */
+bool parseCompressedView(const tinygltf::BufferView &bufferView,
+                         CompressedView &out, std::string &error) {
+  auto it = bufferView.extensions.find(GltfMeshoptDecoder::kExtensionName);
+  if (it == bufferView.extensions.end() || !it->second.IsObject()) {
+    return false;
+  }
+  const tinygltf::Value &extension = it->second;
+  out.buffer = extension.Has("buffer")
+               ? extension.Get("buffer").GetNumberAsInt() : -1;
+  out.byteOffset = getSize(extension, "byteOffset");
+  out.byteLength = getSize(extension, "byteLength");
+  out.byteStride = getSize(extension, "byteStride");
+  out.count = getSize(extension, "count");
+
+  const tinygltf::Value &mode = extension.Get("mode");
+  const tinygltf::Value &filter = extension.Get("filter");
+  if (!mode.IsString() || !parseMode(mode.Get<std::string>(), out.mode)) {
+    error = "invalid mode";
+  } else if (!parseFilter(filter.IsString() ? filter.Get<std::string>() : "",
+                          out.filter)) {
+    error = "invalid filter";
+  } else if (out.byteStride == 0 || out.count == 0 || out.byteLength == 0) {
+    error = "missing byteStride, count or byteLength";
+  } else if (out.count * out.byteStride > bufferView.byteLength) {
+    error = "decoded data exceeds bufferView byteLength";
+  }
+  return true;
+}
+
+} // namespace
+
+bool GltfMeshoptDecoder::hasCompressedViews(const tinygltf::Model &model) {
+  return std::any_of(model.bufferViews.begin(), model.bufferViews.end(),
+                     [](const tinygltf::BufferView &view) {
+                       return view.extensions.count(kExtensionName) > 0;
+                     });
+}
+
+bool GltfMeshoptDecoder::isFallbackBuffer(const tinygltf::Buffer &buffer) {
+  auto it = buffer.extensions.find(kExtensionName);
+  return it != buffer.extensions.end() && it->second.Has("fallback") &&
+      it->second.Get("fallback").IsBool() &&
+      it->second.Get("fallback").Get<bool>();
+}
+
+bool GltfMeshoptDecoder::decodeAll(tinygltf::Model &model,
+                                   const GltfBinaryChunk *binChunk) {
+  auto startTime = std::chrono::high_resolution_clock::now();
+  std::vector<CompressedView> views;
+  size_t outputSize = 0;
+  size_t compressedSize = 0;
+  for (size_t i = 0; i < model.bufferViews.size(); ++i) {
+    CompressedView view;
+    std::string error;
+    if (!parseCompressedView(model.bufferViews[i], view, error)) {
+      continue;
+    }
+    if (!error.empty()) {
+      LOGE("Invalid %s on bufferView %zu: %s", kExtensionName, i,
+           error.c_str());
+      return false;
+    }
+    view.view = static_cast<int>(i);
+    view.outputOffset = outputSize;
+    outputSize += (view.count * view.byteStride + kDecodedAlignment - 1) &
+        ~(kDecodedAlignment - 1);
+    compressedSize += view.byteLength;
+    views.push_back(view);
+  }
+  if (views.empty()) {
+    return true;
+  }
+
+  tinygltf::Buffer decoded;
+  decoded.name = kExtensionName;
+  decoded.data.resize(outputSize);
+
+  // 各任务写入输出 buffer 中互不重叠的区域
+  std::vector<std::future<std::string>> jobs;
+  jobs.reserve(views.size());
+  for (const auto &view: views) {
+    const uint8_t *source = nullptr;
+    size_t sourceSize = 0;
+    if (view.buffer >= 0 && view.buffer < static_cast<int>(model.buffers.size())) {
+      const auto &buffer = model.buffers[view.buffer];
+      source = buffer.data.data();
+      sourceSize = buffer.data.size();
+      if (buffer.data.empty() && buffer.uri.empty() && binChunk) {
+        source = binChunk->data;
+        sourceSize = binChunk->size;
+      }
+    }
+    if (!source || view.byteOffset + view.byteLength > sourceSize) {
+      LOGE("Compressed data of bufferView %d out of range", view.view);
+      return false;
+    }
+
+    uint8_t *dst = decoded.data.data() + view.outputOffset;
+    source += view.byteOffset;
+    jobs.push_back(ThreadPool::shared().submit([view, dst, source]() {
+      std::string error;
+      decode(view.mode, view.filter, dst, view.count, view.byteStride, source,
+             view.byteLength, error);
+      return error;
+    }));
+  }
+
+  bool success = true;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    std::string error = jobs[i].get();
+    if (!error.empty()) {
+      LOGE("Failed to decode bufferView %d: %s", views[i].view, error.c_str());
+      success = false;
+    }
+  }
+  if (!success) {
+    return false;
+  }
+
+  const int decodedIndex = static_cast<int>(model.buffers.size());
+  model.buffers.push_back(std::move(decoded));
+  for (const auto &view: views) {
+    auto &bufferView = model.bufferViews[view.view];
+    bufferView.buffer = decodedIndex;
+    bufferView.byteOffset = view.outputOffset;
+    bufferView.byteLength = view.count * view.byteStride;
+    bufferView.extensions.erase(kExtensionName);
+  }
+
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::high_resolution_clock::now() - startTime).count();
+  LOGI("Decoded %zu meshopt bufferViews (%zu -> %zu bytes) in %lld ms",
+       views.size(), compressedSize, outputSize,
+       static_cast<long long>(duration));
+  return true;
+}
+
+bool GltfMeshoptDecoder::decode(Mode mode, Filter filter, uint8_t *dst,
+                                size_t count, size_t stride,
+                                const uint8_t *src, size_t size,
+                                std::string &error) {
+  bool decoded = false;
+  switch (mode) {
+    case Mode::ATTRIBUTES:
+      if (stride % 4 != 0 || stride > kVertexBlockMaxSize) {
+        error = "invalid byteStride for ATTRIBUTES";
+        return false;
+      }
+      decoded = decodeVertexBuffer(dst, count, stride, src, size);
+      break;
+    case Mode::TRIANGLES:
+      if ((stride != 2 && stride != 4) || count % 3 != 0) {
+        error = "invalid byteStride or count for TRIANGLES";
+        return false;
+      }
+      decoded = decodeIndexBuffer(dst, count, stride, src, size);
+      break;
+    case Mode::INDICES:
+      if (stride != 2 && stride != 4) {
+        error = "invalid byteStride for INDICES";
+        return false;
+      }
+      decoded = decodeIndexSequence(dst, count, stride, src, size);
+      break;
+  }
+  if (!decoded) {
+    error = "malformed compressed data";
+    return false;
+  }
+  if (filter != Filter::NONE &&
+      (mode != Mode::ATTRIBUTES || !applyFilter(filter, dst, count, stride))) {
+    error = "filter does not match byteStride";
+    return false;
+  }
+  return true;
+}
+
+bool GltfMeshoptDecoder::decodeVertexBuffer(uint8_t *dst, size_t count,
+                                            size_t stride, const uint8_t *src,
+                                            size_t size) {
+  if (stride == 0 || stride > kVertexBlockMaxSize || stride % 4 != 0 ||
+      size < 1 + stride) {
+    return false;
+  }
+  const uint8_t *data = src;
+  const uint8_t *dataEnd = src + size;
+  const uint8_t header = *data++;
+  if ((header & 0xf0) != kVertexHeader || (header & 0x0f) > 0) {
+    return false;
+  }
+
+  // 码流末尾保存第一块差分的基准顶点
+  uint8_t lastVertex[kVertexBlockMaxSize];
+  std::memcpy(lastVertex, dataEnd - stride, stride);
+
+  const size_t blockSize = getVertexBlockSize(stride);
+  for (size_t offset = 0; offset < count; offset += blockSize) {
+    const size_t blockCount = std::min(blockSize, count - offset);
+    data = decodeVertexBlock(data, dataEnd, dst + offset * stride, blockCount,
+                             stride, lastVertex);
+    if (!data) {
+      return false;
+    }
+  }
+
+  const size_t tailSize = std::max(stride, kTailMaxSize);
+  return static_cast<size_t>(dataEnd - data) == tailSize;
+}
+
+bool GltfMeshoptDecoder::decodeIndexBuffer(uint8_t *dst, size_t count,
+                                           size_t indexSize,
+                                           const uint8_t *src, size_t size) {
+  // 至少包含头、每个三角形 1 字节的编码与末尾 16 字节的辅助编码表
+  if (count % 3 != 0 || (indexSize != 2 && indexSize != 4) ||
+      size < 1 + count / 3 + 16) {
+    return false;
+  }
+  if ((src[0] & 0xf0) != kIndexHeader) {
+    return false;
+  }
+  const int version = src[0] & 0x0f;
+  if (version > 1) {
+    return false;
+  }
+
+  uint32_t edgeFifo[16][2];
+  uint32_t vertexFifo[16];
+  std::memset(edgeFifo, -1, sizeof(edgeFifo));
+  std::memset(vertexFifo, -1, sizeof(vertexFifo));
+  size_t edgeOffset = 0;
+  size_t vertexOffset = 0;
+  uint32_t next = 0;
+  uint32_t last = 0;
+  // v1 用 13/14 编码与上一个独立索引相差 -1/+1 的顶点
+  const int fecMax = version >= 1 ? 13 : 15;
+
+  const uint8_t *code = src + 1;
+  const uint8_t *data = code + count / 3;
+  const uint8_t *dataSafeEnd = src + size - 16;
+  const uint8_t *codeAuxTable = dataSafeEnd;
+
+  for (size_t i = 0; i < count; i += 3) {
+    // 每个三角形最多读取 16 字节, 检查后读取不会越过辅助编码表
+    if (data > dataSafeEnd) {
+      return false;
+    }
+    const uint8_t codeTri = *code++;
+    uint32_t a, b, c;
+    if (codeTri < 0xf0) {
+      // 复用边 FIFO 中的一条边
+      const int fe = codeTri >> 4;
+      a = edgeFifo[(edgeOffset - 1 - fe) & 15][0];
+      b = edgeFifo[(edgeOffset - 1 - fe) & 15][1];
+      const int fec = codeTri & 15;
+      if (fec < fecMax) {
+        const bool isNew = fec == 0;
+        c = isNew ? next : vertexFifo[(vertexOffset - 1 - fec) & 15];
+        next += isNew;
+        pushVertex(vertexFifo, c, vertexOffset, isNew);
+      } else {
+        // fec - (fec ^ 3) 把 13、14 解码为 -1、1
+        c = fec != 15 ? last + (fec - (fec ^ 3)) : decodeIndex(data, last);
+        last = c;
+        pushVertex(vertexFifo, c, vertexOffset);
+      }
+      pushEdge(edgeFifo, c, b, edgeOffset);
+      pushEdge(edgeFifo, a, c, edgeOffset);
+    } else {
+      int feb, fec;
+      int fea = 0;
+      if (codeTri < 0xfe) {
+        // 常见组合从辅助编码表读取, 表中不含 15
+        const uint8_t codeAux = codeAuxTable[codeTri & 15];
+        feb = codeAux >> 4;
+        fec = codeAux & 15;
+        a = next++;
+        b = feb == 0 ? next : vertexFifo[(vertexOffset - feb) & 15];
+        next += feb == 0;
+        c = fec == 0 ? next : vertexFifo[(vertexOffset - fec) & 15];
+        next += fec == 0;
+      } else {
+        const uint8_t codeAux = *data++;
+        fea = codeTri == 0xfe ? 0 : 15;
+        feb = codeAux >> 4;
+        fec = codeAux & 15;
+        // 不经辅助编码表的 0 表示重置顶点计数
+        if (codeAux == 0) {
+          next = 0;
+        }
+        a = fea == 0 ? next++ : 0;
+        b = feb == 0 ? next++ : vertexFifo[(vertexOffset - feb) & 15];
+        c = fec == 0 ? next++ : vertexFifo[(vertexOffset - fec) & 15];
+        if (fea == 15) {
+          last = a = decodeIndex(data, last);
+        }
+        if (feb == 15) {
+          last = b = decodeIndex(data, last);
+        }
+        if (fec == 15) {
+          last = c = decodeIndex(data, last);
+        }
+      }
+      pushVertex(vertexFifo, a, vertexOffset);
+      pushVertex(vertexFifo, b, vertexOffset, feb == 0 || feb == 15);
+      pushVertex(vertexFifo, c, vertexOffset, fec == 0 || fec == 15);
+      pushEdge(edgeFifo, b, a, edgeOffset);
+      pushEdge(edgeFifo, c, b, edgeOffset);
+      pushEdge(edgeFifo, a, c, edgeOffset);
+    }
+    writeIndex(dst, i + 0, indexSize, a);
+    writeIndex(dst, i + 1, indexSize, b);
+    writeIndex(dst, i + 2, indexSize, c);
+  }
+  // 三角形数据应恰好结束于辅助编码表
+  return data == dataSafeEnd;
+}
+
+bool GltfMeshoptDecoder::decodeIndexSequence(uint8_t *dst, size_t count,
+                                             size_t indexSize,
+                                             const uint8_t *src, size_t size) {
+  // 至少包含头、每个索引 1 字节与 4 字节的结尾
+  if ((indexSize != 2 && indexSize != 4) || size < 1 + count + 4) {
+    return false;
+  }
+  if ((src[0] & 0xf0) != kSequenceHeader || (src[0] & 0x0f) > 1) {
+    return false;
+  }
+
+  const uint8_t *data = src + 1;
+  const uint8_t *dataSafeEnd = src + size - 4;
+  uint32_t last[2] = {0, 0};
+  for (size_t i = 0; i < count; ++i) {
+    // 每个索引最多 5 字节, 结尾保证读取不越界
+    if (data >= dataSafeEnd) {
+      return false;
+    }
+    uint32_t v = decodeVByte(data);
+    // 最低位选择差分基准, 其余位是 zigzag 编码的差值
+    const uint32_t baseline = v & 1;
+    v >>= 1;
+    const uint32_t delta = (v >> 1) ^ (0u - (v & 1));
+    last[baseline] += delta;
+    writeIndex(dst, i, indexSize, last[baseline]);
+  }
+  return data == dataSafeEnd;
+}
+
+bool GltfMeshoptDecoder::applyFilter(Filter filter, uint8_t *data,
+                                     size_t count, size_t stride) {
+  switch (filter) {
+    case Filter::NONE:
+      return true;
+    case Filter::OCTAHEDRAL:
+      if (stride == 4) {
+        decodeOctahedral(reinterpret_cast<int8_t *>(data), count);
+        return true;
+      }
+      if (stride == 8) {
+        decodeOctahedral(reinterpret_cast<int16_t *>(data), count);
+        return true;
+      }
+      return false;
+    case Filter::QUATERNION:
+      if (stride != 8) {
+        return false;
+      }
+      decodeQuaternion(reinterpret_cast<int16_t *>(data), count);
+      return true;
+    case Filter::EXPONENTIAL:
+      if (stride % 4 != 0) {
+        return false;
+      }
+      decodeExponential(reinterpret_cast<uint32_t *>(data), count * stride / 4);
+      return true;
+  }
+  return false;
+}
+
+} // namespace digitalhumans
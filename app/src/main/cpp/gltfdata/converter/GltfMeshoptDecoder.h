@@ -0,0 +1,97 @@
+//
+// Created by vincentsyan on 2025/10/12.
+//
+
+#ifndef LIGHTDIGITALHUMAN_GLTFMESHOPTDECODER_H
+#define LIGHTDIGITALHUMAN_GLTFMESHOPTDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "tiny_gltf.h"
+
+namespace digitalhumans {
+
+struct GltfBinaryChunk;
+
+/**
+ * @brief EXT_meshopt_compression 解码器
+ *
+ * 转换前把压缩的 bufferView 解码到追加在模型末尾的 buffer 中,
+ * bufferView 改为引用解码结果并移除扩展, 之后的转换、缓存与烘焙
+ * 与未压缩的模型完全相同。每个 bufferView 一个任务, 在共享线程池中并行解码。
+ *
+ * 码流与 meshoptimizer 兼容: ATTRIBUTES（顶点编码 v0）、TRIANGLES（索引编码 v0/v1）、
+ * INDICES（索引序列 v1）三种模式, 以及 OCTAHEDRAL、QUATERNION、EXPONENTIAL 过滤器。
+ */
+class GltfMeshoptDecoder {
+ public:
+  static constexpr const char *kExtensionName = "EXT_meshopt_compression";
+
+  /**
+   * @brief 压缩模式
+   */
+  enum class Mode {
+    ATTRIBUTES,
+    TRIANGLES,
+    INDICES
+  };
+
+  /**
+   * @brief 解码后对数据应用的过滤器
+   */
+  enum class Filter {
+    NONE,
+    OCTAHEDRAL,
+    QUATERNION,
+    EXPONENTIAL
+  };
+
+  /**
+   * @brief 模型是否包含压缩的 bufferView
+   */
+  static bool hasCompressedViews(const tinygltf::Model &model);
+
+  /**
+   * @brief buffer 是否为只占位、不含数据的回退 buffer
+   */
+  static bool isFallbackBuffer(const tinygltf::Buffer &buffer);
+
+  /**
+   * @brief 并行解码模型中所有压缩的 bufferView
+   * @param binChunk 映射加载时的 BIN 块, 没有数据与 uri 的 buffer 从中读取
+   * @return 任一 bufferView 解码失败时返回 false, 模型保持不变
+   */
+  static bool decodeAll(tinygltf::Model &model,
+                        const GltfBinaryChunk *binChunk = nullptr);
+
+  /**
+   * @brief 解码一个 bufferView 的数据
+   * @param dst 输出, 大小为 count * stride
+   * @param stride ATTRIBUTES 模式下为 4 的倍数且不超过 256, 索引模式下为 2 或 4
+   * @param error 失败原因
+   */
+  static bool decode(Mode mode, Filter filter, uint8_t *dst, size_t count,
+                     size_t stride, const uint8_t *src, size_t size,
+                     std::string &error);
+
+  static bool decodeVertexBuffer(uint8_t *dst, size_t count, size_t stride,
+                                 const uint8_t *src, size_t size);
+
+  static bool decodeIndexBuffer(uint8_t *dst, size_t count, size_t indexSize,
+                                const uint8_t *src, size_t size);
+
+  static bool decodeIndexSequence(uint8_t *dst, size_t count, size_t indexSize,
+                                  const uint8_t *src, size_t size);
+
+  /**
+   * @brief 对解码后的 count 个元素原地应用过滤器
+   * @return 步长与过滤器不匹配时返回 false
+   */
+  static bool applyFilter(Filter filter, uint8_t *data, size_t count,
+                          size_t stride);
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_GLTFMESHOPTDECODER_H
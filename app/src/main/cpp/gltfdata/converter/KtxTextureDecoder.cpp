@@ -0,0 +1,306 @@
+//
+// Created by vincentsyan on 2025/9/30.
+//
+
+#include "KtxTextureDecoder.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+#include <EGL/egl.h>
+#include <GLES2/gl2ext.h>
+#include "../GltfImage.h"
+#include "../../utils/LogUtils.h"
+
+#ifdef LIGHTDIGITALHUMAN_HAS_LIBKTX
+#include "ktx.h"
+#endif
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr uint8_t kKtx2Identifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+// KTX2 文件头（含 identifier 与数据索引）长度, 层级索引紧随其后
+constexpr size_t kKtx2HeaderSize = 80;
+
+// 支持直接上传的 VkFormat
+constexpr uint32_t kVkFormatR8G8B8A8Unorm = 37;
+constexpr uint32_t kVkFormatR8G8B8A8Srgb = 43;
+constexpr uint32_t kVkFormatEtc2R8G8B8Unorm = 147;
+constexpr uint32_t kVkFormatEtc2R8G8B8Srgb = 148;
+constexpr uint32_t kVkFormatEtc2R8G8B8A8Unorm = 151;
+constexpr uint32_t kVkFormatEtc2R8G8B8A8Srgb = 152;
+constexpr uint32_t kVkFormatAstc4x4Unorm = 157;
+constexpr uint32_t kVkFormatAstc4x4Srgb = 158;
+
+constexpr int kTargetUnknown = -1;
+std::atomic<int> gTranscodeTarget{kTargetUnknown};
+
+/**
+ * @brief VkFormat 对应的 GL 上传参数
+ */
+struct GlFormat {
+  GLenum internalFormat = 0;
+  GLenum format = 0;
+  GLenum type = 0;
+  bool compressed = false;
+};
+
+bool toGlFormat(uint32_t vkFormat, GlFormat &out) {
+  switch (vkFormat) {
+    case kVkFormatR8G8B8A8Unorm:
+    case kVkFormatR8G8B8A8Srgb:
+      out = {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, false};
+      return true;
+    case kVkFormatEtc2R8G8B8Unorm:
+    case kVkFormatEtc2R8G8B8Srgb:
+      out = {GL_COMPRESSED_RGB8_ETC2, GL_RGB, 0, true};
+      return true;
+    case kVkFormatEtc2R8G8B8A8Unorm:
+    case kVkFormatEtc2R8G8B8A8Srgb:
+      out = {GL_COMPRESSED_RGBA8_ETC2_EAC, GL_RGBA, 0, true};
+      return true;
+    case kVkFormatAstc4x4Unorm:
+    case kVkFormatAstc4x4Srgb:
+      out = {GL_COMPRESSED_RGBA_ASTC_4x4_KHR, GL_RGBA, 0, true};
+      return true;
+    default:
+      return false;
+  }
+}
+
+#ifdef LIGHTDIGITALHUMAN_HAS_LIBKTX
+/**
+ * @brief 经 libktx 加载（含 Zstd 解压）并按设备格式转码 Basis Universal 数据
+ */
+std::shared_ptr<ImageData> decodeWithLibktx(const uint8_t *data, size_t size,
+                                            KtxTranscodeTarget target,
+                                            std::string &error) {
+  ktxTexture2 *texture = nullptr;
+  KTX_error_code result = ktxTexture2_CreateFromMemory(
+      data, size, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture);
+  if (result != KTX_SUCCESS) {
+    error = ktxErrorString(result);
+    return nullptr;
+  }
+  std::unique_ptr<ktxTexture2, void (*)(ktxTexture2 *)> guard(
+      texture, [](ktxTexture2 *t) { ktxTexture_Destroy(ktxTexture(t)); });
+
+  if (texture->isArray || texture->numFaces != 1 ||
+      texture->baseDepth > 1) {
+    error = "KTX2 arrays and cube maps are not supported";
+    return nullptr;
+  }
+
+  if (ktxTexture2_NeedsTranscoding(texture)) {
+    ktx_transcode_fmt_e format = KTX_TTF_RGBA32;
+    switch (target) {
+      case KtxTranscodeTarget::ASTC_4x4:
+        format = KTX_TTF_ASTC_4x4_RGBA;
+        break;
+      case KtxTranscodeTarget::ETC2:
+        // 无 Alpha 通道时 ETC1 只占一半显存, 以 ETC2 RGB 格式上传
+        format = ktxTexture2_GetNumComponents(texture) <= 3 ? KTX_TTF_ETC1_RGB
+                                                            : KTX_TTF_ETC2_RGBA;
+        break;
+      case KtxTranscodeTarget::RGBA8:
+        break;
+    }
+    result = ktxTexture2_TranscodeBasis(texture, format, 0);
+    if (result != KTX_SUCCESS) {
+      error = std::string("transcode failed: ") + ktxErrorString(result);
+      return nullptr;
+    }
+  }
+
+  // 转码后 vkFormat 已更新为目标格式
+  GlFormat glFormat;
+  if (!toGlFormat(texture->vkFormat, glFormat)) {
+    error = "unsupported vkFormat " + std::to_string(texture->vkFormat);
+    return nullptr;
+  }
+
+  const uint32_t levelCount = std::max<uint32_t>(texture->numLevels, 1);
+  std::vector<KtxImageData::Level> levels(levelCount);
+  size_t totalSize = 0;
+  for (uint32_t level = 0; level < levelCount; ++level) {
+    ktx_size_t offset = 0;
+    result = ktxTexture_GetImageOffset(ktxTexture(texture), level, 0, 0,
+                                       &offset);
+    const ktx_size_t length = ktxTexture_GetImageSize(ktxTexture(texture),
+                                                      level);
+    if (result != KTX_SUCCESS || offset + length > texture->dataSize) {
+      error = "KTX2 level " + std::to_string(level) + " out of range";
+      return nullptr;
+    }
+    levels[level] = {static_cast<size_t>(offset), static_cast<size_t>(length)};
+    totalSize += static_cast<size_t>(length);
+  }
+
+  std::vector<uint8_t> pixels(totalSize);
+  size_t cursor = 0;
+  for (auto &level: levels) {
+    std::memcpy(pixels.data() + cursor, texture->pData + level.offset,
+                level.size);
+    level.offset = cursor;
+    cursor += level.size;
+  }
+  return std::make_shared<KtxImageData>(
+      static_cast<int>(texture->baseWidth),
+      static_cast<int>(texture->baseHeight), glFormat.internalFormat,
+      glFormat.format, glFormat.type, std::move(pixels), std::move(levels),
+      glFormat.compressed);
+}
+#else
+constexpr size_t kKtx2LevelIndexEntrySize = 24;
+constexpr uint32_t kVkFormatUndefined = 0;
+
+uint32_t readLE32(const uint8_t *data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint64_t readLE64(const uint8_t *data) {
+  uint64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+/**
+ * @brief 直接读取未超压缩的 KTX2（不依赖 libktx）
+ */
+std::shared_ptr<ImageData> decodeUncompressedKtx2(const uint8_t *data,
+                                                  size_t size,
+                                                  std::string &error) {
+  const uint32_t vkFormat = readLE32(data + 12);
+  const int width = static_cast<int>(readLE32(data + 20));
+  const int height = static_cast<int>(readLE32(data + 24));
+  const uint32_t levelCount = std::max<uint32_t>(readLE32(data + 40), 1);
+  const uint32_t supercompression = readLE32(data + 44);
+
+  GlFormat glFormat;
+  if (!toGlFormat(vkFormat, glFormat)) {
+    error = "unsupported vkFormat " + std::to_string(vkFormat);
+    return nullptr;
+  }
+  if (supercompression != 0) {
+    error = "supercompressed KTX2 requires libktx";
+    return nullptr;
+  }
+  if (readLE32(data + 28) > 1 || readLE32(data + 32) > 1 ||
+      readLE32(data + 36) != 1) {
+    error = "KTX2 arrays and cube maps are not supported";
+    return nullptr;
+  }
+  if (width <= 0 || height <= 0 || levelCount > 32 ||
+      kKtx2HeaderSize + levelCount * kKtx2LevelIndexEntrySize > size) {
+    error = "invalid KTX2 header";
+    return nullptr;
+  }
+
+  std::vector<KtxImageData::Level> levels(levelCount);
+  size_t totalSize = 0;
+  for (uint32_t level = 0; level < levelCount; ++level) {
+    const uint8_t *entry =
+        data + kKtx2HeaderSize + level * kKtx2LevelIndexEntrySize;
+    const uint64_t offset = readLE64(entry);
+    const uint64_t length = readLE64(entry + 8);
+    if (offset > size || length > size - offset) {
+      error = "KTX2 level " + std::to_string(level) + " out of range";
+      return nullptr;
+    }
+    levels[level] = {static_cast<size_t>(offset), static_cast<size_t>(length)};
+    totalSize += static_cast<size_t>(length);
+  }
+
+  // 层级数据连续存放到一块内存, 便于 ImageData 持有
+  std::vector<uint8_t> pixels(totalSize);
+  size_t cursor = 0;
+  for (auto &level: levels) {
+    std::memcpy(pixels.data() + cursor, data + level.offset, level.size);
+    level.offset = cursor;
+    cursor += level.size;
+  }
+  return std::make_shared<KtxImageData>(width, height, glFormat.internalFormat,
+                                        glFormat.format, glFormat.type,
+                                        std::move(pixels), std::move(levels),
+                                        glFormat.compressed);
+}
+#endif
+
+} // namespace
+
+bool KtxTextureDecoder::isKtx2(const uint8_t *data, size_t size) {
+  return data && size >= sizeof(kKtx2Identifier) &&
+      std::memcmp(data, kKtx2Identifier, sizeof(kKtx2Identifier)) == 0;
+}
+
+bool KtxTextureDecoder::isAvailable() {
+#ifdef LIGHTDIGITALHUMAN_HAS_LIBKTX
+  return true;
+#else
+  return false;
+#endif
+}
+
+void KtxTextureDecoder::detectDeviceFormats() {
+  const char *extensions =
+      reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+  // ETC2 是 OpenGL ES 3.0 的核心格式
+  KtxTranscodeTarget target = KtxTranscodeTarget::ETC2;
+  if (extensions && strstr(extensions, "GL_KHR_texture_compression_astc_ldr")) {
+    target = KtxTranscodeTarget::ASTC_4x4;
+  }
+  gTranscodeTarget.store(static_cast<int>(target));
+  LOGI("KTX2 transcode target: %s",
+       target == KtxTranscodeTarget::ASTC_4x4 ? "ASTC 4x4" : "ETC2");
+}
+
+KtxTranscodeTarget KtxTextureDecoder::getTranscodeTarget() {
+  if (gTranscodeTarget.load() == kTargetUnknown &&
+      eglGetCurrentContext() != EGL_NO_CONTEXT) {
+    detectDeviceFormats();
+  }
+  const int target = gTranscodeTarget.load();
+  return target == kTargetUnknown ? KtxTranscodeTarget::RGBA8
+                                  : static_cast<KtxTranscodeTarget>(target);
+}
+
+std::shared_ptr<ImageData> KtxTextureDecoder::decode(const uint8_t *data,
+                                                     size_t size,
+                                                     std::string &error) {
+  if (!isKtx2(data, size) || size < kKtx2HeaderSize) {
+    error = "not a KTX2 file";
+    return nullptr;
+  }
+#ifdef LIGHTDIGITALHUMAN_HAS_LIBKTX
+  return decodeWithLibktx(data, size, getTranscodeTarget(), error);
+#else
+  if (readLE32(data + 12) == kVkFormatUndefined) {
+    error = "Basis Universal transcoding requires libktx";
+    return nullptr;
+  }
+  return decodeUncompressedKtx2(data, size, error);
+#endif
+}
+
+GLenum KtxTextureDecoder::toSrgbFormat(GLenum internalFormat) {
+  switch (internalFormat) {
+    case GL_RGBA8:
+      return GL_SRGB8_ALPHA8;
+    case GL_COMPRESSED_RGB8_ETC2:
+      return GL_COMPRESSED_SRGB8_ETC2;
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+      return GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC;
+    case GL_COMPRESSED_RGBA_ASTC_4x4_KHR:
+      return GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR;
+    default:
+      return internalFormat;
+  }
+}
+
+} // namespace digitalhumans
@@ -0,0 +1,79 @@
+//
+// Created by vincentsyan on 2025/9/30.
+//
+
+#ifndef LIGHTDIGITALHUMAN_KTXTEXTUREDECODER_H
+#define LIGHTDIGITALHUMAN_KTXTEXTUREDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <GLES3/gl3.h>
+
+namespace digitalhumans {
+
+class ImageData;
+
+/**
+ * @brief Basis Universal 转码目标
+ */
+enum class KtxTranscodeTarget {
+  ASTC_4x4,   ///< GL_KHR_texture_compression_astc_ldr
+  ETC2,       ///< OpenGL ES 3.0 核心格式, 无 Alpha 时使用 ETC1 子集
+  RGBA8,      ///< 未检测到压缩格式时的非压缩回退
+};
+
+/**
+ * @brief KTX2 / KHR_texture_basisu 纹理解码器
+ *
+ * Basis Universal 数据按设备支持的格式转码（ASTC 优先, 其次 ETC2）,
+ * 输出带完整 mip 链的 KtxImageData, 由 GltfOpenGLContext 以
+ * glCompressedTexImage2D 逐级上传, 不再需要 glGenerateMipmap。
+ * 已是 GPU 格式的 KTX2 只接受 RGBA8 / ETC2 / ASTC 4x4。
+ *
+ * 转码与 Zstd 解压依赖 libktx, 只在定义了 LIGHTDIGITALHUMAN_HAS_LIBKTX 的构建中可用
+ * （Android）; 其余构建只能读取未超压缩的 KTX2, Basis 数据解码失败,
+ * 纹理回退到 texture.source 指向的图像。
+ */
+class KtxTextureDecoder {
+ public:
+  /**
+   * @brief 是否以 KTX2 文件标识开头
+   */
+  static bool isKtx2(const uint8_t *data, size_t size);
+
+  /**
+   * @brief 当前构建是否支持 Basis Universal 转码
+   */
+  static bool isAvailable();
+
+  /**
+   * @brief 检测设备支持的压缩纹理格式, 需在 GL 线程调用
+   *
+   * 解码在工作线程执行, 无法查询 GL, 因此检测结果全局保存。
+   */
+  static void detectDeviceFormats();
+
+  /**
+   * @brief 转码目标; 尚未检测且当前线程有 GL 上下文时先检测
+   */
+  static KtxTranscodeTarget getTranscodeTarget();
+
+  /**
+   * @brief 解码 KTX2 数据, 可在任意线程调用
+   * @param error 失败原因
+   * @return 失败返回 nullptr
+   */
+  static std::shared_ptr<ImageData> decode(const uint8_t *data, size_t size,
+                                           std::string &error);
+
+  /**
+   * @brief 内部格式对应的 sRGB 格式, 没有 sRGB 变体时原样返回
+   */
+  static GLenum toSrgbFormat(GLenum internalFormat);
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_KTXTEXTUREDECODER_H
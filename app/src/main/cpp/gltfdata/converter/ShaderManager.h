@@ -6,6 +6,7 @@
 #define LIGHTDIGITALHUMAN_SHADERMANAGER_H
 
 #include "../GltfRenderer.h"
+#include "../../utils/AssetProvider.h"
 #include <memory>
 
 namespace digitalhumans {
@@ -45,6 +46,41 @@ class ShaderManager {
     shaderFiles_ = files;
   }
 
+  /**
+   * @brief 从资源目录读取全部 GLSL 源码（pbrshader/ 与 iblshader/）
+   * @param provider 资源读取接口
+   * @return 是否全部读取成功
+   */
+  bool loadShaderFiles(const AssetProvider &provider) {
+    GLSLStringFiles files;
+    bool ok = true;
+    auto read = [&](const char *path, std::string &out) {
+      if (!provider.readText(path, out)) {
+        ok = false;
+      }
+    };
+    read("pbrshader/animation.glsl", files.animation);
+    read("pbrshader/brdf.glsl", files.brdf);
+    read("pbrshader/cubemap.frag", files.cubemap);
+    read("pbrshader/cubemap.vert", files.cubemap_vert);
+    read("pbrshader/functions.glsl", files.functions);
+    read("pbrshader/ibl.glsl", files.ibl);
+    read("pbrshader/iridescence.glsl", files.iridescence);
+    read("pbrshader/material_info.glsl", files.material_info);
+    read("pbrshader/pbr.frag", files.pbr);
+    read("pbrshader/primitive.vert", files.primitive);
+    read("pbrshader/punctual.glsl", files.punctual);
+    read("pbrshader/specular_glossiness.frag", files.specular_glossiness);
+    read("pbrshader/textures.glsl", files.textures);
+    read("pbrshader/tonemapping.glsl", files.tonemapping);
+    read("iblshader/fullscreen.vert", files.fullscreen);
+    read("iblshader/panorama_to_cubemap.frag", files.panorama_to_cubemap);
+    read("iblshader/ibl_filtering.frag", files.ibl_filtering);
+    read("iblshader/debug.frag", files.debug);
+    setShaderFiles(files);
+    return ok;
+  }
+
   [[nodiscard]] const GLSLStringFiles &getShaderFiles() const {
     return shaderFiles_;
   }
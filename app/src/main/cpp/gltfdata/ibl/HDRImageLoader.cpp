@@ -2,27 +2,30 @@
 // Created by vincentsyan on 2025/9/16.
 //
 #include "HDRImageLoader.h"
-#include <android/log.h>
+#include <cstring>
 #include "stb_image.h"
 #include "../ibl_sampler.h"
-
-#define LOG_TAG "HDRImageLoader"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#include "../../utils/LogUtils.h"
 
 namespace digitalhumans {
 
-AAssetManager *HDRImageLoader::assetManager_ = nullptr;
+std::shared_ptr<AssetProvider> HDRImageLoader::assetProvider_ = nullptr;
 
+#ifdef __ANDROID__
 void HDRImageLoader::setAssetManager(AAssetManager *assetManager) {
-  assetManager_ = assetManager;
+  setAssetProvider(std::make_shared<AndroidAssetProvider>(assetManager));
   LOGI("AssetManager set successfully");
 }
+#endif
+
+void HDRImageLoader::setAssetProvider(std::shared_ptr<AssetProvider> provider) {
+  assetProvider_ = std::move(provider);
+}
 
 HDRImage HDRImageLoader::loadFromAssets(const std::string &assetPath) {
   HDRImage image;
-  if (!assetManager_) {
-    LOGE("AssetManager not set!");
+  if (!assetProvider_) {
+    LOGE("AssetProvider not set!");
     return image;
   }
 
@@ -78,26 +81,9 @@ HDRImage HDRImageLoader::loadFromFile(const std::string &filePath) {
 std::vector<uint8_t>
 HDRImageLoader::readAssetFile(const std::string &assetPath) {
   std::vector<uint8_t> data;
-  AAsset *asset =
-      AAssetManager_open(assetManager_, assetPath.c_str(), AASSET_MODE_BUFFER);
-  if (!asset) {
-    LOGE("Failed to open asset: %s", assetPath.c_str());
-    return data;
-  }
-  off_t fileSize = AAsset_getLength(asset);
-  if (fileSize <= 0) {
-    LOGE("Invalid asset size: %ld", fileSize);
-    AAsset_close(asset);
-    return data;
-  }
-  data.resize(static_cast<size_t>(fileSize));
-  int bytesRead = AAsset_read(asset, data.data(), fileSize);
-  if (bytesRead != fileSize) {
-    LOGE(" Failed to read complete asset file. Expected: %ld, Read: %d",
-         fileSize, bytesRead);
+  if (!assetProvider_->readFile(assetPath, data)) {
     data.clear();
   }
-  AAsset_close(asset);
   return data;
 }
 
@@ -4,20 +4,24 @@
 
 #ifndef LIGHTDIGITALHUMAN_HDRIMAGELOADER_H
 #define LIGHTDIGITALHUMAN_HDRIMAGELOADER_H
-#include <android/asset_manager.h>
+#include <memory>
 #include <string>
 #include <vector>
+#include "../../utils/AssetProvider.h"
 namespace digitalhumans {
 class HDRImage;
 
 class HDRImageLoader {
  public:
+#ifdef __ANDROID__
   static void setAssetManager(AAssetManager *assetManager);
+#endif
+  static void setAssetProvider(std::shared_ptr<AssetProvider> provider);
   static HDRImage loadFromAssets(const std::string &assetPath);
   static HDRImage loadFromFile(const std::string &filePath);
 
  private:
-  static AAssetManager *assetManager_;
+  static std::shared_ptr<AssetProvider> assetProvider_;
   static std::vector<uint8_t> readAssetFile(const std::string &assetPath);
 };
 } // digitalhumans
@@ -0,0 +1,301 @@
+//
+// Created by vincentsyan on 2025/10/9.
+//
+
+#include "IBLAssetLoader.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <vector>
+#include <GLES3/gl3.h>
+#include "stb_image.h"
+#include "Ktx1File.h"
+#include "../ibl_sampler.h"
+#include "../../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr int kCubeFaceCount = 6;
+constexpr int kShCoefficientCount = 9;
+constexpr int kIrradianceSize = 32;     ///< 由球谐生成的辐照度贴图边长
+constexpr int kCharlieLutSize = 64;
+constexpr int kCharlieLutSamples = 512; ///< 与 IBLSampler::sampleLut 一致
+constexpr float kPi = 3.14159265358979f;
+
+/**
+ * @brief 检查上传结果, 失败时删除纹理
+ */
+GLuint finishUpload(GLuint texture, const char *name) {
+  GLenum error = glGetError();
+  if (error != GL_NO_ERROR) {
+    LOGE("Failed to upload %s: 0x%x", name, error);
+    glDeleteTextures(1, &texture);
+    return 0;
+  }
+  return texture;
+}
+
+/**
+ * @brief 解析 9 个 RGB 球谐系数
+ * 每行一个系数, 兼容 "r g b" 与 sh.txt 的 "( r, g, b); // 注释" 两种写法
+ */
+bool parseShCoefficients(const std::string &text,
+                         std::array<std::array<float, 3>, kShCoefficientCount>
+                         &coefficients) {
+  std::istringstream lines(text);
+  std::string line;
+  int count = 0;
+  while (count < kShCoefficientCount && std::getline(lines, line)) {
+    line = line.substr(0, line.find("//"));
+    std::replace_if(line.begin(), line.end(), [](char c) {
+      return c == '(' || c == ')' || c == ',' || c == ';';
+    }, ' ');
+    std::istringstream values(line);
+    auto &coefficient = coefficients[count];
+    if (values >> coefficient[0] >> coefficient[1] >> coefficient[2]) {
+      ++count;
+    }
+  }
+  return count == kShCoefficientCount;
+}
+
+/**
+ * @brief 由预缩放的辐照度球谐生成 Lambertian 立方体贴图
+ * 系数已包含卷积与 1/π, 按 cmgen 约定的基函数直接求和
+ */
+GLuint createIrradianceFromSh(
+    const std::array<std::array<float, 3>, kShCoefficientCount> &sh) {
+  const size_t faceFloats =
+      static_cast<size_t>(kIrradianceSize) * kIrradianceSize * 3;
+  std::vector<float> pixels(faceFloats * kCubeFaceCount);
+  Ktx1Texture texture;
+  texture.internalFormat = GL_RGB16F;
+  texture.format = GL_RGB;
+  texture.type = GL_FLOAT;
+  texture.typeSize = sizeof(float);
+  texture.width = kIrradianceSize;
+  texture.height = kIrradianceSize;
+  texture.faceCount = kCubeFaceCount;
+  texture.levels.resize(1);
+  texture.levels[0].faceSize =
+      static_cast<uint32_t>(faceFloats * sizeof(float));
+  for (int face = 0; face < kCubeFaceCount; ++face) {
+    float *out = pixels.data() + face * faceFloats;
+    texture.levels[0].faces[face] = reinterpret_cast<const uint8_t *>(out);
+    for (int y = 0; y < kIrradianceSize; ++y) {
+      const float t = (2.0f * y + 1.0f) / kIrradianceSize - 1.0f;
+      for (int x = 0; x < kIrradianceSize; ++x) {
+        const float s = (2.0f * x + 1.0f) / kIrradianceSize - 1.0f;
+        // OpenGL 立方体贴图各面纹理坐标到方向的映射
+        float direction[kCubeFaceCount][3] = {
+            {1.0f, -t, -s}, {-1.0f, -t, s}, {s, 1.0f, t},
+            {s, -1.0f, -t}, {s, -t, 1.0f}, {-s, -t, -1.0f},
+        };
+        const float *d = direction[face];
+        const float length =
+            std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        const float nx = d[0] / length;
+        const float ny = d[1] / length;
+        const float nz = d[2] / length;
+        const float basis[kShCoefficientCount] = {
+            1.0f, ny, nz, nx, ny * nx, ny * nz, 3.0f * nz * nz - 1.0f,
+            nz * nx, nx * nx - ny * ny,
+        };
+        for (int c = 0; c < 3; ++c) {
+          float value = 0.0f;
+          for (int i = 0; i < kShCoefficientCount; ++i) {
+            value += sh[i][c] * basis[i];
+          }
+          *out++ = std::max(value, 0.0f);
+        }
+      }
+    }
+  }
+  return Ktx1File::upload(texture, "irradiance");
+}
+
+GLuint createLutTexture(int width, int height, const uint8_t *rgb) {
+  while (glGetError() != GL_NO_ERROR) {
+  }
+  GLuint texture = 0;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB,
+               GL_UNSIGNED_BYTE, rgb);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  return finishUpload(texture, "LUT");
+}
+
+/**
+ * @brief 解码 GGX BRDF LUT, 图像首行为粗糙度 1, 上传前翻转为纹理行序
+ */
+GLuint loadBrdfLut(const std::vector<uint8_t> &file) {
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  stbi_uc *data = stbi_load_from_memory(file.data(),
+                                        static_cast<int>(file.size()),
+                                        &width, &height, &channels, 3);
+  if (!data) {
+    LOGE("Failed to decode BRDF LUT: %s", stbi_failure_reason());
+    return 0;
+  }
+  const size_t rowBytes = static_cast<size_t>(width) * 3;
+  std::vector<uint8_t> rgb(rowBytes * height);
+  for (int y = 0; y < height; ++y) {
+    std::memcpy(rgb.data() + y * rowBytes,
+                data + static_cast<size_t>(height - 1 - y) * rowBytes,
+                rowBytes);
+  }
+  stbi_image_free(data);
+  return createLutTexture(width, height, rgb.data());
+}
+
+float radicalInverse(uint32_t bits) {
+  bits = (bits << 16u) | (bits >> 16u);
+  bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+  bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+  bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+  bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+  return static_cast<float>(bits) * 2.3283064365386963e-10f;
+}
+
+/**
+ * @brief 按 ibl_filtering.frag 的 LUT(NdotV, roughness) 计算 Charlie 光泽 LUT
+ * 结果写入蓝色通道（着色器读取 .b）, 与环境无关, 进程内只计算一次
+ */
+const std::vector<uint8_t> &getCharlieLut() {
+  static const std::vector<uint8_t> lut = [] {
+    std::vector<uint8_t> rgb(
+        static_cast<size_t>(kCharlieLutSize) * kCharlieLutSize * 3, 0);
+    for (int y = 0; y < kCharlieLutSize; ++y) {
+      const float roughness = (y + 0.5f) / kCharlieLutSize;
+      const float alpha = roughness * roughness;
+      const float invR = 1.0f / std::max(roughness, 0.000001f);
+      for (int x = 0; x < kCharlieLutSize; ++x) {
+        const float NdotV = (x + 0.5f) / kCharlieLutSize;
+        const float vx = std::sqrt(1.0f - NdotV * NdotV);
+        float sum = 0.0f;
+        for (int i = 0; i < kCharlieLutSamples; ++i) {
+          const float phi =
+              2.0f * kPi * static_cast<float>(i) / kCharlieLutSamples;
+          const float sinTheta = std::pow(radicalInverse(i),
+                                          alpha / (2.0f * alpha + 1.0f));
+          const float cosTheta = std::sqrt(1.0f - sinTheta * sinTheta);
+          const float hx = sinTheta * std::cos(phi);
+          const float hz = cosTheta;
+          // L = reflect(-V, H), 只需要 z 分量
+          const float VdotH = vx * hx + NdotV * hz;
+          const float NdotL = std::clamp(2.0f * VdotH * hz - NdotV, 0.0f, 1.0f);
+          if (NdotL <= 0.0f) {
+            continue;
+          }
+          const float NdotH = std::clamp(hz, 0.0f, 1.0f);
+          const float sin2h = 1.0f - NdotH * NdotH;
+          const float distribution =
+              (2.0f + invR) * std::pow(sin2h, invR * 0.5f) / (2.0f * kPi);
+          const float visibility = std::clamp(
+              1.0f / (4.0f * (NdotL + NdotV - NdotL * NdotV)), 0.0f, 1.0f);
+          sum += visibility * distribution * NdotL *
+              std::clamp(VdotH, 0.0f, 1.0f);
+        }
+        const float value = 4.0f * 2.0f * kPi * sum / kCharlieLutSamples;
+        rgb[(static_cast<size_t>(y) * kCharlieLutSize + x) * 3 + 2] =
+            static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+      }
+    }
+    return rgb;
+  }();
+  return lut;
+}
+
+std::string joinPath(const std::string &dir, const char *name) {
+  if (dir.empty()) {
+    return name;
+  }
+  return dir.back() == '/' ? dir + name : dir + "/" + name;
+}
+
+} // namespace
+
+bool IBLAssetLoader::load(const AssetProvider &provider,
+                          const std::string &envDir,
+                          EnvironmentMapTextures &textures) {
+  auto startTime = std::chrono::high_resolution_clock::now();
+
+  std::vector<uint8_t> specularFile;
+  Ktx1Texture specular;
+  if (!provider.readFile(joinPath(envDir, "specular.ktx"), specularFile) ||
+      !Ktx1File::parse(specularFile.data(), specularFile.size(), specular) ||
+      !specular.isCubemap()) {
+    LOGE("Failed to read specular environment: %s", envDir.c_str());
+    return false;
+  }
+  std::vector<uint8_t> brdfFile;
+  if (!provider.readFile(joinPath(envDir, "brdf.ktx"), brdfFile)) {
+    LOGE("Failed to read BRDF LUT: %s", envDir.c_str());
+    return false;
+  }
+
+  EnvironmentMapTextures result;
+  result.specular = Ktx1File::upload(specular, "specular.ktx");
+  result.mipCount = static_cast<int>(specular.levels.size());
+  result.ggxLut = loadBrdfLut(brdfFile);
+
+  // 辐照度优先由镜面贴图自带的球谐生成, 保证漫反射与镜面属于同一环境
+  const std::string *specularSh = specular.findMetadata("sh");
+  std::string shText;
+  std::array<std::array<float, 3>, kShCoefficientCount> sh{};
+  if ((specularSh && parseShCoefficients(*specularSh, sh)) ||
+      (provider.readText(joinPath(envDir, "sh.txt"), shText) &&
+          parseShCoefficients(shText, sh))) {
+    result.diffuse = createIrradianceFromSh(sh);
+  } else {
+    std::vector<uint8_t> diffuseFile;
+    Ktx1Texture diffuse;
+    if (provider.readFile(joinPath(envDir, "diffuse.ktx"), diffuseFile) &&
+        Ktx1File::parse(diffuseFile.data(), diffuseFile.size(), diffuse) &&
+        diffuse.isCubemap()) {
+      // 带 mip 链的是预滤波镜面贴图, 不能当作辐照度使用
+      if (diffuse.levels.size() == 1) {
+        result.diffuse = Ktx1File::upload(diffuse, "diffuse.ktx");
+      } else {
+        LOGW("diffuse.ktx in %s has %zu mip levels, not an irradiance map",
+             envDir.c_str(), diffuse.levels.size());
+      }
+    }
+  }
+  if (result.diffuse == 0) {
+    LOGE("No irradiance data in %s", envDir.c_str());
+  }
+
+  const auto &charlieLut = getCharlieLut();
+  result.charlieLut =
+      createLutTexture(kCharlieLutSize, kCharlieLutSize, charlieLut.data());
+  result.sheen = result.specular;
+
+  if (!result.isValid() || result.charlieLut == 0) {
+    LOGE("Failed to create IBL textures from %s", envDir.c_str());
+    result.release();
+    return false;
+  }
+  textures = result;
+
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::high_resolution_clock::now() - startTime).count();
+  LOGI("IBL loaded from %s in %lld ms", envDir.c_str(),
+       static_cast<long long>(duration));
+  return true;
+}
+
+} // namespace digitalhumans
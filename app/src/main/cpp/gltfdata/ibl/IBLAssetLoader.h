@@ -0,0 +1,44 @@
+//
+// Created by vincentsyan on 2025/10/9.
+//
+
+#ifndef LIGHTDIGITALHUMAN_IBLASSETLOADER_H
+#define LIGHTDIGITALHUMAN_IBLASSETLOADER_H
+
+#include <string>
+#include "../../utils/AssetProvider.h"
+
+namespace digitalhumans {
+
+struct EnvironmentMapTextures;
+
+/**
+ * @brief 从预滤波的环境资源目录加载 IBL 纹理, 跳过 IBLSampler 的 GPU 预处理
+ *
+ * 目录结构（如 "envs"、"envs/studio"）:
+ *   - specular.ktx: KTX1 立方体贴图, 每级 mip 对应一个 GGX 粗糙度, 必需;
+ *                   元数据 "sh" 为 cmgen 写入的 9 个预缩放辐照度球谐系数
+ *   - brdf.ktx:     GGX BRDF LUT（RG 为 scale/bias, 实际为 PNG 编码）, 必需
+ *   - sh.txt:       球谐系数, specular.ktx 不含 "sh" 时使用
+ *   - diffuse.ktx:  单级 Lambertian 辐照度立方体贴图, 没有球谐时使用
+ * 辐照度贴图由球谐在 CPU 上生成（32x32）, 体积小且与镜面贴图一致。
+ * 资源不含光泽（sheen）数据: 光泽环境贴图复用镜面贴图,
+ * Charlie LUT 与环境无关, 在 CPU 上计算一次后复用。
+ * 需在 GL 线程调用。
+ */
+class IBLAssetLoader {
+ public:
+  /**
+   * @brief 读取环境目录并创建 IBL 纹理
+   * @param provider 资源读取
+   * @param envDir 环境目录（相对资源根目录）
+   * @param textures 输出的 IBL 纹理, 失败时不保留任何纹理
+   * @return 是否成功
+   */
+  static bool load(const AssetProvider &provider, const std::string &envDir,
+                   EnvironmentMapTextures &textures);
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_IBLASSETLOADER_H
@@ -0,0 +1,265 @@
+//
+// Created by vincentsyan on 2025/10/10.
+//
+
+#include "IBLBakeCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include <GLES3/gl3.h>
+#include "gtc/packing.hpp"
+#include "Ktx1File.h"
+#include "../ibl_sampler.h"
+#include "../../utils/ContentHash.h"
+#include "../../utils/LogUtils.h"
+#include "../../utils/MappedFile.h"
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr const char *kLambertianFile = "lambertian.ktx";
+constexpr const char *kGgxFile = "ggx.ktx";
+constexpr const char *kCharlieFile = "charlie.ktx";
+constexpr const char *kGgxLutFile = "ggx_lut.ktx";
+constexpr const char *kCharlieLutFile = "charlie_lut.ktx";
+constexpr const char *kMipCountKey = "mipCount";  ///< ggx.ktx 中着色器使用的 mip 层数
+
+/**
+ * @brief 读回像素与写入文件使用的格式
+ */
+struct ReadbackFormat {
+  GLenum internalFormat = 0;  ///< 缓存文件的内部格式
+  GLenum fileType = 0;        ///< 文件中的像素类型
+  uint32_t typeSize = 0;
+  GLenum readType = 0;        ///< glReadPixels 使用的类型
+};
+
+bool getReadbackFormat(GLint internalFormat, ReadbackFormat &format) {
+  switch (internalFormat) {
+    case GL_RGBA16F:
+    case GL_RGBA32F:
+      // 浮点颜色缓冲只保证 RGBA/FLOAT 读回; 着色只需半精度, 统一按 RGBA16F 写入,
+      // 体积减半且无需 OES_texture_float_linear 即可线性过滤
+      format = {GL_RGBA16F, GL_HALF_FLOAT, 2, GL_FLOAT};
+      return true;
+    case GL_RGBA8:
+      format = {GL_RGBA8, GL_UNSIGNED_BYTE, 1, GL_UNSIGNED_BYTE};
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::string pathOf(const std::filesystem::path &dir, const char *name) {
+  return (dir / name).string();
+}
+
+/**
+ * @brief 读回纹理的所有级别并写入 KTX1 文件
+ */
+bool writeTexture(const std::string &path, GLuint texture, bool cubemap,
+                  int size, int levelCount, GLint internalFormat,
+                  const std::vector<std::pair<std::string, std::string>>
+                  &metadata = {}) {
+  ReadbackFormat format;
+  if (!getReadbackFormat(internalFormat, format)) {
+    LOGW("Unsupported IBL texture format for caching: 0x%x", internalFormat);
+    return false;
+  }
+
+  Ktx1Texture ktx;
+  ktx.internalFormat = format.internalFormat;
+  ktx.format = GL_RGBA;
+  ktx.type = format.fileType;
+  ktx.typeSize = format.typeSize;
+  ktx.width = static_cast<uint32_t>(size);
+  ktx.height = static_cast<uint32_t>(size);
+  ktx.faceCount = cubemap ? Ktx1Texture::kMaxFaceCount : 1;
+  ktx.metadata = metadata;
+  ktx.levels.resize(levelCount);
+
+  // 只检查读回本身产生的错误
+  while (glGetError() != GL_NO_ERROR) {
+  }
+  GLint previousFramebuffer = 0;
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+  GLuint framebuffer = 0;
+  glGenFramebuffers(1, &framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+  std::vector<std::vector<uint8_t>> storage;
+  std::vector<float> floats;
+  bool success = true;
+  for (int level = 0; level < levelCount && success; ++level) {
+    const int levelSize = std::max(size >> level, 1);
+    const size_t componentCount = static_cast<size_t>(levelSize) * levelSize * 4;
+    auto &entry = ktx.levels[level];
+    entry.faceSize = static_cast<uint32_t>(componentCount * format.typeSize);
+    for (uint32_t face = 0; face < ktx.faceCount; ++face) {
+      const GLenum target =
+          cubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D;
+      glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target,
+                             texture, level);
+      if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        LOGW("IBL texture level %d is not readable", level);
+        success = false;
+        break;
+      }
+      storage.emplace_back(entry.faceSize);
+      auto &pixels = storage.back();
+      if (format.fileType == GL_HALF_FLOAT) {
+        floats.resize(componentCount);
+        glReadPixels(0, 0, levelSize, levelSize, GL_RGBA, GL_FLOAT,
+                     floats.data());
+        auto *half = reinterpret_cast<uint16_t *>(pixels.data());
+        for (size_t i = 0; i < componentCount; ++i) {
+          half[i] = glm::packHalf1x16(floats[i]);
+        }
+      } else {
+        glReadPixels(0, 0, levelSize, levelSize, GL_RGBA, format.readType,
+                     pixels.data());
+      }
+      entry.faces[face] = pixels.data();
+    }
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+  glDeleteFramebuffers(1, &framebuffer);
+  GLenum error = glGetError();
+  if (error != GL_NO_ERROR) {
+    LOGW("Failed to read back IBL texture: 0x%x", error);
+    return false;
+  }
+  return success && Ktx1File::write(path, ktx);
+}
+
+GLuint loadTexture(const std::string &path, bool cubemap,
+                   int *mipCount = nullptr) {
+  auto file = MappedFile::open(path);
+  Ktx1Texture ktx;
+  if (!file || !Ktx1File::parse(file->data(), file->size(), ktx) ||
+      ktx.isCubemap() != cubemap) {
+    LOGW("Invalid IBL cache file: %s", path.c_str());
+    return 0;
+  }
+  if (mipCount) {
+    const std::string *value = ktx.findMetadata(kMipCountKey);
+    *mipCount = value ? std::atoi(value->c_str()) : 0;
+  }
+  return Ktx1File::upload(ktx, path.c_str());
+}
+
+/**
+ * @brief 将写好的临时目录替换为缓存目录
+ */
+bool commitDirectory(const std::filesystem::path &tempDir,
+                     const std::filesystem::path &dir) {
+  std::error_code error;
+  std::filesystem::rename(tempDir, dir, error);
+  if (error) {
+    // 可能已由其他引擎写入
+    std::filesystem::remove_all(tempDir, error);
+    return std::filesystem::is_directory(dir, error);
+  }
+  return true;
+}
+
+} // namespace
+
+IBLBakeKey IBLBakeKey::make(const HDRImage &image, const IBLSampler &sampler) {
+  IBLBakeKey key;
+  key.settings = sampler.getSettingsHash();
+  const int size[] = {image.width, image.height};
+  uint64_t seed = hash::hashBytes(size, sizeof(size), key.settings);
+  key.environment = hash::hashBytes(image.dataFloat.data(),
+                                    image.dataFloat.size() * sizeof(float),
+                                    seed);
+  return key;
+}
+
+bool IBLBakeCache::load(const std::string &cacheDir, const IBLBakeKey &key,
+                        EnvironmentMapTextures &textures) {
+  auto startTime = std::chrono::high_resolution_clock::now();
+  const std::filesystem::path root(cacheDir);
+  const auto environmentDir = root / hash::toHex(key.environment);
+  const auto lutDir = root / ("lut_" + hash::toHex(key.settings));
+  std::error_code error;
+  if (!std::filesystem::is_directory(environmentDir, error) ||
+      !std::filesystem::is_directory(lutDir, error)) {
+    return false;
+  }
+
+  EnvironmentMapTextures result;
+  result.diffuse = loadTexture(pathOf(environmentDir, kLambertianFile), true);
+  result.specular = loadTexture(pathOf(environmentDir, kGgxFile), true,
+                                &result.mipCount);
+  result.sheen = loadTexture(pathOf(environmentDir, kCharlieFile), true);
+  result.ggxLut = loadTexture(pathOf(lutDir, kGgxLutFile), false);
+  result.charlieLut = loadTexture(pathOf(lutDir, kCharlieLutFile), false);
+
+  if (!result.isValid() || result.sheen == 0 || result.charlieLut == 0 ||
+      result.mipCount <= 0) {
+    result.release();
+    return false;
+  }
+  textures = result;
+
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::high_resolution_clock::now() - startTime).count();
+  LOGI("IBL loaded from cache %s in %lld ms", environmentDir.c_str(),
+       static_cast<long long>(duration));
+  return true;
+}
+
+bool IBLBakeCache::store(const std::string &cacheDir, const IBLBakeKey &key,
+                         const EnvironmentMapTextures &textures,
+                         const IBLSampler &sampler) {
+  const std::filesystem::path root(cacheDir);
+  const auto environmentDir = root / hash::toHex(key.environment);
+  const auto lutDir = root / ("lut_" + hash::toHex(key.settings));
+  const GLint format = sampler.getTextureFormat();
+  const int size = sampler.getTextureSize();
+  const int levels = sampler.getFilteredLevelCount();
+  std::error_code error;
+
+  // 先写临时目录再整体替换, 不会留下不完整的缓存
+  if (!std::filesystem::is_directory(lutDir, error)) {
+    auto tempDir = lutDir;
+    tempDir += ".tmp";
+    std::filesystem::remove_all(tempDir, error);
+    const int lutSize = sampler.getLutResolution();
+    if (!writeTexture(pathOf(tempDir, kGgxLutFile), textures.ggxLut, false,
+                      lutSize, 1, format) ||
+        !writeTexture(pathOf(tempDir, kCharlieLutFile), textures.charlieLut,
+                      false, lutSize, 1, format) ||
+        !commitDirectory(tempDir, lutDir)) {
+      std::filesystem::remove_all(tempDir, error);
+      return false;
+    }
+  }
+
+  auto tempDir = environmentDir;
+  tempDir += ".tmp";
+  std::filesystem::remove_all(tempDir, error);
+  if (!writeTexture(pathOf(tempDir, kLambertianFile), textures.diffuse, true,
+                    size, 1, format) ||
+      !writeTexture(pathOf(tempDir, kGgxFile), textures.specular, true, size,
+                    levels, format,
+                    {{kMipCountKey, std::to_string(textures.mipCount)}}) ||
+      !writeTexture(pathOf(tempDir, kCharlieFile), textures.sheen, true, size,
+                    levels, format) ||
+      !commitDirectory(tempDir, environmentDir)) {
+    std::filesystem::remove_all(tempDir, error);
+    return false;
+  }
+  LOGI("IBL cache written: %s", environmentDir.c_str());
+  return true;
+}
+
+} // namespace digitalhumans
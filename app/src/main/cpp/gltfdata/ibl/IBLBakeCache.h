@@ -0,0 +1,70 @@
+//
+// Created by vincentsyan on 2025/10/10.
+//
+
+#ifndef LIGHTDIGITALHUMAN_IBLBAKECACHE_H
+#define LIGHTDIGITALHUMAN_IBLBAKECACHE_H
+
+#include <cstdint>
+#include <string>
+
+namespace digitalhumans {
+
+struct EnvironmentMapTextures;
+
+class HDRImage;
+
+class IBLSampler;
+
+/**
+ * @brief IBL 烘焙缓存的键
+ */
+struct IBLBakeKey {
+  uint64_t environment = 0;  ///< HDR 像素、尺寸与预处理参数的哈希
+  uint64_t settings = 0;     ///< 预处理参数的哈希, LUT 与环境无关, 只由它决定
+
+  /**
+   * @brief 计算 HDR 全景图在当前预处理参数下的键
+   */
+  static IBLBakeKey make(const HDRImage &image, const IBLSampler &sampler);
+
+  bool isValid() const { return environment != 0; }
+
+  bool operator==(const IBLBakeKey &other) const {
+    return environment == other.environment && settings == other.settings;
+  }
+};
+
+/**
+ * @brief IBL 预处理结果的磁盘缓存
+ *
+ * IBLSampler::filterAll 的输出读回 CPU 后按 KTX1 写入缓存目录（浮点纹理存为 RGBA16F）,
+ * 之后加载只需上传纹理:
+ *   <缓存目录>/<environment>/lambertian.ktx, ggx.ktx, charlie.ktx
+ *   <缓存目录>/lut_<settings>/ggx_lut.ktx, charlie_lut.ktx
+ * LUT 只与预处理参数有关, 所有环境共用一份。
+ * 目录名即键, HDR 内容或预处理参数（包括滤波着色器）变化后自然不再命中。
+ * 需在 GL 线程调用。
+ */
+class IBLBakeCache {
+ public:
+  /**
+   * @brief 从缓存加载 IBL 纹理
+   * @return 缓存不存在或数据损坏时返回 false, 不保留任何纹理
+   */
+  static bool load(const std::string &cacheDir, const IBLBakeKey &key,
+                   EnvironmentMapTextures &textures);
+
+  /**
+   * @brief 读回预处理结果并写入缓存
+   * @param sampler 生成 textures 的 IBLSampler, 提供尺寸与格式
+   * @return 读回或写入失败时返回 false
+   */
+  static bool store(const std::string &cacheDir, const IBLBakeKey &key,
+                    const EnvironmentMapTextures &textures,
+                    const IBLSampler &sampler);
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_IBLBAKECACHE_H
@@ -0,0 +1,248 @@
+//
+// Created by vincentsyan on 2025/10/10.
+//
+
+#include "Ktx1File.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "../../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+namespace {
+
+constexpr uint8_t kKtx1Identifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+constexpr uint32_t kKtx1Endianness = 0x04030201;
+constexpr size_t kKtx1HeaderSize = 64;
+
+uint32_t readLE32(const uint8_t *data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+size_t align4(size_t value) {
+  return (value + 3) & ~static_cast<size_t>(3);
+}
+
+void writeLE32(std::ofstream &out, uint32_t value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void writePadding(std::ofstream &out, size_t size) {
+  static const char kZeros[4] = {};
+  out.write(kZeros, static_cast<std::streamsize>(align4(size) - size));
+}
+
+} // namespace
+
+const std::string *Ktx1Texture::findMetadata(const std::string &key) const {
+  for (const auto &[name, value]: metadata) {
+    if (name == key) {
+      return &value;
+    }
+  }
+  return nullptr;
+}
+
+bool Ktx1File::parse(const uint8_t *data, size_t size, Ktx1Texture &texture) {
+  if (size < kKtx1HeaderSize ||
+      std::memcmp(data, kKtx1Identifier, sizeof(kKtx1Identifier)) != 0) {
+    LOGE("Not a KTX1 file");
+    return false;
+  }
+  const uint8_t *header = data + sizeof(kKtx1Identifier);
+  if (readLE32(header) != kKtx1Endianness) {
+    LOGE("Big-endian KTX1 files are not supported");
+    return false;
+  }
+  texture.type = readLE32(header + 4);
+  texture.typeSize = readLE32(header + 8);
+  texture.format = readLE32(header + 12);
+  texture.internalFormat = readLE32(header + 16);
+  texture.width = readLE32(header + 24);
+  texture.height = readLE32(header + 28);
+  const uint32_t depth = readLE32(header + 32);
+  const uint32_t arrayElements = readLE32(header + 36);
+  texture.faceCount = readLE32(header + 40);
+  const uint32_t mipLevels = readLE32(header + 44);
+  const uint32_t keyValueBytes = readLE32(header + 48);
+  if (texture.width == 0 || texture.height == 0 || depth != 0 ||
+      arrayElements != 0 ||
+      (texture.faceCount != 1 && texture.faceCount != Ktx1Texture::kMaxFaceCount) ||
+      (texture.isCubemap() && texture.width != texture.height)) {
+    LOGE("Unsupported KTX1 layout: %ux%u, %u faces", texture.width,
+         texture.height, texture.faceCount);
+    return false;
+  }
+  // cmgen 把 glType 写成了内部格式, 按格式修正为打包浮点类型
+  if (texture.internalFormat == GL_R11F_G11F_B10F &&
+      texture.type != GL_FLOAT && texture.type != GL_HALF_FLOAT) {
+    texture.type = GL_UNSIGNED_INT_10F_11F_11F_REV;
+  }
+
+  size_t offset = kKtx1HeaderSize;
+  if (keyValueBytes > size - offset) {
+    LOGE("KTX1 key/value data out of range");
+    return false;
+  }
+  const size_t keyValueEnd = offset + keyValueBytes;
+  texture.metadata.clear();
+  while (offset + 4 <= keyValueEnd) {
+    const uint32_t entrySize = readLE32(data + offset);
+    offset += 4;
+    if (entrySize > keyValueEnd - offset) {
+      break;
+    }
+    const char *entry = reinterpret_cast<const char *>(data + offset);
+    const size_t keyLength = strnlen(entry, entrySize);
+    if (keyLength < entrySize) {
+      const char *value = entry + keyLength + 1;
+      texture.metadata.emplace_back(
+          std::string(entry, keyLength),
+          std::string(value, strnlen(value, entrySize - keyLength - 1)));
+    }
+    offset = align4(offset + entrySize);
+  }
+  offset = keyValueEnd;
+
+  texture.levels.assign(std::max(mipLevels, 1u), Ktx1Texture::Level());
+  for (size_t level = 0; level < texture.levels.size(); ++level) {
+    if (offset + 4 > size) {
+      LOGE("KTX1 level %zu out of range", level);
+      return false;
+    }
+    // 非数组立方体贴图的 imageSize 为单个面的大小, 每个面按 4 字节对齐
+    auto &entry = texture.levels[level];
+    entry.faceSize = readLE32(data + offset);
+    offset += 4;
+    for (uint32_t face = 0; face < texture.faceCount; ++face) {
+      if (entry.faceSize > size - offset) {
+        LOGE("KTX1 level %zu face %u out of range", level, face);
+        return false;
+      }
+      entry.faces[face] = data + offset;
+      offset = align4(offset + entry.faceSize);
+    }
+  }
+  return true;
+}
+
+bool Ktx1File::write(const std::string &path, const Ktx1Texture &texture) {
+  std::error_code error;
+  const std::filesystem::path filePath(path);
+  if (filePath.has_parent_path()) {
+    std::filesystem::create_directories(filePath.parent_path(), error);
+  }
+  const std::string tempPath = path + ".tmp";
+  std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    LOGE("Failed to create KTX1 file: %s", tempPath.c_str());
+    return false;
+  }
+
+  size_t keyValueBytes = 0;
+  for (const auto &[key, value]: texture.metadata) {
+    keyValueBytes += 4 + align4(key.size() + value.size() + 2);
+  }
+  out.write(reinterpret_cast<const char *>(kKtx1Identifier),
+            sizeof(kKtx1Identifier));
+  writeLE32(out, kKtx1Endianness);
+  writeLE32(out, texture.type);
+  writeLE32(out, texture.typeSize);
+  writeLE32(out, texture.format);
+  writeLE32(out, texture.internalFormat);
+  writeLE32(out, texture.format);
+  writeLE32(out, texture.width);
+  writeLE32(out, texture.height);
+  writeLE32(out, 0);
+  writeLE32(out, 0);
+  writeLE32(out, texture.faceCount);
+  writeLE32(out, static_cast<uint32_t>(texture.levels.size()));
+  writeLE32(out, static_cast<uint32_t>(keyValueBytes));
+  for (const auto &[key, value]: texture.metadata) {
+    const size_t entrySize = key.size() + value.size() + 2;
+    writeLE32(out, static_cast<uint32_t>(entrySize));
+    out.write(key.c_str(), static_cast<std::streamsize>(key.size() + 1));
+    out.write(value.c_str(), static_cast<std::streamsize>(value.size() + 1));
+    writePadding(out, entrySize);
+  }
+  for (const auto &level: texture.levels) {
+    writeLE32(out, level.faceSize);
+    for (uint32_t face = 0; face < texture.faceCount; ++face) {
+      out.write(reinterpret_cast<const char *>(level.faces[face]),
+                level.faceSize);
+      writePadding(out, level.faceSize);
+    }
+  }
+  out.close();
+
+  if (!out.good()) {
+    LOGE("Failed to write KTX1 file: %s", tempPath.c_str());
+    std::filesystem::remove(tempPath, error);
+    return false;
+  }
+  std::filesystem::rename(tempPath, filePath, error);
+  if (error) {
+    LOGE("Failed to replace KTX1 file: %s (%s)", path.c_str(),
+         error.message().c_str());
+    std::filesystem::remove(tempPath, error);
+    return false;
+  }
+  return true;
+}
+
+GLuint Ktx1File::upload(const Ktx1Texture &texture, const char *name) {
+  while (glGetError() != GL_NO_ERROR) {
+  }
+  const GLenum target =
+      texture.isCubemap() ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+  const auto levelCount = static_cast<GLint>(texture.levels.size());
+  GLuint id = 0;
+  glGenTextures(1, &id);
+  glBindTexture(target, id);
+  glTexParameteri(target, GL_TEXTURE_MIN_FILTER,
+                  levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+  glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+  glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  for (GLint level = 0; level < levelCount; ++level) {
+    const auto &entry = texture.levels[level];
+    const auto width = static_cast<GLsizei>(std::max(texture.width >> level, 1u));
+    const auto height =
+        static_cast<GLsizei>(std::max(texture.height >> level, 1u));
+    for (uint32_t face = 0; face < texture.faceCount; ++face) {
+      const GLenum faceTarget = texture.isCubemap()
+                                ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face
+                                : GL_TEXTURE_2D;
+      if (texture.type == 0) {
+        glCompressedTexImage2D(faceTarget, level, texture.internalFormat,
+                               width, height, 0,
+                               static_cast<GLsizei>(entry.faceSize),
+                               entry.faces[face]);
+      } else {
+        glTexImage2D(faceTarget, level,
+                     static_cast<GLint>(texture.internalFormat), width, height,
+                     0, texture.format, texture.type, entry.faces[face]);
+      }
+    }
+  }
+
+  GLenum error = glGetError();
+  if (error != GL_NO_ERROR) {
+    LOGE("Failed to upload %s: 0x%x", name, error);
+    glDeleteTextures(1, &id);
+    return 0;
+  }
+  return id;
+}
+
+} // namespace digitalhumans
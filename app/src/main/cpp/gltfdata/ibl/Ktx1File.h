@@ -0,0 +1,77 @@
+//
+// Created by vincentsyan on 2025/10/10.
+//
+
+#ifndef LIGHTDIGITALHUMAN_KTX1FILE_H
+#define LIGHTDIGITALHUMAN_KTX1FILE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <GLES3/gl3.h>
+
+namespace digitalhumans {
+
+/**
+ * @brief KTX1 纹理: 2D 或立方体贴图（不支持数组与 3D 纹理）
+ *
+ * 解析得到的像素指针指向调用方持有的文件数据; 写入时指向调用方的像素缓冲。
+ */
+struct Ktx1Texture {
+  static constexpr int kMaxFaceCount = 6;
+
+  struct Level {
+    uint32_t faceSize = 0;   ///< 单个面的字节数
+    std::array<const uint8_t *, kMaxFaceCount> faces{};
+  };
+
+  GLenum internalFormat = 0;
+  GLenum format = 0;
+  GLenum type = 0;           ///< 0 表示压缩格式
+  uint32_t typeSize = 1;     ///< 类型的字节数, 用于字节序转换
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t faceCount = 1;    ///< 1 为 2D 纹理, 6 为立方体贴图
+  std::vector<Level> levels;
+  std::vector<std::pair<std::string, std::string>> metadata;  ///< 键值数据
+
+  bool isCubemap() const { return faceCount == kMaxFaceCount; }
+
+  /**
+   * @brief 查找键值数据, 不存在时返回 nullptr
+   */
+  const std::string *findMetadata(const std::string &key) const;
+};
+
+/**
+ * @brief KTX1 文件读写与上传, 不依赖 libktx
+ */
+class Ktx1File {
+ public:
+  /**
+   * @brief 解析 KTX1 数据（只支持小端文件）
+   * @return 格式错误或数据越界时返回 false
+   */
+  static bool parse(const uint8_t *data, size_t size, Ktx1Texture &texture);
+
+  /**
+   * @brief 写入 KTX1 文件（先写临时文件再替换）
+   */
+  static bool write(const std::string &path, const Ktx1Texture &texture);
+
+  /**
+   * @brief 创建 GL 纹理并上传全部 mip 级别, 需在 GL 线程调用
+   *
+   * 多级纹理使用三线性过滤, GL_TEXTURE_MAX_LEVEL 设为最后一级, 环绕方式为 CLAMP_TO_EDGE。
+   * @param name 日志中使用的名称
+   * @return 失败返回 0
+   */
+  static GLuint upload(const Ktx1Texture &texture, const char *name);
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_KTX1FILE_H
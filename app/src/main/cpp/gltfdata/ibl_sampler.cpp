@@ -8,14 +8,22 @@
 #include "GltfOpenGLContext.h"
 #include "GltfShader.h"
 #include "converter/ShaderManager.h"
+#include "../utils/ContentHash.h"
 #include "../utils/LogUtils.h"
 #include <iostream>
 #include <algorithm>
+#include <iterator>
 #include <cmath>
 #include <memory>
 
 namespace digitalhumans {
 
+void EnvironmentMapTextures::release() {
+  const GLuint textures[] = {diffuse, specular, sheen, ggxLut, charlieLut};
+  glDeleteTextures(static_cast<GLsizei>(std::size(textures)), textures);
+  *this = EnvironmentMapTextures();
+}
+
 IBLSampler::IBLSampler(const std::shared_ptr<GltfOpenGLContext> &gl_)
     : gl_(gl_), textureSize_(256), ggxSampleCount_(1024),
       lambertianSampleCount_(2048),
@@ -661,4 +669,21 @@ void IBLSampler::destroy() {
 int IBLSampler::getMipmapLevels() const {
   return mipmapLevels_;
 }
+
+uint64_t IBLSampler::getSettingsHash() const {
+  const int settings[] = {textureSize_, ggxSampleCount_,
+                          lambertianSampleCount_, sheenSampleCount_,
+                          lowestMipLevel_, lutResolution_};
+  uint64_t seed = hash::hashBytes(settings, sizeof(settings));
+  seed = hash::hashBytes(&lodBias_, sizeof(lodBias_), seed);
+  seed = hash::hashBytes(preferredFormat_.data(), preferredFormat_.size(),
+                         seed);
+  const auto &shaders = ShaderManager::getInstance().getShaderFiles();
+  for (const std::string *source: {&shaders.fullscreen,
+                                   &shaders.panorama_to_cubemap,
+                                   &shaders.ibl_filtering}) {
+    seed = hash::hashBytes(source->data(), source->size(), seed);
+  }
+  return seed;
+}
 }
\ No newline at end of file
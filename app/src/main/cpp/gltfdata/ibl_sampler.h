@@ -5,6 +5,7 @@
 #define IBL_SAMPLER_H
 
 #include <GLES3/gl3.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -19,6 +20,25 @@ class GltfOpenGLContext;
 
 struct HDRImage;
 
+/**
+ * @brief IBL 预处理结果（GL 纹理句柄）, 可在同一上下文的多个引擎间复用
+ */
+struct EnvironmentMapTextures {
+  GLuint diffuse = 0;      ///< Lambertian 漫反射立方体贴图
+  GLuint specular = 0;     ///< GGX 镜面立方体贴图
+  GLuint sheen = 0;        ///< Charlie 光泽立方体贴图
+  GLuint ggxLut = 0;       ///< GGX BRDF LUT
+  GLuint charlieLut = 0;   ///< Charlie BRDF LUT
+  int mipCount = 0;        ///< 镜面贴图 mip 层数
+
+  bool isValid() const { return diffuse != 0 && specular != 0 && ggxLut != 0; }
+
+  /**
+   * @brief 删除全部纹理并清零（多个字段可引用同一纹理）
+   */
+  void release();
+};
+
 struct TextureData {
   GLenum internalFormat;
   GLenum format;
@@ -96,6 +116,25 @@ class IBLSampler {
  public:
   int getMipmapLevels() const;
 
+  int getTextureSize() const { return textureSize_; }
+
+  int getLutResolution() const { return lutResolution_; }
+
+  /**
+   * @brief 镜面与光泽贴图实际过滤的 mip 级数（0..mipmapLevels_）
+   */
+  int getFilteredLevelCount() const { return mipmapLevels_ + 1; }
+
+  /**
+   * @brief 输出纹理的内部格式, init 之后有效
+   */
+  GLint getTextureFormat() const { return getInternalFormat(); }
+
+  /**
+   * @brief 预处理参数与滤波着色器源码的哈希, 任一变化时 IBL 烘焙缓存失效
+   */
+  uint64_t getSettingsHash() const;
+
  private:
   std::shared_ptr<GltfOpenGLContext> gl_;
 
@@ -0,0 +1,115 @@
+//
+// Created by vincentsyan on 2025/9/22.
+//
+
+#include "HeadlessEglContext.h"
+#include <EGL/eglext.h>
+#include <GLES3/gl3.h>
+#include "../utils/LogUtils.h"
+
+namespace digitalhumans {
+
+HeadlessEglContext::~HeadlessEglContext() {
+  destroy();
+}
+
+bool HeadlessEglContext::create(int width, int height) {
+  destroy();
+
+  auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+      eglGetProcAddress("eglGetPlatformDisplayEXT"));
+  if (getPlatformDisplay) {
+    display_ = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                  EGL_DEFAULT_DISPLAY, nullptr);
+  }
+  if (display_ == EGL_NO_DISPLAY) {
+    display_ = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  }
+
+  EGLint major = 0, minor = 0;
+  if (display_ == EGL_NO_DISPLAY || !eglInitialize(display_, &major, &minor)) {
+    LOGE("eglInitialize failed: 0x%x", eglGetError());
+    display_ = EGL_NO_DISPLAY;
+    return false;
+  }
+
+  const EGLint configAttribs[] = {
+      EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+      EGL_RED_SIZE, 8,
+      EGL_GREEN_SIZE, 8,
+      EGL_BLUE_SIZE, 8,
+      EGL_ALPHA_SIZE, 8,
+      EGL_DEPTH_SIZE, 24,
+      EGL_NONE
+  };
+  EGLConfig config = nullptr;
+  EGLint numConfigs = 0;
+  if (!eglChooseConfig(display_, configAttribs, &config, 1, &numConfigs) ||
+      numConfigs == 0) {
+    LOGE("eglChooseConfig failed: 0x%x", eglGetError());
+    destroy();
+    return false;
+  }
+
+  eglBindAPI(EGL_OPENGL_ES_API);
+  const EGLint contextAttribs[] = {EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE};
+  context_ = eglCreateContext(display_, config, EGL_NO_CONTEXT, contextAttribs);
+  if (context_ == EGL_NO_CONTEXT) {
+    LOGE("eglCreateContext failed: 0x%x", eglGetError());
+    destroy();
+    return false;
+  }
+
+  const EGLint surfaceAttribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height,
+                                   EGL_NONE};
+  surface_ = eglCreatePbufferSurface(display_, config, surfaceAttribs);
+  if (surface_ == EGL_NO_SURFACE) {
+    LOGE("eglCreatePbufferSurface failed: 0x%x", eglGetError());
+    destroy();
+    return false;
+  }
+
+  if (!eglMakeCurrent(display_, surface_, surface_, context_)) {
+    LOGE("eglMakeCurrent failed: 0x%x", eglGetError());
+    destroy();
+    return false;
+  }
+
+  width_ = width;
+  height_ = height;
+  LOGI("Headless EGL %d.%d: %s", major, minor, getRendererInfo().c_str());
+  return true;
+}
+
+void HeadlessEglContext::destroy() {
+  if (display_ == EGL_NO_DISPLAY) {
+    return;
+  }
+  eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  if (surface_ != EGL_NO_SURFACE) {
+    eglDestroySurface(display_, surface_);
+    surface_ = EGL_NO_SURFACE;
+  }
+  if (context_ != EGL_NO_CONTEXT) {
+    eglDestroyContext(display_, context_);
+    context_ = EGL_NO_CONTEXT;
+  }
+  eglTerminate(display_);
+  display_ = EGL_NO_DISPLAY;
+  width_ = 0;
+  height_ = 0;
+}
+
+std::string HeadlessEglContext::getRendererInfo() const {
+  if (!isValid()) {
+    return "";
+  }
+  const auto *renderer =
+      reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+  const auto *version = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+  return std::string(renderer ? renderer : "?") + " | " +
+      (version ? version : "?");
+}
+
+} // namespace digitalhumans
@@ -0,0 +1,64 @@
+//
+// Created by vincentsyan on 2025/9/22.
+//
+
+#ifndef LIGHTDIGITALHUMAN_HEADLESSEGLCONTEXT_H
+#define LIGHTDIGITALHUMAN_HEADLESSEGLCONTEXT_H
+
+#include <EGL/egl.h>
+#include <string>
+
+namespace digitalhumans {
+
+/**
+ * @brief 主机端离屏 GLES3 上下文
+ *
+ * 优先使用 EGL_PLATFORM_SURFACELESS_MESA（无需窗口系统, llvmpipe 软件渲染）,
+ * 失败时回退到默认显示。创建 pbuffer 表面并设为当前上下文,
+ * 供基准测试和离屏渲染测试使用。
+ */
+class HeadlessEglContext {
+ public:
+  HeadlessEglContext() = default;
+
+  ~HeadlessEglContext();
+
+  HeadlessEglContext(const HeadlessEglContext &) = delete;
+
+  HeadlessEglContext &operator=(const HeadlessEglContext &) = delete;
+
+  /**
+   * @brief 创建上下文并设为当前
+   * @param width pbuffer 宽度
+   * @param height pbuffer 高度
+   * @return 是否创建成功
+   */
+  bool create(int width, int height);
+
+  /**
+   * @brief 销毁上下文和表面
+   */
+  void destroy();
+
+  bool isValid() const { return context_ != EGL_NO_CONTEXT; }
+
+  int getWidth() const { return width_; }
+
+  int getHeight() const { return height_; }
+
+  /**
+   * @brief 获取渲染器描述（GL_RENDERER / GL_VERSION）
+   */
+  std::string getRendererInfo() const;
+
+ private:
+  EGLDisplay display_ = EGL_NO_DISPLAY;
+  EGLSurface surface_ = EGL_NO_SURFACE;
+  EGLContext context_ = EGL_NO_CONTEXT;
+  int width_ = 0;
+  int height_ = 0;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_HEADLESSEGLCONTEXT_H
@@ -0,0 +1,1133 @@
+//
+// Created by vincentsyan on 2025/9/23.
+//
+// 离屏渲染回归测试:
+// 在 surfaceless EGL（Mesa llvmpipe）上按固定相机/动画时间轴调用
+// Engine::renderFrame, 将结果与 golden 图像比较, 并输出各渲染通道
+// （environment / opaque / transmission / transparent）的 CPU/GPU 耗时。
+//
+// 用法:
+//   render_test [--asset-dir=<dir>] [--golden-dir=<dir>] [--output-dir=<dir>]
+//               [--update-golden] [--frames=N] [--filter=<子串>]
+//               [--timings=<csv文件>]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <GLES3/gl3.h>
+#include "stb_image.h"
+#include "stb_image_write.h"
+#include "../engine/Engine.h"
+#include "../gltfdata/Gltf.h"
+#include "../gltfdata/GltfAccessor.h"
+#include "../gltfdata/GltfAnimation.h"
+#include "../gltfdata/GltfAnimationMixer.h"
+#include "../gltfdata/GltfMesh.h"
+#include "../gltfdata/GltfPrimitive.h"
+#include "../gltfdata/GltfRenderer.h"
+#include "../gltfdata/GltfState.h"
+#include "../gltfdata/RenderPassProfiler.h"
+#include "../gltfdata/UserCamera.h"
+#include "../gltfdata/converter/GltfDracoDecoder.h"
+#include "../gltfdata/converter/GltfLoader.h"
+#include "../gltfdata/converter/ShaderManager.h"
+#include "../gltfdata/ibl/HDRImageLoader.h"
+#include "../gltfdata/ibl/IBLAssetLoader.h"
+#include "../gltfdata/ibl/IBLBakeCache.h"
+#include "../gltfdata/ibl_sampler.h"
+#include "../host/HeadlessEglContext.h"
+#include "../utils/AssetProvider.h"
+#include "../utils/LogUtils.h"
+
+using namespace digitalhumans;
+
+namespace {
+
+constexpr int kWidth = 256;
+constexpr int kHeight = 256;
+constexpr const char *kEnvironmentHdr =
+    "envs/lonely_road_afternoon_puresky_1k.hdr";
+
+/**
+ * @brief 单个渲染用例: 模型 + 相机轨道偏移 + 动画时间点
+ *
+ * 用 RenderCase::load 创建, 再按需链式设置, 例如
+ * RenderCase::load("name", path).orbit(0.3f, 0.1f).cook()。
+ */
+struct RenderCase {
+  std::string name;
+  std::string model;
+  float orbitX = 0.0f;       ///< 相对 fitViewToScene 结果的轨道偏移
+  float orbitY = 0.0f;
+  int animation = -1;        ///< 播放的动画索引, -1 表示静态
+  float animationTime = 0.0f;
+  bool async = false;        ///< 经异步加载管线分帧上传
+  bool cooked = false;       ///< 先烘焙, 再从烘焙文件加载
+  std::string environment;   ///< 预滤波环境目录, 为空时使用 HDR 预处理结果
+  bool cachedIbl = false;    ///< HDR 预处理结果从 IBL 烘焙缓存重新加载
+  bool provider = false;     ///< 经 AssetProvider 读取（Android assets 的加载路径）
+  bool optimizeMeshes = false;  ///< 转换时重排三角形与顶点
+  bool cacheHit = false;     ///< 同一 loader 先加载一次, 渲染从转换资源缓存创建的实例
+  /// 首帧之后配置动画状态并推进时间轴, 结束时的画面作为渲染结果
+  std::function<bool(Engine &)> prepare;
+  std::string golden;        ///< 与其他用例共用的 golden 名称, 为空时使用用例名
+  /// 把模型生成到输出目录中的给定路径, 此时 model 为生成的文件名
+  std::function<bool(const std::string &)> generate;
+  bool draco = false;        ///< 只有 Draco 压缩数据, 构建不含 Draco 时跳过, 含 Draco 时必须通过
+
+  static RenderCase load(std::string name, std::string model) {
+    RenderCase renderCase;
+    renderCase.name = std::move(name);
+    renderCase.model = std::move(model);
+    return renderCase;
+  }
+
+  RenderCase &orbit(float x, float y) {
+    orbitX = x;
+    orbitY = y;
+    return *this;
+  }
+
+  RenderCase &play(int index, float time) {
+    animation = index;
+    animationTime = time;
+    return *this;
+  }
+
+  RenderCase &uploadAsync() {
+    async = true;
+    return *this;
+  }
+
+  RenderCase &cook() {
+    cooked = true;
+    return *this;
+  }
+
+  RenderCase &withEnvironment(std::string directory) {
+    environment = std::move(directory);
+    return *this;
+  }
+
+  RenderCase &reloadIblCache() {
+    cachedIbl = true;
+    return *this;
+  }
+
+  RenderCase &viaProvider() {
+    provider = true;
+    return *this;
+  }
+
+  RenderCase &optimize() {
+    optimizeMeshes = true;
+    return *this;
+  }
+
+  RenderCase &fromCache() {
+    cacheHit = true;
+    return *this;
+  }
+
+  RenderCase &onPrepare(std::function<bool(Engine &)> function) {
+    prepare = std::move(function);
+    return *this;
+  }
+
+  RenderCase &shareGolden(std::string name) {
+    golden = std::move(name);
+    return *this;
+  }
+
+  RenderCase &generatedBy(std::function<bool(const std::string &)> function) {
+    generate = std::move(function);
+    return *this;
+  }
+
+  RenderCase &requireDraco() {
+    draco = true;
+    return *this;
+  }
+};
+
+constexpr const char *kBrainStem = "testmodel/BrainStem/BrainStem.gltf";
+constexpr int kBrainStemUpperBody = 12;  ///< BrainStem 上半身关节子树的根节点
+
+/**
+ * @brief 把动画时间轴固定到 time 并渲染一帧
+ */
+void renderAt(Engine &engine, float time) {
+  engine.state->getAnimationTimer().setFixedTime(time);
+  engine.renderFrame(kWidth, kHeight);
+}
+
+/**
+ * @brief 同一动画的两个相位交叉淡化, 停在淡化中点
+ */
+bool prepareCrossFade(Engine &engine) {
+  auto &mixer = engine.state->getAnimationMixer();
+  const Gltf &gltf = *engine.state->getGltf();
+  const int layer = mixer.addLayer("base");
+  if (!mixer.play(gltf, layer, 0)) {
+    return false;
+  }
+  renderAt(engine, 0.0f);
+  renderAt(engine, 1.0f);
+  // 原实例淡出时再次播放会创建新实例, 从动画开头淡入
+  if (!mixer.stop(layer, 0.5f) || !mixer.play(gltf, layer, 0, 0.5f)) {
+    return false;
+  }
+  renderAt(engine, 1.25f);
+  return true;
+}
+
+/**
+ * @brief 覆盖层之上以半权重叠加同一动画相对首帧的变化量
+ */
+bool prepareAdditive(Engine &engine) {
+  auto &mixer = engine.state->getAnimationMixer();
+  const Gltf &gltf = *engine.state->getGltf();
+  const int base = mixer.addLayer("base");
+  const int additive =
+      mixer.addLayer("additive", AnimationBlendMode::ADDITIVE, 0.5f);
+  if (!mixer.play(gltf, base, 0) || !mixer.play(gltf, additive, 0)) {
+    return false;
+  }
+  renderAt(engine, 0.0f);
+  renderAt(engine, 1.25f);
+  return true;
+}
+
+/**
+ * @brief 只有上半身播放动画, 其余节点保持静止姿态
+ */
+bool prepareMasked(Engine &engine) {
+  auto &mixer = engine.state->getAnimationMixer();
+  const Gltf &gltf = *engine.state->getGltf();
+  const int layer = mixer.addLayer("upper");
+  if (!mixer.setLayerMask(gltf, layer, {kBrainStemUpperBody}) ||
+      !mixer.play(gltf, layer, 0)) {
+    return false;
+  }
+  renderAt(engine, 0.0f);
+  renderAt(engine, 1.25f);
+  return true;
+}
+
+/**
+ * @brief 任何尺寸都按 1/4 频率采样, 停在两次采样之间的插值帧
+ */
+bool prepareLodQuarterRate(Engine &engine) {
+  GltfAnimationLodSettings settings;
+  settings.halfRateSize = 100.0f;
+  settings.quarterRateSize = 100.0f;
+  settings.jointChainSize = 0.0f;
+  settings.morphWeightSize = 0.0f;
+  engine.setAnimationLod(settings);
+  for (int frame = 0; frame < 6; ++frame) {
+    renderAt(engine, 1.0f + 0.1f * static_cast<float>(frame));
+  }
+  const auto stats = engine.getAnimationLodStats();
+  if (stats.updateInterval != 4 || stats.interpolatedFrames == 0) {
+    LOGE("Expected quarter-rate sampling, interval %u, interpolated %zu",
+         stats.updateInterval, stats.interpolatedFrames);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 每帧采样, 跳过手臂、头部等较短的关节链, 这些链停在首帧的姿态
+ */
+bool prepareLodJointChains(Engine &engine) {
+  GltfAnimationLodSettings settings;
+  settings.halfRateSize = 0.0f;
+  settings.quarterRateSize = 0.0f;
+  settings.jointChainSize = 0.15f;
+  settings.morphWeightSize = 0.0f;
+  engine.setAnimationLod(settings);
+  renderAt(engine, 1.25f);
+  const auto stats = engine.getAnimationLodStats();
+  if (stats.updateInterval != 1 || stats.skippedNodes == 0) {
+    LOGE("Expected joint chains to be skipped, interval %u, skipped %zu",
+         stats.updateInterval, stats.skippedNodes);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 生成测试模型: 单个节点与网格, 数据写入与 .gltf 同名的 .bin
+ */
+class GeneratedModel {
+ public:
+  /**
+   * @brief 追加数据（4 字节对齐）并创建 bufferView, 返回其下标
+   */
+  int addBufferView(const void *data, size_t size) {
+    const size_t offset = bin.size();
+    bin.resize(offset + ((size + 3) & ~size_t(3)), 0);
+    std::memcpy(bin.data() + offset, data, size);
+    views += std::string(viewCount > 0 ? "," : "") +
+        "{\"buffer\":0,\"byteOffset\":" + std::to_string(offset) +
+        ",\"byteLength\":" + std::to_string(size) + "}";
+    return viewCount++;
+  }
+
+  /**
+   * @brief 添加访问器, bufferView 为 -1 时数据由扩展提供
+   * @param bounds min/max 的 JSON 片段, 以逗号开头
+   */
+  int addAccessor(int bufferView, int componentType, size_t count,
+                  const char *type, const std::string &bounds = "") {
+    accessors += std::string(accessorCount > 0 ? "," : "") + "{" +
+        (bufferView >= 0
+         ? "\"bufferView\":" + std::to_string(bufferView) + "," : "") +
+        "\"componentType\":" + std::to_string(componentType) +
+        ",\"count\":" + std::to_string(count) + ",\"type\":\"" + type + "\"" +
+        bounds + "}";
+    return accessorCount++;
+  }
+
+  /**
+   * @brief 添加使用默认材质的三角形图元
+   * @param attributes 属性对象的 JSON 片段
+   * @param extensions 扩展对象的 JSON 片段, 为空时不写出
+   */
+  void addPrimitive(const std::string &attributes, int indices,
+                    const std::string &extensions = "") {
+    primitives += std::string(primitives.empty() ? "" : ",") +
+        "{\"attributes\":{" + attributes + "},\"indices\":" +
+        std::to_string(indices) + ",\"material\":0" +
+        (extensions.empty() ? "" : ",\"extensions\":{" + extensions + "}") +
+        "}";
+  }
+
+  /**
+   * @brief 声明使用的扩展, required 为 true 时同时列入 extensionsRequired
+   */
+  void useExtension(const std::string &name, bool required) {
+    used.push_back(name);
+    if (required) {
+      this->required.push_back(name);
+    }
+  }
+
+  bool write(const std::string &path) const {
+    std::error_code error;
+    std::filesystem::create_directories(
+        std::filesystem::path(path).parent_path(), error);
+    const std::string binPath =
+        std::filesystem::path(path).replace_extension(".bin").string();
+    std::ofstream binFile(binPath, std::ios::binary);
+    binFile.write(reinterpret_cast<const char *>(bin.data()),
+                  static_cast<std::streamsize>(bin.size()));
+    std::ofstream file(path);
+    file << "{\"asset\":{\"version\":\"2.0\"},"
+         << extensionList("extensionsUsed", used)
+         << extensionList("extensionsRequired", required)
+         << "\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+         << "\"nodes\":[{\"mesh\":0}],"
+         << "\"meshes\":[{\"primitives\":[" << primitives << "]}],"
+         << "\"materials\":[{\"pbrMetallicRoughness\":"
+         << "{\"metallicFactor\":0,\"roughnessFactor\":0.5}}],"
+         << "\"accessors\":[" << accessors << "],"
+         << "\"bufferViews\":[" << views << "],"
+         << "\"buffers\":[{\"uri\":\""
+         << std::filesystem::path(binPath).filename().string()
+         << "\",\"byteLength\":" << bin.size() << "}]}";
+    binFile.close();
+    file.close();
+    if (!binFile || !file) {
+      LOGE("Failed to write generated model: %s", path.c_str());
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  static std::string extensionList(const char *key,
+                                   const std::vector<std::string> &names) {
+    if (names.empty()) {
+      return "";
+    }
+    std::string list = std::string("\"") + key + "\":[";
+    for (size_t i = 0; i < names.size(); ++i) {
+      list += (i > 0 ? ",\"" : "\"") + names[i] + "\"";
+    }
+    return list + "],";
+  }
+
+  std::vector<uint8_t> bin;
+  std::string views;
+  std::string accessors;
+  std::string primitives;
+  std::vector<std::string> used;
+  std::vector<std::string> required;
+  int viewCount = 0;
+  int accessorCount = 0;
+};
+
+/**
+ * @brief 单位经纬球面上 [first, last] 纬线之间的一段, 按顶点颜色着色
+ */
+struct SphereBand {
+  std::vector<float> positions;  ///< 单位球面的法线与位置相同
+  std::vector<float> colors;
+  std::vector<uint32_t> indices;
+  float minY = 1.0f;
+  float maxY = -1.0f;
+
+  size_t vertexCount() const { return positions.size() / 3; }
+};
+
+SphereBand buildSphereBand(int stacks, int slices, int first, int last) {
+  const float pi = 3.14159265f;
+  const int columns = slices + 1;
+  SphereBand band;
+  for (int stack = first; stack <= last; ++stack) {
+    const float theta = pi * static_cast<float>(stack) / stacks;
+    for (int slice = 0; slice < columns; ++slice) {
+      const float phi = 2.0f * pi * static_cast<float>(slice) / slices;
+      const float y = std::cos(theta);
+      band.positions.insert(band.positions.end(),
+                            {std::sin(theta) * std::cos(phi), y,
+                             std::sin(theta) * std::sin(phi)});
+      band.colors.insert(band.colors.end(),
+                         {0.5f + 0.5f * std::sin(6.0f * phi),
+                          0.5f + 0.5f * std::cos(5.0f * theta), 0.6f});
+      band.minY = std::min(band.minY, y);
+      band.maxY = std::max(band.maxY, y);
+    }
+  }
+  for (int stack = 0; stack < last - first; ++stack) {
+    for (int slice = 0; slice < slices; ++slice) {
+      const uint32_t a = stack * columns + slice;
+      const uint32_t b = a + columns;
+      band.indices.insert(band.indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+    }
+  }
+  return band;
+}
+
+/**
+ * @brief 添加球面的位置、法线与颜色访问器, 返回图元属性的 JSON 片段
+ * @param withData 为 false 时访问器不带 bufferView, 数据由扩展提供
+ */
+std::string addSphereAttributes(GeneratedModel &model, const SphereBand &band,
+                                bool withData) {
+  const size_t bytes = band.positions.size() * sizeof(float);
+  auto view = [&](const std::vector<float> &values) {
+    return withData ? model.addBufferView(values.data(), bytes) : -1;
+  };
+  char bounds[128];
+  std::snprintf(bounds, sizeof(bounds),
+                ",\"min\":[-1,%.6f,-1],\"max\":[1,%.6f,1]", band.minY,
+                band.maxY);
+  const int position = model.addAccessor(view(band.positions), GL_FLOAT,
+                                         band.vertexCount(), "VEC3", bounds);
+  const int normal = model.addAccessor(view(band.positions), GL_FLOAT,
+                                       band.vertexCount(), "VEC3");
+  const int color = model.addAccessor(view(band.colors), GL_FLOAT,
+                                      band.vertexCount(), "VEC3");
+  return "\"POSITION\":" + std::to_string(position) +
+      ",\"NORMAL\":" + std::to_string(normal) +
+      ",\"COLOR_0\":" + std::to_string(color);
+}
+
+/// 共 361 x 361 个顶点, 约为 16 位索引上限的两倍, 切分处位于赤道附近
+constexpr int kLargeMeshStacks = 360;
+constexpr int kLargeMeshSlices = 360;
+
+/**
+ * @brief 生成顶点数超出 16 位索引范围的球面
+ * @param bands 沿纬度切成的图元数。为 1 时是单个 32 位索引的图元, 转换时需要切分;
+ *              否则每个图元的顶点数都在 16 位范围内, 三角形与顶点值和前者完全相同
+ */
+bool writeLargeMesh(const std::string &path, int bands) {
+  GeneratedModel model;
+  for (int i = 0; i < bands; ++i) {
+    const SphereBand band =
+        buildSphereBand(kLargeMeshStacks, kLargeMeshSlices,
+                        kLargeMeshStacks * i / bands,
+                        kLargeMeshStacks * (i + 1) / bands);
+    const std::string attributes = addSphereAttributes(model, band, true);
+    int indices = -1;
+    if (bands == 1) {
+      indices = model.addAccessor(
+          model.addBufferView(band.indices.data(),
+                              band.indices.size() * sizeof(uint32_t)),
+          GL_UNSIGNED_INT, band.indices.size(), "SCALAR");
+    } else {
+      const std::vector<uint16_t> shortIndices(band.indices.begin(),
+                                               band.indices.end());
+      indices = model.addAccessor(
+          model.addBufferView(shortIndices.data(),
+                              shortIndices.size() * sizeof(uint16_t)),
+          GL_UNSIGNED_SHORT, shortIndices.size(), "SCALAR");
+    }
+    model.addPrimitive(attributes, indices);
+  }
+  return model.write(path);
+}
+
+/// 共 25 x 33 个顶点, Draco 码流中的索引为 16 位
+constexpr int kDracoSphereStacks = 24;
+constexpr int kDracoSphereSlices = 32;
+
+/**
+ * @brief 按 Draco 2.2 码流的 MESH_SEQUENTIAL_ENCODING 写出球面
+ *
+ * 连接关系与属性都不压缩: 原始 16 位索引, 属性由通用顺序解码器逐点读取原始 float。
+ * 属性唯一 ID 依次为 0 位置、1 法线、2 颜色。
+ */
+std::vector<uint8_t> encodeDracoSphere(const SphereBand &band) {
+  // 魔数、版本 2.2、三角网格、顺序编码、无元数据
+  std::vector<uint8_t> out = {'D', 'R', 'A', 'C', 'O', 2, 2, 1, 0, 0, 0};
+  auto varint = [&out](size_t value) {
+    for (; value >= 0x80; value >>= 7) {
+      out.push_back(static_cast<uint8_t>(value & 0x7f) | 0x80);
+    }
+    out.push_back(static_cast<uint8_t>(value));
+  };
+  auto raw = [&out](const void *data, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    out.insert(out.end(), bytes, bytes + size);
+  };
+
+  varint(band.indices.size() / 3);
+  varint(band.vertexCount());
+  out.push_back(1);  // 未压缩的索引, 顶点数在 [256, 65536) 内时为 16 位
+  for (const uint32_t index: band.indices) {
+    const auto value = static_cast<uint16_t>(index);
+    raw(&value, sizeof(value));
+  }
+
+  constexpr uint8_t kFloat32 = 9;
+  out.push_back(1);  // 一个属性解码器
+  varint(3);
+  // 属性类型 POSITION = 0, NORMAL = 1, COLOR = 2, 唯一 ID 与类型相同
+  for (uint8_t type = 0; type < 3; ++type) {
+    out.insert(out.end(), {type, kFloat32, 3, 0});
+    varint(type);
+  }
+  out.insert(out.end(), {0, 0, 0});  // 通用顺序解码器
+  const size_t bytes = band.positions.size() * sizeof(float);
+  raw(band.positions.data(), bytes);
+  raw(band.positions.data(), bytes);
+  raw(band.colors.data(), bytes);
+  return out;
+}
+
+/**
+ * @brief 生成 KHR_draco_mesh_compression 压缩的球面
+ * @param fallback 为 true 时访问器同时带有未压缩数据, 构建不含 Draco 时使用
+ */
+bool writeDracoSphere(const std::string &path, bool fallback) {
+  GeneratedModel model;
+  const SphereBand band = buildSphereBand(
+      kDracoSphereStacks, kDracoSphereSlices, 0, kDracoSphereStacks);
+  const std::vector<uint8_t> stream = encodeDracoSphere(band);
+  const int streamView = model.addBufferView(stream.data(), stream.size());
+  const std::string attributes = addSphereAttributes(model, band, fallback);
+  const std::vector<uint16_t> indices(band.indices.begin(),
+                                      band.indices.end());
+  const int indexView = fallback
+      ? model.addBufferView(indices.data(), indices.size() * sizeof(uint16_t))
+      : -1;
+  const std::string extension =
+      std::string("\"") + GltfDracoDecoder::kExtensionName +
+      "\":{\"bufferView\":" + std::to_string(streamView) +
+      ",\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"COLOR_0\":2}}";
+  model.useExtension(GltfDracoDecoder::kExtensionName, !fallback);
+  model.addPrimitive(attributes,
+                     model.addAccessor(indexView, GL_UNSIGNED_SHORT,
+                                       indices.size(), "SCALAR"),
+                     extension);
+  return model.write(path);
+}
+
+/**
+ * @brief 确认单个超大图元在转换时被切分为多个 16 位索引的图元
+ */
+bool checkLargeMeshSplit(Engine &engine) {
+  const auto &gltf = engine.state->getGltf();
+  const auto &accessors = gltf->getAccessors();
+  const auto &primitives = gltf->getMeshes().front()->getPrimitives();
+  for (const auto &primitive: primitives) {
+    const int index = primitive->getIndices().value_or(-1);
+    if (index < 0 ||
+        accessors[index]->getComponentType().value_or(0) != GL_UNSIGNED_SHORT) {
+      LOGE("Large mesh primitive still uses 32-bit indices");
+      return false;
+    }
+  }
+  if (primitives.size() < 2) {
+    LOGE("Large mesh was not split");
+    return false;
+  }
+  engine.renderFrame(kWidth, kHeight);
+  return true;
+}
+
+constexpr const char *kHelmet = "testmodel/DamagedHelmet/DamagedHelmet.glb";
+constexpr const char *kMorph = "testmodel/glb/MorphPrimitivesTest.glb";
+constexpr const char *kMorphMeshopt =
+    "testmodel/glb/MorphPrimitivesTest_meshopt.glb";
+
+const std::vector<RenderCase> kCases = {
+    RenderCase::load("helmet_front", kHelmet),
+    RenderCase::load("helmet_orbit", kHelmet).orbit(0.6f, 0.2f),
+    RenderCase::load("brainstem_t0", kBrainStem).play(0, 0.0f),
+    RenderCase::load("brainstem_t1", kBrainStem).play(0, 1.25f),
+    RenderCase::load("morph_primitives", kMorph).orbit(0.3f, 0.1f),
+    RenderCase::load("helmet_async", kHelmet).uploadAsync(),
+    RenderCase::load("helmet_cooked", kHelmet).cook(),
+    RenderCase::load("brainstem_cooked", kBrainStem).play(0, 1.25f).cook(),
+    RenderCase::load("morph_cooked", kMorph).orbit(0.3f, 0.1f).cook(),
+    RenderCase::load("helmet_ktx_env", kHelmet).withEnvironment("envs"),
+    RenderCase::load("helmet_ktx_studio", kHelmet)
+        .orbit(0.6f, 0.2f)
+        .withEnvironment("envs/studio"),
+    RenderCase::load("helmet_ibl_cache", kHelmet).reloadIblCache(),
+    RenderCase::load("morph_meshopt", kMorphMeshopt).orbit(0.3f, 0.1f),
+    RenderCase::load("morph_meshopt_cooked", kMorphMeshopt)
+        .orbit(0.3f, 0.1f)
+        .cook(),
+    RenderCase::load("morph_meshopt_provider", kMorphMeshopt)
+        .orbit(0.3f, 0.1f)
+        .viaProvider(),
+    RenderCase::load("brainstem_optimized", kBrainStem)
+        .play(0, 1.25f)
+        .optimize(),
+    RenderCase::load("helmet_optimized_cooked", kHelmet)
+        .orbit(0.6f, 0.2f)
+        .cook()
+        .optimize(),
+    RenderCase::load("morph_optimized", kMorph).orbit(0.3f, 0.1f).optimize(),
+    RenderCase::load("brainstem_cache_hit", kBrainStem)
+        .play(0, 1.25f)
+        .fromCache()
+        .shareGolden("brainstem_t1"),
+    RenderCase::load("morph_optimized_cache_hit", kMorph)
+        .orbit(0.3f, 0.1f)
+        .optimize()
+        .fromCache()
+        .shareGolden("morph_optimized"),
+    RenderCase::load("brainstem_crossfade", kBrainStem)
+        .onPrepare(prepareCrossFade),
+    RenderCase::load("brainstem_additive", kBrainStem)
+        .onPrepare(prepareAdditive),
+    RenderCase::load("brainstem_masked", kBrainStem).onPrepare(prepareMasked),
+    RenderCase::load("brainstem_lod_quarter", kBrainStem)
+        .play(0, 1.0f)
+        .onPrepare(prepareLodQuarterRate),
+    RenderCase::load("brainstem_lod_chains", kBrainStem)
+        .play(0, 0.0f)
+        .onPrepare(prepareLodJointChains),
+    RenderCase::load("large_mesh_split", "large_mesh.gltf")
+        .orbit(0.3f, 0.4f)
+        .generatedBy([](const std::string &path) {
+          return writeLargeMesh(path, 1);
+        })
+        .onPrepare(checkLargeMeshSplit)
+        .shareGolden("large_mesh"),
+    RenderCase::load("large_mesh_cache_hit", "large_mesh_cache_hit.gltf")
+        .orbit(0.3f, 0.4f)
+        .generatedBy([](const std::string &path) {
+          return writeLargeMesh(path, 1);
+        })
+        .fromCache()
+        .onPrepare(checkLargeMeshSplit)
+        .shareGolden("large_mesh"),
+    RenderCase::load("large_mesh_bands", "large_mesh_bands.gltf")
+        .orbit(0.3f, 0.4f)
+        .generatedBy([](const std::string &path) {
+          return writeLargeMesh(path, 4);
+        })
+        .shareGolden("large_mesh"),
+    RenderCase::load("draco_sphere", "draco_sphere.gltf")
+        .orbit(0.3f, 0.4f)
+        .generatedBy([](const std::string &path) {
+          return writeDracoSphere(path, false);
+        })
+        .requireDraco(),
+    RenderCase::load("draco_sphere_fallback", "draco_sphere_fallback.gltf")
+        .orbit(0.3f, 0.4f)
+        .generatedBy([](const std::string &path) {
+          return writeDracoSphere(path, true);
+        })
+        .shareGolden("draco_sphere"),
+};
+
+struct Options {
+  std::string assetDir = LIGHTDIGITALHUMAN_ASSET_DIR;
+  std::string goldenDir = LIGHTDIGITALHUMAN_GOLDEN_DIR;
+  std::string outputDir = "render_test_output";
+  std::string timingsFile;
+  std::string filter;
+  bool updateGolden = false;
+  int frames = 5;
+  int channelTolerance = 8;          ///< 单通道允许的差值
+  double maxDifferentRatio = 0.005;  ///< 允许超差像素的比例
+};
+
+struct Image {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> rgba;
+};
+
+struct CaseResult {
+  std::string name;
+  bool passed = false;
+  double differentRatio = 0.0;
+  double frameMs = 0.0;
+  RenderPassTimings passes;
+};
+
+bool parseArg(const char *arg, const char *name, std::string &out) {
+  size_t len = std::strlen(name);
+  if (std::strncmp(arg, name, len) == 0 && arg[len] == '=') {
+    out = arg + len + 1;
+    return true;
+  }
+  return false;
+}
+
+Options parseOptions(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string value;
+    if (parseArg(argv[i], "--asset-dir", value)) {
+      options.assetDir = value;
+    } else if (parseArg(argv[i], "--golden-dir", value)) {
+      options.goldenDir = value;
+    } else if (parseArg(argv[i], "--output-dir", value)) {
+      options.outputDir = value;
+    } else if (parseArg(argv[i], "--timings", value)) {
+      options.timingsFile = value;
+    } else if (parseArg(argv[i], "--filter", value)) {
+      options.filter = value;
+    } else if (parseArg(argv[i], "--frames", value)) {
+      options.frames = std::max(1, std::atoi(value.c_str()));
+    } else if (std::strcmp(argv[i], "--update-golden") == 0) {
+      options.updateGolden = true;
+    } else {
+      LOGW("Unknown argument: %s", argv[i]);
+    }
+  }
+  return options;
+}
+
+Image readFramebuffer(int width, int height) {
+  Image image;
+  image.width = width;
+  image.height = height;
+  image.rgba.resize(static_cast<size_t>(width) * height * 4);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+               image.rgba.data());
+
+  // GL 原点在左下角, 翻转为图像行序
+  const size_t rowBytes = static_cast<size_t>(width) * 4;
+  std::vector<uint8_t> row(rowBytes);
+  for (int y = 0; y < height / 2; ++y) {
+    uint8_t *top = image.rgba.data() + y * rowBytes;
+    uint8_t *bottom = image.rgba.data() + (height - 1 - y) * rowBytes;
+    std::memcpy(row.data(), top, rowBytes);
+    std::memcpy(top, bottom, rowBytes);
+    std::memcpy(bottom, row.data(), rowBytes);
+  }
+  return image;
+}
+
+bool writePng(const std::string &path, const Image &image) {
+  std::filesystem::create_directories(
+      std::filesystem::path(path).parent_path());
+  return stbi_write_png(path.c_str(), image.width, image.height, 4,
+                        image.rgba.data(), image.width * 4) != 0;
+}
+
+bool readPng(const std::string &path, Image &image) {
+  int channels = 0;
+  stbi_uc *data =
+      stbi_load(path.c_str(), &image.width, &image.height, &channels, 4);
+  if (!data) {
+    return false;
+  }
+  image.rgba.assign(data, data + static_cast<size_t>(image.width) *
+      image.height * 4);
+  stbi_image_free(data);
+  return true;
+}
+
+/**
+ * @brief 比较两张图像, 返回超差像素比例, 并生成差异图
+ */
+double compareImages(const Image &actual, const Image &golden,
+                     int channelTolerance, Image &diff) {
+  if (actual.width != golden.width || actual.height != golden.height) {
+    return 1.0;
+  }
+  diff = actual;
+  size_t differentPixels = 0;
+  const size_t pixelCount = static_cast<size_t>(actual.width) * actual.height;
+  for (size_t i = 0; i < pixelCount; ++i) {
+    int maxDelta = 0;
+    for (int c = 0; c < 4; ++c) {
+      int delta = std::abs(static_cast<int>(actual.rgba[i * 4 + c]) -
+          static_cast<int>(golden.rgba[i * 4 + c]));
+      maxDelta = std::max(maxDelta, delta);
+    }
+    bool different = maxDelta > channelTolerance;
+    differentPixels += different ? 1 : 0;
+    diff.rgba[i * 4 + 0] = different ? 255 : actual.rgba[i * 4 + 0] / 4;
+    diff.rgba[i * 4 + 1] = different ? 0 : actual.rgba[i * 4 + 1] / 4;
+    diff.rgba[i * 4 + 2] = different ? 0 : actual.rgba[i * 4 + 2] / 4;
+    diff.rgba[i * 4 + 3] = 255;
+  }
+  return static_cast<double>(differentPixels) / pixelCount;
+}
+
+/**
+ * @brief 首次加载模型以生成烘焙文件
+ * @return 烘焙目录中生成了烘焙文件时返回 true
+ */
+bool cookModel(const std::string &modelPath, const std::string &cookedDir,
+               bool optimizeMeshes) {
+  std::error_code error;
+  std::filesystem::remove_all(cookedDir, error);
+  {
+    Engine engine;
+    GltfLoader loader;
+    loader.setCookedCacheDir(cookedDir);
+    loader.setOptimizeMeshes(optimizeMeshes);
+    if (!loader.loadFromFile(modelPath, engine)) {
+      return false;
+    }
+  }
+  for (const auto &entry:
+      std::filesystem::directory_iterator(cookedDir, error)) {
+    if (entry.path().extension() == ".ldhc") {
+      return true;
+    }
+  }
+  LOGE("No cooked file written for %s", modelPath.c_str());
+  return false;
+}
+
+/**
+ * @brief 按用例配置相机与动画, 渲染并统计通道耗时
+ */
+bool renderOneCase(const Options &options, const RenderCase &renderCase,
+                   const EnvironmentMapTextures &environment, Image &image,
+                   CaseResult &result) {
+  Engine engine;
+  GltfLoader loader;
+  const std::string modelPath =
+      renderCase.generate
+      ? options.outputDir + "/generated/" + renderCase.model
+      : options.assetDir + "/" + renderCase.model;
+  if (renderCase.generate && !renderCase.generate(modelPath)) {
+    return false;
+  }
+  loader.setOptimizeMeshes(renderCase.optimizeMeshes);
+  if (renderCase.cooked) {
+    const std::string cookedDir =
+        options.outputDir + "/cooked/" + renderCase.name;
+    if (!cookModel(modelPath, cookedDir, renderCase.optimizeMeshes)) {
+      return false;
+    }
+    // 全新的 loader, 只能从烘焙文件获取转换结果
+    loader.setCookedCacheDir(cookedDir);
+  }
+  if (renderCase.cacheHit) {
+    Engine warmup;
+    if (!loader.loadFromFile(modelPath, warmup) ||
+        loader.getAssetCache().getEntryCount() == 0) {
+      LOGE("Model not cached: %s", renderCase.model.c_str());
+      return false;
+    }
+  }
+  if (renderCase.async) {
+    // 先设置环境, 模型替换进来时自动绑定
+    if (!engine.applyEnvironmentMap(environment)) {
+      return false;
+    }
+    auto task = loader.loadFromFileAsync(modelPath, engine);
+    // 渲染空场景直到模型上传完成并被替换进来
+    while (task && !task->isFinished()) {
+      engine.renderFrame(kWidth, kHeight);
+    }
+    if (!task || !task->getGltf()) {
+      LOGE("Failed to load model: %s", renderCase.model.c_str());
+      return false;
+    }
+  } else {
+    FileAssetProvider assets(options.assetDir);
+    const bool loaded =
+        renderCase.provider
+        ? loader.loadGltfFromProvider(assets, renderCase.model, engine)
+        : loader.loadFromFile(modelPath, engine);
+    if (!loaded) {
+      LOGE("Failed to load model: %s", renderCase.model.c_str());
+      return false;
+    }
+    if (!engine.applyEnvironmentMap(environment)) {
+      return false;
+    }
+  }
+
+  // 固定动画时间轴
+  auto &timer = engine.state->getAnimationTimer();
+  timer.setFixedTime(renderCase.animationTime);
+  if (renderCase.animation >= 0) {
+    const auto &animations = engine.state->getGltf()->getAnimations();
+    if (renderCase.animation >= static_cast<int>(animations.size())) {
+      LOGE("Animation %d not found in %s", renderCase.animation,
+           renderCase.model.c_str());
+      return false;
+    }
+    engine.state->setAnimationIndices({AnimationEntry(renderCase.animation,
+                                                      -1)});
+  }
+
+  // 首帧完成初始化并将相机适配到场景
+  engine.renderFrame(kWidth, kHeight);
+  auto camera = engine.state->getUserCamera();
+  if (renderCase.orbitX != 0.0f || renderCase.orbitY != 0.0f) {
+    camera->orbit(renderCase.orbitX, renderCase.orbitY);
+  }
+
+  if (renderCase.prepare) {
+    if (!renderCase.prepare(engine)) {
+      LOGE("Failed to prepare case: %s", renderCase.name.c_str());
+      return false;
+    }
+    // 之后的计时帧只用于统计耗时
+    image = readFramebuffer(kWidth, kHeight);
+  }
+
+  auto profiler = std::make_shared<RenderPassProfiler>();
+  engine.renderer->setPassProfiler(profiler);
+
+  RenderPassTimings total;
+  double frameMs = 0.0;
+  for (int frame = 0; frame < options.frames; ++frame) {
+    profiler->beginFrame();
+    auto start = std::chrono::steady_clock::now();
+    engine.renderFrame(kWidth, kHeight);
+    glFinish();
+    frameMs += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    profiler->endFrame();
+
+    const auto &timings = profiler->getLastFrame();
+    for (size_t i = 0; i < RenderPassTimings::kPassCount; ++i) {
+      total.cpuMs[i] += timings.cpuMs[i];
+      total.gpuMs[i] += timings.gpuMs[i];
+    }
+    total.gpuValid = timings.gpuValid;
+  }
+  for (size_t i = 0; i < RenderPassTimings::kPassCount; ++i) {
+    total.cpuMs[i] /= options.frames;
+    total.gpuMs[i] /= options.frames;
+  }
+  result.frameMs = frameMs / options.frames;
+  result.passes = total;
+
+  if (!renderCase.prepare) {
+    image = readFramebuffer(kWidth, kHeight);
+  }
+  engine.renderer->setPassProfiler(nullptr);
+  return true;
+}
+
+void printTimings(const std::vector<CaseResult> &results) {
+  std::printf("\n%-18s %9s", "case", "frame");
+  for (size_t i = 0; i < RenderPassTimings::kPassCount; ++i) {
+    std::printf(" %13s", RenderPassProfiler::getPassName(
+        static_cast<RenderPass>(i)));
+  }
+  std::printf("   (cpu/gpu ms)\n");
+  for (const auto &result: results) {
+    std::printf("%-18s %9.2f", result.name.c_str(), result.frameMs);
+    for (size_t i = 0; i < RenderPassTimings::kPassCount; ++i) {
+      std::printf(" %6.2f/%6.2f", result.passes.cpuMs[i],
+                  result.passes.gpuValid ? result.passes.gpuMs[i] : 0.0);
+    }
+    std::printf("\n");
+  }
+}
+
+void writeTimingsCsv(const std::string &path,
+                     const std::vector<CaseResult> &results) {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    LOGE("Failed to write timings: %s", path.c_str());
+    return;
+  }
+  file << "case,frame_ms";
+  for (size_t i = 0; i < RenderPassTimings::kPassCount; ++i) {
+    const char *pass = RenderPassProfiler::getPassName(
+        static_cast<RenderPass>(i));
+    file << "," << pass << "_cpu_ms," << pass << "_gpu_ms";
+  }
+  file << ",different_ratio,passed\n";
+  for (const auto &result: results) {
+    file << result.name << "," << result.frameMs;
+    for (size_t i = 0; i < RenderPassTimings::kPassCount; ++i) {
+      file << "," << result.passes.cpuMs[i] << ","
+           << (result.passes.gpuValid ? result.passes.gpuMs[i] : 0.0);
+    }
+    file << "," << result.differentRatio << ","
+         << (result.passed ? 1 : 0) << "\n";
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options = parseOptions(argc, argv);
+
+  HeadlessEglContext eglContext;
+  if (!eglContext.create(kWidth, kHeight)) {
+    LOGE("Failed to create headless EGL context");
+    return 1;
+  }
+
+  FileAssetProvider assets(options.assetDir);
+  if (!ShaderManager::getInstance().loadShaderFiles(assets)) {
+    LOGE("Failed to load shaders from %s", options.assetDir.c_str());
+    return 1;
+  }
+
+  HDRImageLoader::setAssetProvider(
+      std::make_shared<FileAssetProvider>(options.assetDir));
+  HDRImage hdrImage = HDRImageLoader::loadFromAssets(kEnvironmentHdr);
+
+  // IBL 预处理在软件渲染器上较慢, 所有用例共用一次结果;
+  // 清空缓存目录保证这里实际烘焙并写入缓存
+  const std::string iblCacheDir = options.outputDir + "/ibl_cache";
+  std::error_code error;
+  std::filesystem::remove_all(iblCacheDir, error);
+  EnvironmentMapTextures environment;
+  Engine bakeEngine;
+  bakeEngine.setIblCacheDir(iblCacheDir);
+  if (!bakeEngine.bakeEnvironmentMap(hdrImage, environment)) {
+    LOGE("Failed to bake environment: %s", kEnvironmentHdr);
+    return 1;
+  }
+  // 预滤波环境按目录加载一次
+  std::map<std::string, EnvironmentMapTextures> environments;
+  environments[""] = environment;
+  const std::string kCachedEnvironment = "<ibl_cache>";
+  auto loadEnvironment = [&](const RenderCase &renderCase,
+                             EnvironmentMapTextures &textures) {
+    if (renderCase.cachedIbl) {
+      IBLSampler sampler(bakeEngine.context);
+      return IBLBakeCache::load(iblCacheDir,
+                                IBLBakeKey::make(hdrImage, sampler), textures);
+    }
+    return IBLAssetLoader::load(assets, renderCase.environment, textures);
+  };
+
+  std::vector<CaseResult> results;
+  int failures = 0;
+  for (const auto &renderCase: kCases) {
+    if (!options.filter.empty() &&
+        renderCase.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    if (renderCase.draco && !GltfDracoDecoder::isAvailable()) {
+#ifdef LIGHTDIGITALHUMAN_EXPECT_DRACO
+      std::printf("[FAIL] %s: built with Draco but the decoder is unavailable\n",
+                  renderCase.name.c_str());
+      CaseResult result;
+      result.name = renderCase.name;
+      results.push_back(result);
+      ++failures;
+#else
+      std::printf("[SKIP] %s: built without Draco\n", renderCase.name.c_str());
+#endif
+      continue;
+    }
+
+    CaseResult result;
+    result.name = renderCase.name;
+    const std::string &environmentName =
+        renderCase.cachedIbl ? kCachedEnvironment : renderCase.environment;
+    if (!environments.count(environmentName) &&
+        !loadEnvironment(renderCase, environments[environmentName])) {
+      environments.erase(environmentName);
+      std::printf("[FAIL] %s: failed to load environment %s\n",
+                  renderCase.name.c_str(), environmentName.c_str());
+      results.push_back(result);
+      ++failures;
+      continue;
+    }
+    Image actual;
+    if (!renderOneCase(options, renderCase,
+                       environments[environmentName], actual, result)) {
+      std::printf("[FAIL] %s: render failed\n", renderCase.name.c_str());
+      results.push_back(result);
+      ++failures;
+      continue;
+    }
+
+    const std::string goldenPath = options.goldenDir + "/" +
+        (renderCase.golden.empty() ? renderCase.name : renderCase.golden) +
+        ".png";
+    if (options.updateGolden) {
+      result.passed = writePng(goldenPath, actual);
+      std::printf("[%s] %s: golden %s\n", result.passed ? "UPDATE" : "FAIL",
+                  renderCase.name.c_str(), goldenPath.c_str());
+      failures += result.passed ? 0 : 1;
+      results.push_back(result);
+      continue;
+    }
+
+    Image golden;
+    if (!readPng(goldenPath, golden)) {
+      std::printf("[FAIL] %s: missing golden %s\n", renderCase.name.c_str(),
+                  goldenPath.c_str());
+      writePng(options.outputDir + "/" + renderCase.name + ".png", actual);
+      results.push_back(result);
+      ++failures;
+      continue;
+    }
+
+    Image diff;
+    result.differentRatio =
+        compareImages(actual, golden, options.channelTolerance, diff);
+    result.passed = result.differentRatio <= options.maxDifferentRatio;
+    std::printf("[%s] %s: %.3f%% pixels differ\n",
+                result.passed ? "PASS" : "FAIL", renderCase.name.c_str(),
+                result.differentRatio * 100.0);
+    if (!result.passed) {
+      writePng(options.outputDir + "/" + renderCase.name + ".png", actual);
+      writePng(options.outputDir + "/" + renderCase.name + "_diff.png", diff);
+      ++failures;
+    }
+    results.push_back(result);
+  }
+
+  printTimings(results);
+  if (!options.timingsFile.empty()) {
+    writeTimingsCsv(options.timingsFile, results);
+  }
+  return failures == 0 ? 0 : 1;
+}
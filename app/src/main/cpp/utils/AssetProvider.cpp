@@ -0,0 +1,93 @@
+//
+// Created by vincentsyan on 2025/9/22.
+//
+
+#include "AssetProvider.h"
+#include <fstream>
+#include "LogUtils.h"
+
+namespace digitalhumans {
+
+bool AssetProvider::readText(const std::string &path, std::string &out) const {
+  std::vector<uint8_t> data;
+  if (!readFile(path, data)) {
+    return false;
+  }
+  out.assign(reinterpret_cast<const char *>(data.data()), data.size());
+  return true;
+}
+
+FileAssetProvider::FileAssetProvider(std::string rootDir)
+    : rootDir_(std::move(rootDir)) {
+  if (!rootDir_.empty() && rootDir_.back() != '/') {
+    rootDir_ += '/';
+  }
+}
+
+bool FileAssetProvider::readFile(const std::string &path,
+                                 std::vector<uint8_t> &out) const {
+  const std::string fullPath =
+      (!path.empty() && path.front() == '/') ? path : rootDir_ + path;
+
+  std::ifstream file(fullPath, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    LOGE("Failed to open file: %s", fullPath.c_str());
+    return false;
+  }
+
+  std::streamsize size = file.tellg();
+  if (size <= 0) {
+    LOGE("Invalid file size: %s", fullPath.c_str());
+    return false;
+  }
+  file.seekg(0, std::ios::beg);
+
+  out.resize(static_cast<size_t>(size));
+  if (!file.read(reinterpret_cast<char *>(out.data()), size)) {
+    LOGE("Failed to read complete file: %s", fullPath.c_str());
+    out.clear();
+    return false;
+  }
+  return true;
+}
+
+#ifdef __ANDROID__
+AndroidAssetProvider::AndroidAssetProvider(AAssetManager *assetManager)
+    : assetManager_(assetManager) {}
+
+bool AndroidAssetProvider::readFile(const std::string &path,
+                                    std::vector<uint8_t> &out) const {
+  if (!assetManager_) {
+    LOGE("AssetManager not set!");
+    return false;
+  }
+
+  AAsset *asset =
+      AAssetManager_open(assetManager_, path.c_str(), AASSET_MODE_BUFFER);
+  if (!asset) {
+    LOGE("Failed to open asset: %s", path.c_str());
+    return false;
+  }
+
+  off_t fileSize = AAsset_getLength(asset);
+  if (fileSize <= 0) {
+    LOGE("Invalid asset size: %ld", static_cast<long>(fileSize));
+    AAsset_close(asset);
+    return false;
+  }
+
+  out.resize(static_cast<size_t>(fileSize));
+  int bytesRead = AAsset_read(asset, out.data(), fileSize);
+  AAsset_close(asset);
+
+  if (bytesRead != fileSize) {
+    LOGE("Failed to read complete asset file. Expected: %ld, Read: %d",
+         static_cast<long>(fileSize), bytesRead);
+    out.clear();
+    return false;
+  }
+  return true;
+}
+#endif
+
+} // namespace digitalhumans
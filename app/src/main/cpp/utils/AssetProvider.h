@@ -0,0 +1,83 @@
+//
+// Created by vincentsyan on 2025/9/22.
+//
+
+#ifndef LIGHTDIGITALHUMAN_ASSETPROVIDER_H
+#define LIGHTDIGITALHUMAN_ASSETPROVIDER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __ANDROID__
+#include <android/asset_manager.h>
+#endif
+
+namespace digitalhumans {
+
+/**
+ * @brief 资源读取接口
+ *
+ * 屏蔽 Android AAssetManager 与普通文件系统的差异,
+ * 使加载器既能在设备上运行, 也能在主机端基准测试中运行。
+ */
+class AssetProvider {
+ public:
+  virtual ~AssetProvider() = default;
+
+  /**
+   * @brief 读取完整的资源文件
+   * @param path 资源相对路径, 如 "testmodel/DamagedHelmet/DamagedHelmet.glb"
+   * @param out 输出的文件内容
+   * @return 是否读取成功
+   */
+  virtual bool readFile(const std::string &path,
+                        std::vector<uint8_t> &out) const = 0;
+
+  /**
+   * @brief 读取文本资源
+   * @param path 资源相对路径
+   * @param out 输出的文本内容
+   * @return 是否读取成功
+   */
+  bool readText(const std::string &path, std::string &out) const;
+};
+
+/**
+ * @brief 基于文件系统的资源读取, 相对路径以 rootDir 为根目录
+ */
+class FileAssetProvider : public AssetProvider {
+ public:
+  explicit FileAssetProvider(std::string rootDir = "");
+
+  bool readFile(const std::string &path,
+                std::vector<uint8_t> &out) const override;
+
+  const std::string &getRootDir() const { return rootDir_; }
+
+ private:
+  std::string rootDir_;
+};
+
+#ifdef __ANDROID__
+/**
+ * @brief 基于 AAssetManager 的资源读取（APK assets 目录）
+ */
+class AndroidAssetProvider : public AssetProvider {
+ public:
+  explicit AndroidAssetProvider(AAssetManager *assetManager);
+
+  bool readFile(const std::string &path,
+                std::vector<uint8_t> &out) const override;
+
+  AAssetManager *getAssetManager() const { return assetManager_; }
+
+ private:
+  AAssetManager *assetManager_;
+};
+#endif
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_ASSETPROVIDER_H
@@ -0,0 +1,479 @@
+//
+// Created by vincentsyan on 2025/10/11.
+//
+
+#include "ComponentConvert.h"
+#include <algorithm>
+#include <cstring>
+#include <GLES3/gl3.h>
+
+// 标准化使用除法以与标量实现逐位一致, NEON 的向量除法只在 AArch64 上提供
+#if defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define DH_COMPONENT_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define DH_COMPONENT_SSE2 1
+#endif
+
+namespace digitalhumans {
+namespace component {
+
+namespace {
+
+/**
+ * @brief 组件类型的标准化参数
+ */
+template<typename T>
+struct NormalizeTraits;
+
+template<>
+struct NormalizeTraits<int8_t> {
+  static constexpr float kDivisor = 127.0f;
+  static constexpr bool kSigned = true;
+};
+
+template<>
+struct NormalizeTraits<uint8_t> {
+  static constexpr float kDivisor = 255.0f;
+  static constexpr bool kSigned = false;
+};
+
+template<>
+struct NormalizeTraits<int16_t> {
+  static constexpr float kDivisor = 32767.0f;
+  static constexpr bool kSigned = true;
+};
+
+template<>
+struct NormalizeTraits<uint16_t> {
+  static constexpr float kDivisor = 65535.0f;
+  static constexpr bool kSigned = false;
+};
+
+template<typename T>
+void convertScalar(const T *src, bool normalized, float *dst, size_t begin,
+                   size_t count) {
+  using Traits = NormalizeTraits<T>;
+  for (size_t i = begin; i < count; ++i) {
+    float value = static_cast<float>(src[i]);
+    if (normalized) {
+      value /= Traits::kDivisor;
+      if (Traits::kSigned) {
+        value = std::max(value, -1.0f);
+      }
+    }
+    dst[i] = value;
+  }
+}
+
+#if DH_COMPONENT_NEON
+
+template<typename T>
+inline float32x4_t finish(float32x4_t value, bool normalized) {
+  using Traits = NormalizeTraits<T>;
+  if (normalized) {
+    value = vdivq_f32(value, vdupq_n_f32(Traits::kDivisor));
+    if (Traits::kSigned) {
+      value = vmaxq_f32(value, vdupq_n_f32(-1.0f));
+    }
+  }
+  return value;
+}
+
+inline void storeU16(uint16x8_t value, bool normalized, float *dst) {
+  vst1q_f32(dst, finish<uint16_t>(
+      vcvtq_f32_u32(vmovl_u16(vget_low_u16(value))), normalized));
+  vst1q_f32(dst + 4, finish<uint16_t>(
+      vcvtq_f32_u32(vmovl_high_u16(value)), normalized));
+}
+
+inline void storeS16(int16x8_t value, bool normalized, float *dst) {
+  vst1q_f32(dst, finish<int16_t>(
+      vcvtq_f32_s32(vmovl_s16(vget_low_s16(value))), normalized));
+  vst1q_f32(dst + 4, finish<int16_t>(
+      vcvtq_f32_s32(vmovl_high_s16(value)), normalized));
+}
+
+size_t convertSimd(const uint8_t *src, bool normalized, float *dst,
+                   size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    uint8x16_t bytes = vld1q_u8(src + i);
+    uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+    uint16x8_t hi = vmovl_high_u8(bytes);
+    vst1q_f32(dst + i, finish<uint8_t>(
+        vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), normalized));
+    vst1q_f32(dst + i + 4, finish<uint8_t>(
+        vcvtq_f32_u32(vmovl_high_u16(lo)), normalized));
+    vst1q_f32(dst + i + 8, finish<uint8_t>(
+        vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), normalized));
+    vst1q_f32(dst + i + 12, finish<uint8_t>(
+        vcvtq_f32_u32(vmovl_high_u16(hi)), normalized));
+  }
+  return i;
+}
+
+size_t convertSimd(const int8_t *src, bool normalized, float *dst,
+                   size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    int8x16_t bytes = vld1q_s8(src + i);
+    int16x8_t lo = vmovl_s8(vget_low_s8(bytes));
+    int16x8_t hi = vmovl_high_s8(bytes);
+    vst1q_f32(dst + i, finish<int8_t>(
+        vcvtq_f32_s32(vmovl_s16(vget_low_s16(lo))), normalized));
+    vst1q_f32(dst + i + 4, finish<int8_t>(
+        vcvtq_f32_s32(vmovl_high_s16(lo)), normalized));
+    vst1q_f32(dst + i + 8, finish<int8_t>(
+        vcvtq_f32_s32(vmovl_s16(vget_low_s16(hi))), normalized));
+    vst1q_f32(dst + i + 12, finish<int8_t>(
+        vcvtq_f32_s32(vmovl_high_s16(hi)), normalized));
+  }
+  return i;
+}
+
+size_t convertSimd(const uint16_t *src, bool normalized, float *dst,
+                   size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    storeU16(vld1q_u16(src + i), normalized, dst + i);
+  }
+  return i;
+}
+
+size_t convertSimd(const int16_t *src, bool normalized, float *dst,
+                   size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    storeS16(vld1q_s16(src + i), normalized, dst + i);
+  }
+  return i;
+}
+
+#elif DH_COMPONENT_SSE2
+
+template<typename T>
+inline __m128 finish(__m128i value, bool normalized) {
+  using Traits = NormalizeTraits<T>;
+  __m128 result = _mm_cvtepi32_ps(value);
+  if (normalized) {
+    result = _mm_div_ps(result, _mm_set1_ps(Traits::kDivisor));
+    if (Traits::kSigned) {
+      result = _mm_max_ps(result, _mm_set1_ps(-1.0f));
+    }
+  }
+  return result;
+}
+
+/// 8 个 16 位分量（已扩展为 32 位的高低两半）写入 dst
+template<typename T>
+inline void store16(__m128i lo32, __m128i hi32, bool normalized, float *dst) {
+  _mm_storeu_ps(dst, finish<T>(lo32, normalized));
+  _mm_storeu_ps(dst + 4, finish<T>(hi32, normalized));
+}
+
+inline void storeU16(__m128i value, bool normalized, float *dst) {
+  const __m128i zero = _mm_setzero_si128();
+  store16<uint16_t>(_mm_unpacklo_epi16(value, zero),
+                    _mm_unpackhi_epi16(value, zero), normalized, dst);
+}
+
+inline void storeS16(__m128i value, bool normalized, float *dst) {
+  // 与自身交错后算术右移完成符号扩展
+  store16<int16_t>(_mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16),
+                   _mm_srai_epi32(_mm_unpackhi_epi16(value, value), 16),
+                   normalized, dst);
+}
+
+size_t convertSimd(const uint8_t *src, bool normalized, float *dst,
+                   size_t count) {
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+    __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+    store16<uint8_t>(_mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                     normalized, dst + i);
+    store16<uint8_t>(_mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero),
+                     normalized, dst + i + 8);
+  }
+  return i;
+}
+
+size_t convertSimd(const int8_t *src, bool normalized, float *dst,
+                   size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+    __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(bytes, bytes), 8);
+    store16<int8_t>(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16),
+                    _mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16),
+                    normalized, dst + i);
+    store16<int8_t>(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16),
+                    _mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16),
+                    normalized, dst + i + 8);
+  }
+  return i;
+}
+
+size_t convertSimd(const uint16_t *src, bool normalized, float *dst,
+                   size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    storeU16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)),
+             normalized, dst + i);
+  }
+  return i;
+}
+
+size_t convertSimd(const int16_t *src, bool normalized, float *dst,
+                   size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    storeS16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)),
+             normalized, dst + i);
+  }
+  return i;
+}
+
+#else
+
+template<typename T>
+size_t convertSimd(const T *, bool, float *, size_t) {
+  return 0;
+}
+
+#endif
+
+template<typename T>
+void convert(const void *src, bool normalized, float *dst, size_t count) {
+  const auto *typed = static_cast<const T *>(src);
+  const size_t done = convertSimd(typed, normalized, dst, count);
+  convertScalar(typed, normalized, dst, done, count);
+}
+
+/**
+ * @brief 16 字节读写一次收集一个元素
+ *
+ * 写入的 16 字节会越过当前元素, 由下一个元素覆盖; 读取不越过源数据末尾
+ * 要求 srcStride >= 16, 写入不越过 dst 末尾要求最后几个元素留给逐个拷贝。
+ */
+size_t gatherSimd(const uint8_t *src, size_t srcStride, size_t elementSize,
+                  uint8_t *dst, size_t count) {
+  if (elementSize > 16 || srcStride < 16) {
+    return 0;
+  }
+  const size_t tail = (16 + elementSize - 1) / elementSize;
+  size_t i = 0;
+  for (; i + tail < count; ++i) {
+#if DH_COMPONENT_NEON
+    vst1q_u8(dst + i * elementSize, vld1q_u8(src + i * srcStride));
+#elif DH_COMPONENT_SSE2
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(dst + i * elementSize),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * srcStride)));
+#else
+    std::memcpy(dst + i * elementSize, src + i * srcStride, 16);
+#endif
+  }
+  return i;
+}
+
+template<size_t N>
+void gatherFixed(const uint8_t *src, size_t srcStride, uint8_t *dst,
+                 size_t begin, size_t count) {
+  for (size_t i = begin; i < count; ++i) {
+    std::memcpy(dst + i * N, src + i * srcStride, N);
+  }
+}
+
+template<size_t N>
+size_t scatterFixed(const uint8_t *values, const uint32_t *indices,
+                    size_t count, uint8_t *dst, size_t dstStride,
+                    size_t dstCount) {
+  size_t skipped = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (indices[i] >= dstCount) {
+      ++skipped;
+      continue;
+    }
+    std::memcpy(dst + indices[i] * dstStride, values + i * N, N);
+  }
+  return skipped;
+}
+
+} // namespace
+
+bool toFloat(const void *src, int componentType, bool normalized, float *dst,
+             size_t count) {
+  switch (componentType) {
+    case GL_BYTE:
+      convert<int8_t>(src, normalized, dst, count);
+      return true;
+    case GL_UNSIGNED_BYTE:
+      convert<uint8_t>(src, normalized, dst, count);
+      return true;
+    case GL_SHORT:
+      convert<int16_t>(src, normalized, dst, count);
+      return true;
+    case GL_UNSIGNED_SHORT:
+      convert<uint16_t>(src, normalized, dst, count);
+      return true;
+    case GL_UNSIGNED_INT: {
+      // glTF 不允许标准化的 UNSIGNED_INT, 按数值转换
+      const auto *typed = static_cast<const uint32_t *>(src);
+      size_t i = 0;
+#if DH_COMPONENT_NEON
+      for (; i + 4 <= count; i += 4) {
+        vst1q_f32(dst + i, vcvtq_f32_u32(vld1q_u32(typed + i)));
+      }
+#endif
+      for (; i < count; ++i) {
+        dst[i] = static_cast<float>(typed[i]);
+      }
+      return true;
+    }
+    case GL_FLOAT:
+      std::memcpy(dst, src, count * sizeof(float));
+      return true;
+    default:
+      return false;
+  }
+}
+
+void gatherElements(const uint8_t *src, size_t srcStride, size_t elementSize,
+                    uint8_t *dst, size_t count) {
+  if (count == 0 || elementSize == 0) {
+    return;
+  }
+  if (srcStride == elementSize) {
+    std::memcpy(dst, src, count * elementSize);
+    return;
+  }
+  const size_t done = gatherSimd(src, srcStride, elementSize, dst, count);
+  // 常见元素大小使用定长拷贝, 由编译器展开
+  switch (elementSize) {
+    case 2:
+      gatherFixed<2>(src, srcStride, dst, done, count);
+      break;
+    case 4:
+      gatherFixed<4>(src, srcStride, dst, done, count);
+      break;
+    case 6:
+      gatherFixed<6>(src, srcStride, dst, done, count);
+      break;
+    case 8:
+      gatherFixed<8>(src, srcStride, dst, done, count);
+      break;
+    case 12:
+      gatherFixed<12>(src, srcStride, dst, done, count);
+      break;
+    case 16:
+      gatherFixed<16>(src, srcStride, dst, done, count);
+      break;
+    default:
+      for (size_t i = done; i < count; ++i) {
+        std::memcpy(dst + i * elementSize, src + i * srcStride, elementSize);
+      }
+      break;
+  }
+}
+
+bool widenIndices(const void *src, int componentType, uint32_t *dst,
+                  size_t count) {
+  size_t i = 0;
+  switch (componentType) {
+    case GL_UNSIGNED_BYTE: {
+      const auto *typed = static_cast<const uint8_t *>(src);
+#if DH_COMPONENT_NEON
+      for (; i + 16 <= count; i += 16) {
+        uint8x16_t bytes = vld1q_u8(typed + i);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+        uint16x8_t hi = vmovl_high_u8(bytes);
+        vst1q_u32(dst + i, vmovl_u16(vget_low_u16(lo)));
+        vst1q_u32(dst + i + 4, vmovl_high_u16(lo));
+        vst1q_u32(dst + i + 8, vmovl_u16(vget_low_u16(hi)));
+        vst1q_u32(dst + i + 12, vmovl_high_u16(hi));
+      }
+#elif DH_COMPONENT_SSE2
+      const __m128i zero = _mm_setzero_si128();
+      for (; i + 16 <= count; i += 16) {
+        __m128i bytes =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(typed + i));
+        __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+        __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+        auto *out = reinterpret_cast<__m128i *>(dst + i);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+      }
+#endif
+      for (; i < count; ++i) {
+        dst[i] = typed[i];
+      }
+      return true;
+    }
+    case GL_UNSIGNED_SHORT: {
+      const auto *typed = static_cast<const uint16_t *>(src);
+#if DH_COMPONENT_NEON
+      for (; i + 8 <= count; i += 8) {
+        uint16x8_t shorts = vld1q_u16(typed + i);
+        vst1q_u32(dst + i, vmovl_u16(vget_low_u16(shorts)));
+        vst1q_u32(dst + i + 4, vmovl_high_u16(shorts));
+      }
+#elif DH_COMPONENT_SSE2
+      const __m128i zero = _mm_setzero_si128();
+      for (; i + 8 <= count; i += 8) {
+        __m128i shorts =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(typed + i));
+        auto *out = reinterpret_cast<__m128i *>(dst + i);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(shorts, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(shorts, zero));
+      }
+#endif
+      for (; i < count; ++i) {
+        dst[i] = typed[i];
+      }
+      return true;
+    }
+    case GL_UNSIGNED_INT:
+      std::memcpy(dst, src, count * sizeof(uint32_t));
+      return true;
+    default:
+      return false;
+  }
+}
+
+size_t scatterElements(const uint8_t *values, size_t elementSize,
+                       const uint32_t *indices, size_t count, uint8_t *dst,
+                       size_t dstStride, size_t dstCount) {
+  switch (elementSize) {
+    case 4:
+      return scatterFixed<4>(values, indices, count, dst, dstStride, dstCount);
+    case 8:
+      return scatterFixed<8>(values, indices, count, dst, dstStride, dstCount);
+    case 12:
+      return scatterFixed<12>(values, indices, count, dst, dstStride, dstCount);
+    case 16:
+      return scatterFixed<16>(values, indices, count, dst, dstStride, dstCount);
+    default:
+      break;
+  }
+  size_t skipped = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (indices[i] >= dstCount) {
+      ++skipped;
+      continue;
+    }
+    std::memcpy(dst + indices[i] * dstStride, values + i * elementSize,
+                elementSize);
+  }
+  return skipped;
+}
+
+} // namespace component
+} // namespace digitalhumans
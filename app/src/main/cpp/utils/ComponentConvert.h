@@ -0,0 +1,58 @@
+//
+// Created by vincentsyan on 2025/10/11.
+//
+
+#ifndef LIGHTDIGITALHUMAN_COMPONENTCONVERT_H
+#define LIGHTDIGITALHUMAN_COMPONENTCONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace digitalhumans {
+namespace component {
+
+/**
+ * @brief 访问器数据的批量转换: 反量化、去交错与稀疏替换
+ *
+ * ARM 上使用 NEON, x86 上使用 SSE2, 其余平台与尾部元素走标量实现。
+ * componentType 为 GL 组件类型枚举。dst 需预先分配, 不能与 src 重叠。
+ */
+
+/**
+ * @brief 将 count 个组件转换为 float
+ *
+ * normalized 时按 glTF 规则标准化: 无符号类型除以最大值,
+ * 有符号类型除以最大值后下限为 -1; 否则按数值转换。
+ * @return 不支持的组件类型返回 false
+ */
+bool toFloat(const void *src, int componentType, bool normalized, float *dst,
+             size_t count);
+
+/**
+ * @brief 按步长收集 count 个元素, 紧密写入 dst
+ * @param srcStride 源数据中相邻元素的字节间隔, 不小于 elementSize
+ */
+void gatherElements(const uint8_t *src, size_t srcStride, size_t elementSize,
+                    uint8_t *dst, size_t count);
+
+/**
+ * @brief 将 UNSIGNED_BYTE/UNSIGNED_SHORT/UNSIGNED_INT 索引扩展为 32 位
+ * @return 不支持的组件类型返回 false
+ */
+bool widenIndices(const void *src, int componentType, uint32_t *dst,
+                  size_t count);
+
+/**
+ * @brief 稀疏替换: 第 i 个值写入 dst 的第 indices[i] 个元素
+ * @param dstStride dst 中相邻元素的字节间隔
+ * @param dstCount dst 的元素数量, 越界的索引被跳过
+ * @return 被跳过的索引数量
+ */
+size_t scatterElements(const uint8_t *values, size_t elementSize,
+                       const uint32_t *indices, size_t count, uint8_t *dst,
+                       size_t dstStride, size_t dstCount);
+
+} // namespace component
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_COMPONENTCONVERT_H
@@ -0,0 +1,39 @@
+//
+// Created by vincentsyan on 2025/9/29.
+//
+
+#ifndef LIGHTDIGITALHUMAN_CONTENTHASH_H
+#define LIGHTDIGITALHUMAN_CONTENTHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace digitalhumans {
+
+/**
+ * @brief 内容哈希（xxHash64 算法）
+ *
+ * 用于识别资源内容是否变化（如烘焙缓存的键）, 不用于安全校验。
+ * 每次处理 32 字节, 吞吐量接近内存带宽, 对几十 MB 的模型文件只需数毫秒。
+ */
+namespace hash {
+
+uint64_t hashBytes(const void *data, size_t size, uint64_t seed = 0);
+
+/**
+ * @brief 以内存映射方式读取并计算文件内容哈希
+ * @return 文件不存在或无法映射时返回 false
+ */
+bool hashFile(const std::string &filePath, uint64_t &out);
+
+/**
+ * @brief 16 位小写十六进制表示
+ */
+std::string toHex(uint64_t value);
+
+} // namespace hash
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_CONTENTHASH_H
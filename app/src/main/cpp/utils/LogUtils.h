@@ -8,10 +8,12 @@
 
 // app/src/main/cpp/log_utils.h
 
-#include <android/log.h>
-
 #define LOG_TAG "DigitalHuman"
 
+#ifdef __ANDROID__
+
+#include <android/log.h>
+
 #define LOGV(...) __android_log_print(ANDROID_LOG_VERBOSE, LOG_TAG, __VA_ARGS__)
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -19,6 +21,27 @@
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 #define LOGF(...) __android_log_print(ANDROID_LOG_FATAL, LOG_TAG, __VA_ARGS__)
 
+#else
+
+// 主机构建（基准测试/离屏测试）: 输出到 stderr, 格式与 logcat 保持一致
+#include <cstdio>
+
+#define DH_HOST_LOG(level, ...)                            \
+  do {                                                     \
+    std::fprintf(stderr, "%s/%s: ", level, LOG_TAG);       \
+    std::fprintf(stderr, __VA_ARGS__);                     \
+    std::fputc('\n', stderr);                              \
+  } while (0)
+
+#define LOGV(...) DH_HOST_LOG("V", __VA_ARGS__)
+#define LOGD(...) DH_HOST_LOG("D", __VA_ARGS__)
+#define LOGI(...) DH_HOST_LOG("I", __VA_ARGS__)
+#define LOGW(...) DH_HOST_LOG("W", __VA_ARGS__)
+#define LOGE(...) DH_HOST_LOG("E", __VA_ARGS__)
+#define LOGF(...) DH_HOST_LOG("F", __VA_ARGS__)
+
+#endif
+
 // 条件编译优化
 #ifdef NDEBUG
 #undef LOGV
@@ -0,0 +1,56 @@
+//
+// Created by vincentsyan on 2025/9/24.
+//
+
+#include "MappedFile.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "LogUtils.h"
+
+namespace digitalhumans {
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string &filePath) {
+  int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    LOGE("Failed to open file for mapping: %s (%s)", filePath.c_str(),
+         std::strerror(errno));
+    return nullptr;
+  }
+
+  struct stat st{};
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    LOGE("Invalid file size for mapping: %s", filePath.c_str());
+    close(fd);
+    return nullptr;
+  }
+
+  size_t size = static_cast<size_t>(st.st_size);
+  void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // 映射建立后即可关闭文件描述符
+  close(fd);
+  if (addr == MAP_FAILED) {
+    LOGE("mmap failed: %s (%s)", filePath.c_str(), std::strerror(errno));
+    return nullptr;
+  }
+
+  // 模型数据基本按顺序访问, 提示内核预读
+  madvise(addr, size, MADV_SEQUENTIAL);
+
+  return std::shared_ptr<MappedFile>(
+      new MappedFile(filePath, static_cast<const uint8_t *>(addr), size));
+}
+
+MappedFile::MappedFile(std::string path, const uint8_t *data, size_t size)
+    : path_(std::move(path)), data_(data), size_(size) {}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    munmap(const_cast<uint8_t *>(data_), size_);
+  }
+}
+
+} // namespace digitalhumans
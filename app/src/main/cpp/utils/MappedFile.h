@@ -0,0 +1,50 @@
+//
+// Created by vincentsyan on 2025/9/24.
+//
+
+#ifndef LIGHTDIGITALHUMAN_MAPPEDFILE_H
+#define LIGHTDIGITALHUMAN_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace digitalhumans {
+
+/**
+ * @brief 只读内存映射文件
+ *
+ * 通过 mmap 将整个文件映射到进程地址空间, 数据按需由内核分页读入,
+ * 避免一次性读入并复制到堆内存。对象析构时解除映射,
+ * 需要引用映射数据的对象应持有其 shared_ptr。
+ */
+class MappedFile {
+ public:
+  /**
+   * @brief 映射文件
+   * @param filePath 文件完整路径
+   * @return 映射成功返回对象, 否则返回 nullptr
+   */
+  static std::shared_ptr<MappedFile> open(const std::string &filePath);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+  const std::string &getPath() const { return path_; }
+
+ private:
+  MappedFile(std::string path, const uint8_t *data, size_t size);
+
+  std::string path_;
+  const uint8_t *data_;
+  size_t size_;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_MAPPEDFILE_H
@@ -0,0 +1,173 @@
+//
+// Created by vincentsyan on 2025/9/27.
+//
+
+#include "PixelConvert.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DH_PIXEL_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define DH_PIXEL_SSE2 1
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define DH_PIXEL_SSSE3 1
+#endif
+#endif
+
+namespace digitalhumans {
+namespace pixel {
+
+void expandGreyToRgb(const uint8_t *src, uint8_t *dst, size_t pixelCount) {
+  size_t i = 0;
+#if DH_PIXEL_NEON
+  for (; i + 16 <= pixelCount; i += 16) {
+    uint8x16_t grey = vld1q_u8(src + i);
+    uint8x16x3_t rgb = {{grey, grey, grey}};
+    vst3q_u8(dst + i * 3, rgb);
+  }
+#endif
+  for (; i < pixelCount; ++i) {
+    dst[i * 3 + 0] = src[i];
+    dst[i * 3 + 1] = src[i];
+    dst[i * 3 + 2] = src[i];
+  }
+}
+
+void expandGreyToRgba(const uint8_t *src, uint8_t *dst, size_t pixelCount) {
+  size_t i = 0;
+#if DH_PIXEL_NEON
+  const uint8x16_t alpha = vdupq_n_u8(0xFF);
+  for (; i + 16 <= pixelCount; i += 16) {
+    uint8x16_t grey = vld1q_u8(src + i);
+    uint8x16x4_t rgba = {{grey, grey, grey, alpha}};
+    vst4q_u8(dst + i * 4, rgba);
+  }
+#elif DH_PIXEL_SSE2
+  const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+  for (; i + 16 <= pixelCount; i += 16) {
+    __m128i grey =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    // (g,g) 与 (g,a) 两两交错得到 (g,g,g,a)
+    __m128i ggLo = _mm_unpacklo_epi8(grey, grey);
+    __m128i ggHi = _mm_unpackhi_epi8(grey, grey);
+    __m128i gaLo = _mm_unpacklo_epi8(grey, alpha);
+    __m128i gaHi = _mm_unpackhi_epi8(grey, alpha);
+    auto *out = reinterpret_cast<__m128i *>(dst + i * 4);
+    _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(ggLo, gaLo));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(ggLo, gaLo));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(ggHi, gaHi));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(ggHi, gaHi));
+  }
+#endif
+  for (; i < pixelCount; ++i) {
+    dst[i * 4 + 0] = src[i];
+    dst[i * 4 + 1] = src[i];
+    dst[i * 4 + 2] = src[i];
+    dst[i * 4 + 3] = 0xFF;
+  }
+}
+
+void expandGreyAlphaToRgba(const uint8_t *src, uint8_t *dst,
+                           size_t pixelCount) {
+  size_t i = 0;
+#if DH_PIXEL_NEON
+  for (; i + 16 <= pixelCount; i += 16) {
+    uint8x16x2_t greyAlpha = vld2q_u8(src + i * 2);
+    uint8x16x4_t rgba = {{greyAlpha.val[0], greyAlpha.val[0],
+                          greyAlpha.val[0], greyAlpha.val[1]}};
+    vst4q_u8(dst + i * 4, rgba);
+  }
+#elif DH_PIXEL_SSE2
+  const __m128i lowByte = _mm_set1_epi16(0x00FF);
+  for (; i + 8 <= pixelCount; i += 8) {
+    __m128i greyAlpha =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+    // 每个 16 位分量的低字节是 g, 复制为 (g,g) 后与 (g,a) 交错
+    __m128i grey = _mm_and_si128(greyAlpha, lowByte);
+    __m128i greyGrey = _mm_or_si128(grey, _mm_slli_epi16(grey, 8));
+    auto *out = reinterpret_cast<__m128i *>(dst + i * 4);
+    _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(greyGrey, greyAlpha));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(greyGrey, greyAlpha));
+  }
+#endif
+  for (; i < pixelCount; ++i) {
+    dst[i * 4 + 0] = src[i * 2];
+    dst[i * 4 + 1] = src[i * 2];
+    dst[i * 4 + 2] = src[i * 2];
+    dst[i * 4 + 3] = src[i * 2 + 1];
+  }
+}
+
+void expandRgbToRgba(const uint8_t *src, uint8_t *dst, size_t pixelCount) {
+  size_t i = 0;
+#if DH_PIXEL_NEON
+  const uint8x16_t alpha = vdupq_n_u8(0xFF);
+  for (; i + 16 <= pixelCount; i += 16) {
+    uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+    uint8x16x4_t rgba = {{rgb.val[0], rgb.val[1], rgb.val[2], alpha}};
+    vst4q_u8(dst + i * 4, rgba);
+  }
+#elif DH_PIXEL_SSSE3
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                        6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+  // 每次读 16 字节只用前 12 字节（4 个像素）, 保证读取不越过输入末尾
+  for (; i + 6 <= pixelCount; i += 4) {
+    __m128i rgb =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 3));
+    __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), rgba);
+  }
+#endif
+  for (; i < pixelCount; ++i) {
+    dst[i * 4 + 0] = src[i * 3 + 0];
+    dst[i * 4 + 1] = src[i * 3 + 1];
+    dst[i * 4 + 2] = src[i * 3 + 2];
+    dst[i * 4 + 3] = 0xFF;
+  }
+}
+
+bool expandToRgba(const uint8_t *src, int channels, uint8_t *dst,
+                  size_t pixelCount) {
+  switch (channels) {
+    case 1:
+      expandGreyToRgba(src, dst, pixelCount);
+      return true;
+    case 2:
+      expandGreyAlphaToRgba(src, dst, pixelCount);
+      return true;
+    case 3:
+      expandRgbToRgba(src, dst, pixelCount);
+      return true;
+    default:
+      return false;
+  }
+}
+
+void narrow16To8(const uint16_t *src, uint8_t *dst, size_t count) {
+  size_t i = 0;
+#if DH_PIXEL_NEON
+  for (; i + 16 <= count; i += 16) {
+    uint8x8_t lo = vshrn_n_u16(vld1q_u16(src + i), 8);
+    uint8x8_t hi = vshrn_n_u16(vld1q_u16(src + i + 8), 8);
+    vst1q_u8(dst + i, vcombine_u8(lo, hi));
+  }
+#elif DH_PIXEL_SSE2
+  for (; i + 16 <= count; i += 16) {
+    __m128i lo = _mm_srli_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), 8);
+    __m128i hi = _mm_srli_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8)), 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                     _mm_packus_epi16(lo, hi));
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[i] = static_cast<uint8_t>(src[i] >> 8);
+  }
+}
+
+} // namespace pixel
+} // namespace digitalhumans
@@ -0,0 +1,47 @@
+//
+// Created by vincentsyan on 2025/9/27.
+//
+
+#ifndef LIGHTDIGITALHUMAN_PIXELCONVERT_H
+#define LIGHTDIGITALHUMAN_PIXELCONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace digitalhumans {
+namespace pixel {
+
+/**
+ * @brief 像素通道展开与位深转换
+ *
+ * ARM 上使用 NEON 交错读写（vld2/vld3 + vst3/vst4）, x86 上使用 SSE2/SSSE3,
+ * 其余平台与尾部像素走标量实现。dst 需预先分配, 不能与 src 重叠。
+ */
+
+/// 灰度 -> RGB
+void expandGreyToRgb(const uint8_t *src, uint8_t *dst, size_t pixelCount);
+
+/// 灰度 -> RGBA（alpha = 255）
+void expandGreyToRgba(const uint8_t *src, uint8_t *dst, size_t pixelCount);
+
+/// 灰度 + alpha -> RGBA
+void expandGreyAlphaToRgba(const uint8_t *src, uint8_t *dst,
+                           size_t pixelCount);
+
+/// RGB -> RGBA（alpha = 255）
+void expandRgbToRgba(const uint8_t *src, uint8_t *dst, size_t pixelCount);
+
+/**
+ * @brief 将 1~3 通道的 8 位像素展开为 RGBA
+ * @return channels 不在 1~3 范围内时返回 false
+ */
+bool expandToRgba(const uint8_t *src, int channels, uint8_t *dst,
+                  size_t pixelCount);
+
+/// 16 位分量 -> 8 位（取高 8 位）
+void narrow16To8(const uint16_t *src, uint8_t *dst, size_t count);
+
+} // namespace pixel
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_PIXELCONVERT_H
@@ -0,0 +1,74 @@
+//
+// Created by vincentsyan on 2025/9/27.
+//
+
+#ifndef LIGHTDIGITALHUMAN_THREADPOOL_H
+#define LIGHTDIGITALHUMAN_THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace digitalhumans {
+
+/**
+ * @brief 固定大小的工作线程池
+ *
+ * 用于加载阶段可并行的 CPU 任务（图像解码等）。任务按提交顺序执行,
+ * 通过返回的 future 获取结果; 析构时执行完已提交的任务再退出。
+ */
+class ThreadPool {
+ public:
+  /**
+   * @param threadCount 工作线程数, 0 表示使用硬件并发数
+   */
+  explicit ThreadPool(size_t threadCount = 0);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief 进程内共享的线程池, 首次使用时创建
+   */
+  static ThreadPool &shared();
+
+  /**
+   * @brief 提交任务
+   * @return 任务结果的 future, 任务抛出的异常在 get() 时重新抛出
+   */
+  template<typename F>
+  std::future<std::invoke_result_t<F>> submit(F &&task) {
+    using Result = std::invoke_result_t<F>;
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(
+        std::forward<F>(task));
+    std::future<Result> future = packaged->get_future();
+    enqueue([packaged]() { (*packaged)(); });
+    return future;
+  }
+
+  size_t getThreadCount() const { return workers.size(); }
+
+ private:
+  void enqueue(std::function<void()> task);
+
+  void workerLoop();
+
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool stopping = false;
+};
+
+} // namespace digitalhumans
+
+#endif //LIGHTDIGITALHUMAN_THREADPOOL_H
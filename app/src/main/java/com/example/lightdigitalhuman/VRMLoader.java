@@ -52,10 +52,13 @@ public class VRMLoader {
             }
             if (success) {
                 Log.i(TAG, "VRM loaded successfully");
-                boolean loadEnvironmentIblFromAssets = engine.loadEnvironmentIblFromAssets("envs" +
-                        "/afrikaans_church_interior_1k.hdr", assetManager);
-                Log.i(TAG,
-                        "loadEnvironmentIblFromAssets loadEnvironmentIblFromAssets " + loadEnvironmentIblFromAssets);
+                // 优先使用预滤波的 KTX 环境, 失败时再在 GPU 上预处理 HDR
+                boolean loadEnvironment = engine.loadEnvironmentFromAssets("envs", assetManager);
+                if (!loadEnvironment) {
+                    loadEnvironment = engine.loadEnvironmentIblFromAssets("envs" +
+                            "/afrikaans_church_interior_1k.hdr", assetManager);
+                }
+                Log.i(TAG, "loadEnvironment " + loadEnvironment);
 
                 initResult.success();
 
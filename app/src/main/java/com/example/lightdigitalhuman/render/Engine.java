@@ -4,6 +4,7 @@ import android.content.Context;
 import android.content.res.AssetManager;
 import android.util.Log;
 
+import java.io.File;
 import java.util.List;
 
 public class Engine {
@@ -26,9 +27,30 @@ public class Engine {
         }
         if (isInitialized) {
             initializeOpenGLResources(context);
+            setCookedCacheDir(new File(context.getCacheDir(), "cooked_models"));
+            setIblCacheDir(new File(context.getCacheDir(), "ibl"));
         }
     }
 
+    /**
+     * 设置烘焙模型目录, 首次加载后的转换结果写入该目录, 之后直接映射加载。
+     * 传入 null 关闭烘焙
+     */
+    public void setCookedCacheDir(File dir) {
+        nativeSetCookedCacheDir(dir != null ? dir.getAbsolutePath() : "");
+    }
+
+    /**
+     * 设置 IBL 烘焙缓存目录, HDR 环境首次预处理的结果写入该目录, 之后直接上传纹理。
+     * 传入 null 关闭缓存
+     */
+    public void setIblCacheDir(File dir) {
+        if (!isInitialized()) {
+            return;
+        }
+        nativeSetIblCacheDir(nativeEnginePtr, dir != null ? dir.getAbsolutePath() : "");
+    }
+
     public long getNativeEnginePtr() {
         return nativeEnginePtr;
     }
@@ -60,6 +82,34 @@ public class Engine {
         return false;
     }
 
+    /**
+     * 异步加载模型, 解析在后台线程执行, GPU 上传在 renderFrame 中分帧完成,
+     * 就绪后自动替换当前模型。通过 getLoadProgress 查询进度。
+     */
+    public boolean loadModelAsync(AssetManager assetManager, String patch) {
+        if (nativeEnginePtr != 0) {
+            return loadModelAsync(nativeEnginePtr, assetManager, patch);
+        }
+        return false;
+    }
+
+    public boolean loadModelFromFileAsync(String patch) {
+        if (nativeEnginePtr != 0) {
+            return loadFromFileAsync(nativeEnginePtr, patch);
+        }
+        return false;
+    }
+
+    /**
+     * 最近一次异步加载的进度, 范围 0~1, 失败时返回 -1
+     */
+    public float getLoadProgress() {
+        if (nativeEnginePtr != 0) {
+            return nativeGetLoadProgress(nativeEnginePtr);
+        }
+        return -1f;
+    }
+
 
     public void renderFrame(int width, int height) {
         if (nativeEnginePtr != 0) {
@@ -150,6 +200,82 @@ public class Engine {
     }
 
 
+    /**
+     * 添加动画层, 同名层已存在时更新其混合方式与权重; 层按添加顺序自下而上混合
+     *
+     * @param additive 为 true 时叠加片段相对其首帧的变化量
+     * @return 层下标, 失败返回 -1
+     */
+    public int addAnimationLayer(String layer, boolean additive, float weight) {
+        if (!isInitialized()) {
+            Log.w(TAG, "⚠️ Engine未初始化");
+            return -1;
+        }
+        return nativeAddAnimationLayer(nativeEnginePtr, layer, additive, weight);
+    }
+
+    /**
+     * 在层上交叉淡化到指定动画, 层不存在时以覆盖方式创建
+     *
+     * @param fadeSeconds 淡化时长, 为 0 时立即切换
+     * @param loopCount   循环次数, -1 为无限循环
+     * @param weight      片段在层内的权重
+     */
+    public boolean crossFadeAnimation(String layer, String animationName, float fadeSeconds,
+                                      int loopCount, float weight) {
+        if (!isInitialized()) {
+            Log.w(TAG, "⚠️ Engine未初始化");
+            return false;
+        }
+        return nativeCrossFadeAnimation(nativeEnginePtr, layer, animationName, fadeSeconds,
+                loopCount, weight);
+    }
+
+    public boolean stopAnimationLayer(String layer, float fadeSeconds) {
+        if (!isInitialized()) {
+            Log.w(TAG, "⚠️ Engine未初始化");
+            return false;
+        }
+        return nativeStopAnimationLayer(nativeEnginePtr, layer, fadeSeconds);
+    }
+
+    public boolean setAnimationLayerWeight(String layer, float weight, float fadeSeconds) {
+        if (!isInitialized()) {
+            Log.w(TAG, "⚠️ Engine未初始化");
+            return false;
+        }
+        return nativeSetAnimationLayerWeight(nativeEnginePtr, layer, weight, fadeSeconds);
+    }
+
+    /**
+     * 限制层只作用于指定节点及其子节点, 为空时作用于全部节点
+     */
+    public boolean setAnimationLayerMask(String layer, String[] rootNodes) {
+        if (!isInitialized()) {
+            Log.w(TAG, "⚠️ Engine未初始化");
+            return false;
+        }
+        return nativeSetAnimationLayerMask(nativeEnginePtr, layer, rootNodes);
+    }
+
+    /**
+     * 设置动画 LOD 阈值, 尺寸均为占视口高度的比例
+     *
+     * @param halfRateSize    模型尺寸低于该值时每 2 帧采样一次动画
+     * @param quarterRateSize 模型尺寸低于该值时每 4 帧采样一次动画
+     * @param jointChainSize  末端关节链（手指、面部等）尺寸低于该值时不再采样
+     * @param morphWeightSize 模型尺寸低于该值时不再采样 morph 权重
+     */
+    public void setAnimationLod(boolean enabled, float halfRateSize, float quarterRateSize,
+                                float jointChainSize, float morphWeightSize) {
+        if (!isInitialized()) {
+            Log.w(TAG, "⚠️ Engine未初始化");
+            return;
+        }
+        nativeSetAnimationLod(nativeEnginePtr, enabled, halfRateSize, quarterRateSize,
+                jointChainSize, morphWeightSize);
+    }
+
     public void  setIbl(boolean enable) {
         if (!isInitialized()) {
             Log.w(TAG, "⚠️ Engine未初始化");
@@ -169,10 +295,20 @@ public class Engine {
 
     private native void initializeOpenGLResources(Context context);
 
+    private native void nativeSetCookedCacheDir(String dir);
+
+    private native void nativeSetIblCacheDir(long nativeEnginePtr, String dir);
+
     private native boolean loadModel(long nativeEnginePtr, AssetManager assetManager, String patch);
 
     private native boolean loadFromFile(long nativeEnginePtr, String filePath);
 
+    private native boolean loadModelAsync(long nativeEnginePtr, AssetManager assetManager, String patch);
+
+    private native boolean loadFromFileAsync(long nativeEnginePtr, String filePath);
+
+    private native float nativeGetLoadProgress(long nativeEnginePtr);
+
     private native void nativeDestroy(long enginePtr);
 
     private native void setUserCamera(long enginePtr, long cameraDataPtr);
@@ -183,6 +319,22 @@ public class Engine {
 
     private native void nativeStopAnimation(long enginePtr, String animationName);
 
+    private native int nativeAddAnimationLayer(long enginePtr, String layer, boolean additive, float weight);
+
+    private native boolean nativeCrossFadeAnimation(long enginePtr, String layer, String animationName,
+                                                    float fadeSeconds, int loopCount, float weight);
+
+    private native boolean nativeStopAnimationLayer(long enginePtr, String layer, float fadeSeconds);
+
+    private native boolean nativeSetAnimationLayerWeight(long enginePtr, String layer, float weight,
+                                                         float fadeSeconds);
+
+    private native boolean nativeSetAnimationLayerMask(long enginePtr, String layer, String[] rootNodes);
+
+    private native void nativeSetAnimationLod(long enginePtr, boolean enabled, float halfRateSize,
+                                              float quarterRateSize, float jointChainSize,
+                                              float morphWeightSize);
+
     private native boolean loadEnvironmentFromAssets(long enginePtr, String env_path, AssetManager assetManager);
 
     private native boolean nativeLoadEnvironmentIblFromAssets(long enginePtr, String env_path, AssetManager assetManager);